@@ -179,10 +179,10 @@ private:
     boost::array< value_type, HIDDEN + 1 > M_delta_weight_h_to_o[OUTPUT];
 
     /*!
-      internal value holder.
+      internal value holder used by train().
       last point value is used as bias input, so back value must be 1.
     */
-    mutable boost::array< value_type, HIDDEN + 1 > M_hidden_layer;
+    boost::array< value_type, HIDDEN + 1 > M_hidden_layer;
 
 public:
     /*!
@@ -271,8 +271,28 @@ public:
       \brief simulate network.
       \param input input data
       \param output reference to the data holder variable
+
+      The hidden layer values are held in the local variable,
+      so this method can be called from several threads at the same time.
+    */
+    void propagate( const input_array & input,
+                    output_array & output ) const
+      {
+          boost::array< value_type, HIDDEN + 1 > hidden_layer;
+          hidden_layer.back() = 1;
+          propagate( input, hidden_layer, output );
+      }
+
+private:
+
+    /*!
+      \brief simulate network.
+      \param input input data
+      \param hidden_layer reference to the hidden layer value holder. back value must be 1.
+      \param output reference to the data holder variable
     */
     void propagate( const input_array & input,
+                    boost::array< value_type, HIDDEN + 1 > & hidden_layer,
                     output_array & output ) const
       {
           // Input to Hidden
@@ -285,14 +305,14 @@ public:
                                                    static_cast< value_type >( 0 ) );
               // add bias
               sum += M_weight_i_to_h[i].back();
-              M_hidden_layer[i] = func_h( sum );
+              hidden_layer[i] = func_h( sum );
           }
           // Hidden to Output
           FuncO func_o;
           for ( std::size_t i = 0; i < OUTPUT; ++i )
           {
-              value_type sum = std::inner_product( M_hidden_layer.begin(),
-                                                   M_hidden_layer.end(),
+              value_type sum = std::inner_product( hidden_layer.begin(),
+                                                   hidden_layer.end(),
                                                    M_weight_h_to_o[i].begin(),
                                                    static_cast< value_type >( 0 ) );
               // bias is already added
@@ -300,6 +320,8 @@ public:
           }
       }
 
+public:
+
     /*!
       \brief update unit connection weights using teacher signal
       \param input input data
@@ -309,7 +331,7 @@ public:
                       const output_array & teacher )
       {
           output_array output;
-          propagate( input, output );
+          propagate( input, M_hidden_layer, output );
 
           // error value mulitiplied by differential
           output_array output_back;
@@ -61,7 +61,6 @@ BasicClient::BasicClient()
       M_compression_level( 0 )
 {
     std::memset( M_message, 0, MAX_MESG );
-    M_compression_message.reserve( MAX_MESG );
     M_decompression_message.reserve( MAX_MESG );
 }
 
@@ -354,14 +353,13 @@ BasicClient::sendMessage( const char * msg )
     if ( M_compression_level > 0
          && M_compressor )
     {
-        M_compressor->compress( msg,
-                                std::strlen( msg ) + 1,
-                                M_compression_message );
+        // the compressed message is sent from the compressor's buffer.
+        M_compressor->compress( msg, std::strlen( msg ) + 1 );
 
-        if ( ! M_compression_message.empty() )
+        if ( M_compressor->size() > 0 )
         {
-            return M_socket->send( M_compression_message.data(),
-                                   M_compression_message.length() );
+            return M_socket->send( M_compressor->data(),
+                                   M_compressor->size() );
         }
 
         return 0;
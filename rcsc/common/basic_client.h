@@ -100,9 +100,6 @@ private:
     //! gzip compression level
     int M_compression_level;
 
-    //! compression message buffer
-    std::string M_compression_message;
-
     //! compression message buffer
     std::string M_decompression_message;
 
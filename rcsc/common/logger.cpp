@@ -37,10 +37,20 @@
 #include <rcsc/game_time.h>
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <iostream>
+#include <istream>
+#include <ostream>
 #include <cstdarg>
 #include <cstring>
 
+#if ! defined(_WIN32) && defined(__GNUC__)
+#define RCSC_LOGGER_THREAD
+#include <pthread.h>
+#include <time.h>
+#endif
+
 namespace rcsc {
 
 namespace  {
@@ -48,14 +58,345 @@ namespace  {
 //! buffer size for the log message.
 #define G_BUFFER_SIZE 2048
 
-//! temporary buffer
-char g_buffer[G_BUFFER_SIZE];
+//! the flush threshold of the records added in one cycle.
+const std::size_t FLUSH_THRESHOLD = 8192 * 3;
+
+//! default capacity of the ring buffer.
+const std::size_t DEFAULT_RING_SIZE = 1024 * 1024;
+
+//! magic string at the top of the binary log file
+const char BINARY_MAGIC[] = "RCDLOG";
+//! binary format version
+const char BINARY_VERSION = 1;
+//! size of the binary file header
+const std::size_t BINARY_FILE_HEADER_SIZE = 8;
+//! size of the binary record header
+const std::size_t BINARY_RECORD_HEADER_SIZE = 12;
+
+//! color tag of the binary record
+enum BinaryColor {
+    COLOR_NONE = 0,
+    COLOR_NAME = 1,
+    COLOR_RGB = 2,
+};
+
+/*!
+  \brief check the byte order of this host.
+  \return 1 if little endian, 0 if big endian
+ */
+inline
+char
+host_byte_order()
+{
+    const boost::uint16_t one = 1;
+    return *reinterpret_cast< const char * >( &one );
+}
+
+/*!
+  \brief get the number of the packed floats of the record kind.
+  \param kind record kind character
+  \return the number of floats, or -1 if unknown kind.
+ */
+int
+binary_float_count( const char kind )
+{
+    switch ( kind ) {
+    case 'M':
+        return 0;
+    case 'p':
+    case 'm':
+        return 2;
+    case 'c':
+    case 'C':
+        return 3;
+    case 'l':
+    case 'r':
+    case 'R':
+        return 4;
+    case 'a':
+        return 5;
+    case 't':
+    case 'T':
+    case 's':
+    case 'S':
+        return 6;
+    default:
+        break;
+    }
+    return -1;
+}
+
+/*!
+  \brief read the 2 or 4 bytes value with the byte order of the file.
+ */
+template < typename T >
+T
+read_binary( const char * p,
+             const bool swap )
+{
+    char b[sizeof( T )];
+    for ( std::size_t i = 0; i < sizeof( T ); ++i )
+    {
+        b[i] = p[ swap ? sizeof( T ) - 1 - i : i ];
+    }
+
+    T val;
+    std::memcpy( &val, b, sizeof( T ) );
+    return val;
+}
+
+#ifdef RCSC_LOGGER_THREAD
+/*!
+  \brief read the index written by the other thread.
+ */
+inline
+std::size_t
+load_acquire( const volatile std::size_t & v )
+{
+    std::size_t r = v;
+    __sync_synchronize();
+    return r;
+}
+
+/*!
+  \brief publish the index to the other thread.
+ */
+inline
+void
+store_release( volatile std::size_t & v,
+               const std::size_t r )
+{
+    __sync_synchronize();
+    v = r;
+}
+#endif
+
+}
+
+/*!
+  \struct LoggerImpl
+  \brief buffers and the writer thread of Logger.
+
+  The records added in one cycle are stored in str_. flush() copies
+  them into the ring buffer, and the writer thread writes the ring
+  buffer to the file. The agent thread only moves head_ and the writer
+  thread only moves tail_, so no lock is needed. If the ring buffer
+  does not have enough room, the records are dropped and counted.
+ */
+struct LoggerImpl {
+
+    char buffer_[G_BUFFER_SIZE]; //!< temporary buffer
+    std::string str_; //!< records added after the last flush
+
+    std::vector< char > ring_; //!< ring buffer. the size is a power of 2.
+    volatile std::size_t head_; //!< total bytes pushed by the agent thread
+    volatile std::size_t tail_; //!< total bytes written by the writer thread
 
-//! main buffer
-std::string g_str;
+    std::size_t dropped_records_; //!< the number of dropped records
+    std::size_t dropped_bytes_; //!< the size of dropped records
+
+    FILE * fout_; //!< output file used by the writer thread
+
+    bool binary_; //!< if true, records are stored in the binary format
+
+#ifdef RCSC_LOGGER_THREAD
+    pthread_t thread_; //!< writer thread
+    bool running_; //!< true if the writer thread is running
+    volatile std::size_t stop_; //!< stop request to the writer thread
+#endif
 
+    LoggerImpl()
+        : ring_( DEFAULT_RING_SIZE )
+        , head_( 0 )
+        , tail_( 0 )
+        , dropped_records_( 0 )
+        , dropped_bytes_( 0 )
+        , fout_( NULL )
+        , binary_( false )
+#ifdef RCSC_LOGGER_THREAD
+        , running_( false )
+        , stop_( 0 )
+#endif
+      {
+          str_.reserve( 8192 * 4 );
+          std::strcpy( buffer_, "" );
+      }
+
+    /*!
+      \brief append a binary record to str_.
+      \param cycle game cycle
+      \param level log level
+      \param kind record kind character, same as the text format
+      \param values values packed as float
+      \param n the number of values
+      \param color color name. NULL if not used.
+      \param rgb array of r, g, b values. NULL if not used.
+      \param text message string. NULL if not used.
+     */
+    void putBinary( const long cycle,
+                    const boost::int32_t level,
+                    const char kind,
+                    const double * values,
+                    const int n,
+                    const char * color,
+                    const int * rgb,
+                    const char * text )
+      {
+          const std::size_t name_len = ( color
+                                         ? std::min( std::strlen( color ),
+                                                     static_cast< std::size_t >( 255 ) )
+                                         : 0 );
+          std::size_t body_size = n * sizeof( float );
+          body_size += ( rgb ? 3 : color ? 1 + name_len : 0 );
+
+          std::size_t text_len = ( text ? std::strlen( text ) : 0 );
+          text_len = std::min( text_len, 65535 - body_size );
+          body_size += text_len;
+
+          char header[BINARY_RECORD_HEADER_SIZE];
+          const boost::int32_t c = static_cast< boost::int32_t >( cycle );
+          const boost::uint16_t size = static_cast< boost::uint16_t >( body_size );
+          std::memcpy( header, &c, 4 );
+          std::memcpy( header + 4, &level, 4 );
+          header[8] = kind;
+          header[9] = static_cast< char >( rgb ? COLOR_RGB : color ? COLOR_NAME : COLOR_NONE );
+          std::memcpy( header + 10, &size, 2 );
+          str_.append( header, BINARY_RECORD_HEADER_SIZE );
+
+          for ( int i = 0; i < n; ++i )
+          {
+              const float f = static_cast< float >( values[i] );
+              char b[sizeof( float )];
+              std::memcpy( b, &f, sizeof( float ) );
+              str_.append( b, sizeof( float ) );
+          }
+
+          if ( rgb )
+          {
+              str_ += static_cast< char >( rgb[0] );
+              str_ += static_cast< char >( rgb[1] );
+              str_ += static_cast< char >( rgb[2] );
+          }
+          else if ( color )
+          {
+              str_ += static_cast< char >( name_len );
+              str_.append( color, name_len );
+          }
+
+          if ( text_len > 0 )
+          {
+              str_.append( text, text_len );
+          }
+      }
+
+#ifdef RCSC_LOGGER_THREAD
+    /*!
+      \brief copy the data into the ring buffer. called by the agent thread.
+      \return false if the ring buffer does not have enough room.
+     */
+    bool push( const char * data,
+               const std::size_t size )
+      {
+          const std::size_t capacity = ring_.size();
+          const std::size_t head = head_;
+          const std::size_t tail = load_acquire( tail_ );
+
+          if ( size > capacity - ( head - tail ) )
+          {
+              return false;
+          }
+
+          const std::size_t pos = head & ( capacity - 1 );
+          const std::size_t first = std::min( size, capacity - pos );
+          std::memcpy( &ring_[pos], data, first );
+          std::memcpy( &ring_[0], data + first, size - first );
+
+          store_release( head_, head + size );
+          return true;
+      }
+
+    /*!
+      \brief write all pushed data to the file. called by the writer thread.
+      \return true if some data is written.
+     */
+    bool drain()
+      {
+          const std::size_t capacity = ring_.size();
+          const std::size_t tail = tail_;
+          const std::size_t head = load_acquire( head_ );
+
+          if ( head == tail )
+          {
+              return false;
+          }
+
+          const std::size_t size = head - tail;
+          const std::size_t pos = tail & ( capacity - 1 );
+          const std::size_t first = std::min( size, capacity - pos );
+          std::fwrite( &ring_[pos], sizeof( char ), first, fout_ );
+          std::fwrite( &ring_[0], sizeof( char ), size - first, fout_ );
+
+          store_release( tail_, head );
+          return true;
+      }
+
+    /*!
+      \brief writer thread loop. the file is flushed when the ring buffer becomes empty.
+     */
+    void run()
+      {
+          bool written = false;
+          for ( ; ; )
+          {
+              // check the stop request before the data,
+              // then all data pushed before the request is written.
+              const bool stop = ( load_acquire( stop_ ) != 0 );
+
+              if ( drain() )
+              {
+                  written = true;
+                  continue;
+              }
+
+              if ( written )
+              {
+                  std::fflush( fout_ );
+                  written = false;
+              }
+
+              if ( stop )
+              {
+                  break;
+              }
+
+              timespec req;
+              req.tv_sec = 0;
+              req.tv_nsec = 2 * 1000 * 1000;
+              nanosleep( &req, NULL );
+          }
+      }
+#endif
+};
+
+#ifdef RCSC_LOGGER_THREAD
+extern "C" {
+
+/*!
+  \brief entry point of the writer thread.
+  \param arg pointer to LoggerImpl
+  \return NULL
+ */
+static
+void *
+logger_writer_main( void * arg )
+{
+    static_cast< LoggerImpl * >( arg )->run();
+    return NULL;
 }
 
+}
+#endif
+
 //! global variable
 Logger dlog;
 
@@ -67,9 +408,9 @@ Logger::Logger()
     : M_time( static_cast< GameTime * >( 0 ) )
     , M_fout( NULL )
     , M_flags( 0 )
+    , M_impl( new LoggerImpl )
 {
-    g_str.reserve( 8192 * 4 );
-    std::strcpy( g_buffer, "" );
+
 }
 
 /*-------------------------------------------------------------------*/
@@ -78,12 +419,7 @@ Logger::Logger()
  */
 Logger::~Logger()
 {
-    if ( M_fout )
-    {
-        this->flush();
-        fclose( M_fout );
-        M_fout = NULL;
-    }
+    close();
 }
 
 /*-------------------------------------------------------------------*/
@@ -93,7 +429,146 @@ Logger::~Logger()
 void
 Logger::open( const std::string & filepath )
 {
+    close();
+
     M_fout = std::fopen( filepath.c_str(), "w" );
+    if ( ! M_fout )
+    {
+        return;
+    }
+
+    if ( M_impl->binary_ )
+    {
+        char header[BINARY_FILE_HEADER_SIZE];
+        std::memcpy( header, BINARY_MAGIC, 6 );
+        header[6] = BINARY_VERSION;
+        header[7] = host_byte_order();
+        std::fwrite( header, sizeof( char ), BINARY_FILE_HEADER_SIZE, M_fout );
+    }
+
+    M_impl->fout_ = M_fout;
+    M_impl->head_ = 0;
+    M_impl->tail_ = 0;
+    M_impl->dropped_records_ = 0;
+    M_impl->dropped_bytes_ = 0;
+
+#ifdef RCSC_LOGGER_THREAD
+    M_impl->stop_ = 0;
+    if ( pthread_create( &M_impl->thread_, NULL,
+                         logger_writer_main, M_impl.get() ) == 0 )
+    {
+        M_impl->running_ = true;
+    }
+    else
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " failed to create the log writer thread."
+                  << " the log is written synchronously." << std::endl;
+    }
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Logger::close()
+{
+    if ( ! M_fout )
+    {
+        return;
+    }
+
+    this->flush();
+
+#ifdef RCSC_LOGGER_THREAD
+    if ( M_impl->running_ )
+    {
+        store_release( M_impl->stop_, 1 );
+        pthread_join( M_impl->thread_, NULL );
+        M_impl->running_ = false;
+    }
+#endif
+
+    if ( M_impl->dropped_records_ > 0 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " dropped " << M_impl->dropped_records_ << " log records ("
+                  << M_impl->dropped_bytes_ << " bytes)." << std::endl;
+    }
+
+    fclose( M_fout );
+    M_fout = NULL;
+    M_impl->fout_ = NULL;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+Logger::setBufferSize( const std::size_t size )
+{
+    if ( M_fout )
+    {
+        return false;
+    }
+
+    std::size_t capacity = 1024;
+    while ( capacity < size )
+    {
+        capacity *= 2;
+    }
+
+    std::vector< char >( capacity ).swap( M_impl->ring_ );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+Logger::setFormat( const Format format )
+{
+    if ( M_fout )
+    {
+        return false;
+    }
+
+    M_impl->binary_ = ( format == BINARY_FORMAT );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Logger::Format
+Logger::format() const
+{
+    return ( M_impl->binary_ ? BINARY_FORMAT : TEXT_FORMAT );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+Logger::droppedRecords() const
+{
+    return M_impl->dropped_records_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+Logger::droppedBytes() const
+{
+    return M_impl->dropped_bytes_;
 }
 
 /*-------------------------------------------------------------------*/
@@ -123,13 +598,54 @@ Logger::setLogFlag( const GameTime * time,
 void
 Logger::flush()
 {
-    if ( M_fout && g_str.length() > 0 )
+    std::string & str = M_impl->str_;
+
+    if ( M_fout && str.length() > 0 )
     {
-        fputs( g_str.c_str(), M_fout );
-        //fwrite( g_str.c_str(), sizeof( char ), g_str.length(), M_fout );
+#ifdef RCSC_LOGGER_THREAD
+        if ( M_impl->running_ )
+        {
+            // no I/O here. the writer thread writes the records.
+            if ( ! M_impl->push( str.data(), str.length() ) )
+            {
+                // push the records one by one, and drop the records that do not fit.
+                std::string::size_type first = 0;
+                while ( first < str.length() )
+                {
+                    std::string::size_type last = str.length();
+                    if ( M_impl->binary_ )
+                    {
+                        // binary records are not delimited.
+                        // the body size is read from the record header written in the host byte order.
+                        if ( first + BINARY_RECORD_HEADER_SIZE <= str.length() )
+                        {
+                            last = std::min( last,
+                                             first + BINARY_RECORD_HEADER_SIZE
+                                             + read_binary< boost::uint16_t >( str.data() + first + 10, false ) );
+                        }
+                    }
+                    else
+                    {
+                        last = str.find( '\n', first );
+                        last = ( last == std::string::npos ? str.length() : last + 1 );
+                    }
+
+                    if ( ! M_impl->push( str.data() + first, last - first ) )
+                    {
+                        M_impl->dropped_records_ += 1;
+                        M_impl->dropped_bytes_ += last - first;
+                    }
+                    first = last;
+                }
+            }
+            str.erase();
+            return;
+        }
+#endif
+        std::fwrite( str.data(), sizeof( char ), str.length(), M_fout );
         fflush( M_fout );
     }
-    g_str.erase();
+    str.erase();
 }
 
 /*-------------------------------------------------------------------*/
@@ -139,7 +655,7 @@ Logger::flush()
 void
 Logger::clear()
 {
-    g_str.erase();
+    M_impl->str_.erase();
 }
 
 /*-------------------------------------------------------------------*/
@@ -155,18 +671,30 @@ Logger::addText( const boost::int32_t level,
     {
         va_list argp;
         va_start( argp, msg );
-        vsnprintf( g_buffer, G_BUFFER_SIZE, msg, argp );
+        vsnprintf( M_impl->buffer_, G_BUFFER_SIZE, msg, argp );
         va_end( argp );
 
+        if ( M_impl->binary_ )
+        {
+            M_impl->putBinary( M_time->cycle(), level, 'M',
+                               NULL, 0,
+                               NULL, NULL, M_impl->buffer_ );
+            if ( M_impl->str_.length() > FLUSH_THRESHOLD )
+            {
+                flush();
+            }
+            return;
+        }
+
         char header[32];
         snprintf( header, 32, "%ld %d M ",
                   M_time->cycle(),
                   level );
 
-        g_str += header;
-        g_str += g_buffer;
-        g_str += '\n';
-        if ( g_str.length() > 8192 * 3 )
+        M_impl->str_ += header;
+        M_impl->str_ += M_impl->buffer_;
+        M_impl->str_ += '\n';
+        if ( M_impl->str_.length() > FLUSH_THRESHOLD )
         {
             flush();
         }
@@ -185,17 +713,26 @@ Logger::addPoint( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y };
+            M_impl->putBinary( M_time->cycle(), level, 'p',
+                               v, 2,
+                               color, NULL, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d p %.4f %.4f ",
                   M_time->cycle(),
                   level,
                   x, y );
-        g_str += msg;
+        M_impl->str_ += msg;
         if ( color )
         {
-            g_str += color;
+            M_impl->str_ += color;
         }
-        g_str += '\n';
+        M_impl->str_ += '\n';
     }
 }
 
@@ -211,14 +748,24 @@ Logger::addPoint( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, 'p',
+                               v, 2,
+                               NULL, rgb, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d p %.4f %.4f #%02x%02x%02x",
                   M_time->cycle(),
                   level,
                   x, y,
                   r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -236,17 +783,26 @@ Logger::addLine( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x1, y1, x2, y2 };
+            M_impl->putBinary( M_time->cycle(), level, 'l',
+                               v, 4,
+                               color, NULL, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d l %.4f %.4f %.4f %.4f ",
                   M_time->cycle(),
                   level,
                   x1, y1, x2, y2 );
-        g_str += msg;
+        M_impl->str_ += msg;
         if ( color )
         {
-            g_str += color;
+            M_impl->str_ += color;
         }
-        g_str += '\n';
+        M_impl->str_ += '\n';
     }
 }
 
@@ -264,14 +820,24 @@ Logger::addLine( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x1, y1, x2, y2 };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, 'l',
+                               v, 4,
+                               NULL, rgb, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d l %.4f %.4f %.4f %.4f #%02x%02x%02x",
                   M_time->cycle(),
                   level,
                   x1, y1, x2, y2,
                   r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -290,19 +856,29 @@ Logger::addArc( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y, radius, start_angle.degree(),
+                                 span_angle };
+            M_impl->putBinary( M_time->cycle(), level, 'a',
+                               v, 5,
+                               color, NULL, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d a %.4f %.4f %.4f %.4f %.4f ",
                   M_time->cycle(),
                   level,
                   x, y, radius, start_angle.degree(), span_angle );
-        g_str += msg;
+        M_impl->str_ += msg;
 
         if ( color )
         {
-            g_str += color;
+            M_impl->str_ += color;
         }
 
-        g_str += '\n';
+        M_impl->str_ += '\n';
     }
 }
 
@@ -322,14 +898,25 @@ Logger::addArc( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y, radius, start_angle.degree(),
+                                 span_angle };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, 'a',
+                               v, 5,
+                               NULL, rgb, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d a %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x",
                   M_time->cycle(),
                   level,
                   x, y, radius, start_angle.degree(), span_angle,
                   r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -347,18 +934,27 @@ Logger::addCircle( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y, radius };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'C' : 'c' ),
+                               v, 3,
+                               color, NULL, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f ",
                   M_time->cycle(),
                   level,
                   ( fill ? 'C' : 'c' ),
                   x, y, radius );
-        g_str += msg;
+        M_impl->str_ += msg;
         if ( color )
         {
-            g_str += color;
+            M_impl->str_ += color;
         }
-        g_str += '\n';
+        M_impl->str_ += '\n';
     }
 }
 
@@ -376,6 +972,16 @@ Logger::addCircle( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y, radius };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'C' : 'c' ),
+                               v, 3,
+                               NULL, rgb, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f #%02x%02x%02x",
                   M_time->cycle(),
@@ -383,8 +989,8 @@ Logger::addCircle( const boost::int32_t level,
                   ( fill ? 'C' : 'c' ),
                   x, y, radius,
                   r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -405,18 +1011,27 @@ Logger::addTriangle( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x1, y1, x2, y2, x3, y3 };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'T' : 't' ),
+                               v, 6,
+                               color, NULL, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f ",
                   M_time->cycle(),
                   level,
                   ( fill ? 'T' : 't' ),
                   x1, y1, x2, y2, x3, y3 );
-        g_str += msg;
+        M_impl->str_ += msg;
         if ( color )
         {
-            g_str += color;
+            M_impl->str_ += color;
         }
-        g_str += '\n';
+        M_impl->str_ += '\n';
     }
 }
 
@@ -437,6 +1052,16 @@ Logger::addTriangle( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x1, y1, x2, y2, x3, y3 };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'T' : 't' ),
+                               v, 6,
+                               NULL, rgb, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x",
                   M_time->cycle(),
@@ -444,8 +1069,8 @@ Logger::addTriangle( const boost::int32_t level,
                   ( fill ? 'T' : 't' ),
                   x1, y1, x2, y2, x3, y3,
                   r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -464,18 +1089,27 @@ Logger::addRect( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { left, top, length, width };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'R' : 'r' ),
+                               v, 4,
+                               color, NULL, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f %.4f ",
                   M_time->cycle(),
                   level,
                   ( fill ? 'R' : 'r' ),
                   left, top, length, width );
-        g_str += msg;
+        M_impl->str_ += msg;
         if ( color )
         {
-            g_str += color;
+            M_impl->str_ += color;
         }
-        g_str += '\n';
+        M_impl->str_ += '\n';
     }
 }
 
@@ -494,6 +1128,16 @@ Logger::addRect( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { left, top, length, width };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'R' : 'r' ),
+                               v, 4,
+                               NULL, rgb, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f %.4f #%02x%02x%02x",
                   M_time->cycle(),
@@ -501,8 +1145,8 @@ Logger::addRect( const boost::int32_t level,
                   ( fill ? 'R' : 'r' ),
                   left, top, length, width,
                   r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -523,6 +1167,16 @@ Logger::addSector( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y, min_radius, max_radius,
+                                 start_angle.degree(), span_angle };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'S' : 's' ),
+                               v, 6,
+                               color, NULL, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f ",
                   M_time->cycle(),
@@ -530,12 +1184,12 @@ Logger::addSector( const boost::int32_t level,
                   ( fill ? 'S' : 's' ),
                   x, y, min_radius, max_radius,
                   start_angle.degree(), span_angle );
-        g_str += msg;
+        M_impl->str_ += msg;
         if ( color )
         {
-            g_str += color;
+            M_impl->str_ += color;
         }
-        g_str += '\n';
+        M_impl->str_ += '\n';
     }
 }
 
@@ -556,6 +1210,17 @@ Logger::addSector( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y, min_radius, max_radius,
+                                 start_angle.degree(), span_angle };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'S' : 's' ),
+                               v, 6,
+                               NULL, rgb, NULL );
+            return;
+        }
+
         char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x",
                   M_time->cycle(),
@@ -564,8 +1229,8 @@ Logger::addSector( const boost::int32_t level,
                   x, y, min_radius, max_radius,
                   start_angle.degree(), span_angle,
                   r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -581,10 +1246,22 @@ Logger::addSector( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
-        char msg[128];
         double span_angle = ( sector.angleLeftStart().isLeftOf( sector.angleRightEnd() )
                               ? ( sector.angleLeftStart() - sector.angleRightEnd() ).abs()
                               : 360.0 - ( sector.angleLeftStart() - sector.angleRightEnd() ).abs() );
+
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { sector.center().x, sector.center().y,
+                                 sector.radiusMin(), sector.radiusMax(),
+                                 sector.angleLeftStart().degree(), span_angle };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'S' : 's' ),
+                               v, 6,
+                               color, NULL, NULL );
+            return;
+        }
+
+        char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f ",
                   M_time->cycle(),
                   level,
@@ -592,12 +1269,12 @@ Logger::addSector( const boost::int32_t level,
                   sector.center().x, sector.center().y,
                   sector.radiusMin(), sector.radiusMax(),
                   sector.angleLeftStart().degree(), span_angle );
-        g_str += msg;
+        M_impl->str_ += msg;
         if ( color )
         {
-            g_str += color;
+            M_impl->str_ += color;
         }
-        g_str += '\n';
+        M_impl->str_ += '\n';
     }
 }
 
@@ -613,10 +1290,23 @@ Logger::addSector( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
-        char msg[128];
         double span_angle = ( sector.angleLeftStart().isLeftOf( sector.angleRightEnd() )
                               ? ( sector.angleLeftStart() - sector.angleRightEnd() ).abs()
                               : 360.0 - ( sector.angleLeftStart() - sector.angleRightEnd() ).abs() );
+
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { sector.center().x, sector.center().y,
+                                 sector.radiusMin(), sector.radiusMax(),
+                                 sector.angleLeftStart().degree(), span_angle };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, ( fill ? 'S' : 's' ),
+                               v, 6,
+                               NULL, rgb, NULL );
+            return;
+        }
+
+        char msg[128];
         snprintf( msg, 128, "%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x",
                   M_time->cycle(),
                   level,
@@ -625,8 +1315,8 @@ Logger::addSector( const boost::int32_t level,
                   sector.radiusMin(), sector.radiusMax(),
                   sector.angleLeftStart().degree(), span_angle,
                   r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -643,22 +1333,31 @@ Logger::addMessage( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y };
+            M_impl->putBinary( M_time->cycle(), level, 'm',
+                               v, 2,
+                               color, NULL, msg );
+            return;
+        }
+
         char header[128];
         snprintf( header, 128, "%ld %d m %.4f %.4f ",
                   M_time->cycle(),
                   level,
                   x, y );
-        g_str += header;
+        M_impl->str_ += header;
 
         if ( color )
         {
-            g_str += "(c ";
-            g_str += color;
-            g_str += ") ";
+            M_impl->str_ += "(c ";
+            M_impl->str_ += color;
+            M_impl->str_ += ") ";
         }
 
-        g_str += msg;
-        g_str += '\n';
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
     }
 }
 
@@ -675,22 +1374,149 @@ Logger::addMessage( const boost::int32_t level,
 {
     if ( M_fout && ( level & M_flags ) && M_time )
     {
+        if ( M_impl->binary_ )
+        {
+            const double v[] = { x, y };
+            const int rgb[] = { r, g, b };
+            M_impl->putBinary( M_time->cycle(), level, 'm',
+                               v, 2,
+                               NULL, rgb, msg );
+            return;
+        }
+
         char header[128];
         snprintf( header, 128, "%ld %d m %.4f %.4f ",
                   M_time->cycle(),
                   level,
                   x, y );
-        g_str += header;
+        M_impl->str_ += header;
 
         char col[8];
         snprintf( col, 8, "#%02x%02x%02x", r, g, b );
-        g_str += "(c ";
-        g_str += col;
-        g_str += ") ";
+        M_impl->str_ += "(c ";
+        M_impl->str_ += col;
+        M_impl->str_ += ") ";
+
+        M_impl->str_ += msg;
+        M_impl->str_ += '\n';
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+Logger::binary_to_text( std::istream & is,
+                        std::ostream & os )
+{
+    char file_header[BINARY_FILE_HEADER_SIZE];
+    if ( ! is.read( file_header, BINARY_FILE_HEADER_SIZE )
+         || std::memcmp( file_header, BINARY_MAGIC, 6 ) != 0 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " not a binary debug log." << std::endl;
+        return false;
+    }
 
-        g_str += msg;
-        g_str += '\n';
+    if ( file_header[6] != BINARY_VERSION )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " unsupported binary debug log version "
+                  << static_cast< int >( file_header[6] ) << std::endl;
+        return false;
     }
+
+    const bool swap = ( file_header[7] != host_byte_order() );
+
+    char header[BINARY_RECORD_HEADER_SIZE];
+    std::vector< char > body;
+    std::string line;
+    char buf[64];
+
+    while ( is.read( header, BINARY_RECORD_HEADER_SIZE ) )
+    {
+        const boost::int32_t cycle = read_binary< boost::int32_t >( header, swap );
+        const boost::int32_t level = read_binary< boost::int32_t >( header + 4, swap );
+        const char kind = header[8];
+        const int color = header[9];
+        const std::size_t size = read_binary< boost::uint16_t >( header + 10, swap );
+
+        body.resize( size + 1 );
+        if ( size > 0
+             && ! is.read( &body[0], size ) )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__
+                      << " broken record at cycle " << cycle << std::endl;
+            return false;
+        }
+
+        const int n = binary_float_count( kind );
+        if ( n < 0
+             || size < n * sizeof( float ) )
+        {
+            // unknown record. skip it.
+            continue;
+        }
+
+        snprintf( buf, sizeof( buf ), "%ld %d %c",
+                  static_cast< long >( cycle ), level, kind );
+        line = buf;
+
+        const char * p = &body[0];
+        const char * end = p + size;
+        for ( int i = 0; i < n; ++i, p += sizeof( float ) )
+        {
+            snprintf( buf, sizeof( buf ), " %.4f",
+                      static_cast< double >( read_binary< float >( p, swap ) ) );
+            line += buf;
+        }
+        line += ' ';
+
+        std::string color_str;
+        if ( color == COLOR_RGB
+             && p + 3 <= end )
+        {
+            snprintf( buf, sizeof( buf ), "#%02x%02x%02x",
+                      static_cast< unsigned char >( p[0] ),
+                      static_cast< unsigned char >( p[1] ),
+                      static_cast< unsigned char >( p[2] ) );
+            color_str = buf;
+            p += 3;
+        }
+        else if ( color == COLOR_NAME
+                  && p < end )
+        {
+            const std::size_t len = std::min( static_cast< std::size_t >( static_cast< unsigned char >( *p ) ),
+                                              static_cast< std::size_t >( end - p - 1 ) );
+            color_str.assign( p + 1, len );
+            p += 1 + len;
+        }
+
+        if ( kind == 'M' )
+        {
+            line.append( p, end );
+        }
+        else if ( kind == 'm' )
+        {
+            if ( color != COLOR_NONE )
+            {
+                line += "(c ";
+                line += color_str;
+                line += ") ";
+            }
+            line.append( p, end );
+        }
+        else
+        {
+            line += color_str;
+        }
+
+        line += '\n';
+        os.write( line.data(), line.length() );
+    }
+
+    return os.good();
 }
 
 }
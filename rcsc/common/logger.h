@@ -38,18 +38,31 @@
 #include <rcsc/geom/sector_2d.h>
 #include <rcsc/geom/triangle_2d.h>
 
+#include <boost/scoped_ptr.hpp>
 #include <boost/cstdint.hpp>
 
 #include <string>
+#include <iosfwd>
 #include <cstdio>
 
 namespace rcsc {
 
 class GameTime;
+struct LoggerImpl;
 
 /*!
   \class Logger
   \brief log output manager
+
+  Each logger has its own buffers. The records added in one cycle are
+  copied into the ring buffer by flush(), and a background thread
+  writes them to the file. The agent thread never waits for the file
+  I/O. If the writer thread falls behind and the ring buffer is full,
+  the records are dropped and counted by droppedRecords().
+
+  In the binary format, the records are stored with the packed floats
+  and without any snprintf. binary_to_text() converts the binary log
+  into the text format for the viewers.
 */
 class Logger {
 public:
@@ -118,6 +131,26 @@ public:
     Message := <x:Real> <y:Real>[ (c <Color>)] <Str>
     **************************************************/
 
+    /*************************************************
+    Binary Log Format:
+    File := <FileHeader> <Record>*
+    FileHeader := "RCDLOG" <Version:UInt8> <ByteOrder:UInt8(1:little, 0:big)>
+    Record := <Time:Int32> <Level:Int32> <Type:Char> <ColorTag:UInt8> <Size:UInt16> <Body>
+    ColorTag := 0 (none) | 1 (name) | 2 (rgb)
+    Body := <Value:Float32>* [<Color>] [<Str>]
+        The number of values is the number of Reals in the text format.
+    Color := <Length:UInt8> <Name> | <R:UInt8> <G:UInt8> <B:UInt8>
+    Str is given only for M and m, and fills the rest of Size.
+    **************************************************/
+
+    /*!
+      \brief output file format
+     */
+    enum Format {
+        TEXT_FORMAT,
+        BINARY_FORMAT,
+    };
+
     static const boost::int32_t SYSTEM    = LEVEL_01; //!< log level definition alias
     static const boost::int32_t SENSOR    = LEVEL_02; //!< log level definition alias
     static const boost::int32_t WORLD     = LEVEL_03; //!< log level definition alias
@@ -151,6 +184,14 @@ private:
     //! log level flag
     boost::int32_t M_flags;
 
+    //! buffers and writer thread
+    boost::scoped_ptr< LoggerImpl > M_impl;
+
+    //! not used
+    Logger( const Logger & );
+    //! not used
+    Logger & operator=( const Logger & );
+
 public:
     /*!
       \brief allocate message buffer memory
@@ -162,6 +203,51 @@ public:
      */
     ~Logger();
 
+    /*!
+      \brief set the ring buffer size. This method has to be called before open().
+      \param size ring buffer size in bytes. rounded up to a power of 2.
+      \return true if the size is changed.
+     */
+    bool setBufferSize( const std::size_t size );
+
+    /*!
+      \brief set the output file format. This method has to be called before open().
+      \param format output file format
+      \return true if the format is changed.
+     */
+    bool setFormat( const Format format );
+
+    /*!
+      \brief get the output file format.
+      \return output file format
+     */
+    Format format() const;
+
+    /*!
+      \brief convert the binary log into the text format.
+      \param is input stream of the binary log
+      \param os output stream of the text log
+      \return true if successfully converted.
+
+      Values are packed as float in the binary log, so the last digit
+      of a large value may differ from the text log.
+     */
+    static
+    bool binary_to_text( std::istream & is,
+                         std::ostream & os );
+
+    /*!
+      \brief get the number of records dropped because the ring buffer was full.
+      \return the number of dropped records
+     */
+    std::size_t droppedRecords() const;
+
+    /*!
+      \brief get the size of records dropped because the ring buffer was full.
+      \return dropped size in bytes
+     */
+    std::size_t droppedBytes() const;
+
     /*!
       \brief set new log level
       \param time const pointer to the game time instance
@@ -188,6 +274,11 @@ public:
      */
     void open( const std::string & filepath );
 
+    /*!
+      \brief write all records, stop the writer thread and close the file.
+     */
+    void close();
+
     /*!
       \brief check if file is opened
       \return true if file is opened
@@ -198,7 +289,8 @@ public:
       }
 
     /*!
-      \brief flush stored message
+      \brief pass the stored messages to the writer thread.
+      If the thread is not available, the messages are written immediately.
     */
     void flush();
 
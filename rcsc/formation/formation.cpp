@@ -117,6 +117,7 @@ Formation::create( std::istream & is )
 Formation::Formation()
     : M_version( 0 )
     , M_samples( new SampleDataSet() )
+    , M_training_observer( static_cast< TrainingObserver * >( 0 ) )
 {
     for ( int i = 0; i < 11; ++i )
     {
@@ -344,6 +345,49 @@ Formation::print( std::ostream & os ) const
     return os;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Formation::Ptr
+Formation::clone() const
+{
+    std::stringstream buf;
+    if ( ! print( buf ) )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " *** ERROR *** failed to print the formation."
+                  << std::endl;
+        return Ptr();
+    }
+
+    Ptr ptr = create( methodName() );
+    if ( ! ptr )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " *** ERROR *** failed to create the formation. "
+                  << methodName()
+                  << std::endl;
+        return Ptr();
+    }
+
+    if ( ! ptr->read( buf ) )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " *** ERROR *** failed to read the copied formation."
+                  << std::endl;
+        return Ptr();
+    }
+
+    // the printed values are rounded. use the exact copy of the samples.
+    if ( M_samples )
+    {
+        ptr->setSamples( SampleDataSet::Ptr( new SampleDataSet( *M_samples ) ) );
+    }
+
+    return ptr;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -57,6 +57,32 @@ public:
     typedef Ptr (*Creator)(); //!< creator function
     typedef rcss::Factory< Creator, std::string > Creators; //!< creator function holder
 
+    /*!
+      \class TrainingObserver
+      \brief interface to watch the progress of the iterative training.
+    */
+    class TrainingObserver {
+    public:
+        /*!
+          \brief virtual destructor.
+         */
+        virtual
+        ~TrainingObserver()
+          { }
+
+        /*!
+          \brief called after each training epoch.
+          \param unum number of the player currently trained
+          \param epoch epoch count for this player
+          \param error average error of the last epoch
+          \return false if the training should be cancelled.
+        */
+        virtual
+        bool progress( const int unum,
+                       const int epoch,
+                       const double & error ) = 0;
+    };
+
 
     /*!
       \enum SideType
@@ -113,6 +139,11 @@ protected:
      */
     formation::SampleDataSet::Ptr M_samples;
 
+    /*!
+      \brief training progress observer. not owned by this instance.
+     */
+    TrainingObserver * M_training_observer;
+
 public:
 
     /*!
@@ -177,6 +208,16 @@ public:
           M_samples = samples;
       }
 
+    /*!
+      \brief set the training progress observer.
+      \param observer raw pointer to the observer. NULL removes the observer.
+      The observer is not deleted by this instance.
+     */
+    void setTrainingObserver( TrainingObserver * observer )
+      {
+          M_training_observer = observer;
+      }
+
     /*!
       \brief check if player is SIDE type or not
       \param unum player's number
@@ -329,9 +370,34 @@ public:
     */
     std::ostream & print( std::ostream & os ) const;
 
+    /*!
+      \brief create the deep copy of this formation.
+      \return smart pointer to the new instance. NULL if failed.
+
+      The copy is made by the print/read round trip, and the sample data set
+      is copied without the text conversion. The training observer is not
+      copied.
+    */
+    Ptr clone() const;
+
 
 protected:
 
+    /*!
+      \brief notify the training progress to the observer.
+      \param unum number of the player currently trained
+      \param epoch epoch count for this player
+      \param error average error of the last epoch
+      \return false if the observer requested to cancel the training.
+     */
+    bool notifyTrainingProgress( const int unum,
+                                 const int epoch,
+                                 const double & error ) const
+      {
+          return ( ! M_training_observer
+                   || M_training_observer->progress( unum, epoch, error ) );
+      }
+
     //
     // read
     //
@@ -576,6 +576,12 @@ FormationBPN::train()
                 //printMessageWithTime( "train. converged. loop=%d", loop );
                 break;
             }
+
+            if ( ! notifyTrainingProgress( unum, loop, ave_err ) )
+            {
+                std::cerr << "FormationBPN::train. Cancelled!!" << std::endl;
+                return;
+            }
         }
         if ( ! success )
         {
@@ -310,7 +310,7 @@ Vector2D
 FormationKNN::getPosition( const int unum,
                            const Vector2D & focus_point ) const
 {
-    static std::vector< const SampleData * > ptr_vector;
+    std::vector< const SampleData * > ptr_vector;
 
     if ( unum < 1 || 11 < unum )
     {
@@ -365,7 +365,6 @@ FormationKNN::getPosition( const int unum,
 
     pos /= sum_inv_dist2;
 
-    ptr_vector.clear();
 
 #if 0
     if ( unum == 11 )
@@ -394,7 +393,7 @@ void
 FormationKNN::getPositions( const Vector2D & focus_point,
                             std::vector< Vector2D > & positions ) const
 {
-    static std::vector< const SampleData * > ptr_vector;
+    std::vector< const SampleData * > ptr_vector;
 
     positions.clear();
 
@@ -447,7 +446,6 @@ FormationKNN::getPositions( const Vector2D & focus_point,
         positions.push_back( pos );
     }
 
-    ptr_vector.clear();
 }
 
 /*-------------------------------------------------------------------*/
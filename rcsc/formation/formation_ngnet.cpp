@@ -545,6 +545,12 @@ FormationNGNet::train()
                 //printMessageWithTime( "train. converged. loop=%d", loop );
                 break;
             }
+
+            if ( ! notifyTrainingProgress( unum, loop, ave_err ) )
+            {
+                std::cerr << "FormationNGNet::train. Cancelled!!" << std::endl;
+                return;
+            }
         }
         if ( ! success )
         {
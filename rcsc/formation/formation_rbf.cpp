@@ -555,6 +555,12 @@ FormationRBF::train()
                 //printMessageWithTime( "train. converged. loop=%d", loop );
                 break;
             }
+
+            if ( ! notifyTrainingProgress( unum, loop, ave_err ) )
+            {
+                std::cerr << "FormationRBF::train. Cancelled!!" << std::endl;
+                return;
+            }
         }
         if ( ! success )
         {
@@ -35,8 +35,7 @@
 
 #include "formation_ssl.h"
 
-#include <rcsc/geom/segment_2d.h>
-#include <rcsc/geom/line_2d.h>
+#include <rcsc/geom/segment_intersection.h>
 #include <rcsc/math_util.h>
 
 #include <sstream>
@@ -292,11 +291,11 @@ FormationSSL::interpolate( const int unum,
         Vector2D result_1 = M_sample_vector.at( tri->v1_ ).getPosition( unum );
         Vector2D result_2 = M_sample_vector.at( tri->v2_ ).getPosition( unum );
 
-        Line2D line_0( vertex_0, focus_point );
-        Segment2D segment_12( vertex_1, vertex_2 );
-        Vector2D intersection_12 = segment_12.intersection( line_0 );
+        Vector2D intersection_12 = Vector2D::INVALIDATED;
 
-        if ( ! intersection_12.isValid() )
+        if ( ! SegmentIntersection::segment_line( vertex_1, vertex_2,
+                                                  vertex_0, focus_point,
+                                                  &intersection_12 ) )
         {
             if ( focus_point.dist2( vertex_0 ) < 1.0e-5 )
             {
@@ -38,9 +38,11 @@
 #include "formation.h"
 
 #include <rcsc/geom/segment_2d.h>
+#include <rcsc/geom/segment_intersection.h>
 
 #include <iterator>
 #include <algorithm>
+#include <map>
 #include <limits>
 #include <fstream>
 #include <sstream>
@@ -83,6 +85,71 @@ SampleDataSet::SampleDataSet()
 
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SampleDataSet::SampleDataSet( const SampleDataSet & other )
+    : M_data_cont( other.dataCont() )
+{
+    copyConstraints( other );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const SampleDataSet &
+SampleDataSet::operator=( const SampleDataSet & other )
+{
+    if ( this != &other )
+    {
+        M_data_cont = other.dataCont();
+        copyConstraints( other );
+    }
+    return *this;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleDataSet::copyConstraints( const SampleDataSet & other )
+{
+    M_constraints.clear();
+
+    if ( other.M_constraints.empty() )
+    {
+        return;
+    }
+
+    std::map< const SampleData *, const SampleData * > address_map;
+    DataCont::const_iterator it = M_data_cont.begin();
+    for ( DataCont::const_iterator o = other.M_data_cont.begin(), o_end = other.M_data_cont.end();
+          o != o_end && it != M_data_cont.end();
+          ++o, ++it )
+    {
+        address_map.insert( std::make_pair( &(*o), &(*it) ) );
+    }
+
+    M_constraints.reserve( other.M_constraints.size() );
+    for ( Constraints::const_iterator c = other.M_constraints.begin(), c_end = other.M_constraints.end();
+          c != c_end;
+          ++c )
+    {
+        std::map< const SampleData *, const SampleData * >::const_iterator first = address_map.find( c->first );
+        std::map< const SampleData *, const SampleData * >::const_iterator second = address_map.find( c->second );
+        if ( first == address_map.end()
+             || second == address_map.end() )
+        {
+            continue;
+        }
+
+        M_constraints.push_back( Constraint( first->second, second->second ) );
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -141,7 +208,6 @@ SampleDataSet::nearestData( const Vector2D & pos,
             min_dist2 = d2;
             rval.first = index;
             rval.second = &(*p);
-            break;
         }
     }
 
@@ -222,34 +288,19 @@ SampleDataSet::existIntersectedConstraints() const
         return false;
     }
 
-    const size_t size = M_constraints.size();
-    for ( size_t i = 0; i < size - 1; ++i )
-    {
-        const Constraint & c0 = M_constraints[i];
-        const Segment2D s0( c0.first->ball_, c0.second->ball_ );
-
-        for ( size_t j = i + 1; j < size; ++j )
-        {
-            const Constraint & c1 = M_constraints[j];
-
-            if ( c0.first == c1.first
-                 || c0.first == c1.second
-                 || c0.second == c1.first
-                 || c0.second == c1.second )
-            {
-                // shares same sample data
-                continue;
-            }
+    SegmentIntersection segments;
+    segments.reserve( M_constraints.size() );
 
-            if ( s0.existIntersectionExceptEndpoint( Segment2D( c1.first->ball_,
-                                                                c1.second->ball_ ) ) )
-            {
-                return true;
-            }
-        }
+    for ( Constraints::const_iterator c = M_constraints.begin();
+          c != M_constraints.end();
+          ++c )
+    {
+        segments.add( c->first->ball_, c->second->ball_ );
     }
 
-    return false;
+    // constraints that share the same sample data are never reported,
+    // because the intersection at the end point is not detected.
+    return segments.existIntersectionExceptEndpoint();
 }
 
 /*-------------------------------------------------------------------*/
@@ -295,6 +346,7 @@ SampleDataSet::addData( const Formation & formation,
         if ( data.ball_.absY() < 0.5 )
         {
             //return ILLEGAL_SYMMETRY_DATA;
+            updateDataIndex();
             return NO_ERROR;
         }
 
@@ -302,7 +354,9 @@ SampleDataSet::addData( const Formation & formation,
         reversed.ball_.y *= -1.0;
         reverseY( formation, reversed.players_ );
 
-        return addData( formation, reversed, false );
+        ErrorType err = addData( formation, reversed, false );
+        updateDataIndex();
+        return err;
     }
 
     updateDataIndex();
@@ -365,6 +419,7 @@ SampleDataSet::insertData( const Formation & formation,
         if ( data.ball_.absY() < 0.5 )
         {
             //return ILLEGAL_SYMMETRY_DATA;
+            updateDataIndex();
             return NO_ERROR;
         }
 
@@ -372,7 +427,9 @@ SampleDataSet::insertData( const Formation & formation,
         reversed.ball_.y *= -1.0;
         reverseY( formation, reversed.players_ );
 
-        return insertData( formation, idx + 1, reversed, false );
+        ErrorType err = insertData( formation, idx + 1, reversed, false );
+        updateDataIndex();
+        return err;
     }
 
     updateDataIndex();
@@ -438,6 +495,7 @@ SampleDataSet::replaceData( const Formation & formation,
     {
         if ( data.ball_.absY() < 0.5 )
         {
+            updateDataIndex();
             return NO_ERROR;
         }
 
@@ -445,7 +503,9 @@ SampleDataSet::replaceData( const Formation & formation,
         reversed.ball_.y *= -1.0;
         reverseY( formation, reversed.players_ );
 
-        return replaceSymmetryData( formation, original_data, reversed );
+        ErrorType err = replaceSymmetryData( formation, original_data, reversed );
+        updateDataIndex();
+        return err;
     }
 
     //
@@ -527,6 +587,29 @@ SampleDataSet::replaceSymmetryData( const Formation & formation,
     return NO_ERROR;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SampleDataSet::ErrorType
+SampleDataSet::restoreData( const size_t idx,
+                            const SampleData & data )
+{
+    if ( M_data_cont.size() <= idx )
+    {
+        return INVALID_INDEX;
+    }
+
+    DataCont::iterator it = M_data_cont.begin();
+    std::advance( it, idx );
+
+    *it = data;
+
+    updateDataIndex();
+
+    return NO_ERROR;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -677,8 +760,10 @@ SampleDataSet::addConstraint( const size_t origin_idx,
           c != M_constraints.end();
           ++c )
     {
-        if ( constraint.existIntersectionExceptEndpoint( Segment2D( c->first->ball_,
-                                                                    c->second->ball_ ) ) )
+        if ( SegmentIntersection::exist_intersection_except_endpoint( origin->ball_,
+                                                                     terminal->ball_,
+                                                                     c->first->ball_,
+                                                                     c->second->ball_ ) )
         {
             std::cerr << __FILE__ << ':' << __LINE__ << ':'
                       << " addConstraint() the input constraint intersects with existing constraint. "
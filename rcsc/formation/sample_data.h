@@ -135,6 +135,12 @@ private:
     DataCont M_data_cont; //!< data container.
     Constraints M_constraints; //!< constraint container.
 
+    /*!
+      \brief copy the constraints of other set. the pointers are rebound to the own data.
+      \param other source object. its data container must be same as this.
+     */
+    void copyConstraints( const SampleDataSet & other );
+
 public:
 
     /*!
@@ -146,22 +152,13 @@ public:
       \brief copy constructor.
       \param other source object.
      */
-    SampleDataSet( const SampleDataSet & other )
-        : M_data_cont( other.dataCont() )
-      { }
+    SampleDataSet( const SampleDataSet & other );
 
     /*!
       \brief substitution operator.
       \param other source object.
      */
-    const SampleDataSet & operator=( const SampleDataSet & other )
-      {
-          if ( this != &other )
-          {
-              M_data_cont = other.dataCont();
-          }
-          return *this;
-      }
+    const SampleDataSet & operator=( const SampleDataSet & other );
 
     /*!
       \brief virtual destructor.
@@ -211,6 +208,12 @@ public:
      */
     bool existTooNearData( const SampleData & data ) const;
 
+    /*!
+      \brief check if there are constraints intersected with others.
+      \return checked result.
+     */
+    bool existIntersectedConstraints() const;
+
 private:
     /*!
       \brief update index value of all data.
@@ -224,12 +227,6 @@ private:
      */
     bool existIntersectedConstraint( const Vector2D & pos ) const;
 
-    /*!
-      \brief check if there are constraints intersected with others.
-      \param checked result.
-     */
-    bool existIntersectedConstraints() const;
-
 public:
 
     /*!
@@ -269,6 +266,18 @@ public:
                            const SampleData & data,
                            const bool symmetry );
 
+    /*!
+      \brief overwrite the data at input index without the distance and constraint check.
+      \param idx input index.
+      \param data input data. it must be the data previously held at the index.
+      \return error code.
+
+      This is used to restore the data set to the previous state, where
+      the intermediate state of the restoration can be invalid.
+     */
+    ErrorType restoreData( const size_t idx,
+                           const SampleData & data );
+
     /*!
       \brief delete exsiting data at input index.
       \param idx input index.
@@ -0,0 +1,584 @@
+// -*-c++-*-
+
+/*!
+  \file sample_harvester.cpp
+  \brief formation sample collector for game logs Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "sample_harvester.h"
+
+#include <rcsc/formation/formation.h>
+#include <rcsc/rcg/parser.h>
+#include <rcsc/rcg/parallel_parser.h>
+#include <rcsc/rcg/util.h>
+
+#ifdef HAVE_LIBZ
+#include <rcsc/gz/gzfstream.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+
+namespace rcsc {
+namespace formation {
+
+namespace {
+
+inline
+double
+round_coord( const double & val )
+{
+    return rint( val / SampleData::PRECISION ) * SampleData::PRECISION;
+}
+
+inline
+std::string
+team_name( const rcg::team_t & team )
+{
+    const char * end = static_cast< const char * >( std::memchr( team.name, '\0', sizeof( team.name ) ) );
+    return std::string( team.name,
+                        end ? end - team.name : sizeof( team.name ) );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SampleHarvester::SampleHarvester()
+    : M_team_name(),
+      M_play_on_only( true ),
+      M_max_size( SampleDataSet::MAX_DATA_SIZE ),
+      M_min_dist( SampleDataSet::NEAR_DIST_THR ),
+      M_side( LEFT ),
+      M_playmode( PM_BeforeKickOff ),
+      M_grid( SampleDataSet::NEAR_DIST_THR ),
+      M_show_count( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleHarvester::setMaxSize( const std::size_t size )
+{
+    if ( size == 0 )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " Illegal max size " << size << std::endl;
+        return;
+    }
+
+    M_max_size = size;
+    thinOut();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleHarvester::setMinDistance( const double & dist )
+{
+    if ( dist <= 0.0 )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " Illegal distance threshold " << dist << std::endl;
+        return;
+    }
+
+    M_min_dist = dist;
+    rebuild();
+    thinOut();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::harvest( const std::string & filepath )
+{
+    // the uncompressed file is parsed in memory by the parallel parser.
+    {
+        rcg::ParallelParser parser;
+        if ( parser.open( filepath ) )
+        {
+            M_side = ( M_team_name.empty() ? LEFT : NEUTRAL );
+            M_playmode = PM_BeforeKickOff;
+
+            return parser.parse( *this );
+        }
+    }
+
+#ifdef HAVE_LIBZ
+    // decompress the next 1MB block while the current block is parsed.
+    rcsc::gzifstream fin( filepath.c_str(), 1024 * 1024, true );
+#else
+    std::ifstream fin( filepath.c_str(), std::ios_base::in | std::ios_base::binary );
+#endif
+    if ( ! fin.is_open() )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " Could not open the file [" << filepath << "]" << std::endl;
+        return false;
+    }
+
+    return harvest( fin );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::harvest( std::istream & is )
+{
+    rcg::Parser::Ptr parser = rcg::Parser::create( is );
+    if ( ! parser )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " Unsupported log format." << std::endl;
+        return false;
+    }
+
+    // the side is fixed when the team names are read.
+    M_side = ( M_team_name.empty() ? LEFT : NEUTRAL );
+    M_playmode = PM_BeforeKickOff;
+
+    return parser->parse( is, *this );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleHarvester::merge( const SampleHarvester & other )
+{
+    if ( M_min_dist < other.M_min_dist )
+    {
+        M_min_dist = other.M_min_dist;
+        rebuild();
+    }
+
+    M_show_count += other.M_show_count;
+
+    for ( DataCont::const_iterator it = other.M_samples.begin(), end = other.M_samples.end();
+          it != end;
+          ++it )
+    {
+        add( *it );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::add( const SampleData & data )
+{
+    SpatialGrid< std::size_t >::Handle h = 0;
+    if ( M_grid.nearest( data.ball_, &h, static_cast< double * >( 0 ), M_min_dist ) )
+    {
+        return false;
+    }
+
+    M_grid.insert( data.ball_, M_samples.size() );
+    M_samples.push_back( data );
+    M_samples.back().index_ = -1;
+
+    if ( M_samples.size() > M_max_size )
+    {
+        thinOut();
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+SampleHarvester::appendTo( const Formation & formation,
+                           SampleDataSet & samples ) const
+{
+    std::size_t count = 0;
+
+    for ( DataCont::const_iterator it = M_samples.begin(), end = M_samples.end();
+          it != end;
+          ++it )
+    {
+        SampleDataSet::ErrorType err = samples.addData( formation, *it, false );
+        if ( err == SampleDataSet::TOO_MANY_DATA )
+        {
+            break;
+        }
+
+        if ( err == SampleDataSet::NO_ERROR )
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::read( std::istream & is )
+{
+    std::string line;
+    int n_line = 0;
+
+    while ( std::getline( is, line ) )
+    {
+        ++n_line;
+        if ( line.empty() || line[0] == '#' ) continue;
+
+        std::istringstream istr( line );
+
+        SampleData data;
+        if ( ! ( istr >> data.ball_.x >> data.ball_.y ) )
+        {
+            std::cerr << __FILE__ << ":" << __LINE__
+                      << " Illegal ball data at line " << n_line << std::endl;
+            return false;
+        }
+
+        for ( int unum = 1; unum <= 11; ++unum )
+        {
+            Vector2D pos;
+            if ( ! ( istr >> pos.x >> pos.y ) )
+            {
+                std::cerr << __FILE__ << ":" << __LINE__
+                          << " Illegal player data at line " << n_line << std::endl;
+                return false;
+            }
+            data.players_.push_back( pos );
+        }
+
+        add( data );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SampleHarvester::print( std::ostream & os ) const
+{
+    os << "# ball_x ball_y p1_x p1_y ... p11_x p11_y\n";
+
+    for ( DataCont::const_iterator it = M_samples.begin(), end = M_samples.end();
+          it != end;
+          ++it )
+    {
+        os << round_coord( it->ball_.x ) << ' ' << round_coord( it->ball_.y );
+        for ( SampleData::PlayerCont::const_iterator p = it->players_.begin(), p_end = it->players_.end();
+              p != p_end;
+              ++p )
+        {
+            os << ' ' << round_coord( p->x ) << ' ' << round_coord( p->y );
+        }
+        os << '\n';
+    }
+
+    return os << std::flush;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleHarvester::thinOut()
+{
+    while ( M_samples.size() > M_max_size )
+    {
+        // the number of samples is about halved.
+        M_min_dist *= std::sqrt( 2.0 );
+        rebuild();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleHarvester::rebuild()
+{
+    DataCont old_samples;
+    old_samples.swap( M_samples );
+
+    M_grid.clear();
+    M_grid.setCellSize( M_min_dist );
+
+    // earlier samples have priority.
+    for ( DataCont::const_iterator it = old_samples.begin(), end = old_samples.end();
+          it != end;
+          ++it )
+    {
+        SpatialGrid< std::size_t >::Handle h = 0;
+        if ( M_grid.nearest( it->ball_, &h, static_cast< double * >( 0 ), M_min_dist ) )
+        {
+            continue;
+        }
+
+        M_grid.insert( it->ball_, M_samples.size() );
+        M_samples.push_back( *it );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleHarvester::updateSide( const std::string & left_name,
+                             const std::string & right_name )
+{
+    if ( M_team_name.empty() )
+    {
+        M_side = LEFT;
+    }
+    else if ( M_team_name == left_name )
+    {
+        M_side = LEFT;
+    }
+    else if ( M_team_name == right_name )
+    {
+        M_side = RIGHT;
+    }
+    else
+    {
+        M_side = NEUTRAL;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleHarvester::addShow( const rcg::ShowInfoT & show )
+{
+    ++M_show_count;
+
+    if ( M_side == NEUTRAL )
+    {
+        return;
+    }
+
+    if ( M_play_on_only
+         && M_playmode != PM_PlayOn )
+    {
+        return;
+    }
+
+    const double reverse = ( M_side == RIGHT ? -1.0 : 1.0 );
+    const int offset = ( M_side == RIGHT ? MAX_PLAYER : 0 );
+
+    SampleData data;
+    data.ball_.assign( round_coord( show.ball_.x_ * reverse ),
+                       round_coord( show.ball_.y_ * reverse ) );
+
+    for ( int i = 0; i < MAX_PLAYER; ++i )
+    {
+        const rcg::PlayerT & p = show.player_[offset + i];
+        if ( p.state_ == rcg::DISABLE )
+        {
+            // the formation needs all players.
+            return;
+        }
+
+        data.players_.push_back( Vector2D( round_coord( p.x_ * reverse ),
+                                           round_coord( p.y_ * reverse ) ) );
+    }
+
+    add( data );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::handleDispInfo( const rcg::dispinfo_t & info )
+{
+    if ( rcg::nstohi( info.mode ) == rcg::SHOW_MODE )
+    {
+        return handleShowInfo( info.body.show );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::handleShowInfo( const rcg::showinfo_t & info )
+{
+    handlePlayMode( info.pmode );
+    handleTeamInfo( info.team[0], info.team[1] );
+
+    rcg::ShowInfoT show;
+    show.time_ = rcg::nstohi( info.time );
+    show.ball_.x_ = rcg::nstohf( info.pos[0].x );
+    show.ball_.y_ = rcg::nstohf( info.pos[0].y );
+
+    for ( int i = 1; i < MAX_PLAYER * 2 + 1; ++i )
+    {
+        const rcg::pos_t & pos = info.pos[i];
+
+        const int side = rcg::nstohi( pos.side );
+        const int unum = rcg::nstohi( pos.unum );
+        if ( unum < 1 || MAX_PLAYER < unum ) continue;
+
+        rcg::PlayerT & p = show.player_[unum - 1 + ( side == RIGHT ? MAX_PLAYER : 0 )];
+        p.side_ = ( side == RIGHT ? 'r' : 'l' );
+        p.unum_ = unum;
+        p.state_ = ( rcg::nstohi( pos.enable ) != 0 ? rcg::STAND : rcg::DISABLE );
+        p.x_ = rcg::nstohf( pos.x );
+        p.y_ = rcg::nstohf( pos.y );
+    }
+
+    addShow( show );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::handleShortShowInfo2( const rcg::short_showinfo_t2 & info )
+{
+    rcg::ShowInfoT show;
+    show.time_ = rcg::nstohi( info.time );
+    show.ball_.x_ = rcg::nltohf( info.ball.x );
+    show.ball_.y_ = rcg::nltohf( info.ball.y );
+
+    for ( int i = 0; i < MAX_PLAYER * 2; ++i )
+    {
+        const rcg::player_t & pos = info.pos[i];
+
+        rcg::PlayerT & p = show.player_[i];
+        p.side_ = ( i < MAX_PLAYER ? 'l' : 'r' );
+        p.unum_ = i % MAX_PLAYER + 1;
+        p.state_ = rcg::nstohi( pos.mode );
+        p.x_ = rcg::nltohf( pos.x );
+        p.y_ = rcg::nltohf( pos.y );
+    }
+
+    addShow( show );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::handlePlayMode( char playmode )
+{
+    M_playmode = static_cast< PlayMode >( playmode );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::handleTeamInfo( const rcg::team_t & team_left,
+                                 const rcg::team_t & team_right )
+{
+    updateSide( team_name( team_left ), team_name( team_right ) );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::handleShow( const int,
+                             const rcg::ShowInfoT & show )
+{
+    addShow( show );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::handlePlayMode( const int,
+                                 const PlayMode pm )
+{
+    M_playmode = pm;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleHarvester::handleTeam( const int,
+                             const rcg::TeamT & team_l,
+                             const rcg::TeamT & team_r )
+{
+    updateSide( team_l.name_, team_r.name_ );
+    return true;
+}
+
+}
+}
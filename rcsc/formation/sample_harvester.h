@@ -0,0 +1,335 @@
+// -*-c++-*-
+
+/*!
+  \file sample_harvester.h
+  \brief formation sample collector for game logs Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_FORMATION_SAMPLE_HARVESTER_H
+#define RCSC_FORMATION_SAMPLE_HARVESTER_H
+
+#include <rcsc/formation/sample_data.h>
+#include <rcsc/rcg/handler.h>
+#include <rcsc/geom/spatial_grid.h>
+#include <rcsc/types.h>
+
+#include <vector>
+#include <string>
+#include <istream>
+
+namespace rcsc {
+
+class Formation;
+
+namespace formation {
+
+/*!
+  \class SampleHarvester
+  \brief rcg handler that collects the formation samples from game logs.
+
+  Each show info in the play on mode is converted to one sample, the ball
+  position and the positions of the target team players. If the target
+  team plays on the right side, the coordinates are reversed so that the
+  team always attacks to the positive x direction.
+
+  A new sample is dropped if the ball position of an already collected
+  sample is within minDistance(), the same rule as
+  SampleDataSet::existTooNearData(). The lookup uses the spatial grid.
+
+  The number of collected samples never exceeds maxSize(). When it is
+  exceeded, the distance threshold is multiplied by sqrt(2) and the
+  collected samples are thinned out by the new threshold. So the memory
+  usage does not depend on the log length, and the result covers the ball
+  area evenly.
+*/
+class SampleHarvester
+    : public rcg::Handler {
+public:
+
+    typedef std::vector< SampleData > DataCont; //!< sample container type
+
+private:
+
+    std::string M_team_name; //!< target team name. empty means the left team.
+    bool M_play_on_only; //!< if true, samples are collected only in play on mode.
+    std::size_t M_max_size; //!< max number of samples
+    double M_min_dist; //!< current distance threshold of ball positions
+
+    SideID M_side; //!< side of the target team in the current log
+    PlayMode M_playmode; //!< current playmode in the current log
+
+    DataCont M_samples; //!< collected samples
+    SpatialGrid< std::size_t > M_grid; //!< ball position index of M_samples
+
+    std::size_t M_show_count; //!< number of handled show info
+
+public:
+
+    /*!
+      \brief create empty harvester.
+     */
+    SampleHarvester();
+
+    /*!
+      \brief set the target team.
+      \param name team name. if empty, the left team is used.
+     */
+    void setTeamName( const std::string & name )
+      {
+          M_team_name = name;
+      }
+
+    /*!
+      \brief set the playmode filter.
+      \param on if true, samples are collected only in play on mode.
+     */
+    void setPlayOnOnly( const bool on )
+      {
+          M_play_on_only = on;
+      }
+
+    /*!
+      \brief set the max number of samples.
+      \param size new value. must be positive.
+     */
+    void setMaxSize( const std::size_t size );
+
+    /*!
+      \brief set the distance threshold of ball positions.
+      \param dist new value. must be positive.
+     */
+    void setMinDistance( const double & dist );
+
+    /*!
+      \brief get the target team name.
+      \return team name string.
+     */
+    const std::string & teamName() const
+      {
+          return M_team_name;
+      }
+
+    /*!
+      \brief get the max number of samples.
+      \return max size value.
+     */
+    std::size_t maxSize() const
+      {
+          return M_max_size;
+      }
+
+    /*!
+      \brief get the current distance threshold.
+      \return distance threshold of ball positions.
+     */
+    double minDistance() const
+      {
+          return M_min_dist;
+      }
+
+    /*!
+      \brief get the collected samples.
+      \return const reference to the sample container.
+     */
+    const DataCont & samples() const
+      {
+          return M_samples;
+      }
+
+    /*!
+      \brief get the number of handled show info.
+      \return the number of show info.
+     */
+    std::size_t showCount() const
+      {
+          return M_show_count;
+      }
+
+    /*!
+      \brief read the game log file. gzipped file is also available if zlib is enabled.
+      \param filepath log file path
+      \return true if successfully parsed.
+
+      The uncompressed v2-v5 file is parsed in memory by rcg::ParallelParser.
+     */
+    bool harvest( const std::string & filepath );
+
+    /*!
+      \brief read the game log from the stream.
+      \param is input stream
+      \return true if successfully parsed.
+     */
+    bool harvest( std::istream & is );
+
+    /*!
+      \brief add the samples collected by other harvester.
+      \param other other harvester.
+     */
+    void merge( const SampleHarvester & other );
+
+    /*!
+      \brief add the sample. the sample near to an existing sample is dropped.
+      \param data added sample.
+      \return true if added.
+     */
+    bool add( const SampleData & data );
+
+    /*!
+      \brief append the collected samples to the sample data set.
+      \param formation formation that holds the role info.
+      \param samples destination data set.
+      \return the number of added samples.
+
+      Samples are added by SampleDataSet::addData(). Samples rejected by it,
+      e.g. too near data, are skipped. Adding is stopped when the data set is full.
+     */
+    std::size_t appendTo( const Formation & formation,
+                          SampleDataSet & samples ) const;
+
+    /*!
+      \brief read the samples printed by print().
+      \param is input stream.
+      \return true if successfully read.
+     */
+    bool read( std::istream & is );
+
+    /*!
+      \brief print the collected samples. each line has one sample.
+      \param os output stream.
+      \return output stream.
+     */
+    std::ostream & print( std::ostream & os ) const;
+
+private:
+
+    /*!
+      \brief increase the distance threshold and thin out the samples until size is not greater than max size.
+     */
+    void thinOut();
+
+    /*!
+      \brief rebuild the grid and drop the samples near to others.
+     */
+    void rebuild();
+
+    /*!
+      \brief set the target side by the team names.
+      \param left_name left team name
+      \param right_name right team name
+     */
+    void updateSide( const std::string & left_name,
+                     const std::string & right_name );
+
+    /*!
+      \brief convert the show info to the sample and add it.
+      \param show show info
+     */
+    void addShow( const rcg::ShowInfoT & show );
+
+public:
+
+    //
+    // rcg::Handler interface
+    //
+
+    virtual
+    bool handleDispInfo( const rcg::dispinfo_t & info );
+    virtual
+    bool handleShowInfo( const rcg::showinfo_t & info );
+    virtual
+    bool handleShortShowInfo2( const rcg::short_showinfo_t2 & info );
+    virtual
+    bool handleMsgInfo( rcg::Int16,
+                        const std::string & )
+      {
+          return true;
+      }
+    virtual
+    bool handlePlayMode( char playmode );
+    virtual
+    bool handleTeamInfo( const rcg::team_t & team_left,
+                         const rcg::team_t & team_right );
+    virtual
+    bool handlePlayerType( const rcg::player_type_t & )
+      {
+          return true;
+      }
+    virtual
+    bool handleServerParam( const rcg::server_params_t & )
+      {
+          return true;
+      }
+    virtual
+    bool handlePlayerParam( const rcg::player_params_t & )
+      {
+          return true;
+      }
+    virtual
+    bool handleEOF()
+      {
+          return true;
+      }
+
+    virtual
+    bool handleShow( const int time,
+                     const rcg::ShowInfoT & show );
+    virtual
+    bool handleMsg( const int,
+                    const int,
+                    const std::string & )
+      {
+          return true;
+      }
+    virtual
+    bool handlePlayMode( const int time,
+                         const PlayMode pm );
+    virtual
+    bool handleTeam( const int time,
+                     const rcg::TeamT & team_l,
+                     const rcg::TeamT & team_r );
+    virtual
+    bool handleServerParam( const std::string & )
+      {
+          return true;
+      }
+    virtual
+    bool handlePlayerParam( const std::string & )
+      {
+          return true;
+      }
+    virtual
+    bool handlePlayerType( const std::string & )
+      {
+          return true;
+      }
+
+};
+
+}
+}
+
+#endif
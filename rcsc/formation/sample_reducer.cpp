@@ -0,0 +1,653 @@
+// -*-c++-*-
+
+/*!
+  \file sample_reducer.cpp
+  \brief formation sample set reduction Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "sample_reducer.h"
+
+#include <rcsc/formation/formation.h>
+
+#include <boost/random.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <iostream>
+#include <cmath>
+
+namespace rcsc {
+namespace formation {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the uniform random value in [0, 1).
+  The engine output is used directly, so the value sequence does not
+  depend on the boost version.
+ */
+inline
+double
+uniform01( boost::mt19937 & engine )
+{
+    return static_cast< double >( engine() ) / 4294967296.0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief update the squared distance to the nearest selected sample.
+ */
+void
+update_nearest_dist2( const std::vector< SampleData > & samples,
+                      const Vector2D & selected,
+                      std::vector< double > & min_dist2 )
+{
+    const int size = static_cast< int >( samples.size() );
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for ( int i = 0; i < size; ++i )
+    {
+        const double d2 = samples[i].ball_.dist2( selected );
+        if ( d2 < min_dist2[i] )
+        {
+            min_dist2[i] = d2;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the index of the max value. the smallest index is returned if tied.
+ */
+std::size_t
+max_index( const std::vector< double > & values )
+{
+    std::size_t result = 0;
+    for ( std::size_t i = 1; i < values.size(); ++i )
+    {
+        if ( values[i] > values[result] )
+        {
+            result = i;
+        }
+    }
+    return result;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SampleReducer::SampleReducer()
+    : M_method( FARTHEST_POINT ),
+      M_target_size( SampleDataSet::MAX_DATA_SIZE ),
+      M_error_budget( 0.0 ),
+      M_seed( 0 ),
+      M_max_iteration( 50 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleReducer::parse_method( const std::string & name,
+                             Method * method )
+{
+    if ( name == "fps" || name == "farthest" )
+    {
+        *method = FARTHEST_POINT;
+        return true;
+    }
+
+    if ( name == "kmeans" || name == "k-means" )
+    {
+        *method = K_MEANS;
+        return true;
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::vector< std::size_t >
+SampleReducer::select( const std::vector< SampleData > & samples,
+                       const std::vector< std::size_t > & fixed,
+                       const std::size_t size ) const
+{
+    std::vector< std::size_t > result;
+
+    if ( size >= samples.size() )
+    {
+        result.reserve( samples.size() );
+        for ( std::size_t i = 0; i < samples.size(); ++i )
+        {
+            result.push_back( i );
+        }
+        return result;
+    }
+
+    if ( M_method == K_MEANS )
+    {
+        result = selectKMeans( samples, fixed, size );
+    }
+    else
+    {
+        result = selectFarthestPoint( samples, fixed, size );
+    }
+
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  The result is the selection order, not sorted.
+ */
+std::vector< std::size_t >
+SampleReducer::selectFarthestPoint( const std::vector< SampleData > & samples,
+                                    const std::vector< std::size_t > & fixed,
+                                    const std::size_t size ) const
+{
+    std::vector< std::size_t > result;
+    if ( samples.empty() )
+    {
+        return result;
+    }
+
+    result.reserve( std::max( size, fixed.size() ) );
+
+    std::vector< double > min_dist2( samples.size(), std::numeric_limits< double >::max() );
+
+    for ( std::vector< std::size_t >::const_iterator it = fixed.begin(), end = fixed.end();
+          it != end;
+          ++it )
+    {
+        if ( *it >= samples.size()
+             || min_dist2[*it] == 0.0 )
+        {
+            continue;
+        }
+
+        result.push_back( *it );
+        update_nearest_dist2( samples, samples[*it].ball_, min_dist2 );
+        min_dist2[*it] = 0.0;
+    }
+
+    if ( result.empty() )
+    {
+        boost::mt19937 engine( static_cast< boost::uint32_t >( M_seed ) );
+        const std::size_t first = std::min( static_cast< std::size_t >( uniform01( engine ) * samples.size() ),
+                                            samples.size() - 1 );
+        result.push_back( first );
+        update_nearest_dist2( samples, samples[first].ball_, min_dist2 );
+        min_dist2[first] = 0.0;
+    }
+
+    while ( result.size() < size )
+    {
+        const std::size_t idx = max_index( min_dist2 );
+        if ( min_dist2[idx] <= 0.0 )
+        {
+            // all remaining samples are duplicated
+            break;
+        }
+
+        result.push_back( idx );
+        update_nearest_dist2( samples, samples[idx].ball_, min_dist2 );
+        min_dist2[idx] = 0.0;
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::vector< std::size_t >
+SampleReducer::selectKMeans( const std::vector< SampleData > & samples,
+                             const std::vector< std::size_t > & fixed,
+                             const std::size_t size ) const
+{
+    const int n = static_cast< int >( samples.size() );
+
+    boost::mt19937 engine( static_cast< boost::uint32_t >( M_seed ) );
+
+    //
+    // k-means++ seeding
+    //
+
+    std::vector< Vector2D > centers;
+    centers.reserve( size );
+
+    std::vector< bool > is_fixed( samples.size(), false );
+    std::vector< double > min_dist2( samples.size(), std::numeric_limits< double >::max() );
+
+    for ( std::vector< std::size_t >::const_iterator it = fixed.begin(), end = fixed.end();
+          it != end;
+          ++it )
+    {
+        if ( *it >= samples.size()
+             || is_fixed[*it] )
+        {
+            continue;
+        }
+
+        is_fixed[*it] = true;
+        centers.push_back( samples[*it].ball_ );
+        update_nearest_dist2( samples, samples[*it].ball_, min_dist2 );
+    }
+
+    if ( centers.empty() )
+    {
+        const std::size_t first = std::min( static_cast< std::size_t >( uniform01( engine ) * samples.size() ),
+                                            samples.size() - 1 );
+        centers.push_back( samples[first].ball_ );
+        update_nearest_dist2( samples, samples[first].ball_, min_dist2 );
+    }
+
+    const std::size_t n_fixed = centers.size();
+
+    while ( centers.size() < size )
+    {
+        double total = 0.0;
+        for ( int i = 0; i < n; ++i )
+        {
+            total += min_dist2[i];
+        }
+
+        if ( total <= 0.0 )
+        {
+            break;
+        }
+
+        const double r = uniform01( engine ) * total;
+        double sum = 0.0;
+        int selected = n - 1;
+        for ( int i = 0; i < n; ++i )
+        {
+            sum += min_dist2[i];
+            if ( min_dist2[i] > 0.0
+                 && r < sum )
+            {
+                selected = i;
+                break;
+            }
+        }
+
+        centers.push_back( samples[selected].ball_ );
+        update_nearest_dist2( samples, samples[selected].ball_, min_dist2 );
+    }
+
+    const int k = static_cast< int >( centers.size() );
+
+    //
+    // Lloyd iterations. the centers of the fixed samples are never moved.
+    //
+
+    std::vector< int > assignment( samples.size(), -1 );
+
+    for ( int iter = 0; iter < M_max_iteration; ++iter )
+    {
+        int changed = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:changed)
+#endif
+        for ( int i = 0; i < n; ++i )
+        {
+            int nearest = 0;
+            double nearest_d2 = samples[i].ball_.dist2( centers[0] );
+            for ( int c = 1; c < k; ++c )
+            {
+                const double d2 = samples[i].ball_.dist2( centers[c] );
+                if ( d2 < nearest_d2 )
+                {
+                    nearest = c;
+                    nearest_d2 = d2;
+                }
+            }
+
+            if ( assignment[i] != nearest )
+            {
+                assignment[i] = nearest;
+                ++changed;
+            }
+        }
+
+        if ( changed == 0 )
+        {
+            break;
+        }
+
+        std::vector< Vector2D > sum( k, Vector2D( 0.0, 0.0 ) );
+        std::vector< int > count( k, 0 );
+        for ( int i = 0; i < n; ++i )
+        {
+            sum[assignment[i]] += samples[i].ball_;
+            ++count[assignment[i]];
+        }
+
+        for ( int c = static_cast< int >( n_fixed ); c < k; ++c )
+        {
+            if ( count[c] > 0 )
+            {
+                centers[c] = sum[c] / static_cast< double >( count[c] );
+            }
+        }
+    }
+
+    //
+    // select the sample nearest to each center
+    //
+
+    std::vector< std::size_t > result;
+    result.reserve( k );
+
+    for ( std::vector< std::size_t >::const_iterator it = fixed.begin(), end = fixed.end();
+          it != end;
+          ++it )
+    {
+        if ( *it < samples.size()
+             && std::find( result.begin(), result.end(), *it ) == result.end() )
+        {
+            result.push_back( *it );
+        }
+    }
+
+    std::vector< bool > used( is_fixed );
+    std::vector< int > best( k, -1 );
+    std::vector< double > best_d2( k, std::numeric_limits< double >::max() );
+
+    for ( int i = 0; i < n; ++i )
+    {
+        const int c = assignment[i];
+        if ( c < static_cast< int >( n_fixed )
+             || used[i] )
+        {
+            continue;
+        }
+
+        const double d2 = samples[i].ball_.dist2( centers[c] );
+        if ( d2 < best_d2[c] )
+        {
+            best[c] = i;
+            best_d2[c] = d2;
+        }
+    }
+
+    for ( int c = static_cast< int >( n_fixed ); c < k; ++c )
+    {
+        if ( best[c] >= 0 )
+        {
+            used[best[c]] = true;
+            result.push_back( best[c] );
+        }
+    }
+
+    // fill the empty clusters by the farthest samples
+
+    if ( result.size() < static_cast< std::size_t >( k ) )
+    {
+        std::fill( min_dist2.begin(), min_dist2.end(), std::numeric_limits< double >::max() );
+        for ( std::vector< std::size_t >::const_iterator it = result.begin(), end = result.end();
+              it != end;
+              ++it )
+        {
+            update_nearest_dist2( samples, samples[*it].ball_, min_dist2 );
+            min_dist2[*it] = 0.0;
+        }
+
+        while ( result.size() < static_cast< std::size_t >( k ) )
+        {
+            const std::size_t idx = max_index( min_dist2 );
+            if ( min_dist2[idx] <= 0.0 )
+            {
+                break;
+            }
+
+            result.push_back( idx );
+            update_nearest_dist2( samples, samples[idx].ball_, min_dist2 );
+            min_dist2[idx] = 0.0;
+        }
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SampleDataSet::Ptr
+SampleReducer::create_data_set( const Formation & formation,
+                                const std::vector< SampleData > & samples,
+                                const std::vector< std::size_t > & indices )
+{
+    SampleDataSet::Ptr result( new SampleDataSet() );
+
+    for ( std::vector< std::size_t >::const_iterator it = indices.begin(), end = indices.end();
+          it != end;
+          ++it )
+    {
+        result->addData( formation, samples[*it], false );
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+SampleReducer::evaluate( const Formation & formation,
+                         const std::vector< SampleData > & samples,
+                         const std::vector< std::size_t > & indices )
+{
+    Formation::Ptr trained = formation.clone();
+    if ( ! trained )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " *** ERROR *** could not copy the formation." << std::endl;
+        return -1.0;
+    }
+
+    trained->setSamples( create_data_set( formation, samples, indices ) );
+    trained->train();
+
+    const int size = static_cast< int >( samples.size() );
+    std::vector< double > errors( samples.size(), 0.0 );
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for ( int i = 0; i < size; ++i )
+    {
+        std::vector< Vector2D > positions;
+        trained->getPositions( samples[i].ball_, positions );
+
+        const std::size_t n = std::min( positions.size(), samples[i].players_.size() );
+        for ( std::size_t p = 0; p < n; ++p )
+        {
+            errors[i] = std::max( errors[i], positions[p].dist( samples[i].players_[p] ) );
+        }
+    }
+
+    return ( errors.empty()
+             ? 0.0
+             : *std::max_element( errors.begin(), errors.end() ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::vector< std::size_t >
+SampleReducer::reduce( const Formation & formation,
+                       const std::vector< SampleData > & samples,
+                       const std::vector< std::size_t > & fixed ) const
+{
+    const std::size_t max_size = std::min( M_target_size, SampleDataSet::MAX_DATA_SIZE );
+
+    if ( M_error_budget <= 0.0 )
+    {
+        return select( samples, fixed, max_size );
+    }
+
+    //
+    // bisection search of the smallest size within the error budget.
+    // the farthest point order is computed only once, and its prefixes are used.
+    //
+
+    std::vector< std::size_t > order;
+    if ( M_method == FARTHEST_POINT )
+    {
+        order = selectFarthestPoint( samples, fixed, std::min( max_size, samples.size() ) );
+    }
+
+    std::size_t low = std::min( std::max( fixed.size(), static_cast< std::size_t >( 3 ) ),
+                                std::min( max_size, samples.size() ) );
+    std::size_t high = std::min( max_size, samples.size() );
+    std::vector< std::size_t > best;
+
+    while ( low <= high )
+    {
+        const std::size_t k = low + ( high - low ) / 2;
+
+        std::vector< std::size_t > indices;
+        if ( M_method == FARTHEST_POINT )
+        {
+            indices.assign( order.begin(), order.begin() + std::min( k, order.size() ) );
+            std::sort( indices.begin(), indices.end() );
+        }
+        else
+        {
+            indices = select( samples, fixed, k );
+        }
+
+        const double error = evaluate( formation, samples, indices );
+        if ( error < 0.0 )
+        {
+            break;
+        }
+
+        if ( error <= M_error_budget )
+        {
+            best.swap( indices );
+            if ( k == 0 ) break;
+            high = k - 1;
+        }
+        else
+        {
+            low = k + 1;
+        }
+    }
+
+    if ( best.empty() )
+    {
+        // the budget could not be satisfied. use the max size.
+        return select( samples, fixed, max_size );
+    }
+
+    return best;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SampleDataSet::Ptr
+SampleReducer::reduce( const Formation & formation,
+                       const SampleDataSet & samples ) const
+{
+    std::vector< SampleData > data( samples.dataCont().begin(), samples.dataCont().end() );
+
+    std::vector< std::size_t > fixed;
+    for ( SampleDataSet::Constraints::const_iterator c = samples.constraints().begin(), end = samples.constraints().end();
+          c != end;
+          ++c )
+    {
+        fixed.push_back( c->first->index_ );
+        fixed.push_back( c->second->index_ );
+    }
+    std::sort( fixed.begin(), fixed.end() );
+    fixed.erase( std::unique( fixed.begin(), fixed.end() ), fixed.end() );
+
+    const std::vector< std::size_t > indices = reduce( formation, data, fixed );
+
+    SampleDataSet::Ptr result( new SampleDataSet() );
+
+    std::vector< int > new_index( data.size(), -1 );
+    for ( std::vector< std::size_t >::const_iterator it = indices.begin(), end = indices.end();
+          it != end;
+          ++it )
+    {
+        if ( result->addData( formation, data[*it], false ) == SampleDataSet::NO_ERROR )
+        {
+            new_index[*it] = static_cast< int >( result->dataCont().size() ) - 1;
+        }
+    }
+
+    // rebind the constraints to the new indices
+
+    for ( SampleDataSet::Constraints::const_iterator c = samples.constraints().begin(), end = samples.constraints().end();
+          c != end;
+          ++c )
+    {
+        const int origin = new_index[c->first->index_];
+        const int terminal = new_index[c->second->index_];
+        if ( origin < 0 || terminal < 0 )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__
+                      << " *** WARNING *** constraint (" << c->first->index_
+                      << ", " << c->second->index_ << ") is dropped." << std::endl;
+            continue;
+        }
+
+        result->addConstraint( origin, terminal );
+    }
+
+    return result;
+}
+
+}
+}
@@ -0,0 +1,211 @@
+// -*-c++-*-
+
+/*!
+  \file sample_reducer.h
+  \brief formation sample set reduction Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_FORMATION_SAMPLE_REDUCER_H
+#define RCSC_FORMATION_SAMPLE_REDUCER_H
+
+#include <rcsc/formation/sample_data.h>
+
+#include <vector>
+#include <string>
+
+namespace rcsc {
+
+class Formation;
+
+namespace formation {
+
+/*!
+  \class SampleReducer
+  \brief selects the representative subset of the samples by the ball position.
+
+  Two selection methods are available.
+  - FARTHEST_POINT: greedy farthest point sampling. The sample farthest
+    from the already selected ones is added one by one. Any prefix of the
+    selection order is also the farthest point selection, so the error
+    budget search does not need to select again.
+  - K_MEANS: k-means++ seeding and Lloyd iterations. The sample nearest to
+    each cluster centroid is selected, so the player positions are always
+    the real data.
+
+  The random choices use the own engine seeded by seed(), so the result is
+  always same for the same input and seed.
+
+  If the error budget is set, the smallest subset, not larger than the
+  target size, whose formation reproduces all input samples within the
+  budget is searched by bisection. The error is the max distance between
+  the player positions of the input samples and the output of the formation
+  trained only by the subset.
+
+  The loops over the samples are run in parallel if OpenMP is enabled by
+  the compiler option. The result does not depend on it.
+*/
+class SampleReducer {
+public:
+
+    /*!
+      \enum Method
+      \brief selection method.
+     */
+    enum Method {
+        FARTHEST_POINT,
+        K_MEANS
+    };
+
+private:
+
+    Method M_method; //!< selection method
+    std::size_t M_target_size; //!< max size of the result
+    double M_error_budget; //!< max allowed error. not used if not positive.
+    unsigned long M_seed; //!< random seed
+    int M_max_iteration; //!< max number of k-means iterations
+
+public:
+
+    /*!
+      \brief create the reducer with the default settings.
+     */
+    SampleReducer();
+
+    /*!
+      \brief get the method by the name.
+      \param name "fps" or "kmeans".
+      \param method pointer to the result variable.
+      \return true if the name is valid.
+     */
+    static
+    bool parse_method( const std::string & name,
+                       Method * method );
+
+    void setMethod( const Method method )
+      {
+          M_method = method;
+      }
+
+    void setTargetSize( const std::size_t size )
+      {
+          M_target_size = size;
+      }
+
+    void setErrorBudget( const double & error )
+      {
+          M_error_budget = error;
+      }
+
+    void setSeed( const unsigned long seed )
+      {
+          M_seed = seed;
+      }
+
+    void setMaxIteration( const int iteration )
+      {
+          M_max_iteration = iteration;
+      }
+
+    Method method() const
+      {
+          return M_method;
+      }
+
+    std::size_t targetSize() const
+      {
+          return M_target_size;
+      }
+
+    const double & errorBudget() const
+      {
+          return M_error_budget;
+      }
+
+    /*!
+      \brief select the representative samples.
+      \param samples input samples
+      \param fixed indices of the samples that must be selected
+      \param size number of the selected samples
+      \return sorted indices of the selected samples
+     */
+    std::vector< std::size_t > select( const std::vector< SampleData > & samples,
+                                       const std::vector< std::size_t > & fixed,
+                                       const std::size_t size ) const;
+
+    /*!
+      \brief get the max error of the formation trained by the subset.
+      \param formation formation that holds the role info.
+      \param samples all samples
+      \param indices indices of the training samples
+      \return max distance between the samples and the trained formation output.
+      negative value if training failed.
+     */
+    static
+    double evaluate( const Formation & formation,
+                     const std::vector< SampleData > & samples,
+                     const std::vector< std::size_t > & indices );
+
+    /*!
+      \brief reduce the samples by the target size and the error budget.
+      \param formation formation that holds the role info.
+      \param samples input samples
+      \param fixed indices of the samples that must be kept
+      \return sorted indices of the kept samples
+     */
+    std::vector< std::size_t > reduce( const Formation & formation,
+                                       const std::vector< SampleData > & samples,
+                                       const std::vector< std::size_t > & fixed ) const;
+
+    /*!
+      \brief reduce the sample data set. the samples with constraints are always kept.
+      \param formation formation that holds the role info.
+      \param samples input data set
+      \return new data set. constraints are copied.
+     */
+    SampleDataSet::Ptr reduce( const Formation & formation,
+                               const SampleDataSet & samples ) const;
+
+private:
+
+    std::vector< std::size_t > selectFarthestPoint( const std::vector< SampleData > & samples,
+                                                    const std::vector< std::size_t > & fixed,
+                                                    const std::size_t size ) const;
+
+    std::vector< std::size_t > selectKMeans( const std::vector< SampleData > & samples,
+                                             const std::vector< std::size_t > & fixed,
+                                             const std::size_t size ) const;
+
+    static
+    SampleDataSet::Ptr create_data_set( const Formation & formation,
+                                        const std::vector< SampleData > & samples,
+                                        const std::vector< std::size_t > & indices );
+};
+
+}
+}
+
+#endif
@@ -38,12 +38,16 @@
 #include <rcsc/geom/line_2d.h>
 #include <rcsc/geom/matrix_2d.h>
 #include <rcsc/geom/polygon_2d.h>
+#include <rcsc/geom/predicates_2d.h>
 #include <rcsc/geom/ray_2d.h>
 #include <rcsc/geom/rect_2d.h>
 #include <rcsc/geom/sector_2d.h>
 #include <rcsc/geom/segment_2d.h>
+#include <rcsc/geom/segment_intersection.h>
 #include <rcsc/geom/size_2d.h>
+#include <rcsc/geom/spatial_grid.h>
 #include <rcsc/geom/triangle_2d.h>
 #include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/vector_2d_array.h>
 
 #endif
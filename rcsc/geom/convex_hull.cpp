@@ -35,6 +35,7 @@
 #include "convex_hull.h"
 
 #include "triangle_2d.h"
+#include "vector_2d_array.h"
 
 #include <algorithm>
 
@@ -92,6 +93,7 @@ struct AngleSortPredicate {
 
  */
 ConvexHull::ConvexHull()
+    : M_moved_count( 0 )
 {
 
 }
@@ -101,7 +103,8 @@ ConvexHull::ConvexHull()
 
  */
 ConvexHull::ConvexHull( const std::vector< Vector2D > & v )
-    : M_input_points( v )
+    : M_input_points( v ),
+      M_moved_count( 0 )
 {
 
 
@@ -116,6 +119,8 @@ ConvexHull::clear()
 {
     clearResults();
     M_input_points.clear();
+    M_sorted_indices.clear();
+    M_moved_count = 0;
 }
 
 /*-------------------------------------------------------------------*/
@@ -129,6 +134,41 @@ ConvexHull::clearResults()
     M_edges.clear();
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ConvexHull::setPoint( const size_t index,
+                      const Vector2D & p )
+{
+    if ( M_input_points.size() <= index )
+    {
+        return;
+    }
+
+    M_input_points[index] = p;
+    ++M_moved_count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ConvexHull::insertPoint( const Vector2D & p )
+{
+    M_input_points.push_back( p );
+
+    if ( M_vertices.size() < 3 )
+    {
+        computeMonotoneChain();
+        return true;
+    }
+
+    return mergePoint( p );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -137,8 +177,9 @@ void
 ConvexHull::compute()
 {
     //computeDirectMethod();
-    computeWrappingMethod();
+    //computeWrappingMethod();
     //computeGrahamScan();
+    computeMonotoneChain();
 }
 
 /*-------------------------------------------------------------------*/
@@ -251,65 +292,64 @@ ConvexHull::computeWrappingMethod()
     }
 
 #ifdef DEBUG_PRINT
-    std::cerr << "min_point=" min_index << ":" << M_input_points[min_index] << std::endl;
+    std::cerr << "min_point=" << min_index << ":" << M_input_points[min_index] << std::endl;
 #endif
 
-    std::set< size_t > vertices; // temporal set for checking already used vertices.
+    const Vector2DArray points( M_input_points );
+    std::vector< char > used( point_size, 0 ); // flags for checking already used vertices.
 
     M_vertices.push_back( M_input_points[min_index] );
 
     size_t current_index = min_index;
-    Vector2D current_point = M_input_points[min_index];
 
     for ( size_t loop_count = 0; loop_count <= point_size; ++loop_count ) // while ( 1 )
     {
-        //std::cerr << "loop " << loop_count
-        //          << " base=" << current_index << ':' << current_point << std::endl;
+        const double cx = points.x( current_index );
+        const double cy = points.y( current_index );
 
         size_t candidate = 0;
         for ( size_t i = 0; i < point_size; ++i )
         {
             if ( i == current_index ) continue;
-            if ( vertices.find( i ) != vertices.end() ) continue;
+            if ( used[i] ) continue;
 
             candidate = i;
             break;
         }
 
+        // relative vector from the current point to the candidate
+        double px = points.x( candidate ) - cx;
+        double py = points.y( candidate ) - cy;
+
         for ( size_t i = candidate + 1; i < point_size; ++i )
         {
             if ( i == current_index ) continue;
-            if ( vertices.find( i ) != vertices.end() ) continue;
+            if ( used[i] ) continue;
 
-            const Vector2D & p = M_input_points[candidate];
-            const Vector2D & q = M_input_points[i];
+            const double qx = points.x( i ) - cx;
+            const double qy = points.y( i ) - cy;
 
-            double area = Triangle2D::double_signed_area( current_point, p, q );
+            // == Triangle2D::double_signed_area( current_point, p, q )
+            const double area = px * qy - py * qx;
 
-            if ( area < 0.0 )
+            if ( area < 0.0
+                 || ( area < 1.0e-6
+                      && px * px + py * py > qx * qx + qy * qy ) )
             {
                 candidate = i;
-            }
-            else if ( area < 1.0e-6 )
-            {
-                if ( current_point.dist2( p ) > current_point.dist2( q ) )
-                {
-                    candidate = i;
-                }
+                px = qx;
+                py = qy;
             }
         }
 
         current_index = candidate;
-        current_point = M_input_points[current_index];
-        vertices.insert( current_index );
-        M_vertices.push_back( current_point );
+        used[current_index] = 1;
+        M_vertices.push_back( M_input_points[current_index] );
 
         if ( current_index == min_index )
         {
             break;
         }
-
-        //std::cerr << "updated to " << current_index << ":" << M_input_points[current_index] << std::endl;
     }
 
     VertexCont::iterator p = M_vertices.begin();
@@ -403,7 +443,7 @@ ConvexHull::computeGrahamScan()
 
  */
 void
-ConvexHull::computeIncrementalMethod()
+ConvexHull::computeDivideAndConquer()
 {
 
 }
@@ -413,7 +453,7 @@ ConvexHull::computeIncrementalMethod()
 
  */
 void
-ConvexHull::computeDivideAndConquer()
+ConvexHull::computeQuickMethod()
 {
 
 }
@@ -423,19 +463,377 @@ ConvexHull::computeDivideAndConquer()
 
  */
 void
-ConvexHull::computeQuickMethod()
+ConvexHull::computeInnerPointsElimination()
 {
 
 }
 
+namespace {
+
+/*!
+  \brief get a double of signed area value of the triangle (o, a, b).
+  \return positive if o, a, b are placed counterclockwise order.
+ */
+inline
+double
+signed_area2( const Vector2DArray & points,
+              const size_t o,
+              const size_t a,
+              const size_t b )
+{
+    return ( ( points.x( a ) - points.x( o ) ) * ( points.y( b ) - points.y( o ) )
+             - ( points.y( a ) - points.y( o ) ) * ( points.x( b ) - points.x( o ) ) );
+}
+
+/*!
+  \brief generate the convex hull of sorted points by Andrew's monotone chain.
+  \param points point array
+  \param sorted point indices sorted by XY order
+  \param hull result container. vertex indices are stored by counter clockwise order.
+
+  Same as the other methods, the points on the edges are kept as vertices.
+  If all points are on the same line, only both end points are returned.
+ */
+void
+monotone_chain( const Vector2DArray & points,
+                const std::vector< size_t > & sorted,
+                std::vector< size_t > & hull )
+{
+    //
+    // remove duplicated points
+    //
+    std::vector< size_t > unique;
+    unique.reserve( sorted.size() );
+    for ( std::vector< size_t >::const_iterator i = sorted.begin();
+          i != sorted.end();
+          ++i )
+    {
+        if ( ! unique.empty()
+             && points.x( unique.back() ) == points.x( *i )
+             && points.y( unique.back() ) == points.y( *i ) )
+        {
+            continue;
+        }
+        unique.push_back( *i );
+    }
+
+    const size_t size = unique.size();
+
+    if ( size < 3 )
+    {
+        hull = unique;
+        return;
+    }
+
+    hull.resize( size * 2 );
+
+    size_t k = 0;
+
+    // lower hull
+    for ( size_t i = 0; i < size; ++i )
+    {
+        while ( k >= 2
+                && signed_area2( points, hull[k-2], hull[k-1], unique[i] ) < 0.0 )
+        {
+            --k;
+        }
+        hull[k++] = unique[i];
+    }
+
+    // upper hull
+    const size_t lower_size = k + 1;
+    for ( size_t i = size - 1; i > 0; --i )
+    {
+        while ( k >= lower_size
+                && signed_area2( points, hull[k-2], hull[k-1], unique[i-1] ) < 0.0 )
+        {
+            --k;
+        }
+        hull[k++] = unique[i-1];
+    }
+
+    // the last vertex is same as the first one.
+    hull.resize( k - 1 );
+
+    if ( hull.size() > size )
+    {
+        // all points are on the same line.
+        // both chains contain the all points.
+        hull.resize( 2 );
+        hull[0] = unique.front();
+        hull[1] = unique.back();
+    }
+}
+
+/*!
+  \brief XY order predicate for the point indices.
+ */
+struct IndexXYCmp {
+    const std::vector< Vector2D > & points_;
+
+    IndexXYCmp( const std::vector< Vector2D > & points )
+        : points_( points )
+      { }
+
+    bool operator()( const size_t lhs,
+                     const size_t rhs ) const
+      {
+          return Vector2D::XYCmp()( points_[lhs], points_[rhs] );
+      }
+};
+
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
  */
 void
-ConvexHull::computeInnerPointsElimination()
+ConvexHull::computeMonotoneChain()
 {
+    clearResults();
+
+    const size_t point_size = M_input_points.size();
+
+    if ( point_size < 3 )
+    {
+        return;
+    }
+
+    updateSortedIndices();
+
+    const Vector2DArray points( M_input_points );
+    std::vector< size_t > hull;
+
+    monotone_chain( points, M_sorted_indices, hull );
+
+    if ( hull.size() < 3 )
+    {
+        // all points are on the same line
+        return;
+    }
 
+    setResults( M_input_points, hull );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ConvexHull::computeIncrementalMethod()
+{
+    clearResults();
+
+    const size_t point_size = M_input_points.size();
+
+    if ( point_size < 3 )
+    {
+        return;
+    }
+
+    //
+    // find the first point that is not on the line of the preceding points.
+    // the initial hull is generated from all points up to it,
+    // because the hull of the collinear points keeps only both end points
+    // and the other points on the line may be on the edge of the final hull.
+    //
+    const Vector2D & origin = M_input_points[0];
+
+    size_t second = 1;
+    while ( second < point_size
+            && M_input_points[second].equals( origin ) )
+    {
+        ++second;
+    }
+
+    size_t third = second + 1;
+    while ( third < point_size
+            && ( M_input_points[second] - origin ).outerProduct( M_input_points[third] - origin ) == 0.0 )
+    {
+        ++third;
+    }
+
+    if ( third >= point_size )
+    {
+        // all points are on the same line
+        return;
+    }
+
+    std::vector< size_t > sorted( third + 1 );
+    for ( size_t i = 0; i <= third; ++i )
+    {
+        sorted[i] = i;
+    }
+    std::sort( sorted.begin(), sorted.end(), IndexXYCmp( M_input_points ) );
+
+    const Vector2DArray points( M_input_points );
+    std::vector< size_t > hull;
+
+    monotone_chain( points, sorted, hull );
+
+    setResults( M_input_points, hull );
+
+    for ( size_t i = third + 1; i < point_size; ++i )
+    {
+        mergePoint( M_input_points[i] );
+    }
+
+    if ( M_vertices.size() < 3 )
+    {
+        clearResults();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ConvexHull::updateSortedIndices()
+{
+    const size_t point_size = M_input_points.size();
+
+    if ( M_sorted_indices.size() > point_size )
+    {
+        M_sorted_indices.clear();
+    }
+
+    const size_t old_size = M_sorted_indices.size();
+
+    M_sorted_indices.reserve( point_size );
+    for ( size_t i = old_size; i < point_size; ++i )
+    {
+        M_sorted_indices.push_back( i );
+    }
+
+    const size_t changed_count = M_moved_count + ( point_size - old_size );
+    M_moved_count = 0;
+
+    if ( changed_count == 0 )
+    {
+        return;
+    }
+
+    const IndexXYCmp cmp( M_input_points );
+
+    if ( old_size == 0
+         || changed_count * 8 > point_size )
+    {
+        std::sort( M_sorted_indices.begin(), M_sorted_indices.end(), cmp );
+        return;
+    }
+
+    //
+    // only a few points are changed.
+    // insertion sort is nearly linear for the almost sorted sequence.
+    //
+    for ( size_t i = 1; i < point_size; ++i )
+    {
+        const size_t idx = M_sorted_indices[i];
+        size_t j = i;
+        while ( j > 0
+                && cmp( idx, M_sorted_indices[j-1] ) )
+        {
+            M_sorted_indices[j] = M_sorted_indices[j-1];
+            --j;
+        }
+        M_sorted_indices[j] = idx;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ConvexHull::mergePoint( const Vector2D & p )
+{
+    const size_t vertex_size = M_vertices.size();
+
+    if ( vertex_size >= 3 )
+    {
+        //
+        // check if the point is strictly inside of the current hull.
+        // the point on the edge is added as a new vertex.
+        //
+        bool inside = true;
+        for ( size_t i = 0; i < vertex_size; ++i )
+        {
+            const Vector2D & o = M_vertices[i];
+            const Vector2D & a = M_vertices[( i + 1 ) % vertex_size];
+
+            if ( ( a - o ).outerProduct( p - o ) <= 0.0 )
+            {
+                inside = false;
+                break;
+            }
+        }
+
+        if ( inside )
+        {
+            return false;
+        }
+    }
+
+    //
+    // the new hull consists of the current vertices and the new point.
+    //
+    std::vector< Vector2D > candidates;
+    candidates.reserve( vertex_size + 1 );
+    candidates.insert( candidates.end(), M_vertices.begin(), M_vertices.end() );
+    candidates.push_back( p );
+
+    std::vector< size_t > sorted( candidates.size() );
+    for ( size_t i = 0; i < sorted.size(); ++i )
+    {
+        sorted[i] = i;
+    }
+    std::sort( sorted.begin(), sorted.end(), IndexXYCmp( candidates ) );
+
+    const Vector2DArray points( candidates );
+    std::vector< size_t > hull;
+
+    monotone_chain( points, sorted, hull );
+
+    clearResults();
+    setResults( candidates, hull );
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ConvexHull::setResults( const std::vector< Vector2D > & points,
+                        const std::vector< size_t > & hull )
+{
+    M_vertices.reserve( hull.size() );
+    for ( std::vector< size_t >::const_iterator i = hull.begin();
+          i != hull.end();
+          ++i )
+    {
+        M_vertices.push_back( points[*i] );
+    }
+
+    if ( M_vertices.size() < 3 )
+    {
+        return;
+    }
+
+    M_edges.reserve( M_vertices.size() );
+
+    VertexCont::iterator p = M_vertices.begin();
+    VertexCont::iterator n = p;
+    ++n;
+    for ( ; n != M_vertices.end(); ++n )
+    {
+        M_edges.push_back( Segment2D( *p, *n ) );
+        p = n;
+    }
+    M_edges.push_back( Segment2D( M_vertices.back(), M_vertices.front() ) );
 }
 
 /*-------------------------------------------------------------------*/
@@ -483,6 +881,9 @@ ConvexHull::sortPointsByAngleFrom( const size_t index )
         return;
     }
 
+    // the index order is broken.
+    M_sorted_indices.clear();
+
     std::swap( M_input_points[0], M_input_points[index] );
 
     std::sort( M_input_points.begin() + 1,
@@ -51,6 +51,9 @@ private:
     std::vector< Vector2D > M_vertices; //!< vertices of convex hull, sorted by counter clockwise order
     EdgeCont M_edges; //!< edges of convex hull (should be ordered by counter clockwise?)
 
+    std::vector< size_t > M_sorted_indices; //!< input point indices sorted by XY order. reused by the next computation.
+    size_t M_moved_count; //!< number of input points moved after the last sort
+
 
     // not used
     ConvexHull( const ConvexHull & );
@@ -97,6 +100,27 @@ public:
           M_input_points.insert( M_input_points.end(), v.begin(), v.end() );
       }
 
+    /*!
+      \brief move the existing input point.
+      \param index index of the input point
+      \param p new position
+
+      The sorted point order of the last monotone chain computation is reused,
+      so recomputing after a few points moved is almost linear time.
+    */
+    void setPoint( const size_t index,
+                   const Vector2D & p );
+
+    /*!
+      \brief add a new point and update the current result incrementally.
+      \param p new point
+      \return false if the point is strictly inside of the current hull.
+
+      If the point is inside of the current hull, no computation is done.
+      Otherwise, the new hull is computed from the current vertices and the new point.
+    */
+    bool insertPoint( const Vector2D & p );
+
     /*!
       \brief generate convex hull.
      */
@@ -167,12 +191,37 @@ public:
      */
     void computeInnerPointsElimination();
 
+    /*!
+      \brief Andrew's monotone chain method version
+     */
+    void computeMonotoneChain();
+
 private:
 
     size_t getMinPointIndex() const;
 
     void sortPointsByAngleFrom( const size_t index );
 
+    /*!
+      \brief update M_sorted_indices for the current input points.
+    */
+    void updateSortedIndices();
+
+    /*!
+      \brief update the current vertices by adding the new point.
+      \param p new point
+      \return true if the convex hull is changed.
+    */
+    bool mergePoint( const Vector2D & p );
+
+    /*!
+      \brief set result variables from the point array.
+      \param points point array
+      \param hull indices of the hull vertices ordered by counter clockwise
+    */
+    void setResults( const std::vector< Vector2D > & points,
+                     const std::vector< size_t > & hull );
+
 public:
 
     Polygon2D toPolygon() const;
@@ -35,6 +35,7 @@
 
 #include "delaunay_triangulation.h"
 
+#include <rcsc/geom/predicates_2d.h>
 #include <rcsc/geom/triangle_2d.h>
 
 namespace rcsc {
@@ -166,6 +167,7 @@ DelaunayTriangulation::clear()
     M_triangles.clear();
     M_edges.clear();
     M_vertices.clear();
+    M_vertex_grid.clear();
 
     //std::cout << "clear() end" << std::endl;
 }
@@ -187,6 +189,7 @@ DelaunayTriangulation::addVertices( const std::vector< Vector2D > & v )
           ++it, ++id )
     {
         M_vertices.push_back( Vertex( id, it->x, it->y ) );
+        M_vertex_grid.insert( *it, id );
     }
 }
 
@@ -350,23 +353,13 @@ const
 DelaunayTriangulation::Vertex *
 DelaunayTriangulation::findNearestVertex( const Vector2D & pos ) const
 {
-    const Vertex * candidate = static_cast< Vertex * >( 0 );
-
-    double min_dist2 = 10000000.0;
-    const VertexCont::const_iterator end = M_vertices.end();
-    for ( VertexCont::const_iterator it = M_vertices.begin();
-          it != end;
-          ++it )
+    SpatialGrid< int >::Handle h = 0;
+    if ( ! M_vertex_grid.nearest( pos, &h ) )
     {
-        double d2 = it->pos().dist2( pos );
-        if ( d2 < min_dist2 )
-        {
-            candidate = &(*it);
-            min_dist2 = d2;
-        }
+        return static_cast< Vertex * >( 0 );
     }
 
-    return candidate;
+    return &M_vertices[M_vertex_grid.value( h )];
 }
 
 /*-------------------------------------------------------------------*/
@@ -377,6 +370,30 @@ void
 DelaunayTriangulation::compute()
 {
     //std::cout << "compute() start " << std::endl;
+
+    //
+    // adjust the cell size of the vertex index to the vertex distribution
+    //
+    if ( ! M_vertices.empty() )
+    {
+        Vector2D min_pos = M_vertices.front().pos();
+        Vector2D max_pos = min_pos;
+        const VertexCont::const_iterator end = M_vertices.end();
+        for ( VertexCont::const_iterator it = M_vertices.begin() + 1;
+              it != end;
+              ++it )
+        {
+            min_pos.x = std::min( min_pos.x, it->pos().x );
+            min_pos.y = std::min( min_pos.y, it->pos().y );
+            max_pos.x = std::max( max_pos.x, it->pos().x );
+            max_pos.y = std::max( max_pos.y, it->pos().y );
+        }
+
+        M_vertex_grid.setCellSize( SpatialGrid< int >::suggest_cell_size( max_pos.x - min_pos.x,
+                                                                          max_pos.y - min_pos.y,
+                                                                          M_vertices.size() ) );
+    }
+
     if ( M_vertices.size() < 3 )
     {
         //std::cout << "compute() too few vertices" << std::endl;
@@ -520,7 +537,7 @@ DelaunayTriangulation::updateContainedVertex( const Vertex * new_vertex,
         new_tri[i] = createTriangle( old_edges[i],
                                      new_edges[ edge_pairs[i].first ],
                                      new_edges[ edge_pairs[i].second ] );
-        if ( ! new_tri[i]->circumcenter().isValid() )
+        if ( new_tri[i]->isDegenerated() )
         {
             std::cerr << __FILE__ << ':' << __LINE__
                       << " updateContainedVertex() detect illegal vertex\n"
@@ -571,10 +588,10 @@ DelaunayTriangulation::updateOnlineVertex( const Vertex * new_vertex,
     EdgePtr online_edge = static_cast< EdgePtr >( 0 );
     for ( std::size_t i = 0; i < 3; ++i )
     {
-        Vector2D rel0( tri->edge( i )->vertex( 0 )->pos() - new_vertex->pos() );
-        Vector2D rel1( tri->edge( i )->vertex( 1 )->pos() - new_vertex->pos() );
         // check area value of sub triangle
-        if ( std::fabs( rel0.outerProduct( rel1 ) ) <= EPSILON )
+        if ( Predicates2D::orient_2d( tri->edge( i )->vertex( 0 )->pos(),
+                                      tri->edge( i )->vertex( 1 )->pos(),
+                                      new_vertex->pos() ) == 0.0 )
         {
             online_edge = tri->edge( i );
             ++online_count;
@@ -659,7 +676,7 @@ DelaunayTriangulation::updateOnlineVertex( const Vertex * new_vertex,
             new_tri_in_tri[i] = createTriangle( old_edge_in_tri[i],
                                                 new_edge[i],
                                                 new_edge_in_tri );
-            if ( ! new_tri_in_tri[i]->circumcenter().isValid() )
+            if ( new_tri_in_tri[i]->isDegenerated() )
             {
                 std::cerr << __FILE__ << ':' << __LINE__
                           << " updateOnlineVertex() detect illegal vertex normal."
@@ -733,7 +750,7 @@ DelaunayTriangulation::updateOnlineVertex( const Vertex * new_vertex,
             new_tri_in_adjacent[i] = createTriangle( old_edge_in_adjacent[i],
                                                      new_edge[i],
                                                      new_edge_in_adjacent );
-            if ( ! new_tri_in_adjacent[i]->circumcenter().isValid() )
+            if ( new_tri_in_adjacent[i]->isDegenerated() )
             {
                 std::cerr << __FILE__ << ':' << __LINE__
                           << " updateOnlineVertex() detect illegal vertex adjacent"
@@ -896,7 +913,7 @@ DelaunayTriangulation::legalizeEdge( TrianglePtr new_tri,
         flipped_tri[i] = createTriangle( new_edge,
                                          edge_in_new_tri[i],
                                          edge_in_adjacent[i] );
-        if ( ! flipped_tri[i]->circumcenter().isValid() )
+        if ( flipped_tri[i]->isDegenerated() )
         {
             std::cerr << __FILE__ << ':' << __LINE__
                       << " legalizeEdge() detect illegal vertex \n"
@@ -943,87 +960,47 @@ DelaunayTriangulation::findTriangleContains( const Vector2D & pos,
     {
         const TrianglePtr tri = it->second;
 
-        if ( std::fabs( tri->circumcenter().x - pos.x )
-             > tri->circumradius()
-             || std::fabs( tri->circumcenter().y - pos.y )
-             > tri->circumradius() )
+        const Vector2D & p0 = tri->vertex( 0 )->pos();
+        const Vector2D & p1 = tri->vertex( 1 )->pos();
+        const Vector2D & p2 = tri->vertex( 2 )->pos();
+
+        if ( pos.x < std::min( p0.x, std::min( p1.x, p2.x ) )
+             || std::max( p0.x, std::max( p1.x, p2.x ) ) < pos.x
+             || pos.y < std::min( p0.y, std::min( p1.y, p2.y ) )
+             || std::max( p0.y, std::max( p1.y, p2.y ) ) < pos.y )
         {
-            // out of circumcircle
+            // out of bounding box
             continue;
         }
 
-        Vector2D rel0( tri->vertex( 0 )->pos() - pos );
-        Vector2D rel1( tri->vertex( 1 )->pos() - pos );
-        Vector2D rel2( tri->vertex( 2 )->pos() - pos );
-
-        double outer0 = rel0.outerProduct( rel1 );
-        double outer1 = rel1.outerProduct( rel2 );
-        double outer2 = rel2.outerProduct( rel0 );
-
-        //std::cout << "findTriangleContains() found online\n"
-        //          << " tri0 = " << tri->vertex( 0 )->pos()
-        //          << " tri0 = " << tri->vertex( 1 )->pos()
-        //          << " tri0 = " << tri->vertex( 2 )->pos()
-        //          << "\n  outer0 = " << outer0
-        //          << "  outer1 = " << outer1
-        //          << "  outer2 = " << outer2
-        //          << std::endl;
-
-        if ( std::fabs( outer0 ) <= EPSILON )
-        {
-            if ( rel0.x * rel1.x > 0.0
-                 || rel0.y * rel1.y > 0.0 )
-            {
-                // not online
-                continue;
-            }
-            //std::cout << "findTriangleContains() found online on 0-1 " << std::endl;
-            *sol = tri;
-            return ONLINE;
-        }
+        // exact signs of the sub triangle areas
+        const double o0 = Predicates2D::orient_2d( p0, p1, pos );
+        const double o1 = Predicates2D::orient_2d( p1, p2, pos );
+        const double o2 = Predicates2D::orient_2d( p2, p0, pos );
 
-        if ( std::fabs( outer1 ) <= EPSILON )
+        if ( ! ( o0 >= 0.0 && o1 >= 0.0 && o2 >= 0.0 )
+             && ! ( o0 <= 0.0 && o1 <= 0.0 && o2 <= 0.0 ) )
         {
-            if ( rel1.x * rel2.x > 0.0
-                 || rel1.y * rel2.y > 0.0 )
-            {
-                // not online
-                continue;
-            }
-            //std::cout << "findTriangleContains() found online on 1-2 " << std::endl;
-            *sol = tri;
-            return ONLINE;
+            continue;
         }
 
-        if ( std::fabs( outer2 ) <= EPSILON )
+        if ( o0 == 0.0 || o1 == 0.0 || o2 == 0.0 )
         {
-            if ( rel2.x * rel0.x > 0.0
-                 || rel2.y * rel0.y > 0.0 )
-            {
-                // not online
-                continue;
-            }
-            //std::cout << "findTriangleContains() found online on 2-0 " << std::endl;
+            //std::cout << "findTriangleContains() found online" << std::endl;
             *sol = tri;
             return ONLINE;
         }
 
-        if ( ( outer0 > 0.0 && outer1 > 0.0 && outer2 > 0.0 )
-             || ( outer0 < 0.0 && outer1 < 0.0 && outer2 < 0.0 ) )
-        {
 #ifdef DEBUG
-            std::cout << __FILE__ << ':' << __LINE__
-                      << " findTriangleContains() found contained "
-                      << " pos" << pos
-                      << " triangle"
-                      << tri->vertex( 0 )->pos()
-                      << tri->vertex( 1 )->pos()
-                      << tri->vertex( 2 )->pos()
-                      << std::endl;
+        std::cout << __FILE__ << ':' << __LINE__
+                  << " findTriangleContains() found contained "
+                  << " pos" << pos
+                  << " triangle"
+                  << p0 << p1 << p2
+                  << std::endl;
 #endif
-            *sol = tri;
-            return CONTAINED;
-        }
+        *sol = tri;
+        return CONTAINED;
     }
 
     //std::cout << "findTriangleContains() end not found " << std::endl;
@@ -32,7 +32,9 @@
 #ifndef RCSC_GEOM_DELAUNAY_TRIANGULATION_H
 #define RCSC_GEOM_DELAUNAY_TRIANGULATION_H
 
+#include <rcsc/geom/predicates_2d.h>
 #include <rcsc/geom/rect_2d.h>
+#include <rcsc/geom/spatial_grid.h>
 #include <rcsc/geom/vector_2d.h>
 
 #include <boost/array.hpp>
@@ -403,6 +405,17 @@ public:
               return M_circumradius;
           }
 
+        /*!
+          \brief check if this triangle has no area.
+          \return true if all vertices are placed on a line.
+         */
+        bool isDegenerated() const
+          {
+              return Predicates2D::orient_2d( M_vertices[0]->pos(),
+                                              M_vertices[1]->pos(),
+                                              M_vertices[2]->pos() ) == 0.0;
+          }
+
         /*!
           \brief check if *circumcircle* contains the specified point
           \param pos target point
@@ -410,7 +423,10 @@ public:
          */
         bool contains( const Vector2D & pos ) const
           {
-              return pos.dist2( M_circumcenter ) < M_circumradius * M_circumradius;
+              return Predicates2D::in_circumcircle( M_vertices[0]->pos(),
+                                                    M_vertices[1]->pos(),
+                                                    M_vertices[2]->pos(),
+                                                    pos );
           }
 
         /*!
@@ -531,6 +547,9 @@ private:
     //! instance of vertices. these are refered by edge and triangle.
     VertexCont M_vertices;
 
+    //! index of vertices used by the nearest vertex search. payload is the vertex id.
+    SpatialGrid< int > M_vertex_grid;
+
     //! edge instance holder. key: id
     EdgeCont M_edges;
 
@@ -623,6 +642,7 @@ public:
       {
           int id = M_vertices.size();
           M_vertices.push_back( Vertex( id, x, y ) );
+          M_vertex_grid.insert( M_vertices.back().pos(), id );
           return id;
       }
 
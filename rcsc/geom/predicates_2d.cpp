@@ -0,0 +1,508 @@
+// -*-c++-*-
+
+/*!
+  \file predicates_2d.cpp
+  \brief robust geometric predicates Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "predicates_2d.h"
+
+#include <cmath>
+#include <cstddef>
+
+namespace rcsc {
+
+namespace {
+
+//
+// An expansion is an array of doubles sorted by increasing magnitude.
+// Its value is the exact sum of all components, and no two components
+// overlap. See Shewchuk's paper for details.
+//
+
+//! half of the machine epsilon (2^-53)
+const double EPS = 1.1102230246251565e-16;
+//! 2^27 + 1, used to split a double into two 26 bit halves
+const double SPLITTER = 134217729.0;
+
+//! error bound of the floating point orient_2d
+const double ORIENT_ERROR_BOUND = ( 3.0 + 16.0 * EPS ) * EPS;
+//! error bound of the floating point in_circle
+const double INCIRCLE_ERROR_BOUND = ( 10.0 + 96.0 * EPS ) * EPS;
+
+//! max length of expansions that appear in the exact in_circle
+const std::size_t MAX_EXPANSION = 512;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief x + y == a + b exactly. |a| >= |b| is required.
+*/
+inline
+void
+fast_two_sum( const double a,
+              const double b,
+              double & x,
+              double & y )
+{
+    x = a + b;
+    const double bv = x - a;
+    y = b - bv;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief x + y == a + b exactly.
+*/
+inline
+void
+two_sum( const double a,
+         const double b,
+         double & x,
+         double & y )
+{
+    x = a + b;
+    const double bv = x - a;
+    const double av = x - bv;
+    const double br = b - bv;
+    const double ar = a - av;
+    y = ar + br;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief x + y == a - b exactly.
+*/
+inline
+void
+two_diff( const double a,
+          const double b,
+          double & x,
+          double & y )
+{
+    x = a - b;
+    const double bv = a - x;
+    const double av = x + bv;
+    const double br = bv - b;
+    const double ar = a - av;
+    y = ar + br;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief hi + lo == a, each half has at most 26 significant bits.
+*/
+inline
+void
+split( const double a,
+       double & hi,
+       double & lo )
+{
+    const double c = SPLITTER * a;
+    const double abig = c - a;
+    hi = c - abig;
+    lo = a - hi;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief x + y == a * b exactly. b is already split.
+*/
+inline
+void
+two_product_presplit( const double a,
+                      const double b,
+                      const double bhi,
+                      const double blo,
+                      double & x,
+                      double & y )
+{
+    x = a * b;
+    double ahi, alo;
+    split( a, ahi, alo );
+    const double err1 = x - ( ahi * bhi );
+    const double err2 = err1 - ( alo * bhi );
+    const double err3 = err2 - ( ahi * blo );
+    y = ( alo * blo ) - err3;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief make the expansion of a - b.
+  \return length of the expansion
+*/
+inline
+std::size_t
+diff_expansion( const double a,
+                const double b,
+                double * h )
+{
+    double x, y;
+    two_diff( a, b, x, y );
+    if ( y == 0.0 )
+    {
+        h[0] = x;
+        return 1;
+    }
+    h[0] = y;
+    h[1] = x;
+    return 2;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief h = e * b. zero components are eliminated.
+  \return length of h
+*/
+std::size_t
+scale_expansion( const std::size_t elen,
+                 const double * e,
+                 const double b,
+                 double * h )
+{
+    double bhi, blo;
+    split( b, bhi, blo );
+
+    double q, hh;
+    two_product_presplit( e[0], b, bhi, blo, q, hh );
+
+    std::size_t hlen = 0;
+    if ( hh != 0.0 ) h[hlen++] = hh;
+
+    for ( std::size_t i = 1; i < elen; ++i )
+    {
+        double p1, p0, sum;
+        two_product_presplit( e[i], b, bhi, blo, p1, p0 );
+        two_sum( q, p0, sum, hh );
+        if ( hh != 0.0 ) h[hlen++] = hh;
+        fast_two_sum( p1, sum, q, hh );
+        if ( hh != 0.0 ) h[hlen++] = hh;
+    }
+
+    if ( q != 0.0 || hlen == 0 )
+    {
+        h[hlen++] = q;
+    }
+    return hlen;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief h = e + f. zero components are eliminated.
+  \return length of h
+*/
+std::size_t
+sum_expansion( const std::size_t elen,
+               const double * e,
+               const std::size_t flen,
+               const double * f,
+               double * h )
+{
+    std::size_t ei = 0, fi = 0;
+    double enow = e[0];
+    double fnow = f[0];
+    double q, qnew, hh;
+
+    if ( ( fnow > enow ) == ( fnow > -enow ) )
+    {
+        q = enow;
+        enow = ( ++ei < elen ? e[ei] : 0.0 );
+    }
+    else
+    {
+        q = fnow;
+        fnow = ( ++fi < flen ? f[fi] : 0.0 );
+    }
+
+    std::size_t hlen = 0;
+    if ( ei < elen && fi < flen )
+    {
+        if ( ( fnow > enow ) == ( fnow > -enow ) )
+        {
+            fast_two_sum( enow, q, qnew, hh );
+            enow = ( ++ei < elen ? e[ei] : 0.0 );
+        }
+        else
+        {
+            fast_two_sum( fnow, q, qnew, hh );
+            fnow = ( ++fi < flen ? f[fi] : 0.0 );
+        }
+        q = qnew;
+        if ( hh != 0.0 ) h[hlen++] = hh;
+
+        while ( ei < elen && fi < flen )
+        {
+            if ( ( fnow > enow ) == ( fnow > -enow ) )
+            {
+                two_sum( q, enow, qnew, hh );
+                enow = ( ++ei < elen ? e[ei] : 0.0 );
+            }
+            else
+            {
+                two_sum( q, fnow, qnew, hh );
+                fnow = ( ++fi < flen ? f[fi] : 0.0 );
+            }
+            q = qnew;
+            if ( hh != 0.0 ) h[hlen++] = hh;
+        }
+    }
+
+    while ( ei < elen )
+    {
+        two_sum( q, enow, qnew, hh );
+        enow = ( ++ei < elen ? e[ei] : 0.0 );
+        q = qnew;
+        if ( hh != 0.0 ) h[hlen++] = hh;
+    }
+
+    while ( fi < flen )
+    {
+        two_sum( q, fnow, qnew, hh );
+        fnow = ( ++fi < flen ? f[fi] : 0.0 );
+        q = qnew;
+        if ( hh != 0.0 ) h[hlen++] = hh;
+    }
+
+    if ( q != 0.0 || hlen == 0 )
+    {
+        h[hlen++] = q;
+    }
+    return hlen;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief h = e * f. h must have the space of 2 * elen * flen.
+  \return length of h
+*/
+std::size_t
+mul_expansion( const std::size_t elen,
+               const double * e,
+               const std::size_t flen,
+               const double * f,
+               double * h )
+{
+    double part[MAX_EXPANSION];
+    double sum[MAX_EXPANSION];
+
+    std::size_t hlen = scale_expansion( elen, e, f[0], h );
+    for ( std::size_t i = 1; i < flen; ++i )
+    {
+        const std::size_t plen = scale_expansion( elen, e, f[i], part );
+        const std::size_t slen = sum_expansion( hlen, h, plen, part, sum );
+        for ( std::size_t j = 0; j < slen; ++j ) h[j] = sum[j];
+        hlen = slen;
+    }
+    return hlen;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief h = a * b - c * d. all arguments are 2 components expansions.
+  h must have the space of 16.
+  \return length of h
+*/
+std::size_t
+cross_expansion( const std::size_t alen, const double * a,
+                 const std::size_t blen, const double * b,
+                 const std::size_t clen, const double * c,
+                 const std::size_t dlen, const double * d,
+                 double * h )
+{
+    double ab[8];
+    double cd[8];
+    const std::size_t ablen = mul_expansion( alen, a, blen, b, ab );
+    const std::size_t cdlen = mul_expansion( clen, c, dlen, d, cd );
+    for ( std::size_t i = 0; i < cdlen; ++i ) cd[i] = -cd[i];
+    return sum_expansion( ablen, ab, cdlen, cd, h );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief exact version of orient_2d.
+*/
+double
+orient_2d_exact( const Vector2D & a,
+                 const Vector2D & b,
+                 const Vector2D & c )
+{
+    double acx[2], acy[2], bcx[2], bcy[2];
+    const std::size_t acxlen = diff_expansion( a.x, c.x, acx );
+    const std::size_t acylen = diff_expansion( a.y, c.y, acy );
+    const std::size_t bcxlen = diff_expansion( b.x, c.x, bcx );
+    const std::size_t bcylen = diff_expansion( b.y, c.y, bcy );
+
+    double det[16];
+    const std::size_t len = cross_expansion( acxlen, acx, bcylen, bcy,
+                                             acylen, acy, bcxlen, bcx,
+                                             det );
+    return det[len - 1];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief exact version of in_circle.
+*/
+double
+in_circle_exact( const Vector2D & a,
+                 const Vector2D & b,
+                 const Vector2D & c,
+                 const Vector2D & d )
+{
+    double adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+    const std::size_t adxlen = diff_expansion( a.x, d.x, adx );
+    const std::size_t adylen = diff_expansion( a.y, d.y, ady );
+    const std::size_t bdxlen = diff_expansion( b.x, d.x, bdx );
+    const std::size_t bdylen = diff_expansion( b.y, d.y, bdy );
+    const std::size_t cdxlen = diff_expansion( c.x, d.x, cdx );
+    const std::size_t cdylen = diff_expansion( c.y, d.y, cdy );
+
+    // 2x2 minors
+    double bc[16], ca[16], ab[16];
+    const std::size_t bclen = cross_expansion( bdxlen, bdx, cdylen, cdy,
+                                               cdxlen, cdx, bdylen, bdy, bc );
+    const std::size_t calen = cross_expansion( cdxlen, cdx, adylen, ady,
+                                               adxlen, adx, cdylen, cdy, ca );
+    const std::size_t ablen = cross_expansion( adxlen, adx, bdylen, bdy,
+                                               bdxlen, bdx, adylen, ady, ab );
+
+    // squared distances. x^2 + y^2 == x^2 - (-y)^2
+    double nady[2], nbdy[2], ncdy[2];
+    for ( std::size_t i = 0; i < adylen; ++i ) nady[i] = -ady[i];
+    for ( std::size_t i = 0; i < bdylen; ++i ) nbdy[i] = -bdy[i];
+    for ( std::size_t i = 0; i < cdylen; ++i ) ncdy[i] = -cdy[i];
+
+    double alift[16], blift[16], clift[16];
+    const std::size_t aliftlen = cross_expansion( adxlen, adx, adxlen, adx,
+                                                  adylen, ady, adylen, nady, alift );
+    const std::size_t bliftlen = cross_expansion( bdxlen, bdx, bdxlen, bdx,
+                                                  bdylen, bdy, bdylen, nbdy, blift );
+    const std::size_t cliftlen = cross_expansion( cdxlen, cdx, cdxlen, cdx,
+                                                  cdylen, cdy, cdylen, ncdy, clift );
+
+    double adet[MAX_EXPANSION], bdet[MAX_EXPANSION], cdet[MAX_EXPANSION];
+    const std::size_t alen = mul_expansion( aliftlen, alift, bclen, bc, adet );
+    const std::size_t blen = mul_expansion( bliftlen, blift, calen, ca, bdet );
+    const std::size_t clen = mul_expansion( cliftlen, clift, ablen, ab, cdet );
+
+    double abdet[MAX_EXPANSION * 2];
+    double det[MAX_EXPANSION * 3];
+    const std::size_t ablen2 = sum_expansion( alen, adet, blen, bdet, abdet );
+    const std::size_t len = sum_expansion( ablen2, abdet, clen, cdet, det );
+
+    return det[len - 1];
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+double
+Predicates2D::orient_2d( const Vector2D & a,
+                         const Vector2D & b,
+                         const Vector2D & c )
+{
+    const double detleft = ( a.x - c.x ) * ( b.y - c.y );
+    const double detright = ( a.y - c.y ) * ( b.x - c.x );
+    const double det = detleft - detright;
+
+    double detsum = 0.0;
+    if ( detleft > 0.0 )
+    {
+        if ( detright <= 0.0 ) return det;
+        detsum = detleft + detright;
+    }
+    else if ( detleft < 0.0 )
+    {
+        if ( detright >= 0.0 ) return det;
+        detsum = -detleft - detright;
+    }
+    else
+    {
+        return det;
+    }
+
+    const double errbound = ORIENT_ERROR_BOUND * detsum;
+    if ( det >= errbound || -det >= errbound )
+    {
+        return det;
+    }
+
+    return orient_2d_exact( a, b, c );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+double
+Predicates2D::in_circle( const Vector2D & a,
+                         const Vector2D & b,
+                         const Vector2D & c,
+                         const Vector2D & d )
+{
+    const double adx = a.x - d.x;
+    const double bdx = b.x - d.x;
+    const double cdx = c.x - d.x;
+    const double ady = a.y - d.y;
+    const double bdy = b.y - d.y;
+    const double cdy = c.y - d.y;
+
+    const double bdxcdy = bdx * cdy;
+    const double cdxbdy = cdx * bdy;
+    const double alift = adx * adx + ady * ady;
+
+    const double cdxady = cdx * ady;
+    const double adxcdy = adx * cdy;
+    const double blift = bdx * bdx + bdy * bdy;
+
+    const double adxbdy = adx * bdy;
+    const double bdxady = bdx * ady;
+    const double clift = cdx * cdx + cdy * cdy;
+
+    const double det = ( alift * ( bdxcdy - cdxbdy )
+                         + blift * ( cdxady - adxcdy )
+                         + clift * ( adxbdy - bdxady ) );
+
+    const double permanent = ( ( std::fabs( bdxcdy ) + std::fabs( cdxbdy ) ) * alift
+                               + ( std::fabs( cdxady ) + std::fabs( adxcdy ) ) * blift
+                               + ( std::fabs( adxbdy ) + std::fabs( bdxady ) ) * clift );
+    const double errbound = INCIRCLE_ERROR_BOUND * permanent;
+    if ( det > errbound || -det > errbound )
+    {
+        return det;
+    }
+
+    return in_circle_exact( a, b, c, d );
+}
+
+}
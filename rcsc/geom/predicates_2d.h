@@ -0,0 +1,120 @@
+// -*-c++-*-
+
+/*!
+  \file predicates_2d.h
+  \brief robust geometric predicates Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_GEOM_PREDICATES_2D_H
+#define RCSC_GEOM_PREDICATES_2D_H
+
+#include <rcsc/geom/vector_2d.h>
+
+namespace rcsc {
+
+/*!
+  \class Predicates2D
+  \brief adaptive precision orientation and in-circle tests.
+
+  These predicates follow J. R. Shewchuk, "Adaptive Precision
+  Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+  At first, the determinant is evaluated by the normal floating point
+  arithmetic with the forward error bound. Only when the sign of the result
+  is not certain, the determinant is evaluated again by the exact
+  expansion arithmetic. So the sign of the returned value is always correct,
+  and the cost is almost same as the naive formula for the usual input.
+
+  The exact arithmetic assumes IEEE 754 double precision with
+  round-to-even, no extended precision registers, and no overflow or
+  underflow in the intermediate values.
+*/
+class Predicates2D {
+private:
+    // not used
+    Predicates2D();
+
+public:
+
+    /*!
+      \brief check the orientation of three points.
+      \param a 1st point
+      \param b 2nd point
+      \param c 3rd point
+      \return positive value if a, b, c are placed counterclockwise order,
+      negative value if they are placed clockwise order,
+      zero if they are placed on a line.
+
+      The magnitude approximates the double of the signed area, the same
+      value as Triangle2D::double_signed_area().
+    */
+    static
+    double orient_2d( const Vector2D & a,
+                      const Vector2D & b,
+                      const Vector2D & c );
+
+    /*!
+      \brief check if the point is contained by the circle through other three points.
+      \param a 1st point on the circle
+      \param b 2nd point on the circle
+      \param c 3rd point on the circle
+      \param d checked point
+      \return positive value if d is inside the circle, negative value if d is
+      outside, zero if four points are cocircular. a, b, c must be placed
+      counterclockwise order. if they are clockwise, the sign is reversed.
+    */
+    static
+    double in_circle( const Vector2D & a,
+                      const Vector2D & b,
+                      const Vector2D & c,
+                      const Vector2D & d );
+
+    /*!
+      \brief check if the point is inside the circumcircle of the triangle.
+      \param a 1st vertex of triangle
+      \param b 2nd vertex of triangle
+      \param c 3rd vertex of triangle
+      \param d checked point
+      \return true if d is strictly inside the circumcircle. the order of
+      vertices does not matter. degenerated triangle always returns false.
+    */
+    static
+    bool in_circumcircle( const Vector2D & a,
+                          const Vector2D & b,
+                          const Vector2D & c,
+                          const Vector2D & d )
+      {
+          const double o = orient_2d( a, b, c );
+          if ( o == 0.0 ) return false;
+          const double i = in_circle( a, b, c, d );
+          return ( o > 0.0 ? i > 0.0 : i < 0.0 );
+      }
+
+};
+
+}
+
+#endif
@@ -0,0 +1,598 @@
+// -*-c++-*-
+
+/*!
+  \file segment_intersection.cpp
+  \brief batched segment intersection engine Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "segment_intersection.h"
+
+#include "segment_2d.h"
+#include "triangle_2d.h"
+
+#include <algorithm>
+#include <set>
+#include <cmath>
+
+namespace rcsc {
+
+const double SegmentIntersection::EPSILON = 1.0e-5;
+const double SegmentIntersection::CALC_ERROR = 1.0e-9;
+
+namespace {
+
+// event types. events at the same x are processed in this order.
+const int REMOVE_EVENT = 0;
+const int INSERT_EVENT = 1;
+const int VERTICAL_EVENT = 2;
+
+/*!
+  \brief get a double of signed area value of the triangle (a, b, c).
+  same formula as Triangle2D::double_signed_area()
+*/
+inline
+double
+orientation( const double & ax,
+             const double & ay,
+             const double & bx,
+             const double & by,
+             const double & cx,
+             const double & cy )
+{
+    return ( ax - cx ) * ( by - cy ) + ( bx - cx ) * ( cy - ay );
+}
+
+/*!
+  \struct SweepStatus
+  \brief the current state of the sweep line, shared by the comparator.
+*/
+struct SweepStatus {
+    const double * lx_;
+    const double * ly_;
+    const double * rx_;
+    const double * ry_;
+    double x_; //!< current sweep line position
+    std::size_t probe_; //!< index used for the range search
+    double probe_y_; //!< y value of the probe
+};
+
+/*!
+  \struct ActiveCmp
+  \brief order of active segments along the sweep line.
+
+  Segments are compared by the orientation test of the end point of the
+  later inserted segment, instead of the interpolated y values.
+  The interpolation error may change the order of segments that touch
+  at the sweep line, and then the crossing may not be detected.
+*/
+struct ActiveCmp {
+    const SweepStatus * status_;
+
+    explicit
+    ActiveCmp( const SweepStatus * status )
+        : status_( status )
+      { }
+
+    /*!
+      \brief get the side of the point relative to the segment.
+      \return positive if the point is above the segment.
+    */
+    double side( const std::size_t i,
+                 const double & x,
+                 const double & y ) const
+      {
+          return orientation( status_->lx_[i], status_->ly_[i],
+                              status_->rx_[i], status_->ry_[i],
+                              x, y );
+      }
+
+    /*!
+      \brief check if the segment is below the point on the sweep line.
+      \param i segment index
+      \param y y value of the point on the sweep line
+      \return true if the segment is below the point.
+    */
+    bool below( const std::size_t i,
+                const double & y ) const
+      {
+          return side( i, status_->x_, y ) > 0.0;
+      }
+
+    bool operator()( const std::size_t lhs,
+                     const std::size_t rhs ) const
+      {
+          if ( lhs == rhs )
+          {
+              return false;
+          }
+
+          if ( lhs == status_->probe_ )
+          {
+              return side( rhs, status_->x_, status_->probe_y_ ) <= 0.0;
+          }
+
+          if ( rhs == status_->probe_ )
+          {
+              return below( lhs, status_->probe_y_ );
+          }
+
+          // test the left point of the later segment.
+          // the earlier segment always spans the sweep line.
+          // the roles must not depend on the argument order,
+          // otherwise the result may be inconsistent by the rounding error.
+          const bool lhs_later = ( status_->lx_[lhs] != status_->lx_[rhs]
+                                   ? status_->lx_[lhs] > status_->lx_[rhs]
+                                   : status_->ly_[lhs] != status_->ly_[rhs]
+                                   ? status_->ly_[lhs] > status_->ly_[rhs]
+                                   : lhs > rhs );
+          const std::size_t later = ( lhs_later ? lhs : rhs );
+          const std::size_t earlier = ( lhs_later ? rhs : lhs );
+
+          double s = side( earlier, status_->lx_[later], status_->ly_[later] );
+          if ( s == 0.0 )
+          {
+              // segments meet at the sweep line.
+              // compare the order at the right side of the sweep line.
+              s = side( earlier, status_->rx_[later], status_->ry_[later] );
+          }
+
+          if ( s == 0.0 )
+          {
+              // collinear
+              return lhs < rhs;
+          }
+
+          // s > 0.0 means the later segment is above the earlier one.
+          return ( lhs_later ? s < 0.0 : s > 0.0 );
+      }
+};
+
+typedef std::set< std::size_t, ActiveCmp > ActiveSet;
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+SegmentIntersection::add( const Vector2D & origin,
+                          const Vector2D & terminal )
+{
+    if ( origin.x < terminal.x
+         || ( origin.x == terminal.x
+              && origin.y <= terminal.y ) )
+    {
+        M_left.push_back( origin );
+        M_right.push_back( terminal );
+    }
+    else
+    {
+        M_left.push_back( terminal );
+        M_right.push_back( origin );
+    }
+
+    return M_left.size() - 1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SegmentIntersection::crossExceptEndpoint( const std::size_t i,
+                                          const std::size_t j ) const
+{
+    const double ax0 = M_left.x( i ), ay0 = M_left.y( i );
+    const double ax1 = M_right.x( i ), ay1 = M_right.y( i );
+    const double bx0 = M_left.x( j ), by0 = M_left.y( j );
+    const double bx1 = M_right.x( j ), by1 = M_right.y( j );
+
+    const double a0 = orientation( ax0, ay0, ax1, ay1, bx0, by0 );
+    const double a1 = orientation( ax0, ay0, ax1, ay1, bx1, by1 );
+    if ( a0 * a1 >= 0.0 )
+    {
+        return false;
+    }
+
+    const double b0 = orientation( bx0, by0, bx1, by1, ax0, ay0 );
+    const double b1 = orientation( bx0, by0, bx1, by1, ax1, ay1 );
+    return b0 * b1 < 0.0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SegmentIntersection::existIntersectionExceptEndpoint() const
+{
+    const std::size_t size = M_left.size();
+
+    if ( size < 2 )
+    {
+        return false;
+    }
+
+    //
+    // create events
+    //
+    M_events.clear();
+    M_events.reserve( size * 2 );
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        Event e;
+        e.index_ = i;
+        e.x_ = M_left.x( i );
+        e.y_ = M_left.y( i );
+
+        if ( M_left.x( i ) == M_right.x( i ) )
+        {
+            // vertical segment is not inserted into the active set.
+            e.type_ = VERTICAL_EVENT;
+            M_events.push_back( e );
+            continue;
+        }
+
+        e.type_ = INSERT_EVENT;
+        M_events.push_back( e );
+
+        e.type_ = REMOVE_EVENT;
+        e.x_ = M_right.x( i );
+        e.y_ = M_right.y( i );
+        M_events.push_back( e );
+    }
+
+    std::sort( M_events.begin(), M_events.end(), EventCmp() );
+
+    //
+    // sweep
+    //
+    SweepStatus status;
+    status.lx_ = &M_left.xs()[0];
+    status.ly_ = &M_left.ys()[0];
+    status.rx_ = &M_right.xs()[0];
+    status.ry_ = &M_right.ys()[0];
+    status.x_ = 0.0;
+    status.probe_ = size;
+    status.probe_y_ = 0.0;
+
+    const ActiveCmp cmp( &status );
+    ActiveSet active( cmp );
+    std::vector< ActiveSet::iterator > handles( size, active.end() );
+
+    const std::vector< Event >::const_iterator end = M_events.end();
+    for ( std::vector< Event >::const_iterator e = M_events.begin();
+          e != end;
+          ++e )
+    {
+        status.x_ = e->x_;
+
+        if ( e->type_ == INSERT_EVENT )
+        {
+            ActiveSet::iterator it = active.insert( e->index_ ).first;
+            handles[e->index_] = it;
+
+            if ( it != active.begin() )
+            {
+                ActiveSet::iterator prev = it;
+                --prev;
+                if ( crossExceptEndpoint( *prev, *it ) )
+                {
+                    return true;
+                }
+            }
+
+            ActiveSet::iterator next = it;
+            ++next;
+            if ( next != active.end()
+                 && crossExceptEndpoint( *it, *next ) )
+            {
+                return true;
+            }
+        }
+        else if ( e->type_ == REMOVE_EVENT )
+        {
+            ActiveSet::iterator it = handles[e->index_];
+            ActiveSet::iterator next = it;
+            ++next;
+
+            if ( it != active.begin()
+                 && next != active.end() )
+            {
+                ActiveSet::iterator prev = it;
+                --prev;
+                if ( crossExceptEndpoint( *prev, *next ) )
+                {
+                    return true;
+                }
+            }
+
+            active.erase( it );
+            handles[e->index_] = active.end();
+        }
+        else
+        {
+            // vertical segment can cross all active segments
+            // in its y range. check them one by one.
+            status.probe_y_ = M_left.y( e->index_ );
+            const double max_y = M_right.y( e->index_ );
+
+            for ( ActiveSet::iterator it = active.lower_bound( status.probe_ );
+                  it != active.end() && cmp.side( *it, status.x_, max_y ) >= 0.0;
+                  ++it )
+            {
+                if ( crossExceptEndpoint( e->index_, *it ) )
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+SegmentIntersection::intersect( const SegmentIntersection & other,
+                                std::vector< IndexPair > & result,
+                                const bool allow_end_point ) const
+{
+    const std::size_t my_size = this->size();
+    const std::size_t other_size = other.size();
+
+    if ( my_size == 0
+         || other_size == 0 )
+    {
+        return 0;
+    }
+
+    //
+    // sort all segments by left x.
+    // type_ is used as the set id. 0: this, 1: other
+    //
+    M_events.clear();
+    M_events.reserve( my_size + other_size );
+
+    for ( std::size_t i = 0; i < my_size; ++i )
+    {
+        Event e;
+        e.x_ = M_left.x( i );
+        e.y_ = M_left.y( i );
+        e.type_ = 0;
+        e.index_ = i;
+        M_events.push_back( e );
+    }
+
+    for ( std::size_t i = 0; i < other_size; ++i )
+    {
+        Event e;
+        e.x_ = other.M_left.x( i );
+        e.y_ = other.M_left.y( i );
+        e.type_ = 1;
+        e.index_ = i;
+        M_events.push_back( e );
+    }
+
+    std::sort( M_events.begin(), M_events.end(), EventCmp() );
+
+    //
+    // sweep. each segment is tested only with segments in the other set
+    // whose x range overlaps.
+    //
+    const SegmentIntersection * sets[2] = { this, &other };
+    std::vector< std::size_t > active[2];
+
+    std::size_t count = 0;
+
+    const std::vector< Event >::const_iterator end = M_events.end();
+    for ( std::vector< Event >::const_iterator e = M_events.begin();
+          e != end;
+          ++e )
+    {
+        const int own = e->type_;
+        const int opp = 1 - own;
+
+        const SegmentIntersection & own_set = *sets[own];
+        const SegmentIntersection & opp_set = *sets[opp];
+
+        const Vector2D l = own_set.M_left[e->index_];
+        const Vector2D r = own_set.M_right[e->index_];
+        const double min_y = std::min( l.y, r.y );
+        const double max_y = std::max( l.y, r.y );
+
+        std::vector< std::size_t > & opp_active = active[opp];
+        std::size_t n = opp_active.size();
+        std::size_t k = 0;
+        while ( k < n )
+        {
+            const std::size_t j = opp_active[k];
+
+            if ( opp_set.M_right.x( j ) < l.x )
+            {
+                // segment j is already left of the sweep line.
+                opp_active[k] = opp_active[n - 1];
+                opp_active.pop_back();
+                --n;
+                continue;
+            }
+            ++k;
+
+            if ( std::max( opp_set.M_left.y( j ), opp_set.M_right.y( j ) ) < min_y
+                 || max_y < std::min( opp_set.M_left.y( j ), opp_set.M_right.y( j ) ) )
+            {
+                continue;
+            }
+
+            const Vector2D ol = opp_set.M_left[j];
+            const Vector2D or_ = opp_set.M_right[j];
+
+            const bool hit = ( allow_end_point
+                               ? exist_intersection( l, r, ol, or_ )
+                               : exist_intersection_except_endpoint( l, r, ol, or_ ) );
+            if ( hit )
+            {
+                result.push_back( own == 0
+                                  ? IndexPair( e->index_, j )
+                                  : IndexPair( j, e->index_ ) );
+                ++count;
+            }
+        }
+
+        active[own].push_back( e->index_ );
+    }
+
+    return count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SegmentIntersection::exist_intersection_except_endpoint( const Vector2D & a0,
+                                                         const Vector2D & a1,
+                                                         const Vector2D & b0,
+                                                         const Vector2D & b1 )
+{
+    return ( Triangle2D::double_signed_area( a0, a1, b0 )
+             * Triangle2D::double_signed_area( a0, a1, b1 )
+             < 0.0 )
+        && ( Triangle2D::double_signed_area( b0, b1, a0 )
+             * Triangle2D::double_signed_area( b0, b1, a1 )
+             < 0.0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SegmentIntersection::exist_intersection( const Vector2D & a0,
+                                         const Vector2D & a1,
+                                         const Vector2D & b0,
+                                         const Vector2D & b1 )
+{
+    // Segment2D only holds two points. no dynamic allocation.
+    return Segment2D( a0, a1 ).existIntersection( Segment2D( b0, b1 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SegmentIntersection::segment_line( const Vector2D & s0,
+                                   const Vector2D & s1,
+                                   const Vector2D & l0,
+                                   const Vector2D & l1,
+                                   Vector2D * sol )
+{
+    // line coefficients. same as Line2D::assign()
+    const double sa = -( s1.y - s0.y );
+    const double sb = s1.x - s0.x;
+    const double sc = -sa * s0.x - sb * s0.y;
+
+    const double la = -( l1.y - l0.y );
+    const double lb = l1.x - l0.x;
+    const double lc = -la * l0.x - lb * l0.y;
+
+    const double tmp = sa * lb - sb * la;
+    if ( std::fabs( tmp ) < EPSILON )
+    {
+        return false;
+    }
+
+    const double x = ( sb * lc - lb * sc ) / tmp;
+    const double y = ( la * sc - sa * lc ) / tmp;
+
+    // same as Segment2D::contains()
+    if ( ( x - s0.x ) * ( x - s1.x ) > CALC_ERROR
+         || ( y - s0.y ) * ( y - s1.y ) > CALC_ERROR )
+    {
+        return false;
+    }
+
+    if ( sol )
+    {
+        sol->assign( x, y );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SegmentIntersection::segment_segment( const Vector2D & a0,
+                                      const Vector2D & a1,
+                                      const Vector2D & b0,
+                                      const Vector2D & b1,
+                                      Vector2D * sol )
+{
+    const double abx = a1.x - a0.x;
+    const double aby = a1.y - a0.y;
+    const double dcx = b0.x - b1.x;
+    const double dcy = b0.y - b1.y;
+    const double adx = b0.x - a0.x;
+    const double ady = b0.y - a0.y;
+
+    const double det = abx * dcy - aby * dcx;
+    if ( std::fabs( det ) < CALC_ERROR )
+    {
+        return false;
+    }
+
+    const double s = ( adx * dcy - ady * dcx ) / det;
+    const double t = ( abx * ady - aby * adx ) / det;
+
+    if ( s < 0.0 || 1.0 < s
+         || t < 0.0 || 1.0 < t )
+    {
+        return false;
+    }
+
+    if ( sol )
+    {
+        sol->assign( a0.x + abx * s, a0.y + aby * s );
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,273 @@
+// -*-c++-*-
+
+/*!
+  \file segment_intersection.h
+  \brief batched segment intersection engine Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_GEOM_SEGMENT_INTERSECTION_H
+#define RCSC_GEOM_SEGMENT_INTERSECTION_H
+
+#include <rcsc/geom/vector_2d_array.h>
+#include <rcsc/geom/vector_2d.h>
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace rcsc {
+
+/*!
+  \class SegmentIntersection
+  \brief segment set that supports batched intersection tests.
+
+  Static methods are the allocation free versions of
+  Segment2D::intersection() and Segment2D::existIntersectionExceptEndpoint().
+  They take raw end points and return the result by the output argument,
+  so no temporary Line2D/Segment2D is created.
+
+  The instance holds many segments, and answers all-pairs queries using
+  the plane sweep algorithm. The event buffer is kept as a member variable
+  and reused by the following queries.
+*/
+class SegmentIntersection {
+public:
+
+    typedef std::pair< std::size_t, std::size_t > IndexPair; //!< pair of segment indices
+
+    static const double EPSILON; //!< threshold value to detect parallel lines
+    static const double CALC_ERROR; //!< calculation error threshold value
+
+private:
+
+    /*!
+      \struct Event
+      \brief sweep line event
+    */
+    struct Event {
+        double x_; //!< event x coordinate
+        double y_; //!< event y coordinate
+        int type_; //!< event type
+        std::size_t index_; //!< segment index
+    };
+
+    /*!
+      \struct EventCmp
+      \brief event order for the plane sweep
+    */
+    struct EventCmp {
+        bool operator()( const Event & lhs,
+                         const Event & rhs ) const
+          {
+              return ( lhs.x_ < rhs.x_
+                       || ( lhs.x_ == rhs.x_
+                            && ( lhs.type_ < rhs.type_
+                                 || ( lhs.type_ == rhs.type_
+                                      && lhs.y_ < rhs.y_ ) ) ) );
+          }
+    };
+
+    // each segment is stored as left and right end points.
+    // (smaller x is left. if x values are same, smaller y is left.)
+    Vector2DArray M_left; //!< left end points
+    Vector2DArray M_right; //!< right end points
+
+    mutable std::vector< Event > M_events; //!< work buffer for the sweep
+
+public:
+
+    /*!
+      \brief create empty set.
+    */
+    SegmentIntersection()
+      { }
+
+    /*!
+      \brief clear all segments.
+    */
+    void clear()
+      {
+          M_left.clear();
+          M_right.clear();
+      }
+
+    /*!
+      \brief reserve the memory space.
+      \param n new capacity
+    */
+    void reserve( const std::size_t n )
+      {
+          M_left.reserve( n );
+          M_right.reserve( n );
+      }
+
+    /*!
+      \brief get the number of segments.
+      \return size of segment set
+    */
+    std::size_t size() const
+      {
+          return M_left.size();
+      }
+
+    /*!
+      \brief check if set is empty or not.
+      \return true if no segment.
+    */
+    bool empty() const
+      {
+          return M_left.empty();
+      }
+
+    /*!
+      \brief add new segment.
+      \param origin 1st end point
+      \param terminal 2nd end point
+      \return index of the added segment
+    */
+    std::size_t add( const Vector2D & origin,
+                     const Vector2D & terminal );
+
+    /*!
+      \brief get the left end point of the specified segment.
+      \param i index of segment
+      \return copy of point value
+    */
+    Vector2D left( const std::size_t i ) const
+      {
+          return M_left[i];
+      }
+
+    /*!
+      \brief get the right end point of the specified segment.
+      \param i index of segment
+      \return copy of point value
+    */
+    Vector2D right( const std::size_t i ) const
+      {
+          return M_right[i];
+      }
+
+    /*!
+      \brief check if any two segments in this set intersect at the point
+      except their end points.
+      \return true if intersected segment pair exists.
+
+      This method is equivalent to testing all pairs by
+      Segment2D::existIntersectionExceptEndpoint(). Pairs that share an end
+      point are never reported, as same as the original predicate.
+      The plane sweep (Shamos-Hoey) is used, so the cost is O(n log n).
+    */
+    bool existIntersectionExceptEndpoint() const;
+
+    /*!
+      \brief find all intersected pairs between this set and other set.
+      \param other another segment set
+      \param result reference to the result container. found pairs are appended.
+      first value is the index in this set, second value is the index in other set.
+      \param allow_end_point if true, touching at the end point is also reported.
+      \return number of found pairs
+    */
+    std::size_t intersect( const SegmentIntersection & other,
+                           std::vector< IndexPair > & result,
+                           const bool allow_end_point = true ) const;
+
+    //////////////////////////////////////////////
+    // static utility
+
+    /*!
+      \brief check if two segments intersect at the point except their end points.
+      \param a0 1st end point of segment a
+      \param a1 2nd end point of segment a
+      \param b0 1st end point of segment b
+      \param b1 2nd end point of segment b
+      \return true if segments cross each other.
+    */
+    static
+    bool exist_intersection_except_endpoint( const Vector2D & a0,
+                                             const Vector2D & a1,
+                                             const Vector2D & b0,
+                                             const Vector2D & b1 );
+
+    /*!
+      \brief check if two segments have the common point.
+      \param a0 1st end point of segment a
+      \param a1 2nd end point of segment a
+      \param b0 1st end point of segment b
+      \param b1 2nd end point of segment b
+      \return true if segments have the common point.
+    */
+    static
+    bool exist_intersection( const Vector2D & a0,
+                             const Vector2D & a1,
+                             const Vector2D & b0,
+                             const Vector2D & b1 );
+
+    /*!
+      \brief get the intersection point of the segment and the line.
+      \param s0 1st end point of segment
+      \param s1 2nd end point of segment
+      \param l0 1st point on line
+      \param l1 2nd point on line
+      \param sol pointer to the variable that receives the intersection point.
+      \return true if intersection exists.
+
+      The result is same as Segment2D( s0, s1 ).intersection( Line2D( l0, l1 ) ).
+    */
+    static
+    bool segment_line( const Vector2D & s0,
+                       const Vector2D & s1,
+                       const Vector2D & l0,
+                       const Vector2D & l1,
+                       Vector2D * sol );
+
+    /*!
+      \brief get the intersection point of two segments.
+      \param a0 1st end point of segment a
+      \param a1 2nd end point of segment a
+      \param b0 1st end point of segment b
+      \param b1 2nd end point of segment b
+      \param sol pointer to the variable that receives the intersection point.
+      \return true if intersection exists. parallel segments always return false.
+    */
+    static
+    bool segment_segment( const Vector2D & a0,
+                          const Vector2D & a1,
+                          const Vector2D & b0,
+                          const Vector2D & b1,
+                          Vector2D * sol );
+
+private:
+
+    bool crossExceptEndpoint( const std::size_t i,
+                              const std::size_t j ) const;
+
+};
+
+}
+
+#endif
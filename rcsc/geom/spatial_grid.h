@@ -0,0 +1,766 @@
+// -*-c++-*-
+
+/*!
+  \file spatial_grid.h
+  \brief uniform spatial hash grid Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_GEOM_SPATIAL_GRID_H
+#define RCSC_GEOM_SPATIAL_GRID_H
+
+#include <rcsc/geom/vector_2d.h>
+
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <limits>
+#include <cstddef>
+#include <cstdlib>
+#include <cmath>
+
+namespace rcsc {
+
+/*!
+  \class SpatialGrid
+  \brief uniform grid that holds points with the payload value.
+
+  Points are registered to the square cells, and the cells are stored in
+  the hash table. So, the memory usage does not depend on the region size.
+  The nearest point search and the radius search only examine the cells
+  around the query point.
+
+  Each registered point is identified by the handle returned by insert().
+  The handle is not changed by move(), and is reused after remove().
+
+  The cost of the hash lookup is larger than the simple distance
+  calculation. For a small number of points, the linear scan is faster,
+  so nearest() scans all points if size() is not greater than the
+  threshold. See test_spatial_grid_benchmark.cpp for the crossover point.
+*/
+template < typename T >
+class SpatialGrid {
+public:
+
+    typedef T value_type; //!< payload type
+    typedef std::size_t Handle; //!< entry identifier type
+
+    //! default threshold size of the linear scan. see test_spatial_grid_benchmark.cpp
+    enum { DEFAULT_LINEAR_SCAN_SIZE = 128 };
+
+private:
+
+    /*!
+      \struct Entry
+      \brief registered point
+    */
+    struct Entry {
+        Vector2D pos_; //!< point coordinate
+        T value_; //!< payload
+        int ix_; //!< cell index x
+        int iy_; //!< cell index y
+        bool used_; //!< false if this entry is removed
+
+        Entry( const Vector2D & pos,
+               const T & value )
+            : pos_( pos ),
+              value_( value ),
+              ix_( 0 ),
+              iy_( 0 ),
+              used_( true )
+          { }
+    };
+
+    typedef std::vector< Handle > Bucket; //!< handle container for one hash slot
+    typedef std::pair< double, Handle > DistHandle; //!< squared distance and handle
+
+    double M_cell_size; //!< cell edge length
+    double M_inv_cell_size; //!< 1 / cell edge length
+
+    std::vector< Entry > M_entries; //!< entry instances. index is used as handle.
+    std::vector< Handle > M_free_handles; //!< removed handles
+    std::size_t M_size; //!< the number of used entries
+    std::size_t M_linear_scan_size; //!< nearest() uses the linear scan if size() is not greater than this value
+
+    std::vector< Bucket > M_buckets; //!< hash table. size is always power of 2.
+
+    // cell index range of all inserted points. not shrinked by remove().
+    int M_min_ix; //!< minimum cell index x
+    int M_max_ix; //!< maximum cell index x
+    int M_min_iy; //!< minimum cell index y
+    int M_max_iy; //!< maximum cell index y
+
+public:
+
+    /*!
+      \brief create empty grid.
+      \param cell_size cell edge length
+    */
+    explicit
+    SpatialGrid( const double & cell_size = 1.0 )
+        : M_cell_size( 1.0 ),
+          M_inv_cell_size( 1.0 ),
+          M_size( 0 ),
+          M_linear_scan_size( DEFAULT_LINEAR_SCAN_SIZE )
+      {
+          setCellSizeImpl( cell_size );
+          clear();
+      }
+
+    /*!
+      \brief remove all points.
+    */
+    void clear()
+      {
+          M_entries.clear();
+          M_free_handles.clear();
+          M_size = 0;
+          M_buckets.assign( 16, Bucket() );
+          M_min_ix = M_min_iy = std::numeric_limits< int >::max();
+          M_max_ix = M_max_iy = std::numeric_limits< int >::min();
+      }
+
+    /*!
+      \brief get the number of points.
+      \return the number of points
+    */
+    std::size_t size() const
+      {
+          return M_size;
+      }
+
+    /*!
+      \brief check if grid is empty or not.
+      \return true if no point.
+    */
+    bool empty() const
+      {
+          return M_size == 0;
+      }
+
+    /*!
+      \brief get the cell edge length.
+      \return cell edge length
+    */
+    const double & cellSize() const
+      {
+          return M_cell_size;
+      }
+
+    /*!
+      \brief change the cell edge length. all points are registered again.
+      \param cell_size new cell edge length
+    */
+    void setCellSize( const double & cell_size )
+      {
+          setCellSizeImpl( cell_size );
+
+          M_min_ix = M_min_iy = std::numeric_limits< int >::max();
+          M_max_ix = M_max_iy = std::numeric_limits< int >::min();
+          for ( typename std::vector< Entry >::iterator e = M_entries.begin();
+                e != M_entries.end();
+                ++e )
+          {
+              if ( e->used_ )
+              {
+                  updateCellIndex( *e );
+              }
+          }
+          rehash( M_buckets.size() );
+      }
+
+    /*!
+      \brief set the threshold size of the linear scan.
+      \param size nearest() scans all points if size() is not greater than this value.
+      0 means the grid is always used.
+    */
+    void setLinearScanSize( const std::size_t size )
+      {
+          M_linear_scan_size = size;
+      }
+
+    /*!
+      \brief check if the handle is registered.
+      \param h handle value
+      \return true if h is a valid handle.
+    */
+    bool valid( const Handle h ) const
+      {
+          return h < M_entries.size() && M_entries[h].used_;
+      }
+
+    /*!
+      \brief get the point coordinate.
+      \param h valid handle value
+      \return const reference to the coordinate
+    */
+    const Vector2D & pos( const Handle h ) const
+      {
+          return M_entries[h].pos_;
+      }
+
+    /*!
+      \brief get the payload.
+      \param h valid handle value
+      \return const reference to the payload
+    */
+    const T & value( const Handle h ) const
+      {
+          return M_entries[h].value_;
+      }
+
+    /*!
+      \brief get the payload.
+      \param h valid handle value
+      \return reference to the payload
+    */
+    T & value( const Handle h )
+      {
+          return M_entries[h].value_;
+      }
+
+    /*!
+      \brief register a new point.
+      \param pos point coordinate
+      \param value payload
+      \return handle of the new point
+    */
+    Handle insert( const Vector2D & pos,
+                   const T & value )
+      {
+          Handle h;
+          if ( ! M_free_handles.empty() )
+          {
+              h = M_free_handles.back();
+              M_free_handles.pop_back();
+              M_entries[h] = Entry( pos, value );
+          }
+          else
+          {
+              h = M_entries.size();
+              M_entries.push_back( Entry( pos, value ) );
+          }
+
+          ++M_size;
+          updateCellIndex( M_entries[h] );
+
+          if ( M_size > M_buckets.size() * 2 )
+          {
+              rehash( M_buckets.size() * 4 );
+          }
+          else
+          {
+              M_buckets[bucketIndex( M_entries[h].ix_, M_entries[h].iy_ )].push_back( h );
+          }
+
+          return h;
+      }
+
+    /*!
+      \brief unregister the point.
+      \param h handle value
+      \return true if removed.
+    */
+    bool remove( const Handle h )
+      {
+          if ( ! valid( h ) )
+          {
+              return false;
+          }
+
+          Entry & e = M_entries[h];
+          eraseFromBucket( h, e.ix_, e.iy_ );
+          e.used_ = false;
+          --M_size;
+          M_free_handles.push_back( h );
+          return true;
+      }
+
+    /*!
+      \brief change the point coordinate.
+      \param h handle value
+      \param pos new point coordinate
+      \return true if moved.
+    */
+    bool move( const Handle h,
+               const Vector2D & pos )
+      {
+          if ( ! valid( h ) )
+          {
+              return false;
+          }
+
+          Entry & e = M_entries[h];
+          const int old_ix = e.ix_;
+          const int old_iy = e.iy_;
+
+          e.pos_ = pos;
+          updateCellIndex( e );
+
+          if ( e.ix_ != old_ix
+               || e.iy_ != old_iy )
+          {
+              eraseFromBucket( h, old_ix, old_iy );
+              M_buckets[bucketIndex( e.ix_, e.iy_ )].push_back( h );
+          }
+
+          return true;
+      }
+
+    /*!
+      \brief find the point nearest to p.
+      \param p query point
+      \param result pointer to the variable that receives the found handle.
+      \param dist2 pointer to the variable that receives the squared distance. may be NULL.
+      \param max_dist points farther than this value are ignored.
+      \return true if found.
+    */
+    bool nearest( const Vector2D & p,
+                  Handle * result,
+                  double * dist2 = static_cast< double * >( 0 ),
+                  const double & max_dist = std::numeric_limits< double >::max() ) const
+      {
+          if ( M_size == 0 )
+          {
+              return false;
+          }
+
+          double best_d2 = ( max_dist < std::sqrt( std::numeric_limits< double >::max() )
+                             ? max_dist * max_dist
+                             : std::numeric_limits< double >::max() );
+          bool found = false;
+
+          if ( M_size <= M_linear_scan_size )
+          {
+              // the hash lookup is slower than the distance calculation
+              // for a small number of points.
+              const std::size_t n = M_entries.size();
+              for ( Handle h = 0; h < n; ++h )
+              {
+                  const Entry & e = M_entries[h];
+                  if ( ! e.used_ ) continue;
+
+                  const double d2 = e.pos_.dist2( p );
+                  if ( d2 < best_d2 )
+                  {
+                      best_d2 = d2;
+                      *result = h;
+                      found = true;
+                  }
+              }
+
+              if ( found && dist2 )
+              {
+                  *dist2 = best_d2;
+              }
+              return found;
+          }
+
+          const int cx = cellIndex( p.x );
+          const int cy = cellIndex( p.y );
+          const double inner = innerDist( p, cx, cy );
+
+          int qx, qy;
+          const int start_ring = clampCell( cx, cy, &qx, &qy );
+          const int max_ring = maxRing( qx, qy );
+
+          for ( int r = 0; r <= max_ring; ++r )
+          {
+              // lower bound of the distance to the cells on the ring
+              const int d = std::max( r, start_ring );
+              const double min_d = ( d - 1 ) * M_cell_size + inner;
+              if ( d > 0
+                   && min_d * min_d >= best_d2 )
+              {
+                  break;
+              }
+
+              for ( RingIterator it( qx, qy, r ); ! it.end(); it.next() )
+              {
+                  if ( ! inRange( it.ix(), it.iy() ) ) continue;
+
+                  const Bucket & bucket = M_buckets[bucketIndex( it.ix(), it.iy() )];
+                  for ( typename Bucket::const_iterator b = bucket.begin();
+                        b != bucket.end();
+                        ++b )
+                  {
+                      const Entry & e = M_entries[*b];
+                      if ( e.ix_ != it.ix() || e.iy_ != it.iy() ) continue;
+
+                      const double d2 = e.pos_.dist2( p );
+                      if ( d2 < best_d2 )
+                      {
+                          best_d2 = d2;
+                          *result = *b;
+                          found = true;
+                      }
+                  }
+              }
+          }
+
+          if ( found && dist2 )
+          {
+              *dist2 = best_d2;
+          }
+
+          return found;
+      }
+
+    /*!
+      \brief find k points nearest to p.
+      \param p query point
+      \param k the number of wanted points
+      \param result reference to the result container.
+      found handles are stored in ascending order of the distance.
+      \return the number of found points
+    */
+    std::size_t nearest( const Vector2D & p,
+                         const std::size_t k,
+                         std::vector< Handle > & result ) const
+      {
+          result.clear();
+
+          if ( M_size == 0
+               || k == 0 )
+          {
+              return 0;
+          }
+
+          const int cx = cellIndex( p.x );
+          const int cy = cellIndex( p.y );
+          const double inner = innerDist( p, cx, cy );
+
+          int qx, qy;
+          const int start_ring = clampCell( cx, cy, &qx, &qy );
+          const int max_ring = maxRing( qx, qy );
+
+          // max heap of the current k candidates
+          std::vector< DistHandle > heap;
+          heap.reserve( k + 1 );
+
+          for ( int r = 0; r <= max_ring; ++r )
+          {
+              const int d = std::max( r, start_ring );
+              const double min_d = ( d - 1 ) * M_cell_size + inner;
+              if ( d > 0
+                   && heap.size() == k
+                   && min_d * min_d >= heap.front().first )
+              {
+                  break;
+              }
+
+              for ( RingIterator it( qx, qy, r ); ! it.end(); it.next() )
+              {
+                  if ( ! inRange( it.ix(), it.iy() ) ) continue;
+
+                  const Bucket & bucket = M_buckets[bucketIndex( it.ix(), it.iy() )];
+                  for ( typename Bucket::const_iterator b = bucket.begin();
+                        b != bucket.end();
+                        ++b )
+                  {
+                      const Entry & e = M_entries[*b];
+                      if ( e.ix_ != it.ix() || e.iy_ != it.iy() ) continue;
+
+                      const double d2 = e.pos_.dist2( p );
+                      if ( heap.size() < k )
+                      {
+                          heap.push_back( DistHandle( d2, *b ) );
+                          std::push_heap( heap.begin(), heap.end() );
+                      }
+                      else if ( d2 < heap.front().first )
+                      {
+                          std::pop_heap( heap.begin(), heap.end() );
+                          heap.back() = DistHandle( d2, *b );
+                          std::push_heap( heap.begin(), heap.end() );
+                      }
+                  }
+              }
+          }
+
+          std::sort_heap( heap.begin(), heap.end() );
+
+          result.reserve( heap.size() );
+          for ( typename std::vector< DistHandle >::const_iterator h = heap.begin();
+                h != heap.end();
+                ++h )
+          {
+              result.push_back( h->second );
+          }
+
+          return result.size();
+      }
+
+    /*!
+      \brief find all points within the circle.
+      \param center center point of the circle
+      \param radius radius of the circle
+      \param result reference to the handle container. found handles are appended.
+      \return the number of found points
+    */
+    std::size_t within( const Vector2D & center,
+                        const double & radius,
+                        std::vector< Handle > & result ) const
+      {
+          if ( M_size == 0 )
+          {
+              return 0;
+          }
+
+          const int min_ix = std::max( M_min_ix, cellIndex( center.x - radius ) );
+          const int max_ix = std::min( M_max_ix, cellIndex( center.x + radius ) );
+          const int min_iy = std::max( M_min_iy, cellIndex( center.y - radius ) );
+          const int max_iy = std::min( M_max_iy, cellIndex( center.y + radius ) );
+          const double r2 = radius * radius;
+
+          std::size_t count = 0;
+          for ( int ix = min_ix; ix <= max_ix; ++ix )
+          {
+              for ( int iy = min_iy; iy <= max_iy; ++iy )
+              {
+                  const Bucket & bucket = M_buckets[bucketIndex( ix, iy )];
+                  for ( typename Bucket::const_iterator b = bucket.begin();
+                        b != bucket.end();
+                        ++b )
+                  {
+                      const Entry & e = M_entries[*b];
+                      if ( e.ix_ != ix || e.iy_ != iy ) continue;
+
+                      if ( e.pos_.dist2( center ) < r2 )
+                      {
+                          result.push_back( *b );
+                          ++count;
+                      }
+                  }
+              }
+          }
+
+          return count;
+      }
+
+    //////////////////////////////////////////////
+    // static utility
+
+    /*!
+      \brief get the cell size so that each cell contains about one point.
+      \param width width of the region
+      \param height height of the region
+      \param n the number of points
+      \return recommended cell edge length
+    */
+    static
+    double suggest_cell_size( const double & width,
+                              const double & height,
+                              const std::size_t n )
+      {
+          const double area = std::fabs( width * height );
+          if ( n == 0
+               || area < 1.0e-10 )
+          {
+              return std::max( 1.0e-3, std::max( std::fabs( width ), std::fabs( height ) ) );
+          }
+
+          return std::max( 1.0e-3, std::sqrt( area / n ) );
+      }
+
+private:
+
+    /*!
+      \class RingIterator
+      \brief iterates the cells at the same Chebyshev distance from the center cell.
+    */
+    class RingIterator {
+    private:
+        const int M_cx;
+        const int M_cy;
+        const int M_r;
+        int M_ix;
+        int M_iy;
+        bool M_end;
+    public:
+        RingIterator( const int cx,
+                      const int cy,
+                      const int r )
+            : M_cx( cx ),
+              M_cy( cy ),
+              M_r( r ),
+              M_ix( cx - r ),
+              M_iy( cy - r ),
+              M_end( false )
+          { }
+
+        int ix() const { return M_ix; }
+        int iy() const { return M_iy; }
+        bool end() const { return M_end; }
+
+        void next()
+          {
+              if ( M_r == 0 )
+              {
+                  M_end = true;
+                  return;
+              }
+
+              if ( M_iy == M_cy - M_r
+                   || M_iy == M_cy + M_r )
+              {
+                  // bottom or top row. all cells are on the ring.
+                  if ( M_ix < M_cx + M_r )
+                  {
+                      ++M_ix;
+                      return;
+                  }
+              }
+              else if ( M_ix == M_cx - M_r )
+              {
+                  // left column. jump to the right column.
+                  M_ix = M_cx + M_r;
+                  return;
+              }
+
+              // move to the next row
+              if ( M_iy == M_cy + M_r )
+              {
+                  M_end = true;
+                  return;
+              }
+
+              ++M_iy;
+              M_ix = M_cx - M_r;
+          }
+    };
+
+    void setCellSizeImpl( const double & cell_size )
+      {
+          M_cell_size = ( cell_size > 1.0e-6 ? cell_size : 1.0e-6 );
+          M_inv_cell_size = 1.0 / M_cell_size;
+      }
+
+    int cellIndex( const double & v ) const
+      {
+          const double i = std::floor( v * M_inv_cell_size );
+          const double limit = static_cast< double >( std::numeric_limits< int >::max() / 2 );
+          return static_cast< int >( std::max( -limit, std::min( limit, i ) ) );
+      }
+
+    /*!
+      \brief get the distance from p to the boundary of the cell (cx, cy).
+    */
+    double innerDist( const Vector2D & p,
+                      const int cx,
+                      const int cy ) const
+      {
+          const double dx = p.x - cx * M_cell_size;
+          const double dy = p.y - cy * M_cell_size;
+          const double d = std::min( std::min( dx, M_cell_size - dx ),
+                                     std::min( dy, M_cell_size - dy ) );
+          return std::max( 0.0, d );
+      }
+
+    void updateCellIndex( Entry & e )
+      {
+          e.ix_ = cellIndex( e.pos_.x );
+          e.iy_ = cellIndex( e.pos_.y );
+          M_min_ix = std::min( M_min_ix, e.ix_ );
+          M_max_ix = std::max( M_max_ix, e.ix_ );
+          M_min_iy = std::min( M_min_iy, e.iy_ );
+          M_max_iy = std::max( M_max_iy, e.iy_ );
+      }
+
+    bool inRange( const int ix,
+                  const int iy ) const
+      {
+          return ( M_min_ix <= ix && ix <= M_max_ix
+                   && M_min_iy <= iy && iy <= M_max_iy );
+      }
+
+    /*!
+      \brief get the cell in the index range of the registered points nearest to the cell (cx, cy).
+      \param cx cell index x of the query point
+      \param cy cell index y of the query point
+      \param qx pointer to the variable that receives the clamped cell index x
+      \param qy pointer to the variable that receives the clamped cell index y
+      \return Chebyshev distance between (cx, cy) and (qx, qy).
+
+      The rings are walked around the clamped cell, so that the cost of the far
+      query point does not depend on its distance.  All registered cells are at
+      least the returned distance away from (cx, cy).
+    */
+    int clampCell( const int cx,
+                   const int cy,
+                   int * qx,
+                   int * qy ) const
+      {
+          *qx = std::max( M_min_ix, std::min( M_max_ix, cx ) );
+          *qy = std::max( M_min_iy, std::min( M_max_iy, cy ) );
+          return std::max( std::abs( cx - *qx ), std::abs( cy - *qy ) );
+      }
+
+    int maxRing( const int cx,
+                 const int cy ) const
+      {
+          return std::max( std::max( std::abs( cx - M_min_ix ), std::abs( M_max_ix - cx ) ),
+                           std::max( std::abs( cy - M_min_iy ), std::abs( M_max_iy - cy ) ) );
+      }
+
+    std::size_t bucketIndex( const int ix,
+                             const int iy ) const
+      {
+          const unsigned long h = ( static_cast< unsigned long >( ix ) * 73856093UL )
+              ^ ( static_cast< unsigned long >( iy ) * 19349663UL );
+          return static_cast< std::size_t >( h & ( M_buckets.size() - 1 ) );
+      }
+
+    void eraseFromBucket( const Handle h,
+                          const int ix,
+                          const int iy )
+      {
+          Bucket & bucket = M_buckets[bucketIndex( ix, iy )];
+          typename Bucket::iterator it = std::find( bucket.begin(), bucket.end(), h );
+          if ( it != bucket.end() )
+          {
+              *it = bucket.back();
+              bucket.pop_back();
+          }
+      }
+
+    void rehash( const std::size_t bucket_count )
+      {
+          M_buckets.assign( bucket_count, Bucket() );
+          for ( Handle h = 0; h < M_entries.size(); ++h )
+          {
+              const Entry & e = M_entries[h];
+              if ( e.used_ )
+              {
+                  M_buckets[bucketIndex( e.ix_, e.iy_ )].push_back( h );
+              }
+          }
+      }
+
+};
+
+}
+
+#endif
@@ -35,6 +35,9 @@
 
 #include <rcsc/time/timer.h>
 
+#include <algorithm>
+#include <cstdlib>
+
 #include <cppunit/extensions/HelperMacros.h>
 
 #define DEBUG_PRINT
@@ -46,6 +49,9 @@ class ConvexHullTest
     CPPUNIT_TEST( testEmpty );
     CPPUNIT_TEST( testPoints );
     CPPUNIT_TEST( testCircle );
+    CPPUNIT_TEST( testMonotoneChain );
+    CPPUNIT_TEST( testIncremental );
+    CPPUNIT_TEST( testIncrementalCollinear );
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -53,6 +59,9 @@ public:
     void testEmpty();
     void testPoints();
     void testCircle();
+    void testMonotoneChain();
+    void testIncremental();
+    void testIncrementalCollinear();
 };
 
 
@@ -256,6 +265,147 @@ ConvexHullTest::testCircle()
     CPPUNIT_ASSERT_EQUAL( 1000, n_edges );
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ConvexHullTest::testMonotoneChain()
+{
+    const int max_loop = 1000;
+
+    rcsc::ConvexHull c;
+
+    for ( int i = 0; i < max_loop; ++i )
+    {
+        rcsc::Vector2D p = rcsc::Vector2D::from_polar( 10.0, (360.0/max_loop)*i );
+        c.addPoint( p );
+    }
+
+    // inner points
+    c.addPoint( rcsc::Vector2D( 0.0, 0.0 ) );
+    c.addPoint( rcsc::Vector2D( 5.0, -5.0 ) );
+
+    {
+        rcsc::Timer timer;
+        c.computeMonotoneChain();
+        std::cout << "\nMonotoneChain elapsed " << timer.elapsedReal() << " [ms]" << std::endl;;
+    }
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( max_loop ), c.vertices().size() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( max_loop ), c.edges().size() );
+
+    // counter clockwise order from the leftmost point
+    CPPUNIT_ASSERT( c.vertices().front().equalsWeakly( rcsc::Vector2D( -10.0, 0.0 ) ) );
+    CPPUNIT_ASSERT( c.toPolygon().area() > 0.0 );
+
+    // collinear points
+    rcsc::ConvexHull l;
+    l.addPoint( rcsc::Vector2D( 0.0, 0.0 ) );
+    l.addPoint( rcsc::Vector2D( 1.0, 1.0 ) );
+    l.addPoint( rcsc::Vector2D( 2.0, 2.0 ) );
+    l.addPoint( rcsc::Vector2D( 1.0, 1.0 ) );
+    l.computeMonotoneChain();
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), l.vertices().size() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ConvexHullTest::testIncremental()
+{
+    rcsc::ConvexHull c;
+
+    c.addPoint( rcsc::Vector2D( -10.0, -10.0 ) );
+    c.addPoint( rcsc::Vector2D( +10.0, -10.0 ) );
+    c.addPoint( rcsc::Vector2D( +10.0, +10.0 ) );
+    c.addPoint( rcsc::Vector2D( -10.0, +10.0 ) );
+    c.addPoint( rcsc::Vector2D( 0.0, 0.0 ) );
+    c.compute();
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 4 ), c.vertices().size() );
+
+    // inner point does not change the hull
+    CPPUNIT_ASSERT( ! c.insertPoint( rcsc::Vector2D( 5.0, 5.0 ) ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 4 ), c.vertices().size() );
+
+    // outer point
+    CPPUNIT_ASSERT( c.insertPoint( rcsc::Vector2D( 20.0, 0.0 ) ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 5 ), c.vertices().size() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 5 ), c.edges().size() );
+
+    // same result as the full computation
+    rcsc::ConvexHull full( c.inputPoints() );
+    full.computeMonotoneChain();
+    CPPUNIT_ASSERT_EQUAL( full.vertices().size(), c.vertices().size() );
+    for ( size_t i = 0; i < c.vertices().size(); ++i )
+    {
+        CPPUNIT_ASSERT( full.vertices()[i].equals( c.vertices()[i] ) );
+    }
+
+    full.computeIncrementalMethod();
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 5 ), full.vertices().size() );
+
+    // move the inner point to the outside
+    c.setPoint( 4, rcsc::Vector2D( 0.0, -12.0 ) );
+    c.compute();
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 6 ), c.vertices().size() );
+
+    // move it back
+    c.setPoint( 4, rcsc::Vector2D( 0.0, 0.0 ) );
+    c.compute();
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 5 ), c.vertices().size() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ConvexHullTest::testIncrementalCollinear()
+{
+    //
+    // the points on the grid contain many collinear points.
+    // both methods must keep the same points on the edges as the vertices.
+    //
+    std::srand( 1 );
+
+    for ( int loop = 0; loop < 1000; ++loop )
+    {
+        rcsc::ConvexHull c;
+
+        const int n = 3 + std::rand() % 30;
+        for ( int i = 0; i < n; ++i )
+        {
+            rcsc::Vector2D p( std::rand() % 5, std::rand() % 5 );
+            if ( loop % 2 == 0
+                 && i < n - 2 )
+            {
+                // the first points are on the same line
+                p.y = p.x;
+            }
+            c.addPoint( p );
+        }
+
+        c.computeMonotoneChain();
+        std::vector< rcsc::Vector2D > expected = c.vertices();
+
+        c.computeIncrementalMethod();
+        std::vector< rcsc::Vector2D > result = c.vertices();
+
+        std::sort( expected.begin(), expected.end(), rcsc::Vector2D::XYCmp() );
+        std::sort( result.begin(), result.end(), rcsc::Vector2D::XYCmp() );
+
+        CPPUNIT_ASSERT_EQUAL( expected.size(), result.size() );
+        for ( size_t i = 0; i < expected.size(); ++i )
+        {
+            CPPUNIT_ASSERT( expected[i].equals( result[i] ) );
+        }
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*-------------------------------------------------------------------*/
 /*-------------------------------------------------------------------*/
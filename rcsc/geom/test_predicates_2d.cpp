@@ -0,0 +1,261 @@
+// -*-c++-*-
+
+/*!
+  \file test_predicates_2d.cpp
+  \brief test code for rcsc::Predicates2D
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "predicates_2d.h"
+#include "delaunay_triangulation.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <iostream>
+#include <cmath>
+
+using rcsc::Vector2D;
+using rcsc::Predicates2D;
+using rcsc::DelaunayTriangulation;
+
+namespace {
+
+inline
+int
+sign( const double & v )
+{
+    return ( v > 0.0 ? 1 : v < 0.0 ? -1 : 0 );
+}
+
+}
+
+
+/*!
+  \class Predicates2DTest
+ */
+class Predicates2DTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( Predicates2DTest );
+    CPPUNIT_TEST( testOrient );
+    CPPUNIT_TEST( testOrientNearDegenerate );
+    CPPUNIT_TEST( testInCircle );
+    CPPUNIT_TEST( testDelaunayOnline );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp();
+    void tearDown();
+
+protected:
+
+    void testOrient();
+    void testOrientNearDegenerate();
+    void testInCircle();
+    void testDelaunayOnline();
+};
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Predicates2DTest );
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Predicates2DTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Predicates2DTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Predicates2DTest::testOrient()
+{
+    const Vector2D a( 0.0, 0.0 );
+    const Vector2D b( 2.0, 0.0 );
+    const Vector2D c( 1.0, 1.0 );
+
+    CPPUNIT_ASSERT( Predicates2D::orient_2d( a, b, c ) > 0.0 );
+    CPPUNIT_ASSERT( Predicates2D::orient_2d( a, c, b ) < 0.0 );
+    CPPUNIT_ASSERT_EQUAL( 0.0, Predicates2D::orient_2d( a, b, Vector2D( 5.0, 0.0 ) ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( 2.0, Predicates2D::orient_2d( a, b, c ), 1.0e-12 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Predicates2DTest::testOrientNearDegenerate()
+{
+    // points close to the line y = x.
+    // the exact value is 12 * ( a.y - a.x ), and ( a.y - a.x ) is exact.
+    const Vector2D b( 12.0, 12.0 );
+    const Vector2D c( 24.0, 24.0 );
+    const double ulp = std::ldexp( 1.0, -53 );
+
+    for ( int i = 0; i < 64; ++i )
+    {
+        for ( int j = 0; j < 64; ++j )
+        {
+            const Vector2D a( 0.5 + i * ulp, 0.5 + j * ulp );
+            CPPUNIT_ASSERT_EQUAL( sign( a.y - a.x ),
+                                  sign( Predicates2D::orient_2d( a, b, c ) ) );
+            CPPUNIT_ASSERT_EQUAL( sign( a.y - a.x ),
+                                  sign( Predicates2D::orient_2d( b, c, a ) ) );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Predicates2DTest::testInCircle()
+{
+    // circle of radius 5 centered at (1024, 1024)
+    const double o = 1024.0;
+    const Vector2D a( o + 5.0, o );
+    const Vector2D b( o + 3.0, o + 4.0 );
+    const Vector2D c( o - 4.0, o + 3.0 );
+
+    const Vector2D on( o, o - 5.0 );
+    const Vector2D in( o, o - 5.0 + std::ldexp( 1.0, -42 ) );
+    const Vector2D out( o, o - 5.0 - std::ldexp( 1.0, -42 ) );
+
+    CPPUNIT_ASSERT_EQUAL( 0.0, Predicates2D::in_circle( a, b, c, on ) );
+    CPPUNIT_ASSERT( Predicates2D::in_circle( a, b, c, in ) > 0.0 );
+    CPPUNIT_ASSERT( Predicates2D::in_circle( a, b, c, out ) < 0.0 );
+
+    // clockwise order reverses the sign
+    CPPUNIT_ASSERT( Predicates2D::in_circle( a, c, b, in ) < 0.0 );
+
+    CPPUNIT_ASSERT( Predicates2D::in_circumcircle( a, c, b, in ) );
+    CPPUNIT_ASSERT( ! Predicates2D::in_circumcircle( a, b, c, on ) );
+    CPPUNIT_ASSERT( ! Predicates2D::in_circumcircle( a, b, c, out ) );
+    CPPUNIT_ASSERT( ! Predicates2D::in_circumcircle( a, b, Vector2D( o + 1.0, o + 2.0 ), in ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Predicates2DTest::testDelaunayOnline()
+{
+    DelaunayTriangulation triangulation( rcsc::Rect2D( Vector2D( -10.0, -10.0 ),
+                                                       rcsc::Size2D( 20.0, 20.0 ) ) );
+    triangulation.addVertex( 0.0, 0.0 );
+    triangulation.addVertex( 4.0, 0.0 );
+    triangulation.addVertex( 4.0, 4.0 );
+    triangulation.addVertex( 0.0, 4.0 );
+    // on the diagonal
+    triangulation.addVertex( 1.0, 1.0 );
+    // very close to the diagonal
+    triangulation.addVertex( 2.0, 2.0 + 1.0e-12 );
+    triangulation.addVertex( 3.0, 3.0 - 1.0e-12 );
+    triangulation.compute();
+
+    // 7 vertices, 4 vertices on the convex hull
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 2 * 7 - 4 - 2 ),
+                          triangulation.triangles().size() );
+
+    // no vertex is inside of circumcircles
+    const DelaunayTriangulation::TriangleCont::const_iterator end = triangulation.triangles().end();
+    for ( DelaunayTriangulation::TriangleCont::const_iterator t = triangulation.triangles().begin();
+          t != end;
+          ++t )
+    {
+        for ( size_t i = 0; i < triangulation.vertices().size(); ++i )
+        {
+            CPPUNIT_ASSERT( ! t->second->contains( triangulation.vertices()[i].pos() ) );
+        }
+    }
+
+    CPPUNIT_ASSERT( triangulation.findTriangleContains( Vector2D( 2.5, 2.5 ) ) );
+    CPPUNIT_ASSERT( triangulation.findTriangleContains( Vector2D( 1.5, 1.5 + 0.5e-12 ) ) );
+    CPPUNIT_ASSERT( triangulation.findTriangleContains( Vector2D( 4.0, 2.0 ) ) );
+    CPPUNIT_ASSERT( ! triangulation.findTriangleContains( Vector2D( 4.0 + 1.0e-12, 2.0 ) ) );
+}
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
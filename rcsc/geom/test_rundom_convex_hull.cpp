@@ -36,7 +36,9 @@
 #include <boost/random.hpp>
 
 #include <fstream>
+#include <vector>
 #include <ctime>
+#include <cstdio>
 
 #include <sys/time.h> // struct timeval, gettimeofday()
 
@@ -64,39 +66,105 @@ print_elapsed( const timeval & start,
               << " [ms]" << std::endl;
 }
 
-int
-main()
-{
-    boost::mt19937 eng( std::time( 0 ) );
+typedef void (rcsc::ConvexHull::*ComputeMethod)();
 
-    //const double min_x = -10.0;
-    //const double max_x = +10.0;
-    //const double min_y = -10.0;
-    //const double max_y = +10.0;
-    //boost::variate_generator< boost::mt19937&, boost::uniform_real<> > x_rng( eng, boost::uniform_real<>( min_x, max_x ) );
-    //boost::variate_generator< boost::mt19937&, boost::uniform_real<> > y_rng( eng, boost::uniform_real<>( min_y, max_y ) );
+void
+benchmark( const char * name,
+           const ComputeMethod method,
+           const std::vector< rcsc::Vector2D > & points,
+           const int loop )
+{
+    rcsc::ConvexHull c;
 
-    boost::variate_generator< boost::mt19937&, boost::normal_distribution<> > x_rng( eng, boost::normal_distribution<>( 0.0, 5.0 ) );
-    boost::variate_generator< boost::mt19937&, boost::normal_distribution<> > y_rng( eng, boost::normal_distribution<>( 0.0, 5.0 ) );
+    timeval start;
+    if ( ::gettimeofday( &start, NULL ) == -1 )
+    {
+        std::perror( "gettimeofday" );
+    }
 
-    rcsc::ConvexHull c0;
-    rcsc::ConvexHull c1;
+    for ( int i = 0; i < loop; ++i )
+    {
+        // copy the input points every time,
+        // because Graham scan sorts the input points.
+        c.clear();
+        c.addPoints( points );
+        (c.*method)();
+    }
 
-    for ( int i = 0; i < 1000; ++i )
+    timeval end;
+    if ( ::gettimeofday( &end, NULL ) == -1 )
     {
-        rcsc::Vector2D p( x_rng(), y_rng() );
-        c0.addPoint( p );
-        c1.addPoint( p );
+        std::perror( "gettimeofday" );
     }
 
+    std::cout << name << '\n'
+              << "  points = " << c.inputPoints().size() << '\n'
+              << "  vertices = " << c.vertices().size() << '\n'
+              << "  edges = " << c.edges().size() << '\n'
+              << "  loop = " << loop << '\n';
+
+    print_elapsed( start, end );
+}
+
+void
+benchmark_all( const std::vector< rcsc::Vector2D > & points,
+               const int loop )
+{
+    benchmark( "DirectMethod", &rcsc::ConvexHull::computeDirectMethod, points,
+               points.size() <= 200 ? loop : 1 );
+    benchmark( "WrappingMethod", &rcsc::ConvexHull::computeWrappingMethod, points, loop );
+    benchmark( "GrahamScan", &rcsc::ConvexHull::computeGrahamScan, points, loop );
+    benchmark( "IncrementalMethod", &rcsc::ConvexHull::computeIncrementalMethod, points, loop );
+    benchmark( "MonotoneChain", &rcsc::ConvexHull::computeMonotoneChain, points, loop );
+}
+
+/*!
+  \brief compare the full recomputation with the presorted update when a few points move.
+ */
+void
+benchmark_update( const std::vector< rcsc::Vector2D > & points,
+                  const int loop )
+{
+    boost::mt19937 eng( 0 );
+    boost::variate_generator< boost::mt19937&, boost::uniform_int<> >
+        index_rng( eng, boost::uniform_int<>( 0, points.size() - 1 ) );
+    boost::variate_generator< boost::mt19937&, boost::normal_distribution<> >
+        noise_rng( eng, boost::normal_distribution<>( 0.0, 0.1 ) );
+
+    const int moved = 3;
+
+    for ( int mode = 0; mode < 2; ++mode )
     {
+        rcsc::ConvexHull c( points );
+        c.computeMonotoneChain();
+
         timeval start;
         if ( ::gettimeofday( &start, NULL ) == -1 )
         {
             std::perror( "gettimeofday" );
         }
 
-        c0.computeWrappingMethod();
+        for ( int i = 0; i < loop; ++i )
+        {
+            for ( int m = 0; m < moved; ++m )
+            {
+                const size_t idx = index_rng();
+                const rcsc::Vector2D p = c.inputPoints()[idx]
+                    + rcsc::Vector2D( noise_rng(), noise_rng() );
+                c.setPoint( idx, p );
+            }
+
+            if ( mode == 0 )
+            {
+                // rebuild from scratch
+                rcsc::ConvexHull tmp( c.inputPoints() );
+                tmp.computeMonotoneChain();
+            }
+            else
+            {
+                c.computeMonotoneChain();
+            }
+        }
 
         timeval end;
         if ( ::gettimeofday( &end, NULL ) == -1 )
@@ -104,44 +172,79 @@ main()
             std::perror( "gettimeofday" );
         }
 
-        std::cout << "WrappingMethod\n"
-                  << "  points = " << c0.inputPoints().size() << '\n'
-                  << "  vertices = " << c0.vertices().size() << '\n'
-                  << "  edges = " << c0.edges().size() << '\n';
+        std::cout << ( mode == 0
+                       ? "MonotoneChain rebuild"
+                       : "MonotoneChain presorted update" )
+                  << '\n'
+                  << "  points = " << c.inputPoints().size() << '\n'
+                  << "  moved points = " << moved << '\n'
+                  << "  loop = " << loop << '\n';
 
         print_elapsed( start, end );
     }
+}
 
+int
+main()
+{
+    boost::mt19937 eng( std::time( 0 ) );
+
+    const int loop = 100;
 
+    //
+    // uniform random points
+    //
+    std::vector< rcsc::Vector2D > random_points;
     {
-        timeval start;
-        if ( ::gettimeofday( &start, NULL ) == -1 )
+        boost::variate_generator< boost::mt19937&, boost::uniform_real<> >
+            x_rng( eng, boost::uniform_real<>( -10.0, 10.0 ) );
+        boost::variate_generator< boost::mt19937&, boost::uniform_real<> >
+            y_rng( eng, boost::uniform_real<>( -10.0, 10.0 ) );
+
+        for ( int i = 0; i < 1000; ++i )
         {
-            std::perror( "gettimeofday" );
+            random_points.push_back( rcsc::Vector2D( x_rng(), y_rng() ) );
         }
+    }
 
-        c1.computeGrahamScan();
+    //
+    // clustered points, i.e. several groups of players
+    //
+    std::vector< rcsc::Vector2D > clustered_points;
+    {
+        boost::variate_generator< boost::mt19937&, boost::uniform_real<> >
+            center_rng( eng, boost::uniform_real<>( -10.0, 10.0 ) );
+        boost::variate_generator< boost::mt19937&, boost::normal_distribution<> >
+            offset_rng( eng, boost::normal_distribution<>( 0.0, 0.5 ) );
 
-        timeval end;
-        if ( ::gettimeofday( &end, NULL ) == -1 )
+        for ( int c = 0; c < 10; ++c )
         {
-            std::perror( "gettimeofday" );
+            const rcsc::Vector2D center( center_rng(), center_rng() );
+            for ( int i = 0; i < 100; ++i )
+            {
+                clustered_points.push_back( center
+                                            + rcsc::Vector2D( offset_rng(), offset_rng() ) );
+            }
         }
+    }
 
-        std::cout << "GrahamScan\n"
-                  << "  points = " << c1.inputPoints().size() << '\n'
-                  << "  vertices = " << c1.vertices().size() << '\n'
-                  << "  edges = " << c1.edges().size() << '\n';
+    std::cout << "---------- uniform random points ----------" << std::endl;
+    benchmark_all( random_points, loop );
 
-        print_elapsed( start, end );
-    }
+    std::cout << "---------- clustered points ----------" << std::endl;
+    benchmark_all( clustered_points, loop );
+
+    std::cout << "---------- few points moved ----------" << std::endl;
+    benchmark_update( random_points, loop * 10 );
 
+    rcsc::ConvexHull c( clustered_points );
+    c.compute();
 
     std::ofstream point_file( "points.dat" );
     std::ofstream edge_file( "edges.dat" );
 
-    c1.printInputPoints( point_file );
-    c1.printEdges( edge_file );
+    c.printInputPoints( point_file );
+    c.printEdges( edge_file );
 
     /*
       > gnuplot
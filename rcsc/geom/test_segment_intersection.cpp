@@ -0,0 +1,388 @@
+// -*-c++-*-
+
+/*!
+  \file test_segment_intersection.cpp
+  \brief test code for rcsc::SegmentIntersection
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "segment_intersection.h"
+#include "segment_2d.h"
+#include "line_2d.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <boost/random.hpp>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using rcsc::Vector2D;
+using rcsc::Line2D;
+using rcsc::Segment2D;
+using rcsc::SegmentIntersection;
+
+namespace {
+
+const double DISTANCE = 1.0e-6;
+
+inline
+bool
+in_distance( const double & x,
+             const double & y )
+{
+    return std::fabs( x - y ) < DISTANCE;
+}
+
+/*!
+  \brief all pairs check by the original predicate.
+*/
+bool
+brute_force( const std::vector< Segment2D > & segments )
+{
+    for ( size_t i = 0; i < segments.size(); ++i )
+    {
+        for ( size_t j = i + 1; j < segments.size(); ++j )
+        {
+            if ( segments[i].existIntersectionExceptEndpoint( segments[j] ) )
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}
+
+
+/*!
+  \class SegmentIntersectionTest
+ */
+class SegmentIntersectionTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( SegmentIntersectionTest );
+    CPPUNIT_TEST( testSegmentLine );
+    CPPUNIT_TEST( testSegmentSegment );
+    CPPUNIT_TEST( testSweep );
+    CPPUNIT_TEST( testSweepRandom );
+    CPPUNIT_TEST( testIntersectSets );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void setUp();
+    void tearDown();
+
+protected:
+
+    void testSegmentLine();
+    void testSegmentSegment();
+    void testSweep();
+    void testSweepRandom();
+    void testIntersectSets();
+};
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SegmentIntersectionTest );
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SegmentIntersectionTest::setUp()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SegmentIntersectionTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SegmentIntersectionTest::testSegmentLine()
+{
+    boost::mt19937 gen( 1 );
+    boost::uniform_real<> dst( -50.0, 50.0 );
+    boost::variate_generator< boost::mt19937 &, boost::uniform_real<> > rng( gen, dst );
+
+    for ( int i = 0; i < 1000; ++i )
+    {
+        const Vector2D s0( rng(), rng() );
+        const Vector2D s1( rng(), rng() );
+        const Vector2D l0( rng(), rng() );
+        const Vector2D l1( rng(), rng() );
+
+        const Vector2D expected = Segment2D( s0, s1 ).intersection( Line2D( l0, l1 ) );
+
+        Vector2D sol;
+        const bool result = SegmentIntersection::segment_line( s0, s1, l0, l1, &sol );
+
+        CPPUNIT_ASSERT_EQUAL( expected.isValid(), result );
+        if ( result )
+        {
+            CPPUNIT_ASSERT( in_distance( expected.x, sol.x ) );
+            CPPUNIT_ASSERT( in_distance( expected.y, sol.y ) );
+        }
+    }
+
+    // parallel
+    CPPUNIT_ASSERT( ! SegmentIntersection::segment_line( Vector2D( 0.0, 0.0 ),
+                                                         Vector2D( 10.0, 0.0 ),
+                                                         Vector2D( 0.0, 1.0 ),
+                                                         Vector2D( 10.0, 1.0 ),
+                                                         static_cast< Vector2D * >( 0 ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SegmentIntersectionTest::testSegmentSegment()
+{
+    Vector2D sol;
+
+    CPPUNIT_ASSERT( SegmentIntersection::segment_segment( Vector2D( -1.0, -1.0 ),
+                                                          Vector2D( 1.0, 1.0 ),
+                                                          Vector2D( -1.0, 1.0 ),
+                                                          Vector2D( 1.0, -1.0 ),
+                                                          &sol ) );
+    CPPUNIT_ASSERT( in_distance( sol.x, 0.0 ) );
+    CPPUNIT_ASSERT( in_distance( sol.y, 0.0 ) );
+
+    // touching at the end point
+    CPPUNIT_ASSERT( SegmentIntersection::segment_segment( Vector2D( 0.0, 0.0 ),
+                                                          Vector2D( 2.0, 0.0 ),
+                                                          Vector2D( 1.0, 0.0 ),
+                                                          Vector2D( 1.0, 5.0 ),
+                                                          &sol ) );
+    CPPUNIT_ASSERT( in_distance( sol.x, 1.0 ) );
+    CPPUNIT_ASSERT( in_distance( sol.y, 0.0 ) );
+    CPPUNIT_ASSERT( ! SegmentIntersection::exist_intersection_except_endpoint( Vector2D( 0.0, 0.0 ),
+                                                                               Vector2D( 2.0, 0.0 ),
+                                                                               Vector2D( 1.0, 0.0 ),
+                                                                               Vector2D( 1.0, 5.0 ) ) );
+
+    // apart
+    CPPUNIT_ASSERT( ! SegmentIntersection::segment_segment( Vector2D( 0.0, 0.0 ),
+                                                            Vector2D( 2.0, 0.0 ),
+                                                            Vector2D( 3.0, -1.0 ),
+                                                            Vector2D( 3.0, 1.0 ),
+                                                            &sol ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SegmentIntersectionTest::testSweep()
+{
+    SegmentIntersection s;
+    CPPUNIT_ASSERT( ! s.existIntersectionExceptEndpoint() );
+
+    // polyline that shares end points
+    s.add( Vector2D( 0.0, 0.0 ), Vector2D( 10.0, 0.0 ) );
+    s.add( Vector2D( 10.0, 0.0 ), Vector2D( 10.0, 10.0 ) );
+    s.add( Vector2D( 10.0, 10.0 ), Vector2D( 0.0, 10.0 ) );
+    s.add( Vector2D( 0.0, 10.0 ), Vector2D( 0.0, 0.0 ) );
+    s.add( Vector2D( 0.0, 0.0 ), Vector2D( 10.0, 10.0 ) );
+    CPPUNIT_ASSERT( ! s.existIntersectionExceptEndpoint() );
+
+    // T junction is not a crossing
+    s.add( Vector2D( 5.0, 0.0 ), Vector2D( 5.0, -5.0 ) );
+    CPPUNIT_ASSERT( ! s.existIntersectionExceptEndpoint() );
+
+    // vertical segment crosses the diagonal
+    s.add( Vector2D( 3.0, 1.0 ), Vector2D( 3.0, 9.0 ) );
+    CPPUNIT_ASSERT( s.existIntersectionExceptEndpoint() );
+
+    s.clear();
+    CPPUNIT_ASSERT( s.empty() );
+
+    // crossing between segments that are not adjacent at the insertion
+    s.add( Vector2D( 0.0, 0.0 ), Vector2D( 20.0, 10.0 ) );
+    s.add( Vector2D( 1.0, 5.0 ), Vector2D( 20.0, 5.0 ) );
+    s.add( Vector2D( 2.0, 1.0 ), Vector2D( 3.0, 1.0 ) );
+    CPPUNIT_ASSERT( s.existIntersectionExceptEndpoint() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SegmentIntersectionTest::testSweepRandom()
+{
+    boost::mt19937 gen( 12345 );
+    boost::uniform_int<> dst( -10, 10 );
+    boost::variate_generator< boost::mt19937 &, boost::uniform_int<> > rng( gen, dst );
+
+    int crossed = 0;
+    for ( int trial = 0; trial < 2000; ++trial )
+    {
+        // integer grid points make many degenerate cases,
+        // e.g. shared end points, vertical segments and collinear segments.
+        std::vector< Vector2D > points;
+        for ( int i = 0; i < 8; ++i )
+        {
+            points.push_back( Vector2D( rng(), rng() ) );
+        }
+
+        std::vector< Segment2D > segments;
+        SegmentIntersection s;
+
+        const int n = 2 + ( trial % 5 );
+        for ( int i = 0; i < n; ++i )
+        {
+            const Vector2D & p0 = points[( rng() + 10 ) % points.size()];
+            const Vector2D & p1 = points[( rng() + 10 ) % points.size()];
+            segments.push_back( Segment2D( p0, p1 ) );
+            s.add( p0, p1 );
+        }
+
+        const bool expected = brute_force( segments );
+        CPPUNIT_ASSERT_EQUAL( expected, s.existIntersectionExceptEndpoint() );
+        if ( expected ) ++crossed;
+    }
+
+    // both results must be tested.
+    CPPUNIT_ASSERT( crossed > 0 );
+    CPPUNIT_ASSERT( crossed < 2000 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SegmentIntersectionTest::testIntersectSets()
+{
+    boost::mt19937 gen( 7 );
+    boost::uniform_real<> dst( -20.0, 20.0 );
+    boost::variate_generator< boost::mt19937 &, boost::uniform_real<> > rng( gen, dst );
+
+    std::vector< Segment2D > a_segments;
+    std::vector< Segment2D > b_segments;
+    SegmentIntersection a;
+    SegmentIntersection b;
+
+    for ( int i = 0; i < 50; ++i )
+    {
+        const Vector2D p0( rng(), rng() );
+        const Vector2D p1 = p0 + Vector2D( rng(), rng() ) * 0.2;
+        a_segments.push_back( Segment2D( p0, p1 ) );
+        a.add( p0, p1 );
+    }
+
+    for ( int i = 0; i < 30; ++i )
+    {
+        const Vector2D p0( rng(), rng() );
+        const Vector2D p1 = p0 + Vector2D( rng(), rng() ) * 0.2;
+        b_segments.push_back( Segment2D( p0, p1 ) );
+        b.add( p0, p1 );
+    }
+
+    std::vector< SegmentIntersection::IndexPair > pairs;
+    const size_t count = a.intersect( b, pairs );
+
+    size_t expected = 0;
+    for ( size_t i = 0; i < a_segments.size(); ++i )
+    {
+        for ( size_t j = 0; j < b_segments.size(); ++j )
+        {
+            if ( a_segments[i].existIntersection( b_segments[j] ) )
+            {
+                ++expected;
+                CPPUNIT_ASSERT( std::find( pairs.begin(), pairs.end(),
+                                           SegmentIntersection::IndexPair( i, j ) )
+                                != pairs.end() );
+            }
+        }
+    }
+
+    CPPUNIT_ASSERT( expected > 0 );
+    CPPUNIT_ASSERT_EQUAL( expected, count );
+    CPPUNIT_ASSERT_EQUAL( expected, pairs.size() );
+}
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
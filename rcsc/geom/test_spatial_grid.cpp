@@ -0,0 +1,388 @@
+// -*-c++-*-
+
+/*!
+  \file test_spatial_grid.cpp
+  \brief test code for rcsc::SpatialGrid
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "spatial_grid.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <boost/random.hpp>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using rcsc::Vector2D;
+
+typedef rcsc::SpatialGrid< int > Grid;
+
+namespace {
+
+/*!
+  \brief find the nearest point by the linear scan.
+*/
+int
+linear_nearest( const std::vector< Vector2D > & points,
+                const std::vector< bool > & alive,
+                const Vector2D & p )
+{
+    int index = -1;
+    double min_d2 = 1.0e100;
+    for ( size_t i = 0; i < points.size(); ++i )
+    {
+        if ( ! alive[i] ) continue;
+        const double d2 = points[i].dist2( p );
+        if ( d2 < min_d2 )
+        {
+            min_d2 = d2;
+            index = static_cast< int >( i );
+        }
+    }
+    return index;
+}
+
+}
+
+
+/*!
+  \class SpatialGridTest
+ */
+class SpatialGridTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( SpatialGridTest );
+    CPPUNIT_TEST( testInsertRemove );
+    CPPUNIT_TEST( testNearest );
+    CPPUNIT_TEST( testNearestK );
+    CPPUNIT_TEST( testWithin );
+    CPPUNIT_TEST( testFarQuery );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+
+    std::vector< Vector2D > M_points;
+
+public:
+
+    void setUp();
+    void tearDown();
+
+protected:
+
+    void testInsertRemove();
+    void testNearest();
+    void testNearestK();
+    void testWithin();
+    void testFarQuery();
+};
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SpatialGridTest );
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SpatialGridTest::setUp()
+{
+    boost::mt19937 gen( 3 );
+    boost::uniform_real<> dst( -52.5, 52.5 );
+    boost::variate_generator< boost::mt19937 &, boost::uniform_real<> > rng( gen, dst );
+
+    M_points.clear();
+    for ( int i = 0; i < 500; ++i )
+    {
+        M_points.push_back( Vector2D( rng(), rng() * 0.65 ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SpatialGridTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SpatialGridTest::testInsertRemove()
+{
+    Grid grid( 5.0 );
+    CPPUNIT_ASSERT( grid.empty() );
+
+    Grid::Handle h = 0;
+    CPPUNIT_ASSERT( ! grid.nearest( Vector2D( 0.0, 0.0 ), &h ) );
+
+    const Grid::Handle h0 = grid.insert( Vector2D( 1.0, 1.0 ), 10 );
+    const Grid::Handle h1 = grid.insert( Vector2D( -20.0, 3.0 ), 11 );
+    const Grid::Handle h2 = grid.insert( Vector2D( 30.0, -8.0 ), 12 );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), grid.size() );
+    CPPUNIT_ASSERT_EQUAL( 11, grid.value( h1 ) );
+
+    CPPUNIT_ASSERT( grid.nearest( Vector2D( -15.0, 0.0 ), &h ) );
+    CPPUNIT_ASSERT_EQUAL( h1, h );
+
+    // move h0 near the query point
+    CPPUNIT_ASSERT( grid.move( h0, Vector2D( -16.0, 0.0 ) ) );
+    CPPUNIT_ASSERT( grid.nearest( Vector2D( -15.0, 0.0 ), &h ) );
+    CPPUNIT_ASSERT_EQUAL( h0, h );
+
+    CPPUNIT_ASSERT( grid.remove( h0 ) );
+    CPPUNIT_ASSERT( ! grid.remove( h0 ) );
+    CPPUNIT_ASSERT( ! grid.valid( h0 ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 2 ), grid.size() );
+    CPPUNIT_ASSERT( grid.nearest( Vector2D( -15.0, 0.0 ), &h ) );
+    CPPUNIT_ASSERT_EQUAL( h1, h );
+
+    // removed handle is reused
+    const Grid::Handle h3 = grid.insert( Vector2D( 0.0, 0.0 ), 13 );
+    CPPUNIT_ASSERT_EQUAL( h0, h3 );
+    CPPUNIT_ASSERT_EQUAL( 13, grid.value( h3 ) );
+
+    // max distance
+    CPPUNIT_ASSERT( ! grid.nearest( Vector2D( 100.0, 100.0 ), &h,
+                                    static_cast< double * >( 0 ), 10.0 ) );
+    CPPUNIT_ASSERT( grid.nearest( Vector2D( 31.0, -8.0 ), &h,
+                                  static_cast< double * >( 0 ), 10.0 ) );
+    CPPUNIT_ASSERT_EQUAL( h2, h );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SpatialGridTest::testNearest()
+{
+    const double cell_sizes[] = { 0.5, 4.0, 30.0 };
+
+    boost::mt19937 gen( 4 );
+    boost::uniform_real<> dst( -70.0, 70.0 );
+    boost::variate_generator< boost::mt19937 &, boost::uniform_real<> > rng( gen, dst );
+
+    for ( int c = 0; c < 3; ++c )
+    {
+        Grid grid( cell_sizes[c] );
+        std::vector< Grid::Handle > handles;
+        std::vector< bool > alive( M_points.size(), true );
+
+        for ( size_t i = 0; i < M_points.size(); ++i )
+        {
+            handles.push_back( grid.insert( M_points[i], static_cast< int >( i ) ) );
+        }
+
+        // remove and move some points
+        for ( size_t i = 0; i < M_points.size(); i += 7 )
+        {
+            grid.remove( handles[i] );
+            alive[i] = false;
+        }
+
+        std::vector< Vector2D > points = M_points;
+        for ( size_t i = 3; i < points.size(); i += 11 )
+        {
+            if ( ! alive[i] ) continue;
+            points[i] = Vector2D( rng(), rng() );
+            grid.move( handles[i], points[i] );
+        }
+
+        for ( int i = 0; i < 300; ++i )
+        {
+            const Vector2D p( rng(), rng() );
+
+            Grid::Handle h = 0;
+            double d2 = 0.0;
+            CPPUNIT_ASSERT( grid.nearest( p, &h, &d2 ) );
+
+            const int expected = linear_nearest( points, alive, p );
+            CPPUNIT_ASSERT_EQUAL( expected, grid.value( h ) );
+            CPPUNIT_ASSERT( std::fabs( d2 - points[expected].dist2( p ) ) < 1.0e-9 );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SpatialGridTest::testNearestK()
+{
+    Grid grid( 3.0 );
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        grid.insert( M_points[i], static_cast< int >( i ) );
+    }
+
+    const Vector2D p( 10.0, -5.0 );
+
+    std::vector< std::pair< double, int > > expected;
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        expected.push_back( std::make_pair( M_points[i].dist2( p ), static_cast< int >( i ) ) );
+    }
+    std::sort( expected.begin(), expected.end() );
+
+    std::vector< Grid::Handle > result;
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 10 ), grid.nearest( p, 10, result ) );
+    for ( size_t i = 0; i < 10; ++i )
+    {
+        CPPUNIT_ASSERT_EQUAL( expected[i].second, grid.value( result[i] ) );
+    }
+
+    // k is larger than the number of points
+    CPPUNIT_ASSERT_EQUAL( M_points.size(), grid.nearest( p, 1000, result ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SpatialGridTest::testWithin()
+{
+    Grid grid( 2.0 );
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        grid.insert( M_points[i], static_cast< int >( i ) );
+    }
+
+    const Vector2D center( -3.0, 2.0 );
+    const double radius = 9.0;
+
+    std::vector< Grid::Handle > result;
+    const size_t count = grid.within( center, radius, result );
+
+    std::vector< int > found;
+    for ( size_t i = 0; i < result.size(); ++i )
+    {
+        found.push_back( grid.value( result[i] ) );
+    }
+    std::sort( found.begin(), found.end() );
+
+    std::vector< int > expected;
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        if ( M_points[i].dist2( center ) < radius * radius )
+        {
+            expected.push_back( static_cast< int >( i ) );
+        }
+    }
+
+    CPPUNIT_ASSERT( ! expected.empty() );
+    CPPUNIT_ASSERT_EQUAL( expected.size(), count );
+    CPPUNIT_ASSERT( found == expected );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SpatialGridTest::testFarQuery()
+{
+    Grid grid( 0.5 );
+    grid.setLinearScanSize( 0 );
+
+    std::vector< bool > alive( M_points.size(), true );
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        grid.insert( M_points[i], static_cast< int >( i ) );
+    }
+
+    // the query cells are far from the registered cells,
+    // and some of them are out of the range of the cell index.
+    const Vector2D queries[] = { Vector2D( 1.0e6, 3.0 ),
+                                 Vector2D( -2.0e7, -4.0e7 ),
+                                 Vector2D( 10.0, 5.0e9 ),
+                                 Vector2D( -1.0e12, 1.0e12 ) };
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        Grid::Handle h = 0;
+        CPPUNIT_ASSERT( grid.nearest( queries[i], &h ) );
+        CPPUNIT_ASSERT_EQUAL( linear_nearest( M_points, alive, queries[i] ), grid.value( h ) );
+
+        std::vector< Grid::Handle > result;
+        CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), grid.nearest( queries[i], 3, result ) );
+        CPPUNIT_ASSERT_EQUAL( grid.value( h ), grid.value( result[0] ) );
+    }
+}
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
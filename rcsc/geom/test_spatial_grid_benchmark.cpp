@@ -0,0 +1,163 @@
+// -*-c++-*-
+
+/*!
+  \file test_spatial_grid_benchmark.cpp
+  \brief benchmark of rcsc::SpatialGrid
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "spatial_grid.h"
+#include "vector_2d_array.h"
+
+#include <boost/random.hpp>
+
+#include <iostream>
+#include <vector>
+#include <ctime>
+#include <cstdio>
+
+#include <sys/time.h> // struct timeval, gettimeofday()
+
+double
+elapsed_usec( const timeval & start,
+              const timeval & end )
+{
+    return ( end.tv_sec - start.tv_sec ) * 1000.0 * 1000.0
+        + ( end.tv_usec - start.tv_usec );
+}
+
+/*!
+  \brief compare the nearest point search by the linear scan and the grid.
+  \param points registered points
+  \param queries query points
+  \param loop the number of repetition
+*/
+void
+benchmark( const std::vector< rcsc::Vector2D > & points,
+           const std::vector< rcsc::Vector2D > & queries,
+           const int loop )
+{
+    const rcsc::Vector2DArray array( points );
+
+    rcsc::SpatialGrid< int > grid( rcsc::SpatialGrid< int >::suggest_cell_size( 105.0, 68.0,
+                                                                                points.size() ) );
+    // measure the grid itself
+    grid.setLinearScanSize( 0 );
+
+    for ( size_t i = 0; i < points.size(); ++i )
+    {
+        grid.insert( points[i], static_cast< int >( i ) );
+    }
+
+    long check_sum_linear = 0;
+    long check_sum_grid = 0;
+
+    timeval start, end;
+
+    //
+    // linear scan
+    //
+    ::gettimeofday( &start, NULL );
+    for ( int l = 0; l < loop; ++l )
+    {
+        for ( std::vector< rcsc::Vector2D >::const_iterator q = queries.begin();
+              q != queries.end();
+              ++q )
+        {
+            check_sum_linear += array.nearest( *q );
+        }
+    }
+    ::gettimeofday( &end, NULL );
+    const double linear_usec = elapsed_usec( start, end );
+
+    //
+    // grid
+    //
+    ::gettimeofday( &start, NULL );
+    for ( int l = 0; l < loop; ++l )
+    {
+        for ( std::vector< rcsc::Vector2D >::const_iterator q = queries.begin();
+              q != queries.end();
+              ++q )
+        {
+            rcsc::SpatialGrid< int >::Handle h = 0;
+            if ( grid.nearest( *q, &h ) )
+            {
+                check_sum_grid += grid.value( h );
+            }
+        }
+    }
+    ::gettimeofday( &end, NULL );
+    const double grid_usec = elapsed_usec( start, end );
+
+    const double n_query = static_cast< double >( loop ) * queries.size();
+
+    std::printf( "%6d  linear %8.1f [ns/query]  grid %8.1f [ns/query]  %s%s\n",
+                 static_cast< int >( points.size() ),
+                 linear_usec * 1000.0 / n_query,
+                 grid_usec * 1000.0 / n_query,
+                 ( grid_usec < linear_usec ? "grid" : "linear" ),
+                 ( check_sum_linear == check_sum_grid ? "" : "  *** result mismatch ***" ) );
+}
+
+int
+main()
+{
+    boost::mt19937 eng( std::time( 0 ) );
+
+    boost::variate_generator< boost::mt19937&, boost::uniform_real<> >
+        x_rng( eng, boost::uniform_real<>( -52.5, 52.5 ) );
+    boost::variate_generator< boost::mt19937&, boost::uniform_real<> >
+        y_rng( eng, boost::uniform_real<>( -34.0, 34.0 ) );
+
+    std::vector< rcsc::Vector2D > queries;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        queries.push_back( rcsc::Vector2D( x_rng(), y_rng() ) );
+    }
+
+    //
+    // points uniformly distributed in the field
+    //
+    std::cout << "nearest point search. points are uniformly distributed in the field."
+              << std::endl;
+
+    const int sizes[] = { 4, 8, 11, 16, 22, 32, 48, 64, 96, 128, 256, 512, 1024, 4096 };
+    for ( size_t s = 0; s < sizeof( sizes ) / sizeof( int ); ++s )
+    {
+        std::vector< rcsc::Vector2D > points;
+        for ( int i = 0; i < sizes[s]; ++i )
+        {
+            points.push_back( rcsc::Vector2D( x_rng(), y_rng() ) );
+        }
+
+        benchmark( points, queries, std::max( 1, 100000 / sizes[s] ) );
+    }
+
+    return 0;
+}
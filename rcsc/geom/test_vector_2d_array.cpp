@@ -0,0 +1,313 @@
+// -*-c++-*-
+
+/*!
+  \file test_vector_2d_array.cpp
+  \brief test code for rcsc::Vector2DArray
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "vector_2d_array.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <iostream>
+#include <cmath>
+
+using rcsc::Vector2D;
+using rcsc::Vector2DArray;
+
+namespace {
+
+const double DISTANCE = 1.0e-6;
+
+inline
+bool
+in_distance( const double & x,
+             const double & y )
+{
+    return std::fabs( x - y ) < DISTANCE;
+}
+
+}
+
+
+/*!
+  \class Vector2DArrayTest
+ */
+class Vector2DArrayTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( Vector2DArrayTest );
+    CPPUNIT_TEST( testAssign );
+    CPPUNIT_TEST( testDistance );
+    CPPUNIT_TEST( testRotate );
+    CPPUNIT_TEST( testNearest );
+    CPPUNIT_TEST( testWithin );
+    CPPUNIT_TEST( testOuterProduct );
+    CPPUNIT_TEST( testPolar );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+
+    std::vector< Vector2D > M_points;
+
+public:
+
+    void setUp();
+    void tearDown();
+
+protected:
+
+    void testAssign();
+    void testDistance();
+    void testRotate();
+    void testNearest();
+    void testWithin();
+    void testOuterProduct();
+    void testPolar();
+};
+
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( Vector2DArrayTest );
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::setUp()
+{
+    M_points.clear();
+    M_points.push_back( Vector2D( 1.0, -2.0 ) );
+    M_points.push_back( Vector2D( -3.5, 4.5 ) );
+    M_points.push_back( Vector2D( 10.0, 0.0 ) );
+    M_points.push_back( Vector2D( 0.5, 0.5 ) );
+    M_points.push_back( Vector2D( -7.0, -7.0 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::tearDown()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::testAssign()
+{
+    Vector2DArray a0;
+    CPPUNIT_ASSERT( a0.empty() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), a0.size() );
+    CPPUNIT_ASSERT_EQUAL( -1, a0.nearest( Vector2D( 0.0, 0.0 ) ) );
+
+    const Vector2DArray a1( M_points );
+    CPPUNIT_ASSERT_EQUAL( M_points.size(), a1.size() );
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        CPPUNIT_ASSERT( a1[i] == M_points[i] );
+    }
+
+    std::vector< Vector2D > v;
+    a1.copyTo( v );
+    CPPUNIT_ASSERT( v.size() == M_points.size() );
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        CPPUNIT_ASSERT( v[i].equals( M_points[i] ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::testDistance()
+{
+    const Vector2DArray a( M_points );
+    const Vector2D p( 2.0, -1.0 );
+
+    std::vector< double > d2;
+    a.dist2( p, d2 );
+
+    CPPUNIT_ASSERT_EQUAL( M_points.size(), d2.size() );
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        CPPUNIT_ASSERT( in_distance( d2[i], M_points[i].dist2( p ) ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::testRotate()
+{
+    Vector2DArray a( M_points );
+    a.rotate( 30.0 ).translate( Vector2D( 1.0, 2.0 ) );
+
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        const Vector2D expected = M_points[i].rotatedVector( 30.0 ) + Vector2D( 1.0, 2.0 );
+        CPPUNIT_ASSERT( in_distance( a.x( i ), expected.x ) );
+        CPPUNIT_ASSERT( in_distance( a.y( i ), expected.y ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::testNearest()
+{
+    const Vector2DArray a( M_points );
+
+    double d2 = 0.0;
+    CPPUNIT_ASSERT_EQUAL( 3, a.nearest( Vector2D( 0.0, 0.0 ), &d2 ) );
+    CPPUNIT_ASSERT( in_distance( d2, 0.5 ) );
+    CPPUNIT_ASSERT_EQUAL( 2, a.nearest( Vector2D( 100.0, 0.0 ) ) );
+    CPPUNIT_ASSERT_EQUAL( 4, a.nearest( Vector2D( -6.0, -8.0 ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::testWithin()
+{
+    const Vector2DArray a( M_points );
+
+    std::vector< size_t > result;
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 2 ),
+                          a.within( Vector2D( 0.0, 0.0 ), 3.0, result ) );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 0 ), result[0] );
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), result[1] );
+
+    CPPUNIT_ASSERT( a.existWithin( Vector2D( 10.0, 0.5 ), 1.0 ) );
+    CPPUNIT_ASSERT( ! a.existWithin( Vector2D( 20.0, 20.0 ), 1.0 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::testOuterProduct()
+{
+    const Vector2DArray a( M_points );
+    const Vector2D origin( 1.0, 1.0 );
+    const Vector2D v( -2.0, 3.0 );
+
+    std::vector< double > result;
+    a.outerProduct( v, result );
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        CPPUNIT_ASSERT( in_distance( result[i], M_points[i].outerProduct( v ) ) );
+    }
+
+    a.outerProduct( origin, v, result );
+    for ( size_t i = 0; i < M_points.size(); ++i )
+    {
+        CPPUNIT_ASSERT( in_distance( result[i], ( M_points[i] - origin ).outerProduct( v ) ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArrayTest::testPolar()
+{
+    std::vector< double > mag;
+    std::vector< double > deg;
+    mag.push_back( 1.0 ); deg.push_back( 0.0 );
+    mag.push_back( 2.0 ); deg.push_back( 90.0 );
+    mag.push_back( 3.0 ); deg.push_back( -135.0 );
+
+    Vector2DArray a;
+    Vector2DArray::polar2vector( mag, deg, a );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< size_t >( 3 ), a.size() );
+    for ( size_t i = 0; i < a.size(); ++i )
+    {
+        const Vector2D expected = Vector2D::polar2vector( mag[i], deg[i] );
+        CPPUNIT_ASSERT( in_distance( a.x( i ), expected.x ) );
+        CPPUNIT_ASSERT( in_distance( a.y( i ), expected.y ) );
+    }
+}
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
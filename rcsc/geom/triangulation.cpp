@@ -33,9 +33,12 @@
 
 #include "triangulation.h"
 
+#include "predicates_2d.h"
+
 #include "triangle/triangle.h"
 
 #include <vector>
+#include <algorithm>
 #include <limits>
 #include <cstddef>
 #include <cstdlib>
@@ -61,6 +64,7 @@ Triangulation::clear()
     clearResults();
 
     M_points.clear();
+    M_point_grid.clear();
     M_constraints.clear();
 }
 
@@ -92,6 +96,7 @@ Triangulation::addPoint( const Vector2D & p )
     M_point_set.insert( p );
 #endif
 
+    M_point_grid.insert( p, static_cast< int >( M_points.size() ) );
     M_points.push_back( p );
     return true;
 }
@@ -127,7 +132,14 @@ Triangulation::addPoints( const PointCont & v )
     return size;
 #else
 
-    M_points.insert( M_points.end(), v.begin(), v.end() );
+    M_points.reserve( M_points.size() + v.size() );
+    for ( PointCont::const_iterator p = v.begin();
+          p != v.end();
+          ++p )
+    {
+        M_point_grid.insert( *p, static_cast< int >( M_points.size() ) );
+        M_points.push_back( *p );
+    }
     return v.size();
 #endif
 }
@@ -167,6 +179,26 @@ Triangulation::compute()
     const PointCont & points = M_points;
     const size_t points_size = points.size();
 
+    //
+    // adjust the cell size of the point index to the point distribution
+    //
+    if ( points_size > 0 )
+    {
+        Vector2D min_pos = points.front();
+        Vector2D max_pos = points.front();
+        for ( size_t i = 1; i < points_size; ++i )
+        {
+            min_pos.x = std::min( min_pos.x, points[i].x );
+            min_pos.y = std::min( min_pos.y, points[i].y );
+            max_pos.x = std::max( max_pos.x, points[i].x );
+            max_pos.y = std::max( max_pos.y, points[i].y );
+        }
+
+        M_point_grid.setCellSize( SpatialGrid< int >::suggest_cell_size( max_pos.x - min_pos.x,
+                                                                         max_pos.y - min_pos.y,
+                                                                         points_size ) );
+    }
+
     const SegmentSet & constraints = M_constraints;
     const size_t constraints_size = constraints.size();
 
@@ -350,16 +382,22 @@ Triangulation::findTriangleContains( const Vector2D & point ) const
           t != t_end;
           ++t )
     {
-        Vector2D rel1( points[t->v0_] - point );
-        Vector2D rel2( points[t->v1_] - point );
-        Vector2D rel3( points[t->v2_] - point );
-
-        double outer1 = rel1.outerProduct( rel2 );
-        double outer2 = rel2.outerProduct( rel3 );
-        double outer3 = rel3.outerProduct( rel1 );
+        const Vector2D & p0 = points[t->v0_];
+        const Vector2D & p1 = points[t->v1_];
+        const Vector2D & p2 = points[t->v2_];
+
+        // the point on the edge is also contained.
+        const double o0 = Predicates2D::orient_2d( p0, p1, point );
+        const double o1 = Predicates2D::orient_2d( p1, p2, point );
+        if ( ( o0 > 0.0 && o1 < 0.0 )
+             || ( o0 < 0.0 && o1 > 0.0 ) )
+        {
+            continue;
+        }
 
-        if ( ( outer1 >= -1.0e-9 && outer2 >= -1.0e-9 && outer3 >= -1.0e-9 )
-             || ( outer1 <= 1.0e-9 && outer2 <= 1.0e-9 && outer3 <= 1.0e-9 ) )
+        const double o2 = Predicates2D::orient_2d( p2, p0, point );
+        if ( ( o0 >= 0.0 && o1 >= 0.0 && o2 >= 0.0 )
+             || ( o0 <= 0.0 && o1 <= 0.0 && o2 <= 0.0 ) )
         {
             return &(*t);
         }
@@ -376,24 +414,13 @@ Triangulation::findTriangleContains( const Vector2D & point ) const
 int
 Triangulation::findNearestPoint( const Vector2D & point ) const
 {
-    int index = -1;
-    double min_dist2 = std::numeric_limits< double >::max();
-
-    const PointCont::const_iterator p_end = M_points.end();
-    int i = 0;
-    for ( PointCont::const_iterator p = M_points.begin();
-          p != p_end;
-          ++p, ++i )
+    SpatialGrid< int >::Handle h = 0;
+    if ( ! M_point_grid.nearest( point, &h ) )
     {
-        double d2 = p->dist2( point );
-        if ( d2 < min_dist2 )
-        {
-            min_dist2 = d2;
-            index = i;
-        }
+        return -1;
     }
 
-    return index;
+    return M_point_grid.value( h );
 }
 
 }
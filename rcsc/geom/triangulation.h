@@ -31,6 +31,7 @@
 #define RCSC_GEOM_TRIANGULATION_USING_TRIANGLE_H
 
 #include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/spatial_grid.h>
 
 #include <vector>
 #include <set>
@@ -83,6 +84,7 @@ private:
 #endif
 
     PointCont M_points; //! input points
+    SpatialGrid< int > M_point_grid; //!< index of input points, used by the search methods. payload is the point index.
     SegmentSet M_constraints; //!< input constraint segments
 
     TriangleCont M_triangles; //!< result triangles
@@ -0,0 +1,360 @@
+// -*-c++-*-
+
+/*!
+  \file vector_2d_array.cpp
+  \brief structure-of-arrays 2d point container Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "vector_2d_array.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2DArray &
+Vector2DArray::assign( const std::vector< Vector2D > & v )
+{
+    const std::size_t size = v.size();
+
+    M_x.resize( size );
+    M_y.resize( size );
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        M_x[i] = v[i].x;
+        M_y[i] = v[i].y;
+    }
+
+    return *this;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArray::copyTo( std::vector< Vector2D > & v ) const
+{
+    const std::size_t size = M_x.size();
+
+    v.resize( size );
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        v[i].x = M_x[i];
+        v[i].y = M_y[i];
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2DArray &
+Vector2DArray::translate( const Vector2D & v )
+{
+    const std::size_t size = M_x.size();
+    double * xs = ( size > 0 ? &M_x[0] : static_cast< double * >( 0 ) );
+    double * ys = ( size > 0 ? &M_y[0] : static_cast< double * >( 0 ) );
+    const double vx = v.x;
+    const double vy = v.y;
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        xs[i] += vx;
+        ys[i] += vy;
+    }
+
+    return *this;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2DArray &
+Vector2DArray::scale( const double & scalar )
+{
+    const std::size_t size = M_x.size();
+    double * xs = ( size > 0 ? &M_x[0] : static_cast< double * >( 0 ) );
+    double * ys = ( size > 0 ? &M_y[0] : static_cast< double * >( 0 ) );
+    const double s = scalar;
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        xs[i] *= s;
+        ys[i] *= s;
+    }
+
+    return *this;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Vector2DArray &
+Vector2DArray::rotate( const double & deg )
+{
+    // rotation matrix is computed only once for all elements.
+    const double c = std::cos( deg * AngleDeg::DEG2RAD );
+    const double s = std::sin( deg * AngleDeg::DEG2RAD );
+
+    const std::size_t size = M_x.size();
+    double * xs = ( size > 0 ? &M_x[0] : static_cast< double * >( 0 ) );
+    double * ys = ( size > 0 ? &M_y[0] : static_cast< double * >( 0 ) );
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        const double x = xs[i];
+        const double y = ys[i];
+        xs[i] = c * x - s * y;
+        ys[i] = s * x + c * y;
+    }
+
+    return *this;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArray::dist2( const Vector2D & p,
+                      std::vector< double > & result ) const
+{
+    const std::size_t size = M_x.size();
+
+    result.resize( size );
+
+    if ( size == 0 )
+    {
+        return;
+    }
+
+    const double * xs = &M_x[0];
+    const double * ys = &M_y[0];
+    double * r = &result[0];
+    const double px = p.x;
+    const double py = p.y;
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        const double dx = xs[i] - px;
+        const double dy = ys[i] - py;
+        r[i] = dx * dx + dy * dy;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArray::outerProduct( const Vector2D & v,
+                             std::vector< double > & result ) const
+{
+    outerProduct( Vector2D( 0.0, 0.0 ), v, result );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArray::outerProduct( const Vector2D & origin,
+                             const Vector2D & v,
+                             std::vector< double > & result ) const
+{
+    const std::size_t size = M_x.size();
+
+    result.resize( size );
+
+    if ( size == 0 )
+    {
+        return;
+    }
+
+    const double * xs = &M_x[0];
+    const double * ys = &M_y[0];
+    double * r = &result[0];
+    const double ox = origin.x;
+    const double oy = origin.y;
+    const double vx = v.x;
+    const double vy = v.y;
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        r[i] = ( xs[i] - ox ) * vy - ( ys[i] - oy ) * vx;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+Vector2DArray::nearest( const Vector2D & p,
+                        double * min_dist2 ) const
+{
+    const std::size_t size = M_x.size();
+
+    if ( size == 0 )
+    {
+        return -1;
+    }
+
+    const double * xs = &M_x[0];
+    const double * ys = &M_y[0];
+    const double px = p.x;
+    const double py = p.y;
+
+    int index = -1;
+    double min_d2 = std::numeric_limits< double >::max();
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        const double dx = xs[i] - px;
+        const double dy = ys[i] - py;
+        const double d2 = dx * dx + dy * dy;
+        if ( d2 < min_d2 )
+        {
+            min_d2 = d2;
+            index = static_cast< int >( i );
+        }
+    }
+
+    if ( min_dist2 )
+    {
+        *min_dist2 = min_d2;
+    }
+
+    return index;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+Vector2DArray::within( const Vector2D & center,
+                       const double & radius,
+                       std::vector< std::size_t > & result ) const
+{
+    const std::size_t size = M_x.size();
+
+    if ( size == 0 )
+    {
+        return 0;
+    }
+
+    const double * xs = &M_x[0];
+    const double * ys = &M_y[0];
+    const double cx = center.x;
+    const double cy = center.y;
+    const double r2 = radius * radius;
+
+    std::size_t count = 0;
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        const double dx = xs[i] - cx;
+        const double dy = ys[i] - cy;
+        if ( dx * dx + dy * dy < r2 )
+        {
+            result.push_back( i );
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+Vector2DArray::existWithin( const Vector2D & center,
+                            const double & radius ) const
+{
+    const std::size_t size = M_x.size();
+
+    if ( size == 0 )
+    {
+        return false;
+    }
+
+    const double * xs = &M_x[0];
+    const double * ys = &M_y[0];
+    const double cx = center.x;
+    const double cy = center.y;
+    const double r2 = radius * radius;
+
+    // no early exit, in order to keep the loop vectorizable.
+    int found = 0;
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        const double dx = xs[i] - cx;
+        const double dy = ys[i] - cy;
+        found |= ( dx * dx + dy * dy < r2 );
+    }
+
+    return found != 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Vector2DArray::polar2vector( const std::vector< double > & mag,
+                             const std::vector< double > & deg,
+                             Vector2DArray & result )
+{
+    const std::size_t size = std::min( mag.size(), deg.size() );
+
+    result.resize( size );
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        const double rad = deg[i] * AngleDeg::DEG2RAD;
+        result.M_x[i] = mag[i] * std::cos( rad );
+        result.M_y[i] = mag[i] * std::sin( rad );
+    }
+}
+
+}
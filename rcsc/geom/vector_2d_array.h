@@ -0,0 +1,337 @@
+// -*-c++-*-
+
+/*!
+  \file vector_2d_array.h
+  \brief structure-of-arrays 2d point container Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_GEOM_VECTOR2D_ARRAY_H
+#define RCSC_GEOM_VECTOR2D_ARRAY_H
+
+#include <rcsc/geom/vector_2d.h>
+
+#include <vector>
+#include <cstddef>
+
+namespace rcsc {
+
+/*!
+  \class Vector2DArray
+  \brief 2D point container that holds X and Y values in separated arrays.
+
+  Batch operations are written as plain loops over contiguous arrays,
+  so that the compiler can vectorize them.
+*/
+class Vector2DArray {
+public:
+
+    typedef std::vector< double > ValueCont; //!< coordinate value container type
+
+private:
+
+    ValueCont M_x; //!< X coordinates
+    ValueCont M_y; //!< Y coordinates
+
+public:
+
+    /*!
+      \brief create empty array.
+    */
+    Vector2DArray()
+      { }
+
+    /*!
+      \brief create array with the copy of given points.
+      \param v source points
+    */
+    explicit
+    Vector2DArray( const std::vector< Vector2D > & v )
+      {
+          assign( v );
+      }
+
+    /*!
+      \brief replace all elements with the copy of given points.
+      \param v source points
+      \return reference to itself
+    */
+    Vector2DArray & assign( const std::vector< Vector2D > & v );
+
+    /*!
+      \brief clear all elements.
+    */
+    void clear()
+      {
+          M_x.clear();
+          M_y.clear();
+      }
+
+    /*!
+      \brief reserve the memory space.
+      \param n new capacity
+    */
+    void reserve( const std::size_t n )
+      {
+          M_x.reserve( n );
+          M_y.reserve( n );
+      }
+
+    /*!
+      \brief change the number of elements.
+      \param n new size
+    */
+    void resize( const std::size_t n )
+      {
+          M_x.resize( n, 0.0 );
+          M_y.resize( n, 0.0 );
+      }
+
+    /*!
+      \brief get the number of elements.
+      \return size of array
+    */
+    std::size_t size() const
+      {
+          return M_x.size();
+      }
+
+    /*!
+      \brief check if array is empty or not.
+      \return true if no element.
+    */
+    bool empty() const
+      {
+          return M_x.empty();
+      }
+
+    /*!
+      \brief append a new point.
+      \param p new point
+    */
+    void push_back( const Vector2D & p )
+      {
+          M_x.push_back( p.x );
+          M_y.push_back( p.y );
+      }
+
+    /*!
+      \brief remove the last point.
+    */
+    void pop_back()
+      {
+          M_x.pop_back();
+          M_y.pop_back();
+      }
+
+    /*!
+      \brief overwrite the specified element.
+      \param i index of element
+      \param p new value
+    */
+    void set( const std::size_t i,
+              const Vector2D & p )
+      {
+          M_x[i] = p.x;
+          M_y[i] = p.y;
+      }
+
+    /*!
+      \brief get the specified element.
+      \param i index of element
+      \return copy of point value
+    */
+    Vector2D operator[]( const std::size_t i ) const
+      {
+          return Vector2D( M_x[i], M_y[i] );
+      }
+
+    /*!
+      \brief get the specified element with range check.
+      \param i index of element
+      \return copy of point value
+    */
+    Vector2D at( const std::size_t i ) const
+      {
+          return Vector2D( M_x.at( i ), M_y.at( i ) );
+      }
+
+    /*!
+      \brief get X coordinate of the specified element.
+      \param i index of element
+      \return X value
+    */
+    const double & x( const std::size_t i ) const
+      {
+          return M_x[i];
+      }
+
+    /*!
+      \brief get Y coordinate of the specified element.
+      \param i index of element
+      \return Y value
+    */
+    const double & y( const std::size_t i ) const
+      {
+          return M_y[i];
+      }
+
+    /*!
+      \brief get X coordinate array.
+      \return const reference to the X value container
+    */
+    const ValueCont & xs() const
+      {
+          return M_x;
+      }
+
+    /*!
+      \brief get Y coordinate array.
+      \return const reference to the Y value container
+    */
+    const ValueCont & ys() const
+      {
+          return M_y;
+      }
+
+    /*!
+      \brief copy all elements to the array of Vector2D.
+      \param v reference to the result container
+    */
+    void copyTo( std::vector< Vector2D > & v ) const;
+
+    //////////////////////////////////////////////
+    // batch operations
+
+    /*!
+      \brief add the vector to all elements.
+      \param v added vector
+      \return reference to itself
+    */
+    Vector2DArray & translate( const Vector2D & v );
+
+    /*!
+      \brief multiply all elements by the scalar value.
+      \param scalar multiplied value
+      \return reference to itself
+    */
+    Vector2DArray & scale( const double & scalar );
+
+    /*!
+      \brief rotate all elements around the origin.
+      \param deg rotated angle by double type
+      \return reference to itself
+    */
+    Vector2DArray & rotate( const double & deg );
+
+    /*!
+      \brief rotate all elements around the origin.
+      \param angle rotated angle
+      \return reference to itself
+    */
+    Vector2DArray & rotate( const AngleDeg & angle )
+      {
+          return rotate( angle.degree() );
+      }
+
+    /*!
+      \brief get squared distances from the point to all elements.
+      \param p base point
+      \param result reference to the result container. resized to size().
+    */
+    void dist2( const Vector2D & p,
+                std::vector< double > & result ) const;
+
+    /*!
+      \brief get outer(cross) products of all elements with 'v'.
+      \param v target vector
+      \param result reference to the result container. resized to size().
+
+      result[i] is equivalent to this->at( i ).outerProduct( v ).
+    */
+    void outerProduct( const Vector2D & v,
+                       std::vector< double > & result ) const;
+
+    /*!
+      \brief get outer(cross) products of all relative vectors with 'v'.
+      \param origin base point of the relative vectors
+      \param v target vector
+      \param result reference to the result container. resized to size().
+
+      result[i] is equivalent to ( this->at( i ) - origin ).outerProduct( v ).
+    */
+    void outerProduct( const Vector2D & origin,
+                       const Vector2D & v,
+                       std::vector< double > & result ) const;
+
+    /*!
+      \brief find the element nearest to the point.
+      \param p base point
+      \param min_dist2 pointer to the variable that receives the squared distance. may be NULL.
+      \return index of the nearest element. if array is empty, returns -1.
+    */
+    int nearest( const Vector2D & p,
+                 double * min_dist2 = static_cast< double * >( 0 ) ) const;
+
+    /*!
+      \brief find all elements within the circle.
+      \param center center point of the circle
+      \param radius radius of the circle
+      \param result reference to the index container. found indices are appended.
+      \return number of found elements
+    */
+    std::size_t within( const Vector2D & center,
+                        const double & radius,
+                        std::vector< std::size_t > & result ) const;
+
+    /*!
+      \brief check if there is any element within the circle.
+      \param center center point of the circle
+      \param radius radius of the circle
+      \return true if at least one element exists in the circle.
+    */
+    bool existWithin( const Vector2D & center,
+                      const double & radius ) const;
+
+    //////////////////////////////////////////////
+    // static utility
+
+    /*!
+      \brief create points from POLAR values.
+      \param mag lengths of vectors
+      \param deg angles of vectors by degree
+      \param result reference to the result array. resized to mag.size().
+    */
+    static
+    void polar2vector( const std::vector< double > & mag,
+                       const std::vector< double > & deg,
+                       Vector2DArray & result );
+
+};
+
+}
+
+#endif
@@ -39,7 +39,50 @@
 
 #include "gzcompressor.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+
+namespace {
+
+/*!
+  \brief the preset dictionary for the soccer server messages.
+
+  zlib finds the matches from the end of the dictionary most cheaply,
+  so the most frequent fragments (sense_body and see) are put last.
+ */
+const char MESSAGE_DICTIONARY[] =
+    "(server_param (player_param (player_type (id (change_player_type "
+    "(init l r (ok (error (warning (think) (done) (synch_see) "
+    "(hear referee self our opp play_on kick_off_ free_kick_ "
+    "corner_kick_ goal_kick_ kick_in_ offside_ foul_charge_ "
+    "(score (clang (ver (ear (on (off (compression "
+    "(turn (dash (kick (tackle (catch (move (turn_neck (say (pointto "
+    "(attentionto (change_view (change_focus "
+    "(fullstate (pmode (vmode high normal) (count (arm (mov "
+    "(ball (player (stamina (speed (head_angle "
+    "((f c t) ((f c b) ((f l t) ((f l b) ((f r t) ((f r b) "
+    "((f p l t) ((f p l c) ((f p l b) ((f p r t) ((f p r c) ((f p r b) "
+    "((f g l t) ((f g l b) ((f g r t) ((f g r b) "
+    "((f t l 50) ((f t l 40) ((f t l 30) ((f t l 20) ((f t l 10) "
+    "((f t 0) ((f t r 10) ((f t r 20) ((f t r 30) ((f t r 40) ((f t r 50) "
+    "((f b l 50) ((f b l 40) ((f b l 30) ((f b l 20) ((f b l 10) "
+    "((f b 0) ((f b r 10) ((f b r 20) ((f b r 30) ((f b r 40) ((f b r 50) "
+    "((f l t 30) ((f l t 20) ((f l t 10) ((f l 0) "
+    "((f l b 10) ((f l b 20) ((f l b 30) "
+    "((f r t 30) ((f r t 20) ((f r t 10) ((f r 0) "
+    "((f r b 10) ((f r b 20) ((f r b 30) "
+    "((g l) ((g r) ((f c) ((l l) ((l r) ((l t) ((l b) ((F) ((G) ((P) "
+    "((B) ((b) ((p) ((p \"\" goalie) ((p \" "
+    "(sense_body 0 (view_mode high normal) (stamina 8000 1 130600) "
+    "(speed 0 0) (head_angle 0) (kick 0) (dash 0) (turn 0) (say 0) "
+    "(turn_neck 0) (catch 0) (move 0) (change_view 0) (change_focus 0) "
+    "(arm (movable 0) (expires 0) (target 0 0) (count 0)) "
+    "(focus (target none) (count 0)) (tackle (expires 0) (count 0)) "
+    "(collision none) (foul  (charged 0) (card none)) (focus_point 0 0))"
+    "(see 0 ";
+
+}
 
 namespace rcsc {
 
@@ -53,11 +96,15 @@ class GZCompressorImpl {
 private:
 #ifdef HAVE_LIBZ
     z_stream M_stream;
+#endif
+
+    //! preset dictionary. empty if not used.
+    std::string M_dictionary;
 
     char * M_out_buffer;
     int M_out_size;
     int M_out_avail;
-#endif
+
 public:
 
     /*!
@@ -66,11 +113,9 @@ public:
      */
     explicit
     GZCompressorImpl( const int level )
-#ifdef HAVE_LIBZ
         : M_out_buffer( NULL )
         , M_out_size( 0 )
         , M_out_avail( 0 )
-#endif
       {
 #ifdef HAVE_LIBZ
           M_stream.zalloc = Z_NULL;
@@ -92,8 +137,8 @@ public:
       {
 #ifdef HAVE_LIBZ
           deflateEnd( &M_stream );
-          std::free( M_out_buffer );
 #endif
+          std::free( M_out_buffer );
       }
 
     /*!
@@ -111,34 +156,57 @@ public:
 #endif
       }
 
+    /*!
+      \return the return value of deflateSetDictionary
+     */
+    int setDictionary( const char * dict,
+                       const int size )
+      {
+          if ( dict && size > 0 )
+          {
+              M_dictionary.assign( dict, size );
+          }
+          else
+          {
+              M_dictionary.clear();
+          }
+#ifdef HAVE_LIBZ
+          return reset();
+#else
+          return 0;
+#endif
+      }
+
+    const char * data() const
+      {
+          return M_out_buffer;
+      }
+
+    int size() const
+      {
+          return M_out_size;
+      }
+
     /*!
       \return the return value of deflate
 
       Z_OK, Z_STREAM_END, Z_STREAM_ERROR, Z_BUF_ERROR
      */
     int compress( const char * src_buf,
-                  const int src_size,
-                  std::string & dest )
+                  const int src_size )
       {
-          dest.clear();
+          M_out_size = 0;
 #ifdef HAVE_LIBZ
-          // allocate output buffer
-          if ( M_out_buffer == NULL )
+          // the output buffer is enlarged only when the bound exceeds it.
+          if ( ! reserve( static_cast< int >( deflateBound( &M_stream, src_size ) ) + 16 ) )
           {
-              M_out_avail = static_cast< int >( src_size * 1.01 + 12 );
-              M_out_buffer = static_cast< char * >( std::malloc( M_out_avail ) );
-
-              if ( M_out_buffer == NULL )
-              {
-                  return Z_MEM_ERROR;
-              }
-
-              M_stream.next_out = (Bytef*)M_out_buffer;
-              M_stream.avail_out = M_out_avail;
+              return Z_MEM_ERROR;
           }
 
           M_stream.next_in = (Bytef*)src_buf;
           M_stream.avail_in = src_size;
+          M_stream.next_out = (Bytef*)M_out_buffer;
+          M_stream.avail_out = M_out_avail;
 
           int bytes_out = M_stream.total_out;
           int err = 0;
@@ -146,19 +214,15 @@ public:
           {
               if ( M_stream.avail_out == 0 )
               {
-                  int extra = static_cast< int >( M_out_avail * 0.5 );
-                  M_out_buffer
-                      = static_cast< char * >( std::realloc( M_out_buffer,
-                                                             M_out_avail + extra ) );
-                  if ( M_out_buffer == NULL )
+                  if ( ! reserve( M_out_avail + M_out_avail / 2 ) )
                   {
                       err = Z_MEM_ERROR;
                       break;
                   }
 
-                  M_stream.next_out = (Bytef*)( M_out_buffer + M_out_avail );
-                  M_stream.avail_out += extra;
-                  M_out_avail += extra;
+                  const int written = M_stream.total_out - bytes_out;
+                  M_stream.next_out = (Bytef*)( M_out_buffer + written );
+                  M_stream.avail_out = M_out_avail - written;
               }
 
               err = deflate( &M_stream, Z_SYNC_FLUSH ); //Z_NO_FLUSH );
@@ -171,21 +235,77 @@ public:
 
           M_out_size = M_stream.total_out - bytes_out;
 
-          // copy to the destination buffer
-
-          dest.assign( M_out_buffer, M_out_size );
-
-          M_out_size = 0;
-          deflateReset( &M_stream );
-          M_stream.next_out = (Bytef*)M_out_buffer;
-          M_stream.avail_out = M_out_avail;
+          reset();
 
           return err;
 #else
-          dest.assign( src_buf, src_size );
+          if ( ! reserve( src_size ) )
+          {
+              return -1;
+          }
+          std::memcpy( M_out_buffer, src_buf, src_size );
+          M_out_size = src_size;
           return 0;
 #endif
       }
+
+    /*!
+      \return the return value of deflate
+     */
+    int compress( const char * src_buf,
+                  const int src_size,
+                  std::string & dest )
+      {
+          int err = compress( src_buf, src_size );
+
+          // copy to the destination buffer
+          dest.assign( M_out_buffer, M_out_size );
+
+          return err;
+      }
+
+private:
+
+    /*!
+      \brief enlarge the output buffer if needed.
+      \return false if failed to allocate
+     */
+    bool reserve( const int size )
+      {
+          if ( size <= M_out_avail )
+          {
+              return true;
+          }
+
+          char * buf = static_cast< char * >( std::realloc( M_out_buffer, size ) );
+          if ( buf == NULL )
+          {
+              return false;
+          }
+
+          M_out_buffer = buf;
+          M_out_avail = size;
+          return true;
+      }
+
+#ifdef HAVE_LIBZ
+    /*!
+      \brief reset the stream for the next message, and load the dictionary again.
+      \return the return value of deflateReset or deflateSetDictionary
+     */
+    int reset()
+      {
+          int err = deflateReset( &M_stream );
+          if ( err == Z_OK
+               && ! M_dictionary.empty() )
+          {
+              err = deflateSetDictionary( &M_stream,
+                                          (const Bytef*)M_dictionary.data(),
+                                          M_dictionary.size() );
+          }
+          return err;
+      }
+#endif
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -198,18 +318,20 @@ class GZDecompressorImpl {
 private:
 #ifdef HAVE_LIBZ
     z_stream M_stream;
+#endif
+
+    //! preset dictionary. empty if not used.
+    std::string M_dictionary;
 
     char * M_out_buffer;
     int M_out_size;
     int M_out_avail;
-#endif
+
 public:
     GZDecompressorImpl()
-#ifdef HAVE_LIBZ
         : M_out_buffer( NULL )
         , M_out_size( 0 )
         , M_out_avail( 0 )
-#endif
       {
 #ifdef HAVE_LIBZ
           M_stream.zalloc = Z_NULL;
@@ -224,39 +346,56 @@ public:
       {
 #ifdef HAVE_LIBZ
           inflateEnd( &M_stream );
-          std::free( M_out_buffer );
 #endif
+          std::free( M_out_buffer );
+      }
+
+    /*!
+      \brief set the preset dictionary. it is used when the message requires it.
+     */
+    void setDictionary( const char * dict,
+                        const int size )
+      {
+          if ( dict && size > 0 )
+          {
+              M_dictionary.assign( dict, size );
+          }
+          else
+          {
+              M_dictionary.clear();
+          }
+      }
+
+    const char * data() const
+      {
+          return M_out_buffer;
+      }
+
+    int size() const
+      {
+          return M_out_size;
       }
 
     /*!
       \brief decompress the message
       \param src_buf source message
       \param src_size the length of source message
-      \param dest reference to the destination variable.
      */
     int decompress( const char * src_buf,
-                    const int src_size,
-                    std::string & dest )
+                    const int src_size )
       {
-          dest.clear();
+          M_out_size = 0;
 #ifdef HAVE_LIBZ
-          // allocate output buffer
-          if ( M_out_buffer == NULL )
+          // the output buffer is enlarged only when the message needs it.
+          if ( ! reserve( std::max( src_size * 4, 1024 ) ) )
           {
-              M_out_avail = src_size * 2;
-              M_out_buffer
-                  = static_cast< char * >( std::malloc( M_out_avail ) );
-              if ( M_out_buffer == NULL )
-              {
-                  return Z_MEM_ERROR;
-              }
-
-              M_stream.next_out = (Bytef*)M_out_buffer;
-              M_stream.avail_out = M_out_avail;
+              return Z_MEM_ERROR;
           }
 
           M_stream.next_in = (Bytef*)src_buf;
           M_stream.avail_in = src_size;
+          M_stream.next_out = (Bytef*)M_out_buffer;
+          M_stream.avail_out = M_out_avail;
 
           int bytes_out = M_stream.total_out;
 
@@ -265,23 +404,31 @@ public:
           {
               if ( M_stream.avail_out == 0 )
               {
-                  int extra = static_cast< int >( M_out_avail * 0.5 );
-                  M_out_buffer
-                      = static_cast< char * >( std::realloc( M_out_buffer,
-                                                             M_out_avail + extra ) );
-                  if ( M_out_buffer == NULL )
+                  if ( ! reserve( M_out_avail + M_out_avail / 2 ) )
                   {
                       err = Z_MEM_ERROR;
                       break;
                   }
 
-                  M_stream.next_out = (Bytef*)( M_out_buffer + M_out_avail );
-                  M_stream.avail_out += extra;
-                  M_out_avail += extra;
+                  const int written = M_stream.total_out - bytes_out;
+                  M_stream.next_out = (Bytef*)( M_out_buffer + written );
+                  M_stream.avail_out = M_out_avail - written;
               }
 
               err = inflate( &M_stream, Z_SYNC_FLUSH ); // Z_NO_FLUSH );
 
+              if ( err == Z_NEED_DICT
+                   && ! M_dictionary.empty() )
+              {
+                  err = inflateSetDictionary( &M_stream,
+                                              (const Bytef*)M_dictionary.data(),
+                                              M_dictionary.size() );
+                  if ( err == Z_OK )
+                  {
+                      continue;
+                  }
+              }
+
               if ( err != Z_OK )
               {
                   break;
@@ -290,21 +437,61 @@ public:
 
           M_out_size = M_stream.total_out - bytes_out;
 
-          // copy to the destination buffer
-
-          dest.assign( M_out_buffer, M_out_size );
-
-          M_out_size = 0;
           inflateReset( &M_stream );
-          M_stream.next_out = (Bytef*)M_out_buffer;
-          M_stream.avail_out = M_out_avail;
 
           return err;
 #else
-          dest.assign( src_buf, src_size );
+          if ( ! reserve( src_size ) )
+          {
+              return -1;
+          }
+          std::memcpy( M_out_buffer, src_buf, src_size );
+          M_out_size = src_size;
           return 0;
 #endif
       }
+
+    /*!
+      \brief decompress the message
+      \param src_buf source message
+      \param src_size the length of source message
+      \param dest reference to the destination variable.
+     */
+    int decompress( const char * src_buf,
+                    const int src_size,
+                    std::string & dest )
+      {
+          int err = decompress( src_buf, src_size );
+
+          // copy to the destination buffer
+          dest.assign( M_out_buffer, M_out_size );
+
+          return err;
+      }
+
+private:
+
+    /*!
+      \brief enlarge the output buffer if needed.
+      \return false if failed to allocate
+     */
+    bool reserve( const int size )
+      {
+          if ( size <= M_out_avail )
+          {
+              return true;
+          }
+
+          char * buf = static_cast< char * >( std::realloc( M_out_buffer, size ) );
+          if ( buf == NULL )
+          {
+              return false;
+          }
+
+          M_out_buffer = buf;
+          M_out_avail = size;
+          return true;
+      }
 };
 
 
@@ -333,6 +520,17 @@ GZCompressor::~GZCompressor()
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+const std::string &
+GZCompressor::message_dictionary()
+{
+    static const std::string s_dict( MESSAGE_DICTIONARY );
+    return s_dict;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 int
 GZCompressor::setLevel( int level )
@@ -343,6 +541,28 @@ GZCompressor::setLevel( int level )
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+int
+GZCompressor::setDictionary( const char * dict,
+                             const int size )
+{
+    return M_impl->setDictionary( dict, size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+GZCompressor::compress( const char * src_buf,
+                        const int src_size )
+{
+    return M_impl->compress( src_buf, src_size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 int
 GZCompressor::compress( const char * src_buf,
@@ -352,6 +572,26 @@ GZCompressor::compress( const char * src_buf,
     return M_impl->compress( src_buf, src_size, dest );
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+const char *
+GZCompressor::data() const
+{
+    return M_impl->data();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+GZCompressor::size() const
+{
+    return M_impl->size();
+}
+
 /////////////////////////////////////////////////////////////////////
 
 /*-------------------------------------------------------------------*/
@@ -376,6 +616,28 @@ GZDecompressor::~GZDecompressor()
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+void
+GZDecompressor::setDictionary( const char * dict,
+                               const int size )
+{
+    M_impl->setDictionary( dict, size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+GZDecompressor::decompress( const char * src_buf,
+                            const int src_size )
+{
+    return M_impl->decompress( src_buf, src_size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 int
 GZDecompressor::decompress( const char * src_buf,
@@ -385,4 +647,24 @@ GZDecompressor::decompress( const char * src_buf,
     return M_impl->decompress( src_buf, src_size, dest );
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+const char *
+GZDecompressor::data() const
+{
+    return M_impl->data();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+GZDecompressor::size() const
+{
+    return M_impl->size();
+}
+
 }
@@ -44,6 +44,15 @@ class GZDecompressorImpl;
 /*!
   \class GZCompressor
   \brief compress message string
+
+  The zlib stream and the output buffer are reused for all messages.
+  compress() without the destination string keeps the result in the
+  internal buffer, so that no memory is allocated after the buffer has
+  grown to the largest message.
+
+  A preset dictionary improves the ratio of the small messages. The
+  receiver must use the same dictionary. rcssserver does not use any
+  dictionary, so it must not be set for the server connection.
  */
 class GZCompressor {
 private:
@@ -65,6 +74,14 @@ public:
      */
     ~GZCompressor();
 
+    /*!
+      \brief get the preset dictionary made from the typical
+      (see ...) and (sense_body ...) messages.
+      \return const reference to the dictionary string
+     */
+    static
+    const std::string & message_dictionary();
+
     /*!
       \brief set zlib compression level
       \param level zlib compression level. [1,9]
@@ -72,6 +89,26 @@ public:
      */
     int setLevel( const int level );
 
+    /*!
+      \brief set the preset dictionary used for all following messages.
+      \param dict pointer to the dictionary. if NULL, the dictionary is removed.
+      \param size size of the dictionary
+      \return result status of deflateSetDictionary
+     */
+    int setDictionary( const char * dict,
+                       const int size );
+
+    /*!
+      \brief compress the src_buf into the internal buffer
+      \param src_buf pointer to the source buffer
+      \param src_size size of source buffer
+      \return status of compression
+
+      The result is available by data() and size() until the next call.
+     */
+    int compress( const char * src_buf,
+                  const int src_size );
+
     /*!
       \brief compress the src_buf and copy output buffer to std::string
       \param src_buf pointer to the source buffer
@@ -83,6 +120,18 @@ public:
                   const int src_size,
                   std::string & dest );
 
+    /*!
+      \brief get the last compressed data
+      \return pointer to the internal buffer
+     */
+    const char * data() const;
+
+    /*!
+      \brief get the size of the last compressed data
+      \return size of the compressed data
+     */
+    int size() const;
+
 };
 
 
@@ -91,6 +140,9 @@ public:
 /*!
   \class GZDecompressor
   \brief decompress message string
+
+  As GZCompressor, the zlib stream and the output buffer are reused.
+  The preset dictionary is used only when the message requires it.
  */
 class GZDecompressor {
 private:
@@ -110,6 +162,25 @@ public:
      */
     ~GZDecompressor();
 
+    /*!
+      \brief set the preset dictionary used when the message requires it.
+      \param dict pointer to the dictionary. if NULL, the dictionary is removed.
+      \param size size of the dictionary
+     */
+    void setDictionary( const char * dict,
+                        const int size );
+
+    /*!
+      \brief decompress the src_buf into the internal buffer
+      \param src_buf source buffer
+      \param src_size size of source buffer
+      \return status of decompression
+
+      The result is available by data() and size() until the next call.
+     */
+    int decompress( const char * src_buf,
+                    const int src_size );
+
     /*!
       \brief decompress the src_buf and copy output buffer to std::string
       \param src_buf source buffer
@@ -121,6 +192,18 @@ public:
                     const int src_size,
                     std::string & dest );
 
+    /*!
+      \brief get the last decompressed data
+      \return pointer to the internal buffer
+     */
+    const char * data() const;
+
+    /*!
+      \brief get the size of the last decompressed data
+      \return size of the decompressed data
+     */
+    int size() const;
+
 };
 
 }
@@ -42,6 +42,11 @@
 #include <zlib.h>
 #endif
 
+#if defined(HAVE_LIBZ) && ! defined(_WIN32)
+#define RCSC_GZ_READAHEAD_THREAD
+#include <pthread.h>
+#endif
+
 namespace rcsc {
 
 /////////////////////////////////////////////////////////////////////
@@ -57,15 +62,104 @@ struct gzfilebuf_impl {
     gzFile file_;
 #endif
 
+#ifdef RCSC_GZ_READAHEAD_THREAD
+    pthread_t thread_; //!< readahead thread
+    pthread_mutex_t mutex_; //!< guard for the following variables
+    pthread_cond_t cond_; //!< notified when ready_ or stop_ is changed
+    bool running_; //!< true if the thread is running
+    bool stop_; //!< stop request to the thread
+    bool ready_; //!< true if the next block is filled by the thread
+    int ready_size_; //!< result of gzread for the next block
+    char * next_; //!< the block filled by the thread
+    std::size_t next_size_; //!< the capacity of the next block
+#endif
+
     //! constructor
     gzfilebuf_impl()
         : open_mode_( static_cast< std::ios_base::openmode >( 0 ) )
 #ifdef HAVE_LIBZ
         , file_( NULL )
 #endif
-      { }
+#ifdef RCSC_GZ_READAHEAD_THREAD
+        , running_( false )
+        , stop_( false )
+        , ready_( false )
+        , ready_size_( 0 )
+        , next_( NULL )
+        , next_size_( 0 )
+#endif
+      {
+#ifdef RCSC_GZ_READAHEAD_THREAD
+          pthread_mutex_init( &mutex_, NULL );
+          pthread_cond_init( &cond_, NULL );
+#endif
+      }
+
+    //! destructor
+    ~gzfilebuf_impl()
+      {
+#ifdef RCSC_GZ_READAHEAD_THREAD
+          pthread_cond_destroy( &cond_ );
+          pthread_mutex_destroy( &mutex_ );
+#endif
+      }
+
+#ifdef RCSC_GZ_READAHEAD_THREAD
+    /*!
+      \brief readahead loop. decompress the next block while the
+      consumer does not take it, until EOF, error or stop request.
+     */
+    void run()
+      {
+          pthread_mutex_lock( &mutex_ );
+          while ( ! stop_ )
+          {
+              if ( ready_ )
+              {
+                  pthread_cond_wait( &cond_, &mutex_ );
+                  continue;
+              }
+
+              char * buf = next_;
+              const std::size_t size = next_size_;
+              pthread_mutex_unlock( &mutex_ );
+
+              const int n = gzread( file_, buf, static_cast< unsigned >( size ) );
+
+              pthread_mutex_lock( &mutex_ );
+              ready_ = true;
+              ready_size_ = n;
+              pthread_cond_broadcast( &cond_ );
+
+              if ( n <= 0 )
+              {
+                  break;
+              }
+          }
+          pthread_mutex_unlock( &mutex_ );
+      }
+#endif
 };
 
+#ifdef RCSC_GZ_READAHEAD_THREAD
+extern "C" {
+
+/*!
+  \brief entry point of the readahead thread.
+  \param arg pointer to gzfilebuf_impl
+  \return NULL
+ */
+static
+void *
+gzfilebuf_readahead_main( void * arg )
+{
+    static_cast< gzfilebuf_impl * >( arg )->run();
+    return NULL;
+}
+
+}
+#endif
+
 /////////////////////////////////////////////////////////////////////
 
 /*-------------------------------------------------------------------*/
@@ -76,6 +170,8 @@ gzfilebuf::gzfilebuf()
     : M_impl( new gzfilebuf_impl )
     , M_buf_size( 8192 )
     , M_buf( NULL )
+    , M_buf_pos( 0 )
+    , M_readahead( false )
     , M_remained_size( 0 )
 {
     //std::cerr << "create gzfilebuf" << std::endl;
@@ -167,8 +263,20 @@ gzfilebuf::open( const char * path,
             destroyInternalBuffer();
         }
 
+#if ZLIB_VERNUM >= 0x1240
+        // enlarge zlib's internal buffer to reduce the read calls.
+        if ( testi
+             && M_buf_size > 8192 )
+        {
+            gzbuffer( M_impl->file_, static_cast< unsigned >( M_buf_size ) );
+        }
+#endif
+
         //std::cerr << "gzfilebuf::open allocate buffer" << std::endl;
-        M_buf = new char_type[M_buf_size];
+        // the readahead mode uses the second half as the next block.
+        M_buf = new char_type[ testi && M_readahead
+                               ? M_buf_size * 2
+                               : M_buf_size ];
 
         if ( testi )
         {
@@ -176,8 +284,11 @@ gzfilebuf::open( const char * path,
             // because no data is read at first.
             //std::cerr << "gzfilebuf::open. in mode. setg" << std::endl;
             M_remained_size = 0;
+            M_buf_pos = 0;
             this->setg( M_buf, M_buf, M_buf );
             M_impl->open_mode_ = std::ios_base::in;
+
+            startReadahead();
         }
 
         if ( testo )
@@ -203,6 +314,7 @@ gzfilebuf::close() throw()
 #ifdef HAVE_LIBZ
     if ( this->is_open() )
     {
+        stopReadahead();
         flushBuf();
         destroyInternalBuffer();
         //std::cerr << "close gzip file" << std::endl;
@@ -231,6 +343,109 @@ gzfilebuf::close() throw()
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+bool
+gzfilebuf::setBufferSize( const std::size_t size )
+{
+    if ( is_open()
+         || size == 0 )
+    {
+        return false;
+    }
+
+    M_buf_size = size;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+gzfilebuf::setReadahead( const bool on )
+{
+    if ( is_open() )
+    {
+        return false;
+    }
+
+    M_readahead = on;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+gzfilebuf::startReadahead()
+{
+#ifdef RCSC_GZ_READAHEAD_THREAD
+    if ( ! M_readahead
+         || M_impl->running_
+         || ! is_open()
+         || ! ( M_impl->open_mode_ & std::ios_base::in )
+         || ! M_buf )
+    {
+        return false;
+    }
+
+    // the thread fills the block that is not used by the get area.
+    M_impl->next_ = ( this->eback() == M_buf
+                      ? M_buf + M_buf_size
+                      : M_buf );
+    M_impl->next_size_ = M_buf_size;
+    M_impl->stop_ = false;
+    M_impl->ready_ = false;
+    M_impl->ready_size_ = 0;
+
+    if ( pthread_create( &M_impl->thread_, NULL,
+                         gzfilebuf_readahead_main, M_impl.get() ) != 0 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " failed to create the readahead thread."
+                  << " the file is read synchronously." << std::endl;
+        return false;
+    }
+
+    M_impl->running_ = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+gzfilebuf::stopReadahead() throw()
+{
+#ifdef RCSC_GZ_READAHEAD_THREAD
+    if ( ! M_impl
+         || ! M_impl->running_ )
+    {
+        return;
+    }
+
+    pthread_mutex_lock( &M_impl->mutex_ );
+    M_impl->stop_ = true;
+    pthread_cond_broadcast( &M_impl->cond_ );
+    pthread_mutex_unlock( &M_impl->mutex_ );
+
+    pthread_join( M_impl->thread_, NULL );
+
+    M_impl->running_ = false;
+    M_impl->stop_ = false;
+    M_impl->ready_ = false;
+    M_impl->ready_size_ = 0;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 bool
 gzfilebuf::flushBuf()
@@ -346,6 +561,8 @@ gzfilebuf::makeModeString( std::ios_base::openmode mode,
 void
 gzfilebuf::destroyInternalBuffer() throw()
 {
+    stopReadahead();
+
     if ( M_buf )
     {
         //std::cerr << "gzfilebuf destroy buffer" << std::endl;
@@ -405,31 +622,17 @@ gzfilebuf::seekoff( std::streamoff off,
 #ifdef HAVE_LIBZ
     if ( M_impl->open_mode_ & std::ios_base::in )
     {
-        if ( way & std::ios_base::beg )
+        if ( way == std::ios_base::beg )
         {
-            ret = gzseek( M_impl->file_, off, SEEK_SET );
-            //std::cerr << "seekoff in beg off = " << off
-            //          << " ret = " << ret
-            //          << std::endl;
-            M_remained_size = 0;
-            this->setg( M_buf, M_buf, M_buf );
+            ret = seekInput( off );
         }
 
-        if ( way & std::ios_base::cur )
+        if ( way == std::ios_base::cur )
         {
-            ret = gzseek( M_impl->file_, off, SEEK_CUR );
-            ret -= this->egptr() - this->gptr();
-            //off_type diff = this->egptr() - this->gptr();
-            //std::cerr << "seekoff in cur off = " << off
-            //          << " ret = " << ret
-            //          << " pointer_diff = "<< diff
-            //          << " total = " << ret - diff
-            //          << std::endl;
-            if ( off != 0 )
-            {
-                M_remained_size = 0;
-                this->setg( M_buf, M_buf, M_buf );
-            }
+            // the position of gptr() is known without asking zlib.
+            ret = seekInput( M_buf_pos
+                             + static_cast< std::streamoff >( this->gptr() - this->eback() )
+                             + off );
         }
     }
 
@@ -479,10 +682,7 @@ gzfilebuf::seekpos( std::streampos pos,
          && ( mode & std::ios_base::in ) )
     {
         //std::cerr << "seekpos in " << pos << std::endl;
-        ret = gzseek( M_impl->file_, pos, SEEK_SET );
-        // and reset buffer pointer to initial position
-        M_remained_size = 0;
-        this->setg( M_buf, M_buf, M_buf );
+        ret = seekInput( pos );
     }
 
     if ( ( M_impl->open_mode_ & std::ios_base::out )
@@ -500,6 +700,53 @@ gzfilebuf::seekpos( std::streampos pos,
     return ret;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+  The decompressed data in the current get area is used as a checkpoint.
+  If the destination is in the get area, only the get pointer is moved.
+  Otherwise, the readahead thread is stopped and zlib seeks the position
+  (backward seek makes zlib restart from the top of the file).
+*/
+std::streampos
+gzfilebuf::seekInput( std::streamoff pos )
+{
+    if ( pos < 0 )
+    {
+        return -1;
+    }
+
+    const std::streamoff avail = this->egptr() - this->eback();
+    if ( this->eback()
+         && M_buf_pos <= pos
+         && pos <= M_buf_pos + avail )
+    {
+        this->setg( this->eback(),
+                    this->eback() + ( pos - M_buf_pos ),
+                    this->egptr() );
+        return pos;
+    }
+
+    std::streampos ret = -1;
+#ifdef HAVE_LIBZ
+    const bool restart = M_readahead;
+    stopReadahead();
+
+    z_off_t result = gzseek( M_impl->file_, static_cast< z_off_t >( pos ), SEEK_SET );
+    // and reset buffer pointer to initial position
+    M_remained_size = 0;
+    M_buf_pos = ( result < 0 ? gztell( M_impl->file_ ) : result );
+    this->setg( M_buf, M_buf, M_buf );
+
+    if ( restart )
+    {
+        startReadahead();
+    }
+
+    ret = result;
+#endif
+    return ret;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -576,6 +823,37 @@ gzfilebuf::underflow()
         return traits_type::eof();
     }
 
+#ifdef RCSC_GZ_READAHEAD_THREAD
+    if ( M_impl->running_ )
+    {
+        pthread_mutex_lock( &M_impl->mutex_ );
+        while ( ! M_impl->ready_ )
+        {
+            pthread_cond_wait( &M_impl->cond_, &M_impl->mutex_ );
+        }
+
+        const int read_size = M_impl->ready_size_;
+        if ( read_size <= 0 )
+        {
+            // keep the ready flag. the thread has already finished.
+            pthread_mutex_unlock( &M_impl->mutex_ );
+            return traits_type::eof();
+        }
+
+        // swap the blocks. the consumed block is given to the thread.
+        char_type * buf = M_impl->next_;
+        M_impl->next_ = this->eback();
+        M_impl->ready_ = false;
+        pthread_cond_broadcast( &M_impl->cond_ );
+        pthread_mutex_unlock( &M_impl->mutex_ );
+
+        M_buf_pos += this->egptr() - this->eback();
+        this->setg( buf, buf, buf + read_size );
+
+        return traits_type::to_int_type( *gptr() );
+    }
+#endif
+
     if ( M_remained_size )
     {
         M_buf[0] = M_remained_char;
@@ -591,6 +869,7 @@ gzfilebuf::underflow()
     //std::cerr << "read_pos = " << gzseek( M_impl->file_, 0, SEEK_CUR )
     //          << std::endl;
     int total_size = read_size + M_remained_size;
+    M_buf_pos += this->egptr() - this->eback();
     this->setg( M_buf, M_buf, M_buf + total_size / sizeof( char_type ) );
     //std::cerr << "gzfilebuf::underflow. total_size=" << total_size
     //          << "  remained_size=" << M_remained_size
@@ -702,6 +981,22 @@ gzifstream::gzifstream( const char * path )
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+gzifstream::gzifstream( const char * path,
+                        const std::size_t buf_size,
+                        const bool readahead )
+    : std::istream( static_cast< std::streambuf * >( 0 ) )
+    , M_file_buf()
+{
+    this->init( &M_file_buf );
+    M_file_buf.setBufferSize( buf_size );
+    M_file_buf.setReadahead( readahead );
+    this->open( path );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 void
 gzifstream::open( const char * path )
@@ -49,6 +49,14 @@ struct gzfilebuf_impl;
   It doesn't yet support seeking (allowed by zlib but slow/limited),
   putback and read/write access(tricky). Otherwise, it attempts
   to be a drop-in replacement for the standard file streambuf.
+
+  For the large input files, the buffer size can be enlarged by
+  setBufferSize(), and the readahead mode can be enabled by
+  setReadahead() before open(). In the readahead mode, a background
+  thread decompresses the next block into the second buffer while the
+  current block is consumed. A seek to the position in the current
+  block only moves the get pointer, so rewinding after reading the
+  file header does not restart the decompression from the top.
 */
 class gzfilebuf
     : public std::streambuf {
@@ -96,6 +104,10 @@ private:
     std::size_t M_buf_size;
     //! pointer to the stream buffer. This is used as array.
     char_type * M_buf;
+    //! uncompressed position of the top of the get area
+    std::streamoff M_buf_pos;
+    //! if true, the next block is decompressed by the background thread.
+    bool M_readahead;
 
     //! used in underflow
     int M_remained_size;
@@ -157,6 +169,39 @@ public:
     */
     gzfilebuf * close() throw();
 
+    /*!
+      \brief set the buffer size. This method has to be called before open().
+      \param size new buffer size in bytes. zlib's internal buffer is also
+      resized if supported.
+      \return true if the size is changed.
+     */
+    bool setBufferSize( const std::size_t size );
+
+    /*!
+      \brief get the buffer size.
+      \return buffer size in bytes
+     */
+    std::size_t bufferSize() const
+      {
+          return M_buf_size;
+      }
+
+    /*!
+      \brief set the readahead mode. This method has to be called before open().
+      \param on if true, the background thread decompresses the next block
+      while the current block is consumed. The mode is used only for the input.
+      \return true if the mode is changed.
+     */
+    bool setReadahead( const bool on );
+
+    /*!
+      \brief check if the readahead mode is enabled.
+      \return readahead mode flag
+     */
+    bool readahead() const
+      {
+          return M_readahead;
+      }
 
 private:
 
@@ -190,6 +235,24 @@ private:
      */
     void destroyInternalBuffer() throw();
 
+    /*!
+      \brief start the readahead thread, if the readahead mode is enabled.
+      \return true if the thread is started.
+     */
+    bool startReadahead();
+
+    /*!
+      \brief stop the readahead thread, if running.
+     */
+    void stopReadahead() throw();
+
+    /*!
+      \brief move the input position.
+      \param pos new uncompressed position
+      \return new position value. in case of error, returned -1.
+     */
+    std::streampos seekInput( std::streamoff pos );
+
 protected:
     //virtual
     //void imbue( const locale& loc );
@@ -317,6 +380,16 @@ public:
     explicit
     gzifstream( const char * path );
 
+    /*!
+      \brief init stream buffer with the buffer configuration and open file.
+      \param path file path to be opened.
+      \param buf_size buffer size in bytes
+      \param readahead if true, the readahead mode is enabled.
+     */
+    gzifstream( const char * path,
+                const std::size_t buf_size,
+                const bool readahead = true );
+
     /*!
       \brief get underlying stream buffer.
       \return pointer to the file buffer
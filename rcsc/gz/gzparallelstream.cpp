@@ -0,0 +1,652 @@
+// -*-c++-*-
+
+/*!
+  \file gzparallelstream.cpp
+  \brief parallel gzip compression stream Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "gzparallelstream.h"
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+#if defined(HAVE_LIBZ) && ! defined(_WIN32)
+#define RCSC_GZ_PARALLEL_THREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <deque>
+#include <map>
+
+namespace rcsc {
+
+namespace {
+
+/*!
+  \struct gzparallel_block
+  \brief one block of the uncompressed data and its gzip member.
+ */
+struct gzparallel_block {
+    std::vector< char > input_; //!< uncompressed data. the capacity is the block size.
+    std::size_t size_; //!< uncompressed data size
+    std::vector< char > output_; //!< compressed gzip member
+    unsigned long seq_; //!< submitted order
+    bool ok_; //!< compression result
+
+    explicit
+    gzparallel_block( const std::size_t block_size )
+        : input_( block_size ),
+          size_( 0 ),
+          seq_( 0 ),
+          ok_( true )
+      { }
+};
+
+#ifdef HAVE_LIBZ
+/*!
+  \brief release the compression stream.
+  \param z compression stream. may be NULL.
+ */
+void
+release_stream( z_stream * z )
+{
+    if ( z )
+    {
+        deflateEnd( z );
+        delete z;
+    }
+}
+#endif
+
+/*!
+  \brief compress the block into one gzip member.
+  \param z pointer to the compression stream variable. the stream is created at the first call.
+  \param level compression level
+  \param block target block
+  \return true if successfully compressed.
+ */
+bool
+#ifdef HAVE_LIBZ
+compress_block( z_stream ** z,
+                const int level,
+                gzparallel_block & block )
+{
+    if ( ! *z )
+    {
+        z_stream * s = new z_stream;
+        s->zalloc = Z_NULL;
+        s->zfree = Z_NULL;
+        s->opaque = Z_NULL;
+
+        // windowBits + 16: write the gzip header and trailer
+        if ( deflateInit2( s, level, Z_DEFLATED, 15 + 16, 8,
+                           Z_DEFAULT_STRATEGY ) != Z_OK )
+        {
+            delete s;
+            return false;
+        }
+
+        *z = s;
+    }
+    else if ( deflateReset( *z ) != Z_OK )
+    {
+        return false;
+    }
+
+    const std::size_t bound = deflateBound( *z, static_cast< uLong >( block.input_.size() ) ) + 32;
+    if ( block.output_.size() < bound )
+    {
+        block.output_.resize( bound );
+    }
+
+    (*z)->next_in = reinterpret_cast< Bytef * >( &block.input_[0] );
+    (*z)->avail_in = static_cast< uInt >( block.size_ );
+    (*z)->next_out = reinterpret_cast< Bytef * >( &block.output_[0] );
+    (*z)->avail_out = static_cast< uInt >( block.output_.size() );
+
+    if ( deflate( *z, Z_FINISH ) != Z_STREAM_END )
+    {
+        return false;
+    }
+
+    block.output_.resize( block.output_.size() - (*z)->avail_out );
+    return true;
+}
+#else
+compress_block( void **,
+                const int,
+                gzparallel_block & block )
+{
+    // Without zlib, the data is written without any modification.
+    block.output_.assign( block.input_.begin(), block.input_.begin() + block.size_ );
+    return true;
+}
+#endif
+
+/*!
+  \brief write the compressed block to the destination.
+  \param dest destination stream buffer
+  \param block compressed block
+  \return true if successfully written.
+ */
+bool
+write_block( std::streambuf & dest,
+             const gzparallel_block & block )
+{
+    if ( ! block.ok_ )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " failed to compress the block." << std::endl;
+        return false;
+    }
+
+    const std::streamsize len = static_cast< std::streamsize >( block.output_.size() );
+    if ( len > 0
+         && dest.sputn( &block.output_[0], len ) != len )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " failed to write the compressed block." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+/*!
+  \brief implementation of gzparallelstreambuf
+
+  The filled blocks are queued to the worker threads. Each worker deflates
+  the block by its own compression stream, and the worker that completes
+  the next block in the submitted order writes the completed blocks to the
+  destination. So, the writer thread never waits for deflate while a free
+  block remains.
+ */
+struct gzparallelstreambuf_impl {
+    std::streambuf & dest_; //!< destination stream buffer
+    const int level_; //!< compression level
+
+    std::vector< gzparallel_block * > blocks_; //!< all block instances
+    std::vector< gzparallel_block * > free_; //!< blocks not used
+    gzparallel_block * current_; //!< block used as the put area
+
+    unsigned long submitted_; //!< the number of submitted blocks
+    bool error_; //!< true if compression or writing failed
+
+#ifdef HAVE_LIBZ
+    z_stream * stream_; //!< compression stream used without the worker threads
+#else
+    void * stream_; //!< dummy
+#endif
+
+#ifdef RCSC_GZ_PARALLEL_THREAD
+    std::vector< pthread_t > threads_; //!< running worker threads
+    pthread_mutex_t mutex_; //!< guard for the following variables
+    pthread_cond_t cond_; //!< notified when the queue or the free blocks are changed
+    std::deque< gzparallel_block * > todo_; //!< blocks waiting for the compression
+    std::map< unsigned long, gzparallel_block * > done_; //!< compressed blocks waiting for the writing
+    unsigned long written_; //!< the number of written blocks
+    bool writing_; //!< true if any worker is writing the blocks
+    bool stop_; //!< stop request to the workers
+#endif
+
+    /*!
+      \brief create the blocks.
+      \param dest destination stream buffer
+      \param level compression level
+      \param block_size uncompressed size of one block
+      \param block_count the number of blocks
+     */
+    gzparallelstreambuf_impl( std::streambuf & dest,
+                              const int level,
+                              const std::size_t block_size,
+                              const std::size_t block_count )
+        : dest_( dest ),
+          level_( level ),
+          current_( static_cast< gzparallel_block * >( 0 ) ),
+          submitted_( 0 ),
+          error_( false ),
+          stream_( 0 )
+#ifdef RCSC_GZ_PARALLEL_THREAD
+        , written_( 0 )
+        , writing_( false )
+        , stop_( false )
+#endif
+      {
+#ifdef RCSC_GZ_PARALLEL_THREAD
+          pthread_mutex_init( &mutex_, NULL );
+          pthread_cond_init( &cond_, NULL );
+#endif
+          for ( std::size_t i = 0; i < block_count; ++i )
+          {
+              blocks_.push_back( new gzparallel_block( block_size ) );
+          }
+          free_.assign( blocks_.begin(), blocks_.end() );
+          current_ = free_.back();
+          free_.pop_back();
+      }
+
+    /*!
+      \brief release all blocks. the worker threads must be stopped.
+     */
+    ~gzparallelstreambuf_impl()
+      {
+#ifdef RCSC_GZ_PARALLEL_THREAD
+          pthread_cond_destroy( &cond_ );
+          pthread_mutex_destroy( &mutex_ );
+#endif
+#ifdef HAVE_LIBZ
+          release_stream( stream_ );
+#endif
+          for ( std::size_t i = 0; i < blocks_.size(); ++i )
+          {
+              delete blocks_[i];
+          }
+      }
+
+    /*!
+      \brief pass the current block to the compression, and get the next free block.
+      \return true if no error occured.
+     */
+    bool submit()
+      {
+          gzparallel_block * block = current_;
+          current_ = static_cast< gzparallel_block * >( 0 );
+
+#ifdef RCSC_GZ_PARALLEL_THREAD
+          if ( ! threads_.empty() )
+          {
+              pthread_mutex_lock( &mutex_ );
+              block->seq_ = submitted_++;
+              todo_.push_back( block );
+              pthread_cond_broadcast( &cond_ );
+
+              // all blocks are used. wait for the slowest one.
+              while ( free_.empty() )
+              {
+                  pthread_cond_wait( &cond_, &mutex_ );
+              }
+              current_ = free_.back();
+              free_.pop_back();
+
+              const bool result = ! error_;
+              pthread_mutex_unlock( &mutex_ );
+              return result;
+          }
+#endif
+
+          block->seq_ = submitted_++;
+          block->ok_ = compress_block( &stream_, level_, *block );
+          if ( ! write_block( dest_, *block ) )
+          {
+              error_ = true;
+          }
+          current_ = block;
+          return ! error_;
+      }
+
+    /*!
+      \brief check the error state.
+      \return true if no error occured.
+     */
+    bool good()
+      {
+#ifdef RCSC_GZ_PARALLEL_THREAD
+          pthread_mutex_lock( &mutex_ );
+          const bool result = ! error_;
+          pthread_mutex_unlock( &mutex_ );
+          return result;
+#else
+          return ! error_;
+#endif
+      }
+
+    /*!
+      \brief wait until all submitted blocks are written.
+      \return true if no error occured.
+     */
+    bool wait()
+      {
+#ifdef RCSC_GZ_PARALLEL_THREAD
+          if ( ! threads_.empty() )
+          {
+              pthread_mutex_lock( &mutex_ );
+              while ( written_ != submitted_ )
+              {
+                  pthread_cond_wait( &cond_, &mutex_ );
+              }
+              const bool result = ! error_;
+              pthread_mutex_unlock( &mutex_ );
+              return result;
+          }
+#endif
+          return ! error_;
+      }
+
+#ifdef RCSC_GZ_PARALLEL_THREAD
+    /*!
+      \brief worker loop. compress the queued blocks until the stop request.
+     */
+    void run()
+      {
+          z_stream * stream = static_cast< z_stream * >( 0 );
+
+          pthread_mutex_lock( &mutex_ );
+          while ( true )
+          {
+              while ( todo_.empty()
+                      && ! stop_ )
+              {
+                  pthread_cond_wait( &cond_, &mutex_ );
+              }
+
+              if ( todo_.empty() )
+              {
+                  break;
+              }
+
+              gzparallel_block * block = todo_.front();
+              todo_.pop_front();
+              pthread_mutex_unlock( &mutex_ );
+
+              block->ok_ = compress_block( &stream, level_, *block );
+
+              pthread_mutex_lock( &mutex_ );
+              done_.insert( std::make_pair( block->seq_, block ) );
+              writeCompleted();
+          }
+          pthread_mutex_unlock( &mutex_ );
+
+          release_stream( stream );
+      }
+
+    /*!
+      \brief write the compressed blocks in the submitted order.
+      The mutex must be locked by the caller.
+     */
+    void writeCompleted()
+      {
+          if ( writing_ )
+          {
+              // the other worker writes this block after its own block.
+              return;
+          }
+
+          writing_ = true;
+
+          std::map< unsigned long, gzparallel_block * >::iterator it;
+          while ( ( it = done_.find( written_ ) ) != done_.end() )
+          {
+              gzparallel_block * block = it->second;
+              done_.erase( it );
+
+              const bool skip = error_;
+              pthread_mutex_unlock( &mutex_ );
+
+              const bool result = ( skip || write_block( dest_, *block ) );
+
+              pthread_mutex_lock( &mutex_ );
+              if ( ! result )
+              {
+                  error_ = true;
+              }
+              ++written_;
+              free_.push_back( block );
+              pthread_cond_broadcast( &cond_ );
+          }
+
+          writing_ = false;
+      }
+#endif
+};
+
+#ifdef RCSC_GZ_PARALLEL_THREAD
+extern "C" {
+
+/*!
+  \brief entry point of the compression worker thread.
+  \param arg pointer to gzparallelstreambuf_impl
+  \return NULL
+ */
+static
+void *
+gzparallelstreambuf_worker_main( void * arg )
+{
+    static_cast< gzparallelstreambuf_impl * >( arg )->run();
+    return NULL;
+}
+
+}
+#endif
+
+const std::size_t gzparallelstreambuf::DEFAULT_BLOCK_SIZE = 128 * 1024;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzparallelstreambuf::gzparallelstreambuf( std::streambuf & strm,
+                                          int level,
+                                          std::size_t block_size,
+                                          int threads )
+    : std::streambuf()
+    , M_strmbuf( strm )
+    , M_level( level )
+    , M_block_size( std::max( block_size, static_cast< std::size_t >( 1024 ) ) )
+    , M_threads( threads )
+{
+    if ( M_level < NO_COMPRESSION
+         || BEST_COMPRESSION < M_level )
+    {
+        M_level = DEFAULT_COMPRESSION;
+    }
+
+#ifdef RCSC_GZ_PARALLEL_THREAD
+    if ( M_threads <= 0 )
+    {
+        const long n = sysconf( _SC_NPROCESSORS_ONLN );
+        M_threads = ( n > 0 ? static_cast< int >( n ) : 1 );
+    }
+#else
+    M_threads = 0;
+#endif
+
+    // each worker can hold two blocks, one is compressed and the other is queued.
+    // the last one is used as the put area.
+    M_impl.reset( new gzparallelstreambuf_impl( M_strmbuf, M_level, M_block_size,
+                                                M_threads * 2 + 1 ) );
+
+#ifdef RCSC_GZ_PARALLEL_THREAD
+    for ( int i = 0; i < M_threads; ++i )
+    {
+        pthread_t thread;
+        if ( pthread_create( &thread, NULL,
+                             gzparallelstreambuf_worker_main, M_impl.get() ) != 0 )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__
+                      << " failed to create the compression thread." << std::endl;
+            break;
+        }
+        M_impl->threads_.push_back( thread );
+    }
+    M_threads = static_cast< int >( M_impl->threads_.size() );
+    if ( M_threads == 0 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " the blocks are compressed synchronously." << std::endl;
+    }
+#endif
+
+    this->setp( &M_impl->current_->input_[0],
+                &M_impl->current_->input_[0] + M_block_size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzparallelstreambuf::~gzparallelstreambuf()
+{
+    finish();
+
+#ifdef RCSC_GZ_PARALLEL_THREAD
+    pthread_mutex_lock( &M_impl->mutex_ );
+    M_impl->stop_ = true;
+    pthread_cond_broadcast( &M_impl->cond_ );
+    pthread_mutex_unlock( &M_impl->mutex_ );
+
+    for ( std::size_t i = 0; i < M_impl->threads_.size(); ++i )
+    {
+        pthread_join( M_impl->threads_[i], NULL );
+    }
+    M_impl->threads_.clear();
+#endif
+
+    this->setp( NULL, NULL );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+gzparallelstreambuf::finish()
+{
+    // an empty member is written for the empty output
+    if ( pptr() != pbase()
+         || M_impl->submitted_ == 0 )
+    {
+        if ( ! submitBlock() )
+        {
+            M_impl->wait();
+            return false;
+        }
+    }
+
+    if ( ! M_impl->wait() )
+    {
+        return false;
+    }
+
+    return M_strmbuf.pubsync() == 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::streambuf::int_type
+gzparallelstreambuf::overflow( int_type c )
+{
+    if ( pptr() == epptr()
+         && ! submitBlock() )
+    {
+        return traits_type::eof();
+    }
+
+    if ( c != traits_type::eof() )
+    {
+        *pptr() = traits_type::to_char_type( c );
+        pbump( 1 );
+        return c;
+    }
+
+    return traits_type::not_eof( c );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+gzparallelstreambuf::sync()
+{
+    if ( pptr() == epptr()
+         && ! submitBlock() )
+    {
+        return -1;
+    }
+
+    return ( M_impl->good() ? 0 : -1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+gzparallelstreambuf::submitBlock()
+{
+    M_impl->current_->size_ = pptr() - pbase();
+
+    const bool result = M_impl->submit();
+
+    this->setp( &M_impl->current_->input_[0],
+                &M_impl->current_->input_[0] + M_block_size );
+
+    return result;
+}
+
+/////////////////////////////////////////////////////////////////////
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzoparallelstream::gzoparallelstream( std::streambuf & dest,
+                                      int level,
+                                      std::size_t block_size,
+                                      int threads )
+    : std::ostream( static_cast< std::streambuf * >( 0 ) )
+    , M_parallel_buf( dest, level, block_size, threads )
+{
+    this->init( &M_parallel_buf );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzoparallelstream::gzoparallelstream( std::ostream & dest,
+                                      int level,
+                                      std::size_t block_size,
+                                      int threads )
+    : std::ostream( static_cast< std::streambuf * >( 0 ) )
+    , M_parallel_buf( *dest.rdbuf(), level, block_size, threads )
+{
+    this->init( &M_parallel_buf );
+}
+
+} // end namespace
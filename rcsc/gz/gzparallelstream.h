@@ -0,0 +1,237 @@
+// -*-c++-*-
+
+/*!
+  \file gzparallelstream.h
+  \brief parallel gzip compression stream Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_GZ_GZPARALLELSTREAM_H
+#define RCSC_GZ_GZPARALLELSTREAM_H
+
+#include <boost/scoped_ptr.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace rcsc {
+
+struct gzparallelstreambuf_impl;
+
+/////////////////////////////////////////////////////////////////////
+/*!
+  \class gzparallelstreambuf
+  \brief gzip output stream buffer that compresses the blocks in parallel.
+
+  The written data is split into the fixed size blocks, and each block is
+  compressed into an independent gzip member. The output is a sequence
+  of the gzip members, which is a standard gzip stream readable by
+  gunzip, gzopen() and gzfilebuf.
+
+  The put area is one block. When it is filled, the block is queued to the
+  background worker threads and the next free block becomes the put area,
+  so the writer does not wait for deflate. The workers compress the blocks
+  at the same time, and write them to the destination in the original
+  order. The writer waits only when all blocks (two per thread) are in use.
+  Without pthread (e.g. win32), the blocks are compressed in the writer
+  thread.
+
+  The destination is written by the worker threads. It must not be used
+  by others until finish() returns or this object is destroyed.
+
+  sync() never waits for the compression, so std::endl or flush() does
+  not cut the data into small members nor block the writer. The last
+  partial block is written by finish() or the destructor.
+*/
+class gzparallelstreambuf
+    : public std::streambuf {
+public:
+
+    /*!
+      \brief typical compression level enumeration
+    */
+    enum CompressionLevel {
+        DEFAULT_COMPRESSION = 6,
+        NO_COMPRESSION = 0,
+        BEST_SPEED = 1,
+        BEST_COMPRESSION = 9,
+    };
+
+    //! default block size in bytes
+    static const std::size_t DEFAULT_BLOCK_SIZE;
+
+private:
+
+    //! destination stream buffer
+    std::streambuf & M_strmbuf;
+
+    //! compression level
+    int M_level;
+    //! uncompressed size of one block
+    std::size_t M_block_size;
+    //! the number of compression threads
+    int M_threads;
+
+    //! Pimpl ideom.
+    boost::scoped_ptr< gzparallelstreambuf_impl > M_impl;
+
+    //! not used
+    gzparallelstreambuf( const gzparallelstreambuf & );
+    //! not used
+    gzparallelstreambuf & operator=( const gzparallelstreambuf & );
+
+public:
+
+    /*!
+      \brief constructor with the destination stream buffer
+      \param strm destination stream buffer
+      \param level gzip compression level (0-9)
+      \param block_size uncompressed size of one gzip member
+      \param threads the number of compression threads.
+      if 0, the number of the online processors is used.
+    */
+    explicit
+    gzparallelstreambuf( std::streambuf & strm,
+                         int level = DEFAULT_COMPRESSION,
+                         std::size_t block_size = DEFAULT_BLOCK_SIZE,
+                         int threads = 0 );
+
+    /*!
+      \brief destructor. all buffered data is written.
+    */
+    ~gzparallelstreambuf();
+
+    /*!
+      \brief get the uncompressed size of one block.
+      \return block size in bytes
+     */
+    std::size_t blockSize() const
+      {
+          return M_block_size;
+      }
+
+    /*!
+      \brief get the number of compression threads.
+      \return the number of threads. 0 if the blocks are compressed in the writer thread.
+     */
+    int threads() const
+      {
+          return M_threads;
+      }
+
+    /*!
+      \brief compress and write all buffered data including the partial block.
+      wait until all blocks are written, then synchronize the destination.
+      \return true if successfully written.
+     */
+    bool finish();
+
+protected:
+
+    /*!
+      \brief pass the filled block to the workers, then put the character.
+      \param c put character
+      \return c, or EOF if failed.
+     */
+    virtual
+    int_type overflow( int_type c );
+
+    /*!
+      \brief pass the filled block to the workers. the partial block is kept.
+      \retval 0 no error occured
+      \retval -1 failed
+     */
+    virtual
+    int sync();
+
+private:
+
+    /*!
+      \brief pass the put area to the compression, and set the next free block to the put area.
+      \return true if no error occured.
+     */
+    bool submitBlock();
+};
+
+/////////////////////////////////////////////////////////////////////
+
+/*!
+  \class gzoparallelstream
+  \brief gzip output stream class that compresses the blocks in parallel.
+*/
+class gzoparallelstream
+    : public std::ostream {
+private:
+
+    //! buffer for this steram
+    gzparallelstreambuf M_parallel_buf;
+
+    //! not used.
+    gzoparallelstream( const gzoparallelstream & );
+    //! not used.
+    gzoparallelstream & operator=( const gzoparallelstream & );
+
+public:
+
+    /*!
+      \brief constructor with another stream buffer
+      \param dest destination stream buffer
+      \param level gzip compression level
+      \param block_size uncompressed size of one gzip member
+      \param threads the number of compression threads
+     */
+    explicit
+    gzoparallelstream( std::streambuf & dest,
+                       int level = gzparallelstreambuf::DEFAULT_COMPRESSION,
+                       std::size_t block_size = gzparallelstreambuf::DEFAULT_BLOCK_SIZE,
+                       int threads = 0 );
+
+    /*!
+      \brief constructor with another stream
+      \param dest destination stream
+      \param level gzip compression level
+      \param block_size uncompressed size of one gzip member
+      \param threads the number of compression threads
+    */
+    explicit
+    gzoparallelstream( std::ostream & dest,
+                       int level = gzparallelstreambuf::DEFAULT_COMPRESSION,
+                       std::size_t block_size = gzparallelstreambuf::DEFAULT_BLOCK_SIZE,
+                       int threads = 0 );
+
+    /*!
+      \brief write all buffered data including the partial block.
+      \return true if successfully written.
+     */
+    bool finish()
+      {
+          return M_parallel_buf.finish();
+      }
+};
+
+} // end namespace
+
+#endif
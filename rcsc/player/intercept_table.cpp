@@ -61,6 +61,7 @@ InterceptTable::InterceptTable( const WorldModel & world )
     , M_update_time( 0, 0 )
 {
     M_ball_pos_cache.reserve( MAX_CYCLE + 2 );
+    M_ball_pos_array.reserve( MAX_CYCLE + 2 );
     //M_ball_vel_cache.reserve( MAX_CYCLE + 2 );
 
     M_self_cache.reserve( ( MAX_CYCLE + 2 ) * 2 );
@@ -85,6 +86,7 @@ void
 InterceptTable::clear()
 {
     M_ball_pos_cache.clear();
+    M_ball_pos_array.clear();
 
     M_self_reach_cycle = 1000;
     M_self_exhaust_reach_cycle = 1000;
@@ -346,6 +348,7 @@ InterceptTable::createBallCache()
 
     if ( M_world.self().isKickable() )
     {
+        M_ball_pos_array.assign( M_ball_pos_cache );
         return;
     }
 
@@ -375,6 +378,8 @@ InterceptTable::createBallCache()
     {
         M_ball_pos_cache.push_back( bpos );
     }
+
+    M_ball_pos_array.assign( M_ball_pos_cache );
 }
 
 /*-------------------------------------------------------------------*/
@@ -494,7 +499,7 @@ InterceptTable::predictTeammate()
     int min_cycle = 1000;
     int second_min_cycle = 1000;
 
-    PlayerIntercept predictor( M_world, M_ball_pos_cache );
+    PlayerIntercept predictor( M_world, M_ball_pos_cache, M_ball_pos_array );
 
     for ( PlayerPtrCont::const_iterator it = teammates.begin();
           it != t_end;
@@ -601,7 +606,7 @@ InterceptTable::predictOpponent()
     int min_cycle = 1000;
     int second_min_cycle = 1000;
 
-    PlayerIntercept predictor( M_world, M_ball_pos_cache );
+    PlayerIntercept predictor( M_world, M_ball_pos_cache, M_ball_pos_array );
 
     for ( PlayerPtrCont::const_iterator it = opponents.begin();
           it != o_end;
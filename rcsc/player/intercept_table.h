@@ -33,6 +33,7 @@
 #define RCSC_PLAYER_INTERCEPT_TABLE_H
 
 #include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/vector_2d_array.h>
 #include <rcsc/game_time.h>
 #include <vector>
 
@@ -277,6 +278,8 @@ private:
 
     //! cache of predicted future ball positions
     std::vector< Vector2D > M_ball_pos_cache;
+    //! the same ball positions in the structure-of-arrays layout
+    Vector2DArray M_ball_pos_array;
     //std::vector< Vector2D > M_ball_vel_cache;
 
     //! predicted min reach cycle for self without stamina exhaust
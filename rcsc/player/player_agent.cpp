@@ -1191,6 +1191,9 @@ PlayerAgent::Impl::openDebugLog()
     filepath << agent_.config().teamName() << '-' << agent_.world().self().unum()
              << agent_.config().debugLogExt();
 
+    dlog.setFormat( agent_.config().debugLogBinary()
+                    ? Logger::BINARY_FORMAT
+                    : Logger::TEXT_FORMAT );
     dlog.open( filepath.str() );
 
     if ( ! dlog.isOpen() )
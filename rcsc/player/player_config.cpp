@@ -144,6 +144,7 @@ PlayerConfig::setDefaultParam()
     // debug logging
     //
     M_debug_log_ext = ".log";
+    M_debug_log_binary = false;
 
     M_debug_system = false;
     M_debug_sensor = false;
@@ -233,6 +234,7 @@ PlayerConfig::createParamMap( ParamMap & param_map )
         ( "offline_client_number", "", &M_offline_client_number )
 
         ( "debug_log_ext", "", &M_debug_log_ext )
+        ( "debug_log_binary", "", BoolSwitch( &M_debug_log_binary ) )
 
         ( "debug_system", "", BoolSwitch( &M_debug_system ) )
         ( "debug_sensor", "", BoolSwitch( &M_debug_sensor ) )
@@ -134,6 +134,7 @@ private:
     //
 
     std::string M_debug_log_ext; //!< the extension string of debug log file
+    bool M_debug_log_binary; //!< if true, debug log is written in the binary format
 
     bool M_debug_system; //!< debug level flag
     bool M_debug_sensor; //!< debug level flag
@@ -452,6 +453,12 @@ public:
      */
     const std::string & debugLogExt() const { return M_debug_log_ext; }
 
+    /*!
+      \brief check if the debug log is written in the binary format.
+      \return true if the binary format is used.
+     */
+    bool debugLogBinary() const { return M_debug_log_binary; }
+
     /*!
       \brief get the debug flag
       \return debug flag
@@ -97,6 +97,9 @@ PlayerIntercept::predict( const PlayerObject & player,
     const std::size_t MAX_LOOP = std::min( static_cast< std::size_t >( max_cycle ),
                                            M_ball_pos_cache.size() );
 
+    // squared distances to all ball positions are computed at once
+    M_ball_pos_array.dist2( player_pos, M_ball_dist2 );
+
     for ( std::size_t cycle = static_cast< std::size_t >( min_cycle );
           cycle < MAX_LOOP;
           ++cycle )
@@ -113,8 +116,10 @@ PlayerIntercept::predict( const PlayerObject & player,
                                       ? ServerParam::i().catchableArea()
                                       : player_type.kickableArea() );
 
-        if ( control_area + player_type.realSpeedMax() * ( cycle + pos_count ) + 0.5
-             < player_pos.dist( ball_pos ) )
+        const double reach_dist = ( control_area
+                                    + player_type.realSpeedMax() * ( cycle + pos_count )
+                                    + 0.5 );
+        if ( reach_dist * reach_dist < M_ball_dist2[cycle] )
         {
             // never reach
 #ifdef DEBUG2
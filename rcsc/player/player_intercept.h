@@ -33,6 +33,7 @@
 #define RCSC_PLAYER_PLAYER_INTERCEPT_H
 
 #include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/vector_2d_array.h>
 #include <vector>
 
 namespace rcsc {
@@ -52,6 +53,11 @@ private:
     const WorldModel & M_world;
     //! const reference to the predicted ball position cache instance
     const std::vector< Vector2D > & M_ball_pos_cache;
+    //! const reference to the same ball positions in the structure-of-arrays layout
+    const Vector2DArray & M_ball_pos_array;
+
+    //! work buffer for squared distances from the player to the ball positions
+    mutable std::vector< double > M_ball_dist2;
 
     // not used
     PlayerIntercept();
@@ -62,11 +68,14 @@ public:
       \brief construct with all variables.
       \param world const reference to the WormdModel instance
       \param ball_pos_cache const reference to the ball position container
+      \param ball_pos_array const reference to the ball position array
     */
     PlayerIntercept( const WorldModel & world,
-                     const std::vector< Vector2D > & ball_pos_cache )
+                     const std::vector< Vector2D > & ball_pos_cache,
+                     const Vector2DArray & ball_pos_array )
         : M_world( world )
         , M_ball_pos_cache( ball_pos_cache )
+        , M_ball_pos_array( ball_pos_array )
       { }
 
     /*!
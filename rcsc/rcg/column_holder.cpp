@@ -0,0 +1,489 @@
+// -*-c++-*-
+
+/*!
+  \file column_holder.cpp
+  \brief columnar game log holder Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "column_holder.h"
+
+#include "util.h"
+
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#ifdef HAVE_WINDOWS_H
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const float RAD2DEGF = 180.0f / 3.14159265358979323846f;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+rcsc::rcg::TeamT
+to_team( const rcsc::rcg::team_t & from )
+{
+    char buf[18];
+    std::memset( buf, 0, 18 );
+    std::memcpy( buf, from.name, sizeof( from.name ) );
+
+    rcsc::rcg::TeamT to;
+    to.name_ = buf;
+    to.score_ = ntohs( from.score );
+    return to;
+}
+
+}
+
+namespace rcsc {
+namespace rcg {
+
+const int ColumnHolder::PLAYER_SLOTS;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+ColumnHolder::ColumnHolder()
+    : Holder(),
+      M_last_playmode( PM_Null )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+ColumnHolder::clear()
+{
+    M_time.clear();
+    M_playmode.clear();
+
+    M_ball_x.clear();
+    M_ball_y.clear();
+    M_ball_vx.clear();
+    M_ball_vy.clear();
+
+    for ( int i = 0; i < PLAYER_SLOTS; ++i )
+    {
+        M_player_state[i].clear();
+        M_player_x[i].clear();
+        M_player_y[i].clear();
+        M_player_body[i].clear();
+        M_player_stamina[i].clear();
+    }
+
+    M_last_playmode = PM_Null;
+    M_playmodes.clear();
+    M_teams.clear();
+    M_msgs.clear();
+
+    M_strings.clear();
+    M_string_ids.clear();
+
+    M_server_params.clear();
+    M_player_params.clear();
+    M_player_types.clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+ColumnHolder::reserve( const std::size_t rows )
+{
+    M_time.reserve( rows );
+    M_playmode.reserve( rows );
+
+    M_ball_x.reserve( rows );
+    M_ball_y.reserve( rows );
+    M_ball_vx.reserve( rows );
+    M_ball_vy.reserve( rows );
+
+    for ( int i = 0; i < PLAYER_SLOTS; ++i )
+    {
+        M_player_state[i].reserve( rows );
+        M_player_x[i].reserve( rows );
+        M_player_y[i].reserve( rows );
+        M_player_body[i].reserve( rows );
+        M_player_stamina[i].reserve( rows );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::size_t
+ColumnHolder::index( const int time ) const
+{
+    if ( time <= 0 )
+    {
+        return 0;
+    }
+
+    return std::lower_bound( M_time.begin(), M_time.end(),
+                             static_cast< UInt32 >( time ) )
+        - M_time.begin();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+ColumnHolder::intern( const std::string & str )
+{
+    std::map< std::string, int >::iterator it = M_string_ids.lower_bound( str );
+    if ( it != M_string_ids.end()
+         && it->first == str )
+    {
+        return it->second;
+    }
+
+    const int id = static_cast< int >( M_strings.size() );
+    M_strings.push_back( str );
+    M_string_ids.insert( it, std::make_pair( str, id ) );
+    return id;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addShowInfo( const showinfo_t & show )
+{
+    const int time = static_cast< UInt16 >( ntohs( show.time ) );
+
+    // showinfo_t always contains the playmode and the team data.
+    const PlayMode pm = static_cast< PlayMode >( show.pmode );
+    if ( M_playmodes.empty()
+         || M_last_playmode != pm )
+    {
+        addPlayMode( time, pm );
+    }
+
+    const TeamT team_l = to_team( show.team[0] );
+    const TeamT team_r = to_team( show.team[1] );
+    if ( M_teams.empty()
+         || ! M_teams.back().team_l_.equals( team_l )
+         || ! M_teams.back().team_r_.equals( team_r ) )
+    {
+        addTeam( time, team_l, team_r );
+    }
+
+    M_time.push_back( static_cast< UInt32 >( time ) );
+    M_playmode.push_back( static_cast< char >( M_last_playmode ) );
+
+    M_ball_x.push_back( nstohf( show.pos[0].x ) );
+    M_ball_y.push_back( nstohf( show.pos[0].y ) );
+    M_ball_vx.push_back( 0.0f );
+    M_ball_vy.push_back( 0.0f );
+
+    for ( int i = 0; i < PLAYER_SLOTS; ++i )
+    {
+        const pos_t & p = show.pos[i+1];
+        M_player_state[i].push_back( static_cast< Int32 >( ntohs( p.enable ) ) );
+        M_player_x[i].push_back( nstohf( p.x ) );
+        M_player_y[i].push_back( nstohf( p.y ) );
+        M_player_body[i].push_back( static_cast< float >( static_cast< Int16 >( ntohs( p.angle ) ) ) );
+        M_player_stamina[i].push_back( 0.0f );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addShowInfo2( const showinfo_t2 & show )
+{
+    const int time = static_cast< UInt16 >( ntohs( show.time ) );
+
+    const PlayMode pm = static_cast< PlayMode >( show.pmode );
+    if ( M_playmodes.empty()
+         || M_last_playmode != pm )
+    {
+        addPlayMode( time, pm );
+    }
+
+    const TeamT team_l = to_team( show.team[0] );
+    const TeamT team_r = to_team( show.team[1] );
+    if ( M_teams.empty()
+         || ! M_teams.back().team_l_.equals( team_l )
+         || ! M_teams.back().team_r_.equals( team_r ) )
+    {
+        addTeam( time, team_l, team_r );
+    }
+
+    return addLegacyShow( time, show.ball, show.pos );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addShortShowInfo2( const short_showinfo_t2 & show2 )
+{
+    const int time = static_cast< UInt16 >( ntohs( show2.time ) );
+
+    return addLegacyShow( time, show2.ball, show2.pos );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addLegacyShow( const int time,
+                             const ball_t & ball,
+                             const player_t * players )
+{
+    M_time.push_back( static_cast< UInt32 >( time ) );
+    M_playmode.push_back( static_cast< char >( M_last_playmode ) );
+
+    M_ball_x.push_back( nltohf( ball.x ) );
+    M_ball_y.push_back( nltohf( ball.y ) );
+    M_ball_vx.push_back( nltohf( ball.deltax ) );
+    M_ball_vy.push_back( nltohf( ball.deltay ) );
+
+    for ( int i = 0; i < PLAYER_SLOTS; ++i )
+    {
+        const player_t & p = players[i];
+        M_player_state[i].push_back( static_cast< Int32 >( ntohs( p.mode ) ) );
+        M_player_x[i].push_back( nltohf( p.x ) );
+        M_player_y[i].push_back( nltohf( p.y ) );
+        M_player_body[i].push_back( nltohf( p.body_angle ) * RAD2DEGF );
+        M_player_stamina[i].push_back( nltohf( p.stamina ) );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addMsgInfo( const Int16 board,
+                          const std::string & msg )
+{
+    return addMsg( lastTime(), static_cast< Int16 >( ntohs( board ) ), msg );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addDrawInfo( const drawinfo_t & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addPlayMode( const char pmode )
+{
+    return addPlayMode( lastTime(), static_cast< PlayMode >( pmode ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addTeamInfo( const team_t & team_l,
+                           const team_t & team_r )
+{
+    return addTeam( lastTime(), to_team( team_l ), to_team( team_r ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addPlayerType( const player_type_t & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addServerParam( const server_params_t & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addPlayerParam( const player_params_t & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addShow( const int time,
+                       const ShowInfoT & show )
+{
+    M_time.push_back( static_cast< UInt32 >( time ) );
+    M_playmode.push_back( static_cast< char >( M_last_playmode ) );
+
+    M_ball_x.push_back( show.ball_.x_ );
+    M_ball_y.push_back( show.ball_.y_ );
+    M_ball_vx.push_back( show.ball_.vx_ );
+    M_ball_vy.push_back( show.ball_.vy_ );
+
+    for ( int i = 0; i < PLAYER_SLOTS; ++i )
+    {
+        const PlayerT & p = show.player_[i];
+        M_player_state[i].push_back( p.state_ );
+        M_player_x[i].push_back( p.x_ );
+        M_player_y[i].push_back( p.y_ );
+        M_player_body[i].push_back( p.body_ );
+        M_player_stamina[i].push_back( p.stamina_ );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addMsg( const int time,
+                      const int board,
+                      const std::string & msg )
+{
+    MsgEvent ev;
+    ev.time_ = time;
+    ev.board_ = board;
+    ev.string_id_ = intern( msg );
+
+    M_msgs.push_back( ev );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addPlayMode( const int time,
+                           const PlayMode pm )
+{
+    M_last_playmode = pm;
+    M_playmodes.push_back( std::make_pair( time, pm ) );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addTeam( const int time,
+                       const TeamT & team_l,
+                       const TeamT & team_r )
+{
+    TeamEvent ev;
+    ev.time_ = time;
+    ev.team_l_ = team_l;
+    ev.team_r_ = team_r;
+
+    M_teams.push_back( ev );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addServerParam( const std::string & msg )
+{
+    M_server_params.push_back( msg );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addPlayerParam( const std::string & msg )
+{
+    M_player_params.push_back( msg );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+ColumnHolder::addPlayerType( const std::string & msg )
+{
+    M_player_types.push_back( msg );
+    return true;
+}
+
+}
+}
@@ -0,0 +1,438 @@
+// -*-c++-*-
+
+/*!
+  \file column_holder.h
+  \brief columnar game log holder Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_COLUMN_HOLDER_H
+#define RCSC_RCG_COLUMN_HOLDER_H
+
+#include <rcsc/rcg/holder.h>
+#include <rcsc/rcg/types.h>
+#include <rcsc/types.h>
+
+#include <vector>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace rcsc {
+namespace rcg {
+
+/*!
+  \class ColumnHolder
+  \brief game log holder that stores the show data as the column arrays.
+
+  Each show data appends one row. The row values are stored in the
+  separated contiguous arrays (ball x, ball y, player x of the slot 0, ...),
+  so an analysis that reads a few values over the whole match touches only
+  those arrays, and the simple loops over them can be vectorized by the
+  compiler. Player slots 0-10 are the left players and 11-21 are the right
+  players, as the player array of ShowInfoT.
+
+  Each message string is stored only once in the string table, and the
+  message events refer to it by the string id.
+
+  The playmode and the team data are stored as the events with the game
+  time, and the playmode in effect is also recorded for each row. The
+  server_param, player_param and player_type messages of rcg v4/v5 are
+  kept as the raw strings. The binary parameter structs and drawinfo_t of
+  the older formats are accepted but not stored.
+*/
+class ColumnHolder
+    : public Holder {
+public:
+
+    //! the number of player slots
+    static const int PLAYER_SLOTS = MAX_PLAYER * 2;
+
+    /*!
+      \struct MsgEvent
+      \brief message data
+     */
+    struct MsgEvent {
+        int time_; //!< game time
+        int board_; //!< message board type
+        int string_id_; //!< index of the string table
+    };
+
+    /*!
+      \struct TeamEvent
+      \brief team data
+     */
+    struct TeamEvent {
+        int time_; //!< game time
+        TeamT team_l_; //!< left team
+        TeamT team_r_; //!< right team
+    };
+
+private:
+
+    //
+    // rows
+    //
+
+    std::vector< UInt32 > M_time; //!< game time
+    std::vector< char > M_playmode; //!< playmode in effect
+
+    std::vector< float > M_ball_x; //!< ball position x
+    std::vector< float > M_ball_y; //!< ball position y
+    std::vector< float > M_ball_vx; //!< ball velocity x
+    std::vector< float > M_ball_vy; //!< ball velocity y
+
+    std::vector< Int32 > M_player_state[PLAYER_SLOTS]; //!< player state flags
+    std::vector< float > M_player_x[PLAYER_SLOTS]; //!< player position x
+    std::vector< float > M_player_y[PLAYER_SLOTS]; //!< player position y
+    std::vector< float > M_player_body[PLAYER_SLOTS]; //!< player body direction (degree)
+    std::vector< float > M_player_stamina[PLAYER_SLOTS]; //!< player stamina
+
+    //
+    // events
+    //
+
+    PlayMode M_last_playmode; //!< last received playmode
+    std::vector< std::pair< int, PlayMode > > M_playmodes; //!< playmode events
+    std::vector< TeamEvent > M_teams; //!< team events
+    std::vector< MsgEvent > M_msgs; //!< message events
+
+    std::vector< std::string > M_strings; //!< interned message strings
+    std::map< std::string, int > M_string_ids; //!< string to the index of M_strings
+
+    std::vector< std::string > M_server_params; //!< raw server_param messages
+    std::vector< std::string > M_player_params; //!< raw player_param messages
+    std::vector< std::string > M_player_types; //!< raw player_type messages
+
+public:
+
+    /*!
+      \brief create the empty holder.
+     */
+    ColumnHolder();
+
+    /*!
+      \brief clear all data.
+     */
+    void clear();
+
+    /*!
+      \brief reserve the capacity of all row arrays.
+      \param rows the number of rows
+     */
+    void reserve( const std::size_t rows );
+
+    /*!
+      \brief get the number of rows.
+      \return the number of the stored show data
+     */
+    std::size_t size() const
+      {
+          return M_time.size();
+      }
+
+    /*!
+      \brief check if no row is stored.
+      \return true if no show data is stored.
+     */
+    bool empty() const
+      {
+          return M_time.empty();
+      }
+
+    /*!
+      \brief get the row index of the game time.
+      \param time game time
+      \return index of the first row whose time is equal or greater than time. size() if not found.
+     */
+    std::size_t index( const int time ) const;
+
+    //
+    // row columns
+    //
+
+    /*!
+      \brief get the game time column.
+      \return const reference to the column
+     */
+    const std::vector< UInt32 > & time() const
+      {
+          return M_time;
+      }
+
+    /*!
+      \brief get the playmode column. the value is PlayMode.
+      \return const reference to the column
+     */
+    const std::vector< char > & playmode() const
+      {
+          return M_playmode;
+      }
+
+    /*!
+      \brief get the ball position x column.
+      \return const reference to the column
+     */
+    const std::vector< float > & ballX() const
+      {
+          return M_ball_x;
+      }
+
+    /*!
+      \brief get the ball position y column.
+      \return const reference to the column
+     */
+    const std::vector< float > & ballY() const
+      {
+          return M_ball_y;
+      }
+
+    /*!
+      \brief get the ball velocity x column.
+      \return const reference to the column
+     */
+    const std::vector< float > & ballVX() const
+      {
+          return M_ball_vx;
+      }
+
+    /*!
+      \brief get the ball velocity y column.
+      \return const reference to the column
+     */
+    const std::vector< float > & ballVY() const
+      {
+          return M_ball_vy;
+      }
+
+    /*!
+      \brief get the player state column.
+      \param slot player slot [0, PLAYER_SLOTS)
+      \return const reference to the column
+     */
+    const std::vector< Int32 > & playerState( const int slot ) const
+      {
+          return M_player_state[slot];
+      }
+
+    /*!
+      \brief get the player position x column.
+      \param slot player slot [0, PLAYER_SLOTS)
+      \return const reference to the column
+     */
+    const std::vector< float > & playerX( const int slot ) const
+      {
+          return M_player_x[slot];
+      }
+
+    /*!
+      \brief get the player position y column.
+      \param slot player slot [0, PLAYER_SLOTS)
+      \return const reference to the column
+     */
+    const std::vector< float > & playerY( const int slot ) const
+      {
+          return M_player_y[slot];
+      }
+
+    /*!
+      \brief get the player body direction column.
+      \param slot player slot [0, PLAYER_SLOTS)
+      \return const reference to the column
+     */
+    const std::vector< float > & playerBody( const int slot ) const
+      {
+          return M_player_body[slot];
+      }
+
+    /*!
+      \brief get the player stamina column.
+      \param slot player slot [0, PLAYER_SLOTS)
+      \return const reference to the column
+     */
+    const std::vector< float > & playerStamina( const int slot ) const
+      {
+          return M_player_stamina[slot];
+      }
+
+    //
+    // events
+    //
+
+    /*!
+      \brief get the playmode events.
+      \return const reference to the container of (time, playmode)
+     */
+    const std::vector< std::pair< int, PlayMode > > & playmodeEvents() const
+      {
+          return M_playmodes;
+      }
+
+    /*!
+      \brief get the team events.
+      \return const reference to the container
+     */
+    const std::vector< TeamEvent > & teamEvents() const
+      {
+          return M_teams;
+      }
+
+    /*!
+      \brief get the message events.
+      \return const reference to the container
+     */
+    const std::vector< MsgEvent > & msgEvents() const
+      {
+          return M_msgs;
+      }
+
+    /*!
+      \brief get the interned string.
+      \param id string id
+      \return const reference to the string
+     */
+    const std::string & str( const int id ) const
+      {
+          return M_strings[id];
+      }
+
+    /*!
+      \brief get the interned strings.
+      \return const reference to the string table
+     */
+    const std::vector< std::string > & strings() const
+      {
+          return M_strings;
+      }
+
+    /*!
+      \brief get the raw server_param messages.
+      \return const reference to the container
+     */
+    const std::vector< std::string > & serverParams() const
+      {
+          return M_server_params;
+      }
+
+    /*!
+      \brief get the raw player_param messages.
+      \return const reference to the container
+     */
+    const std::vector< std::string > & playerParams() const
+      {
+          return M_player_params;
+      }
+
+    /*!
+      \brief get the raw player_type messages.
+      \return const reference to the container
+     */
+    const std::vector< std::string > & playerTypes() const
+      {
+          return M_player_types;
+      }
+
+    //
+    // Holder interface
+    //
+
+    virtual
+    bool addShowInfo( const showinfo_t & show );
+
+    virtual
+    bool addShowInfo2( const showinfo_t2 & show );
+
+    virtual
+    bool addShortShowInfo2( const short_showinfo_t2 & show2 );
+
+    virtual
+    bool addMsgInfo( const Int16 board,
+                     const std::string & msg );
+
+    virtual
+    bool addDrawInfo( const drawinfo_t & draw );
+
+    virtual
+    bool addPlayMode( const char pmode );
+
+    virtual
+    bool addTeamInfo( const team_t & team_l,
+                      const team_t & team_r );
+
+    virtual
+    bool addPlayerType( const player_type_t & ptinfo );
+
+    virtual
+    bool addServerParam( const server_params_t & sparams );
+
+    virtual
+    bool addPlayerParam( const player_params_t & pparams );
+
+    virtual
+    bool addShow( const int time,
+                  const ShowInfoT & show );
+
+    virtual
+    bool addMsg( const int time,
+                 const int board,
+                 const std::string & msg );
+
+    virtual
+    bool addPlayMode( const int time,
+                      const PlayMode pm );
+
+    virtual
+    bool addTeam( const int time,
+                  const TeamT & team_l,
+                  const TeamT & team_r );
+
+    virtual
+    bool addServerParam( const std::string & msg );
+
+    virtual
+    bool addPlayerParam( const std::string & msg );
+
+    virtual
+    bool addPlayerType( const std::string & msg );
+
+private:
+
+    int lastTime() const
+      {
+          return ( M_time.empty() ? 0 : static_cast< int >( M_time.back() ) );
+      }
+
+    int intern( const std::string & str );
+
+    bool addLegacyShow( const int time,
+                        const ball_t & ball,
+                        const player_t * players );
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
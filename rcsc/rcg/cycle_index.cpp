@@ -0,0 +1,1202 @@
+// -*-c++-*-
+
+/*!
+  \file cycle_index.cpp
+  \brief random access index of rcg file Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#ifdef HAVE_WINDOWS_H
+#include <windows.h>
+#endif
+
+#include "cycle_index.h"
+
+#include "parser_v2.h"
+#include "parser_v3.h"
+#include "parser_v4.h"
+#include "parser_v5.h"
+#include "show_scanner.h"
+#include "handler.h"
+#include "types.h"
+#include "util.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+namespace {
+
+using namespace rcsc;
+using namespace rcsc::rcg;
+
+//! magic number of the sidecar file
+const char INDEX_MAGIC[4] = { 'R', 'C', 'G', 'I' };
+
+//! format version of the sidecar file
+const boost::uint32_t INDEX_FORMAT = 1;
+
+//! size of the deflate window
+const int WINDOW_SIZE = 32768;
+
+//! size of the compressed input buffer
+const int INPUT_SIZE = 16384;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the size and the modification time of the file.
+ */
+bool
+file_status( const std::string & filepath,
+             boost::int64_t * size,
+             boost::int64_t * time )
+{
+    struct stat st;
+    if ( ::stat( filepath.c_str(), &st ) != 0 )
+    {
+        return false;
+    }
+
+    *size = static_cast< boost::int64_t >( st.st_size );
+    *time = static_cast< boost::int64_t >( st.st_mtime );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check the gzip magic number.
+ */
+bool
+is_gzip_file( const std::string & filepath )
+{
+    std::FILE * fp = std::fopen( filepath.c_str(), "rb" );
+    if ( ! fp )
+    {
+        return false;
+    }
+
+    unsigned char magic[2] = { 0, 0 };
+    const bool result = ( std::fread( magic, 1, 2, fp ) == 2
+                          && magic[0] == 0x1f
+                          && magic[1] == 0x8b );
+    std::fclose( fp );
+    return result;
+}
+
+//
+// sidecar values are written in network byte order.
+//
+
+void
+write_u32( std::ostream & os,
+           const boost::uint32_t value )
+{
+    const boost::uint32_t n = htonl( value );
+    os.write( reinterpret_cast< const char * >( &n ), sizeof( n ) );
+}
+
+void
+write_u64( std::ostream & os,
+           const boost::int64_t value )
+{
+    const boost::uint64_t v = static_cast< boost::uint64_t >( value );
+    write_u32( os, static_cast< boost::uint32_t >( v >> 32 ) );
+    write_u32( os, static_cast< boost::uint32_t >( v & 0xffffffffu ) );
+}
+
+bool
+read_u32( std::istream & is,
+          boost::uint32_t * value )
+{
+    boost::uint32_t n = 0;
+    if ( ! is.read( reinterpret_cast< char * >( &n ), sizeof( n ) ) )
+    {
+        return false;
+    }
+    *value = ntohl( n );
+    return true;
+}
+
+bool
+read_u64( std::istream & is,
+          boost::int64_t * value )
+{
+    boost::uint32_t hi = 0, lo = 0;
+    if ( ! read_u32( is, &hi )
+         || ! read_u32( is, &lo ) )
+    {
+        return false;
+    }
+    *value = static_cast< boost::int64_t >( ( static_cast< boost::uint64_t >( hi ) << 32 ) | lo );
+    return true;
+}
+
+#ifdef HAVE_LIBZ
+/*-------------------------------------------------------------------*/
+/*!
+  \class InflateBuf
+  \brief input stream buffer that inflates the gzip file.
+
+  The get area is the part of the deflate window produced by the last
+  inflate() call. The buffer can be started from the top of the file, in
+  which case the checkpoints are recorded if the container is given, or
+  from the checkpoint.
+ */
+class InflateBuf
+    : public std::streambuf {
+private:
+
+    std::FILE * M_fp;
+    z_stream M_strm;
+    bool M_end; //!< true if the stream end or the error is reached
+    bool M_error; //!< true if the error is detected
+
+    boost::int64_t M_in; //!< compressed bytes consumed by inflate()
+    boost::int64_t M_out; //!< uncompressed bytes produced by inflate()
+
+    std::vector< CycleIndex::Checkpoint > * M_checkpoints;
+    boost::int64_t M_last; //!< output offset of the last checkpoint
+
+    unsigned char M_input[INPUT_SIZE];
+    unsigned char M_window[WINDOW_SIZE];
+
+    // not used
+    InflateBuf( const InflateBuf & );
+    InflateBuf & operator=( const InflateBuf & );
+
+public:
+
+    /*!
+      \brief open the gzip file from the top.
+      \param filepath gzip file path
+      \param checkpoints pointer to the result checkpoints. may be NULL.
+     */
+    InflateBuf( const std::string & filepath,
+                std::vector< CycleIndex::Checkpoint > * checkpoints )
+        : M_fp( std::fopen( filepath.c_str(), "rb" ) ),
+          M_end( false ),
+          M_error( false ),
+          M_in( 0 ),
+          M_out( 0 ),
+          M_checkpoints( checkpoints ),
+          M_last( 0 )
+      {
+          init();
+          // automatic gzip/zlib header detection
+          if ( ! M_fp
+               || inflateInit2( &M_strm, 47 ) != Z_OK )
+          {
+              fail();
+          }
+      }
+
+    /*!
+      \brief open the gzip file from the checkpoint.
+      \param filepath gzip file path
+      \param point start point
+     */
+    InflateBuf( const std::string & filepath,
+                const CycleIndex::Checkpoint & point )
+        : M_fp( std::fopen( filepath.c_str(), "rb" ) ),
+          M_end( false ),
+          M_error( false ),
+          M_in( point.in_ ),
+          M_out( point.out_ ),
+          M_checkpoints( static_cast< std::vector< CycleIndex::Checkpoint > * >( 0 ) ),
+          M_last( 0 )
+      {
+          init();
+          // raw deflate data
+          if ( ! M_fp
+               || inflateInit2( &M_strm, -15 ) != Z_OK )
+          {
+              fail();
+              return;
+          }
+
+          if ( std::fseek( M_fp, static_cast< long >( point.in_ - ( point.bits_ ? 1 : 0 ) ), SEEK_SET ) != 0 )
+          {
+              fail();
+              return;
+          }
+
+          if ( point.bits_ )
+          {
+              const int c = std::getc( M_fp );
+              if ( c == EOF
+                   || inflatePrime( &M_strm, point.bits_, c >> ( 8 - point.bits_ ) ) != Z_OK )
+              {
+                  fail();
+                  return;
+              }
+          }
+
+          if ( inflateSetDictionary( &M_strm,
+                                     reinterpret_cast< const Bytef * >( point.window_.data() ),
+                                     static_cast< uInt >( point.window_.size() ) ) != Z_OK )
+          {
+              fail();
+          }
+      }
+
+    ~InflateBuf()
+      {
+          inflateEnd( &M_strm );
+          if ( M_fp )
+          {
+              std::fclose( M_fp );
+          }
+      }
+
+    /*!
+      \brief skip the uncompressed data.
+      \param n the number of bytes
+      \return true if skipped.
+     */
+    bool skip( boost::int64_t n )
+      {
+          while ( n > 0 )
+          {
+              if ( gptr() == egptr()
+                   && underflow() == traits_type::eof() )
+              {
+                  return false;
+              }
+
+              const boost::int64_t step = std::min( n, static_cast< boost::int64_t >( egptr() - gptr() ) );
+              gbump( static_cast< int >( step ) );
+              n -= step;
+          }
+          return true;
+      }
+
+    /*!
+      \brief check if the error is detected.
+      \return true if the file could not be opened or the data is broken.
+     */
+    bool error() const
+      {
+          return M_error;
+      }
+
+protected:
+
+    virtual
+    int_type underflow()
+      {
+          if ( gptr() < egptr() )
+          {
+              return traits_type::to_int_type( *gptr() );
+          }
+
+          while ( ! M_end )
+          {
+              if ( M_strm.avail_in == 0 )
+              {
+                  M_strm.avail_in = static_cast< uInt >( std::fread( M_input, 1, INPUT_SIZE, M_fp ) );
+                  M_strm.next_in = M_input;
+                  if ( M_strm.avail_in == 0 )
+                  {
+                      // the file is truncated
+                      fail();
+                      break;
+                  }
+              }
+
+              if ( M_strm.avail_out == 0 )
+              {
+                  M_strm.avail_out = WINDOW_SIZE;
+                  M_strm.next_out = M_window;
+              }
+
+              unsigned char * first = M_strm.next_out;
+
+              M_in += M_strm.avail_in;
+              M_out += M_strm.avail_out;
+              const int ret = inflate( &M_strm, Z_BLOCK );
+              M_in -= M_strm.avail_in;
+              M_out -= M_strm.avail_out;
+
+              if ( ret == Z_NEED_DICT
+                   || ret == Z_DATA_ERROR
+                   || ret == Z_MEM_ERROR )
+              {
+                  fail();
+                  break;
+              }
+
+              if ( ret == Z_STREAM_END )
+              {
+                  M_end = true;
+              }
+              else if ( M_checkpoints
+                        && ( M_strm.data_type & 128 )
+                        && ! ( M_strm.data_type & 64 )
+                        && ( M_out == 0
+                             || M_out - M_last > CycleIndex::CHECKPOINT_SPAN ) )
+              {
+                  // the end of the deflate block, and not the last block
+                  addCheckpoint();
+              }
+
+              if ( M_strm.next_out > first )
+              {
+                  char * p = reinterpret_cast< char * >( first );
+                  setg( p, p, reinterpret_cast< char * >( M_strm.next_out ) );
+                  return traits_type::to_int_type( *gptr() );
+              }
+          }
+
+          return traits_type::eof();
+      }
+
+    virtual
+    std::streampos seekoff( std::streamoff off,
+                            std::ios_base::seekdir way,
+                            std::ios_base::openmode )
+      {
+          // only tellg() is supported.
+          if ( off != 0
+               || way != std::ios_base::cur )
+          {
+              return std::streampos( -1 );
+          }
+
+          return std::streampos( M_out - ( egptr() - gptr() ) );
+      }
+
+private:
+
+    void init()
+      {
+          std::memset( &M_strm, 0, sizeof( M_strm ) );
+          M_strm.zalloc = Z_NULL;
+          M_strm.zfree = Z_NULL;
+          M_strm.opaque = Z_NULL;
+          M_strm.avail_in = 0;
+          M_strm.next_in = Z_NULL;
+          M_strm.avail_out = 0;
+          setg( 0, 0, 0 );
+      }
+
+    void fail()
+      {
+          M_end = true;
+          M_error = true;
+      }
+
+    void addCheckpoint()
+      {
+          CycleIndex::Checkpoint point;
+          point.in_ = M_in;
+          point.bits_ = M_strm.data_type & 7;
+          point.out_ = M_out;
+
+          // the window is circular. the oldest data starts at next_out.
+          const int left = static_cast< int >( M_strm.avail_out );
+          point.window_.reserve( WINDOW_SIZE );
+          if ( M_out >= WINDOW_SIZE
+               && left > 0 )
+          {
+              point.window_.append( reinterpret_cast< const char * >( M_window + WINDOW_SIZE - left ),
+                                    left );
+          }
+          point.window_.append( reinterpret_cast< const char * >( M_window ),
+                                WINDOW_SIZE - left );
+          if ( static_cast< boost::int64_t >( point.window_.size() ) > M_out )
+          {
+              point.window_.erase( 0, point.window_.size() - static_cast< std::size_t >( M_out ) );
+          }
+
+          M_checkpoints->push_back( point );
+          M_last = M_out;
+      }
+};
+#endif
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief parse the text lines from the current position.
+  \param size the number of bytes to be parsed. if negative, until the end of file.
+ */
+bool
+parse_text( const ParserV4 & parser,
+            std::istream & is,
+            const boost::int64_t size,
+            int n_line,
+            Handler & handler )
+{
+    std::string line;
+    line.reserve( 8192 );
+
+    boost::int64_t read_size = 0;
+    while ( ( size < 0 || read_size < size )
+            && std::getline( is, line ) )
+    {
+        read_size += line.size() + 1;
+        if ( ! parser.parseLine( n_line, line, handler ) )
+        {
+            return false;
+        }
+        ++n_line;
+    }
+
+    return ( size >= 0 || is.eof() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief parse the data blocks from the current position.
+  \param end end offset in the file. if negative, until the end of file.
+ */
+template < typename BinaryParser >
+bool
+parse_binary( const BinaryParser & parser,
+              std::istream & is,
+              const boost::int64_t end,
+              Handler & handler )
+{
+    while ( is.good() )
+    {
+        if ( end >= 0
+             && static_cast< boost::int64_t >( is.tellg() ) >= end )
+        {
+            return true;
+        }
+
+        if ( ! parser.parseData( is, handler ) )
+        {
+            return false;
+        }
+    }
+
+    return is.eof();
+}
+
+}
+
+namespace rcsc {
+namespace rcg {
+
+const boost::int64_t CycleIndex::CHECKPOINT_SPAN = 1024 * 1024;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CycleIndex::CycleIndex()
+    : M_version( 0 ),
+      M_compressed( false ),
+      M_file_size( 0 ),
+      M_file_time( 0 ),
+      M_data_begin( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::string
+CycleIndex::sidecar_path( const std::string & filepath )
+{
+    return filepath + ".idx";
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CycleIndex::clear()
+{
+    M_filepath.clear();
+    M_version = 0;
+    M_compressed = false;
+    M_file_size = 0;
+    M_file_time = 0;
+    M_data_begin = 0;
+    M_entries.clear();
+    M_checkpoints.clear();
+    M_show_table.clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CycleIndex::open( const std::string & filepath )
+{
+    const std::string index_path = sidecar_path( filepath );
+
+    if ( read( filepath, index_path ) )
+    {
+        return true;
+    }
+
+    if ( ! build( filepath ) )
+    {
+        return false;
+    }
+
+    if ( ! write( index_path ) )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " Could not write the index file [" << index_path << "]" << std::endl;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CycleIndex::build( const std::string & filepath )
+{
+    clear();
+
+    if ( ! file_status( filepath, &M_file_size, &M_file_time ) )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " Could not open the file [" << filepath << "]" << std::endl;
+        return false;
+    }
+
+    M_compressed = is_gzip_file( filepath );
+
+    boost::scoped_ptr< std::streambuf > buf;
+    if ( M_compressed )
+    {
+#ifdef HAVE_LIBZ
+        buf.reset( new InflateBuf( filepath, &M_checkpoints ) );
+#else
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " gzipped file is not supported [" << filepath << "]" << std::endl;
+        return false;
+#endif
+    }
+    else
+    {
+        std::filebuf * fbuf = new std::filebuf();
+        buf.reset( fbuf );
+        if ( ! fbuf->open( filepath.c_str(), std::ios_base::in | std::ios_base::binary ) )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__
+                      << " Could not open the file [" << filepath << "]" << std::endl;
+            return false;
+        }
+    }
+
+    std::istream is( buf.get() );
+
+    char header[4];
+    if ( ! is.read( header, 4 )
+         || std::strncmp( header, "ULG", 3 ) != 0 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " Unsupported log format [" << filepath << "]" << std::endl;
+        clear();
+        return false;
+    }
+
+    bool result = false;
+    switch ( header[3] ) {
+    case REC_VERSION_2:
+    case REC_VERSION_3:
+        M_version = header[3];
+        M_data_begin = 4;
+        result = scanBinary( is );
+        break;
+    case '0' + REC_VERSION_4:
+    case '0' + REC_VERSION_5:
+        {
+            M_version = header[3] - '0';
+            std::string rest;
+            result = ( std::getline( is, rest ) && rest.empty() ); // "ULGn\n"
+            M_data_begin = 5;
+            result = result && scanText( is );
+        }
+        break;
+    default:
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " Unsupported log version [" << filepath << "]" << std::endl;
+        break;
+    }
+
+#ifdef HAVE_LIBZ
+    if ( M_compressed
+         && static_cast< InflateBuf * >( buf.get() )->error() )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " Broken gzip file [" << filepath << "]" << std::endl;
+        result = false;
+    }
+#endif
+
+    if ( ! result )
+    {
+        clear();
+        return false;
+    }
+
+    M_filepath = filepath;
+    updateShowTable();
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CycleIndex::scanText( std::istream & is )
+{
+    std::string line;
+    line.reserve( 8192 );
+
+    boost::int64_t offset = M_data_begin;
+    int n_line = 1;
+
+    while ( std::getline( is, line ) )
+    {
+        ++n_line;
+
+        ShowScanner scanner( line );
+        int mode = NO_INFO;
+        if ( scanner.startsWith( "(show " ) )
+        {
+            mode = SHOW_MODE;
+            scanner.advance( 6 );
+        }
+        else if ( scanner.startsWith( "(playmode " ) )
+        {
+            mode = PM_MODE;
+            scanner.advance( 10 );
+        }
+        else if ( scanner.startsWith( "(team " ) )
+        {
+            mode = TEAM_MODE;
+            scanner.advance( 6 );
+        }
+
+        if ( mode != NO_INFO )
+        {
+            const int time = static_cast< int >( scanner.readLong() );
+            M_entries.push_back( Entry( mode, time, n_line, offset ) );
+        }
+
+        offset += line.size() + 1;
+    }
+
+    return is.eof();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CycleIndex::scanBinary( std::istream & is )
+{
+    std::vector< char > body( sizeof( short_showinfo_t2 ) + sizeof( showinfo_t ) );
+    boost::int64_t offset = M_data_begin;
+    int last_time = 0;
+
+    while ( true )
+    {
+        Int16 mode;
+        if ( ! is.read( reinterpret_cast< char * >( &mode ), sizeof( Int16 ) ) )
+        {
+            // same as the parser, the partial mode value is ignored.
+            return is.eof();
+        }
+        mode = ntohs( mode );
+
+        if ( mode == NO_INFO )
+        {
+            offset += sizeof( Int16 );
+            continue;
+        }
+
+        std::size_t size = 0;
+        if ( mode == MSG_MODE )
+        {
+            Int16 header[2];
+            if ( ! is.read( reinterpret_cast< char * >( header ), sizeof( header ) ) )
+            {
+                return false;
+            }
+            const int len = ntohs( header[1] );
+            if ( len < 0
+                 || ! is.ignore( len ) )
+            {
+                return false;
+            }
+            size = sizeof( header ) + len;
+        }
+        else
+        {
+            size = data_block_size( M_version, mode );
+            if ( size == 0 )
+            {
+                std::cerr << __FILE__ << ':' << __LINE__
+                          << " Unknown mode" << mode
+                          << std::endl;
+                return false;
+            }
+
+            if ( ! is.read( &body[0], size ) )
+            {
+                return false;
+            }
+
+            if ( mode == SHOW_MODE )
+            {
+                Int16 time = 0;
+                if ( M_version == REC_VERSION_2 )
+                {
+                    std::memcpy( &time, &body[0] + offsetof( showinfo_t, time ), sizeof( Int16 ) );
+                }
+                else
+                {
+                    std::memcpy( &time, &body[0] + offsetof( short_showinfo_t2, time ), sizeof( Int16 ) );
+                }
+                last_time = ntohs( time );
+                M_entries.push_back( Entry( mode, last_time, 0, offset ) );
+            }
+            else if ( mode == PM_MODE
+                      || mode == TEAM_MODE )
+            {
+                // the game time is the time of the last show.
+                M_entries.push_back( Entry( mode, last_time, 0, offset ) );
+            }
+        }
+
+        offset += sizeof( Int16 ) + size;
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+CycleIndex::updateShowTable()
+{
+    M_show_table.clear();
+
+    const int size = static_cast< int >( M_entries.size() );
+    for ( int i = 0; i < size; ++i )
+    {
+        const Entry & e = M_entries[i];
+        if ( e.mode_ != SHOW_MODE )
+        {
+            continue;
+        }
+
+        while ( static_cast< int >( M_show_table.size() ) <= e.time_ )
+        {
+            M_show_table.push_back( i );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const CycleIndex::Entry *
+CycleIndex::findShow( const int cycle ) const
+{
+    if ( M_show_table.empty()
+         || cycle >= static_cast< int >( M_show_table.size() ) )
+    {
+        return static_cast< const Entry * >( 0 );
+    }
+
+    return &M_entries[ M_show_table[ std::max( 0, cycle ) ] ];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CycleIndex::write( const std::string & index_path ) const
+{
+    if ( M_version == 0 )
+    {
+        return false;
+    }
+
+    const std::string tmp_path = index_path + ".tmp";
+
+    {
+        std::ofstream fout( tmp_path.c_str(), std::ios_base::out | std::ios_base::binary );
+        if ( ! fout.is_open() )
+        {
+            return false;
+        }
+
+        fout.write( INDEX_MAGIC, sizeof( INDEX_MAGIC ) );
+        write_u32( fout, INDEX_FORMAT );
+        write_u32( fout, static_cast< boost::uint32_t >( M_version ) );
+        write_u32( fout, M_compressed ? 1 : 0 );
+        write_u64( fout, M_file_size );
+        write_u64( fout, M_file_time );
+        write_u64( fout, M_data_begin );
+
+        write_u32( fout, static_cast< boost::uint32_t >( M_entries.size() ) );
+        for ( std::vector< Entry >::const_iterator it = M_entries.begin(), end = M_entries.end();
+              it != end;
+              ++it )
+        {
+            write_u32( fout, static_cast< boost::uint32_t >( it->mode_ ) );
+            write_u32( fout, static_cast< boost::uint32_t >( it->time_ ) );
+            write_u32( fout, static_cast< boost::uint32_t >( it->line_ ) );
+            write_u64( fout, it->offset_ );
+        }
+
+        write_u32( fout, static_cast< boost::uint32_t >( M_checkpoints.size() ) );
+        for ( std::vector< Checkpoint >::const_iterator it = M_checkpoints.begin(), end = M_checkpoints.end();
+              it != end;
+              ++it )
+        {
+            write_u64( fout, it->in_ );
+            write_u32( fout, static_cast< boost::uint32_t >( it->bits_ ) );
+            write_u64( fout, it->out_ );
+            write_u32( fout, static_cast< boost::uint32_t >( it->window_.size() ) );
+            fout.write( it->window_.data(), it->window_.size() );
+        }
+
+        fout.flush();
+        if ( ! fout )
+        {
+            fout.close();
+            std::remove( tmp_path.c_str() );
+            return false;
+        }
+    }
+
+    std::remove( index_path.c_str() );
+    if ( std::rename( tmp_path.c_str(), index_path.c_str() ) != 0 )
+    {
+        std::remove( tmp_path.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CycleIndex::read( const std::string & filepath,
+                  const std::string & index_path )
+{
+    clear();
+
+    boost::int64_t file_size = 0, file_time = 0;
+    if ( ! file_status( filepath, &file_size, &file_time ) )
+    {
+        return false;
+    }
+
+    std::ifstream fin( index_path.c_str(), std::ios_base::in | std::ios_base::binary );
+    if ( ! fin.is_open() )
+    {
+        return false;
+    }
+
+    char magic[4];
+    boost::uint32_t format = 0, version = 0, compressed = 0;
+    boost::int64_t size = 0, time = 0, data_begin = 0;
+    if ( ! fin.read( magic, sizeof( magic ) )
+         || std::memcmp( magic, INDEX_MAGIC, sizeof( magic ) ) != 0
+         || ! read_u32( fin, &format )
+         || format != INDEX_FORMAT
+         || ! read_u32( fin, &version )
+         || ! read_u32( fin, &compressed )
+         || ! read_u64( fin, &size )
+         || ! read_u64( fin, &time )
+         || ! read_u64( fin, &data_begin ) )
+    {
+        return false;
+    }
+
+    if ( size != file_size
+         || time != file_time )
+    {
+        // the log file is modified.
+        return false;
+    }
+
+    boost::uint32_t n_entries = 0;
+    if ( ! read_u32( fin, &n_entries ) )
+    {
+        return false;
+    }
+
+    M_entries.reserve( n_entries );
+    for ( boost::uint32_t i = 0; i < n_entries; ++i )
+    {
+        boost::uint32_t mode = 0, t = 0, line = 0;
+        boost::int64_t offset = 0;
+        if ( ! read_u32( fin, &mode )
+             || ! read_u32( fin, &t )
+             || ! read_u32( fin, &line )
+             || ! read_u64( fin, &offset ) )
+        {
+            clear();
+            return false;
+        }
+        M_entries.push_back( Entry( static_cast< int >( mode ),
+                                    static_cast< int >( t ),
+                                    static_cast< int >( line ),
+                                    offset ) );
+    }
+
+    boost::uint32_t n_checkpoints = 0;
+    if ( ! read_u32( fin, &n_checkpoints ) )
+    {
+        clear();
+        return false;
+    }
+
+    M_checkpoints.resize( n_checkpoints );
+    for ( boost::uint32_t i = 0; i < n_checkpoints; ++i )
+    {
+        Checkpoint & point = M_checkpoints[i];
+        boost::uint32_t bits = 0, window_size = 0;
+        if ( ! read_u64( fin, &point.in_ )
+             || ! read_u32( fin, &bits )
+             || ! read_u64( fin, &point.out_ )
+             || ! read_u32( fin, &window_size )
+             || window_size > static_cast< boost::uint32_t >( WINDOW_SIZE ) )
+        {
+            clear();
+            return false;
+        }
+
+        point.bits_ = static_cast< int >( bits );
+        point.window_.resize( window_size );
+        if ( window_size > 0
+             && ! fin.read( &point.window_[0], window_size ) )
+        {
+            clear();
+            return false;
+        }
+    }
+
+    M_filepath = filepath;
+    M_version = static_cast< int >( version );
+    M_compressed = ( compressed != 0 );
+    M_file_size = size;
+    M_file_time = time;
+    M_data_begin = data_begin;
+    updateShowTable();
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::streambuf *
+CycleIndex::openAt( const boost::int64_t offset ) const
+{
+    if ( ! M_compressed )
+    {
+        std::filebuf * buf = new std::filebuf();
+        if ( ! buf->open( M_filepath.c_str(), std::ios_base::in | std::ios_base::binary )
+             || buf->pubseekpos( offset, std::ios_base::in ) != std::streampos( offset ) )
+        {
+            delete buf;
+            return static_cast< std::streambuf * >( 0 );
+        }
+        return buf;
+    }
+
+#ifdef HAVE_LIBZ
+    // find the last checkpoint before the offset
+    std::vector< Checkpoint >::const_iterator point = M_checkpoints.end();
+    for ( std::vector< Checkpoint >::const_iterator it = M_checkpoints.begin(), end = M_checkpoints.end();
+          it != end && it->out_ <= offset;
+          ++it )
+    {
+        point = it;
+    }
+
+    InflateBuf * buf = ( point == M_checkpoints.end()
+                         ? new InflateBuf( M_filepath, static_cast< std::vector< Checkpoint > * >( 0 ) )
+                         : new InflateBuf( M_filepath, *point ) );
+
+    if ( ! buf->skip( offset - ( point == M_checkpoints.end() ? 0 : point->out_ ) )
+         || buf->error() )
+    {
+        delete buf;
+        return static_cast< std::streambuf * >( 0 );
+    }
+
+    return buf;
+#else
+    return static_cast< std::streambuf * >( 0 );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CycleIndex::parseRange( const boost::int64_t begin,
+                        const boost::int64_t end,
+                        const int first_line,
+                        Handler & handler ) const
+{
+    boost::scoped_ptr< std::streambuf > buf( openAt( begin ) );
+    if ( ! buf )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " Could not seek the file [" << M_filepath << "]" << std::endl;
+        return false;
+    }
+
+    std::istream is( buf.get() );
+
+    switch ( M_version ) {
+    case REC_VERSION_2:
+        return parse_binary( ParserV2(), is, end, handler );
+    case REC_VERSION_3:
+        return parse_binary( ParserV3(), is, end, handler );
+    case REC_VERSION_4:
+        return parse_text( ParserV4(), is, ( end < 0 ? -1 : end - begin ), first_line, handler );
+    case REC_VERSION_5:
+        return parse_text( ParserV5(), is, ( end < 0 ? -1 : end - begin ), first_line, handler );
+    default:
+        break;
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CycleIndex::seek( const int cycle,
+                  Handler & handler,
+                  const int last_cycle ) const
+{
+    const Entry * target = findShow( cycle );
+    if ( ! target )
+    {
+        return false;
+    }
+
+    const Entry * last = ( last_cycle >= 0
+                           ? findShow( last_cycle + 1 )
+                           : static_cast< const Entry * >( 0 ) );
+    const boost::int64_t end_offset = ( last ? last->offset_ : -1 );
+
+    if ( ! handler.handleLogVersion( M_version ) )
+    {
+        return false;
+    }
+
+    // the data before the first show (parameters, player types and the initial states)
+    const Entry & first = *findShow( 0 );
+    if ( first.offset_ > M_data_begin
+         && ! parseRange( M_data_begin, first.offset_, 2, handler ) )
+    {
+        return false;
+    }
+
+    // the last playmode and team after the first show
+    const Entry * playmode = static_cast< const Entry * >( 0 );
+    const Entry * team = static_cast< const Entry * >( 0 );
+    for ( const Entry * e = target - 1; e > &first; --e )
+    {
+        if ( ! playmode && e->mode_ == PM_MODE ) playmode = e;
+        if ( ! team && e->mode_ == TEAM_MODE ) team = e;
+        if ( playmode && team ) break;
+    }
+
+    const Entry * states[2] = { playmode, team };
+    if ( playmode && team
+         && team->offset_ < playmode->offset_ )
+    {
+        std::swap( states[0], states[1] );
+    }
+
+    for ( int i = 0; i < 2; ++i )
+    {
+        const Entry * e = states[i];
+        if ( e
+             && ! parseRange( e->offset_, e->offset_ + 1, e->line_, handler ) )
+        {
+            return false;
+        }
+    }
+
+    if ( ! parseRange( target->offset_, end_offset, target->line_, handler ) )
+    {
+        return false;
+    }
+
+    return handler.handleEOF();
+}
+
+}
+}
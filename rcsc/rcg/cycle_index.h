@@ -0,0 +1,257 @@
+// -*-c++-*-
+
+/*!
+  \file cycle_index.h
+  \brief random access index of rcg file Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_CYCLE_INDEX_H
+#define RCSC_RCG_CYCLE_INDEX_H
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+#include <string>
+#include <iosfwd>
+
+namespace rcsc {
+namespace rcg {
+
+class Handler;
+
+/*!
+  \class CycleIndex
+  \brief byte offsets of the show, playmode and team data in the rcg file.
+
+  The index is built by one sequential scan of the file, and it is saved
+  to the sidecar file (<log>.idx) by open(). The sidecar is reused while
+  the size and the modification time of the log file are not changed.
+
+  Offsets are the positions in the uncompressed data. For the gzipped
+  file, the inflate state is checkpointed at the deflate block boundary
+  every CHECKPOINT_SPAN bytes of the uncompressed data. The checkpoint
+  keeps the last 32K bytes of the output as the dictionary, so seek()
+  starts inflating from the nearest checkpoint and never decompresses
+  more than CHECKPOINT_SPAN bytes before the target. Only the single
+  member gzip file is supported.
+
+  seek() passes the data before the first show (parameters, player types
+  and the initial playmode and team), the last playmode and team data
+  before the target cycle, and then the data from the target cycle to
+  the handler.
+*/
+class CycleIndex {
+public:
+
+    //! uncompressed bytes between the gzip checkpoints
+    static const boost::int64_t CHECKPOINT_SPAN;
+
+    /*!
+      \struct Entry
+      \brief position of the indexed data.
+     */
+    struct Entry {
+        int mode_; //!< SHOW_MODE, PM_MODE or TEAM_MODE
+        int time_; //!< game time
+        int line_; //!< line number. only for the text format.
+        boost::int64_t offset_; //!< offset in the uncompressed data
+
+        Entry()
+            : mode_( 0 ),
+              time_( 0 ),
+              line_( 0 ),
+              offset_( 0 )
+          { }
+
+        Entry( const int mode,
+               const int time,
+               const int line,
+               const boost::int64_t offset )
+            : mode_( mode ),
+              time_( time ),
+              line_( line ),
+              offset_( offset )
+          { }
+    };
+
+    /*!
+      \struct Checkpoint
+      \brief inflate state at the deflate block boundary.
+     */
+    struct Checkpoint {
+        boost::int64_t in_; //!< offset in the compressed file
+        int bits_; //!< the number of bits of the block in the byte before in_
+        boost::int64_t out_; //!< offset in the uncompressed data
+        std::string window_; //!< last 32K bytes of the uncompressed data
+
+        Checkpoint()
+            : in_( 0 ),
+              bits_( 0 ),
+              out_( 0 )
+          { }
+    };
+
+private:
+
+    std::string M_filepath; //!< indexed log file
+    int M_version; //!< log version. 0 if not indexed.
+    bool M_compressed; //!< true if the log file is gzipped
+    boost::int64_t M_file_size; //!< size of the log file
+    boost::int64_t M_file_time; //!< modification time of the log file
+    boost::int64_t M_data_begin; //!< offset of the data after the header
+
+    std::vector< Entry > M_entries; //!< indexed data in the file order
+    std::vector< Checkpoint > M_checkpoints; //!< gzip checkpoints in the file order
+
+    //! index of the first show entry whose time is equal or greater than the cycle
+    std::vector< int > M_show_table;
+
+public:
+
+    /*!
+      \brief create the empty index.
+     */
+    CycleIndex();
+
+    /*!
+      \brief get the sidecar file path.
+      \param filepath log file path
+      \return sidecar file path
+     */
+    static
+    std::string sidecar_path( const std::string & filepath );
+
+    /*!
+      \brief read the sidecar file, or build the index and write the sidecar file.
+      \param filepath log file path
+      \return true if the index is available.
+
+      Failure of writing the sidecar is reported, but the index is still available.
+     */
+    bool open( const std::string & filepath );
+
+    /*!
+      \brief scan the log file and build the index.
+      \param filepath log file path
+      \return true if successfully built.
+     */
+    bool build( const std::string & filepath );
+
+    /*!
+      \brief read the sidecar file.
+      \param filepath log file path
+      \param index_path sidecar file path
+      \return true if the sidecar is read and it matches the log file.
+     */
+    bool read( const std::string & filepath,
+               const std::string & index_path );
+
+    /*!
+      \brief write the sidecar file. the file is written to the temporary file and renamed.
+      \param index_path sidecar file path
+      \return true if successfully written.
+     */
+    bool write( const std::string & index_path ) const;
+
+    /*!
+      \brief clear all data.
+     */
+    void clear();
+
+    /*!
+      \brief get the log version.
+      \return log version. 0 if not indexed.
+     */
+    int version() const
+      {
+          return M_version;
+      }
+
+    /*!
+      \brief check if the log file is gzipped.
+      \return true if gzipped.
+     */
+    bool isCompressed() const
+      {
+          return M_compressed;
+      }
+
+    /*!
+      \brief get the indexed data.
+      \return const reference to the entry container
+     */
+    const std::vector< Entry > & entries() const
+      {
+          return M_entries;
+      }
+
+    /*!
+      \brief get the gzip checkpoints.
+      \return const reference to the checkpoint container
+     */
+    const std::vector< Checkpoint > & checkpoints() const
+      {
+          return M_checkpoints;
+      }
+
+    /*!
+      \brief get the first show data at the cycle or later.
+      \param cycle game time
+      \return pointer to the entry. NULL if not found.
+     */
+    const Entry * findShow( const int cycle ) const;
+
+    /*!
+      \brief parse the log from the cycle.
+      \param cycle first game time
+      \param handler reference to the rcg data handler.
+      \param last_cycle last game time. if negative, the log is parsed until the end of file.
+      \return true if successfully parsed.
+     */
+    bool seek( const int cycle,
+               Handler & handler,
+               const int last_cycle = -1 ) const;
+
+private:
+
+    void updateShowTable();
+
+    bool scanText( std::istream & is );
+    bool scanBinary( std::istream & is );
+
+    std::streambuf * openAt( const boost::int64_t offset ) const;
+
+    bool parseRange( const boost::int64_t begin,
+                     const boost::int64_t end,
+                     const int first_line,
+                     Handler & handler ) const;
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
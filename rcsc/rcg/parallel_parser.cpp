@@ -0,0 +1,876 @@
+// -*-c++-*-
+
+/*!
+  \file parallel_parser.cpp
+  \brief parallel rcg file parser Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#ifdef HAVE_NETINET_IN_H
+#include <netinet/in.h>
+#endif
+#ifdef HAVE_WINDOWS_H
+#include <windows.h>
+#endif
+
+#include "parallel_parser.h"
+
+#include "parser_v4.h"
+#include "parser_v5.h"
+#include "handler.h"
+#include "types.h"
+#include "util.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using namespace rcsc;
+using namespace rcsc::rcg;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \struct Chunk
+  \brief range of the text lines parsed by one task.
+ */
+struct Chunk {
+    const char * begin_; //!< first character
+    const char * end_; //!< position after the last line
+    int first_line_; //!< line number of the first line
+
+    Chunk( const char * begin,
+           const char * end,
+           const int first_line )
+        : begin_( begin ),
+          end_( end ),
+          first_line_( first_line )
+      { }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class EventBuffer
+  \brief handler that records the v4/v5 events of one chunk.
+ */
+class EventBuffer
+    : public Handler {
+private:
+
+    enum Type {
+        SHOW,
+        MSG,
+        PLAYMODE,
+        TEAM,
+        PLAYER_TYPE,
+        SERVER_PARAM,
+        PLAYER_PARAM
+    };
+
+    struct Event {
+        Type type_;
+        int time_; //!< game time
+        int value_; //!< message board or playmode
+        std::size_t index_; //!< index of the stored data
+
+        Event( const Type type,
+               const int time,
+               const int value,
+               const std::size_t index )
+            : type_( type ),
+              time_( time ),
+              value_( value ),
+              index_( index )
+          { }
+    };
+
+    std::vector< Event > M_events;
+    std::vector< ShowInfoT > M_shows;
+    std::vector< TeamT > M_teams; //!< pairs of the left and right teams
+    std::vector< std::string > M_texts; //!< messages and parameter lines
+    int M_line; //!< current line number
+
+public:
+
+    EventBuffer()
+        : M_line( 0 )
+      { }
+
+    /*!
+      \brief pass the recorded events to the handler in the recorded order.
+      \param handler destination handler
+     */
+    void replay( Handler & handler ) const
+      {
+          for ( std::vector< Event >::const_iterator e = M_events.begin(), end = M_events.end();
+                e != end;
+                ++e )
+          {
+              switch ( e->type_ ) {
+              case SHOW:
+                  handler.handleShow( e->time_, M_shows[e->index_] );
+                  break;
+              case MSG:
+                  handler.handleMsg( e->time_, e->value_, M_texts[e->index_] );
+                  break;
+              case PLAYMODE:
+                  handler.handlePlayMode( e->time_, static_cast< PlayMode >( e->value_ ) );
+                  break;
+              case TEAM:
+                  handler.handleTeam( e->time_, M_teams[e->index_], M_teams[e->index_ + 1] );
+                  break;
+              case PLAYER_TYPE:
+                  if ( ! handler.handlePlayerType( M_texts[e->index_] ) )
+                  {
+                      std::cerr << e->value_ << ": error: "
+                                << "Illegal player_type line. \"" << M_texts[e->index_] << "\""
+                                << std::endl;
+                  }
+                  break;
+              case SERVER_PARAM:
+                  if ( ! handler.handleServerParam( M_texts[e->index_] ) )
+                  {
+                      std::cerr << e->value_ << ": error: "
+                                << "Illegal server_param line. \"" << M_texts[e->index_] << "\""
+                                << std::endl;
+                  }
+                  break;
+              case PLAYER_PARAM:
+                  if ( ! handler.handlePlayerParam( M_texts[e->index_] ) )
+                  {
+                      std::cerr << e->value_ << ": error: "
+                                << "Illegal player_param line. \"" << M_texts[e->index_] << "\""
+                                << std::endl;
+                  }
+                  break;
+              default:
+                  break;
+              }
+          }
+      }
+
+    /*!
+      \brief set the line number reported when the handler rejects the parameter line.
+      \param n_line current line number
+     */
+    void setLine( const int n_line )
+      {
+          M_line = n_line;
+      }
+
+    // v4/v5 events
+
+    bool handleShow( const int time,
+                     const ShowInfoT & show )
+      {
+          M_events.push_back( Event( SHOW, time, 0, M_shows.size() ) );
+          M_shows.push_back( show );
+          return true;
+      }
+
+    bool handleMsg( const int time,
+                    const int board,
+                    const std::string & msg )
+      {
+          M_events.push_back( Event( MSG, time, board, M_texts.size() ) );
+          M_texts.push_back( msg );
+          return true;
+      }
+
+    bool handlePlayMode( const int time,
+                         const PlayMode pm )
+      {
+          M_events.push_back( Event( PLAYMODE, time, pm, 0 ) );
+          return true;
+      }
+
+    bool handleTeam( const int time,
+                     const TeamT & team_l,
+                     const TeamT & team_r )
+      {
+          M_events.push_back( Event( TEAM, time, 0, M_teams.size() ) );
+          M_teams.push_back( team_l );
+          M_teams.push_back( team_r );
+          return true;
+      }
+
+    bool handleServerParam( const std::string & msg )
+      {
+          M_events.push_back( Event( SERVER_PARAM, 0, M_line, M_texts.size() ) );
+          M_texts.push_back( msg );
+          return true;
+      }
+
+    bool handlePlayerParam( const std::string & msg )
+      {
+          M_events.push_back( Event( PLAYER_PARAM, 0, M_line, M_texts.size() ) );
+          M_texts.push_back( msg );
+          return true;
+      }
+
+    bool handlePlayerType( const std::string & msg )
+      {
+          M_events.push_back( Event( PLAYER_TYPE, 0, M_line, M_texts.size() ) );
+          M_texts.push_back( msg );
+          return true;
+      }
+
+    // old formats are never passed by the text parser
+
+    bool handleDispInfo( const dispinfo_t & )
+      {
+          return true;
+      }
+
+    bool handleShowInfo( const showinfo_t & )
+      {
+          return true;
+      }
+
+    bool handleShortShowInfo2( const short_showinfo_t2 & )
+      {
+          return true;
+      }
+
+    bool handleMsgInfo( Int16,
+                        const std::string & )
+      {
+          return true;
+      }
+
+    bool handlePlayMode( char )
+      {
+          return true;
+      }
+
+    bool handleTeamInfo( const team_t &,
+                         const team_t & )
+      {
+          return true;
+      }
+
+    bool handlePlayerType( const player_type_t & )
+      {
+          return true;
+      }
+
+    bool handleServerParam( const server_params_t & )
+      {
+          return true;
+      }
+
+    bool handlePlayerParam( const player_params_t & )
+      {
+          return true;
+      }
+
+    bool handleEOF()
+      {
+          return true;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief find the end of the line.
+  \return position of the newline character, or end.
+ */
+inline
+const char *
+find_eol( const char * first,
+          const char * end )
+{
+    const void * p = std::memchr( first, '\n', end - first );
+    return ( p ? static_cast< const char * >( p ) : end );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief find the first show line that starts at first or after.
+  \return top of the show line, or end.
+ */
+const char *
+find_show_line( const char * first,
+                const char * end )
+{
+    static const char SHOW[] = "(show ";
+    static const std::size_t SHOW_LEN = sizeof( SHOW ) - 1;
+
+    // the newline just before first is also checked.
+    const char * p = first - 1;
+    while ( p < end )
+    {
+        p = find_eol( p, end );
+        if ( p == end )
+        {
+            break;
+        }
+
+        ++p;
+        if ( static_cast< std::size_t >( end - p ) >= SHOW_LEN
+             && ! std::memcmp( p, SHOW, SHOW_LEN ) )
+        {
+            return p;
+        }
+    }
+
+    return end;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief count the newline characters.
+ */
+int
+count_lines( const char * first,
+             const char * end )
+{
+    int n = 0;
+    while ( first < end )
+    {
+        first = find_eol( first, end );
+        if ( first == end )
+        {
+            break;
+        }
+        ++n;
+        ++first;
+    }
+    return n;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief parse all lines in the chunk.
+  \return false if the illegal line is found. the events before the line are kept.
+ */
+bool
+parse_chunk( const ParserV4 & parser,
+             const Chunk & chunk,
+             EventBuffer & buffer )
+{
+    std::string line;
+    line.reserve( 8192 );
+
+    int n_line = chunk.first_line_;
+    const char * p = chunk.begin_;
+    while ( p < chunk.end_ )
+    {
+        const char * eol = find_eol( p, chunk.end_ );
+        line.assign( p, eol );
+
+        buffer.setLine( n_line );
+        if ( ! parser.parseLine( n_line, line, buffer ) )
+        {
+            return false;
+        }
+
+        ++n_line;
+        p = eol + 1;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \struct Record
+  \brief position of one binary record.
+ */
+struct Record {
+    Int16 mode_; //!< data mode in host byte order
+    std::size_t pos_; //!< top of the record body
+    std::size_t size_; //!< size of the record body
+
+    Record( const Int16 mode,
+            const std::size_t pos,
+            const std::size_t size )
+        : mode_( mode ),
+          pos_( pos ),
+          size_( size )
+      { }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief index the records of the binary log.
+  \param data top of the file image
+  \param size file size
+  \param version log version
+  \param records pointer to the result records
+  \return false if the broken record is found. the records before it are kept.
+ */
+bool
+index_records( const char * data,
+               const std::size_t size,
+               const int version,
+               std::vector< Record > * records )
+{
+    std::size_t pos = 4; // skip header
+
+    while ( size - pos >= sizeof( Int16 ) )
+    {
+        Int16 mode;
+        std::memcpy( &mode, data + pos, sizeof( Int16 ) );
+        mode = ntohs( mode );
+        pos += sizeof( Int16 );
+
+        std::size_t body = 0;
+        if ( mode == NO_INFO )
+        {
+            continue;
+        }
+        else if ( mode == MSG_MODE )
+        {
+            // board, length and message
+            if ( size - pos < sizeof( Int16 ) * 2 )
+            {
+                return false;
+            }
+
+            Int16 len;
+            std::memcpy( &len, data + pos + sizeof( Int16 ), sizeof( Int16 ) );
+            len = ntohs( len );
+            if ( len < 0 )
+            {
+                return false;
+            }
+            body = sizeof( Int16 ) * 2 + len;
+        }
+        else
+        {
+            body = data_block_size( version, mode );
+            if ( body == 0 )
+            {
+                std::cerr << __FILE__ << ':' << __LINE__
+                          << " Unknown mode" << mode
+                          << std::endl;
+                return false;
+            }
+        }
+
+        if ( size - pos < body )
+        {
+            return false;
+        }
+
+        records->push_back( Record( mode, pos, body ) );
+        pos += body;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief pass one binary record to the handler.
+  \return handled result
+ */
+bool
+handle_record( const char * data,
+               const int version,
+               const Record & record,
+               Handler & handler )
+{
+    const char * body = data + record.pos_;
+
+    switch ( record.mode_ ) {
+    case SHOW_MODE:
+        if ( version == REC_VERSION_2 )
+        {
+            showinfo_t show;
+            std::memcpy( &show, body, sizeof( showinfo_t ) );
+            return handler.handleShowInfo( show );
+        }
+        else
+        {
+            short_showinfo_t2 show;
+            std::memcpy( &show, body, sizeof( short_showinfo_t2 ) );
+            return handler.handleShortShowInfo2( show );
+        }
+    case MSG_MODE:
+        {
+            Int16 board;
+            std::memcpy( &board, body, sizeof( Int16 ) );
+
+            const char * msg = body + sizeof( Int16 ) * 2;
+            std::size_t len = record.size_ - sizeof( Int16 ) * 2;
+            if ( len > 0
+                 && msg[len - 1] == 0 )
+            {
+                len = std::find( msg, msg + len, '\0' ) - msg;
+            }
+            return handler.handleMsgInfo( board, std::string( msg, len ) );
+        }
+    case DRAW_MODE:
+        return true;
+    case PM_MODE:
+        return handler.handlePlayMode( *body );
+    case TEAM_MODE:
+        {
+            team_t team[2];
+            std::memcpy( team, body, sizeof( team_t ) * 2 );
+            return handler.handleTeamInfo( team[0], team[1] );
+        }
+    case PT_MODE:
+        {
+            player_type_t ptinfo;
+            std::memcpy( &ptinfo, body, sizeof( player_type_t ) );
+            return handler.handlePlayerType( ptinfo );
+        }
+    case PARAM_MODE:
+        {
+            server_params_t sparams;
+            std::memcpy( &sparams, body, sizeof( server_params_t ) );
+            return handler.handleServerParam( sparams );
+        }
+    case PPARAM_MODE:
+        {
+            player_params_t pparams;
+            std::memcpy( &pparams, body, sizeof( player_params_t ) );
+            return handler.handlePlayerParam( pparams );
+        }
+    default:
+        break;
+    }
+
+    return false;
+}
+
+}
+
+namespace rcsc {
+namespace rcg {
+
+const std::size_t ParallelParser::DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ParallelParser::ParallelParser()
+    : M_version( 0 ),
+      M_data( static_cast< const char * >( 0 ) ),
+      M_size( 0 ),
+      M_mapped( false ),
+      M_chunk_size( DEFAULT_CHUNK_SIZE )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ParallelParser::~ParallelParser()
+{
+    close();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParallelParser::open( const std::string & filepath )
+{
+    close();
+
+#ifndef _WIN32
+    int fd = ::open( filepath.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " Could not open the file [" << filepath << "]" << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) == 0
+         && st.st_size > 0 )
+    {
+        void * addr = ::mmap( 0, static_cast< std::size_t >( st.st_size ),
+                              PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( addr != MAP_FAILED )
+        {
+            M_data = static_cast< const char * >( addr );
+            M_size = static_cast< std::size_t >( st.st_size );
+            M_mapped = true;
+        }
+    }
+    ::close( fd );
+#endif
+
+    if ( ! M_data )
+    {
+        std::ifstream fin( filepath.c_str(), std::ios_base::in | std::ios_base::binary );
+        if ( ! fin.is_open() )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__
+                      << " Could not open the file [" << filepath << "]" << std::endl;
+            return false;
+        }
+
+        std::string buf( ( std::istreambuf_iterator< char >( fin ) ),
+                         std::istreambuf_iterator< char >() );
+        if ( ! buf.empty() )
+        {
+            char * data = new char[buf.size()];
+            std::memcpy( data, buf.data(), buf.size() );
+            M_data = data;
+            M_size = buf.size();
+        }
+    }
+
+    if ( M_size < 4
+         || std::strncmp( M_data, "ULG", 3 ) != 0 )
+    {
+        // compressed, rcg v1 or not a rcg file
+        close();
+        return false;
+    }
+
+    switch ( M_data[3] ) {
+    case REC_VERSION_2:
+        M_version = REC_VERSION_2;
+        break;
+    case REC_VERSION_3:
+        M_version = REC_VERSION_3;
+        break;
+    case '0' + REC_VERSION_4:
+        M_version = REC_VERSION_4;
+        break;
+    case '0' + REC_VERSION_5:
+        M_version = REC_VERSION_5;
+        break;
+    default:
+        close();
+        return false;
+    }
+
+    M_filepath = filepath;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ParallelParser::close()
+{
+    if ( M_data )
+    {
+#ifndef _WIN32
+        if ( M_mapped )
+        {
+            ::munmap( const_cast< char * >( M_data ), M_size );
+        }
+        else
+#endif
+        {
+            delete [] M_data;
+        }
+    }
+
+    M_filepath.clear();
+    M_version = 0;
+    M_data = static_cast< const char * >( 0 );
+    M_size = 0;
+    M_mapped = false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParallelParser::parse( Handler & handler ) const
+{
+    if ( M_version == REC_VERSION_2
+         || M_version == REC_VERSION_3 )
+    {
+        return parseBinary( handler );
+    }
+
+    if ( M_version == REC_VERSION_4
+         || M_version == REC_VERSION_5 )
+    {
+        return parseText( handler );
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParallelParser::parseText( Handler & handler ) const
+{
+    const char * const end = M_data + M_size;
+
+    // header line
+    const char * eol = find_eol( M_data, end );
+    const std::string header( M_data, eol );
+    if ( header != ( M_version == REC_VERSION_4 ? "ULG4" : "ULG5" ) )
+    {
+        return false;
+    }
+
+    if ( ! handler.handleLogVersion( M_version ) )
+    {
+        return false;
+    }
+
+    boost::shared_ptr< ParserV4 > parser( M_version == REC_VERSION_4
+                                          ? new ParserV4()
+                                          : new ParserV5() );
+
+    //
+    // split to the chunks
+    //
+
+    std::vector< Chunk > chunks;
+    {
+        const char * p = ( eol < end ? eol + 1 : end );
+        int n_line = 2;
+        while ( p < end )
+        {
+            const char * next = ( static_cast< std::size_t >( end - p ) > M_chunk_size
+                                  ? find_show_line( p + M_chunk_size, end )
+                                  : end );
+            chunks.push_back( Chunk( p, next, n_line ) );
+            n_line += count_lines( p, next );
+            p = next;
+        }
+    }
+
+    //
+    // parse the chunks in parallel, and pass the events in the chunk order
+    //
+
+    const int size = static_cast< int >( chunks.size() );
+    bool failed = false;
+
+#ifdef _OPENMP
+#pragma omp parallel for ordered schedule(dynamic)
+#endif
+    for ( int i = 0; i < size; ++i )
+    {
+        // the chunks after the broken one are never passed to the handler.
+        // skip parsing them once the failure is visible to this thread.
+#ifdef _OPENMP
+#pragma omp flush( failed )
+#endif
+        const bool skip = failed;
+
+        EventBuffer buffer;
+        const bool result = ( skip
+                              ? false
+                              : parse_chunk( *parser, chunks[i], buffer ) );
+
+#ifdef _OPENMP
+#pragma omp ordered
+#endif
+        {
+            if ( ! failed )
+            {
+                buffer.replay( handler );
+                failed = ! result;
+#ifdef _OPENMP
+#pragma omp flush( failed )
+#endif
+            }
+        }
+    }
+
+    if ( failed )
+    {
+        return false;
+    }
+
+    return handler.handleEOF();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParallelParser::parseBinary( Handler & handler ) const
+{
+    if ( ! handler.handleLogVersion( M_version ) )
+    {
+        return false;
+    }
+
+    std::vector< Record > records;
+    records.reserve( M_size / ( M_version == REC_VERSION_2
+                                ? sizeof( showinfo_t )
+                                : sizeof( short_showinfo_t2 ) ) + 16 );
+
+    const bool indexed = index_records( M_data, M_size, M_version, &records );
+
+    for ( std::vector< Record >::const_iterator it = records.begin(), end = records.end();
+          it != end;
+          ++it )
+    {
+        if ( ! handle_record( M_data, M_version, *it, handler ) )
+        {
+            return false;
+        }
+    }
+
+    if ( ! indexed )
+    {
+        return false;
+    }
+
+    return handler.handleEOF();
+}
+
+}
+}
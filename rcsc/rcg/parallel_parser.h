@@ -0,0 +1,155 @@
+// -*-c++-*-
+
+/*!
+  \file parallel_parser.h
+  \brief parallel rcg file parser Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_PARALLEL_PARSER_H
+#define RCSC_RCG_PARALLEL_PARSER_H
+
+#include <string>
+#include <cstddef>
+
+namespace rcsc {
+namespace rcg {
+
+class Handler;
+
+/*!
+  \class ParallelParser
+  \brief rcg parser that reads the whole uncompressed file from memory.
+
+  The file is mapped to memory by mmap(2) if available, otherwise it is
+  read into a buffer at once.
+
+  The text log (v4/v5) is split into chunks at the lines starting with
+  "(show ". The chunks are parsed by the OpenMP worker threads into the
+  event buffers, and the buffered events are passed to the handler in the
+  chunk order. Because a chunk waits for its turn in the ordered section,
+  at most a few chunks per thread are buffered at the same time. The
+  handler receives the same callbacks in the same order as Parser::parse(),
+  and it is always called from one thread at a time. If the library is
+  built without OpenMP, the chunks are parsed one by one in the calling
+  thread.
+
+  For the binary log (v2/v3), the record offsets are indexed in the first
+  pass, and the records are passed to the handler from the mapped memory.
+
+  The compressed file and the rcg v1 are not supported. The caller should
+  use Parser::create() and Parser::parse() if open() fails.
+*/
+class ParallelParser {
+public:
+
+    //! default chunk size in bytes
+    static const std::size_t DEFAULT_CHUNK_SIZE;
+
+private:
+
+    std::string M_filepath; //!< opened file path
+    int M_version; //!< detected log version. 0 if not opened.
+
+    const char * M_data; //!< top of the file image
+    std::size_t M_size; //!< file size
+    bool M_mapped; //!< true if M_data is mapped by mmap(2)
+
+    std::size_t M_chunk_size; //!< target chunk size of the text log
+
+    // not used
+    ParallelParser( const ParallelParser & );
+    const ParallelParser & operator=( const ParallelParser & );
+
+public:
+
+    /*!
+      \brief create the parser without any file.
+     */
+    ParallelParser();
+
+    /*!
+      \brief release the file image.
+     */
+    ~ParallelParser();
+
+    /*!
+      \brief open the file and detect the log version.
+      \param filepath rcg file path
+      \return true if the file is an uncompressed rcg v2-v5 file.
+     */
+    bool open( const std::string & filepath );
+
+    /*!
+      \brief release the file image.
+     */
+    void close();
+
+    /*!
+      \brief check if the file is opened.
+      \return true if the file image is available.
+     */
+    bool isOpen() const
+      {
+          return M_version != 0;
+      }
+
+    /*!
+      \brief get the detected log version.
+      \return log version number. 0 if not opened.
+     */
+    int version() const
+      {
+          return M_version;
+      }
+
+    /*!
+      \brief set the target size of the text chunk.
+      \param size chunk size in bytes. the actual chunk is extended to the next show line.
+     */
+    void setChunkSize( const std::size_t size )
+      {
+          M_chunk_size = ( size > 0 ? size : 1 );
+      }
+
+    /*!
+      \brief analyze the opened file.
+      \param handler reference to the rcg data handler.
+      \retval true, if successfuly parsed.
+      \retval false, if incorrect format is detected.
+     */
+    bool parse( Handler & handler ) const;
+
+private:
+
+    bool parseText( Handler & handler ) const;
+    bool parseBinary( Handler & handler ) const;
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
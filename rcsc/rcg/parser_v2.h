@@ -65,7 +65,6 @@ public:
     bool parse( std::istream & is,
                 Handler & handler ) const;
 
-private:
     /*!
       \brief parse data block.
       \param is reference to the imput stream (usually ifstream).
@@ -80,6 +79,7 @@ private:
     bool parseData( std::istream & is,
                     Handler & handler ) const;
 
+private:
     /*!
       \brief parse MSG_MODE info(msg_info_t)
       \param is reference to the input stream
@@ -65,7 +65,6 @@ public:
     bool parse( std::istream & is,
                 Handler & handler ) const;
 
-private:
     /*!
       \brief parse data block.
       \param is reference to the imput stream (usually ifstream).
@@ -79,6 +78,7 @@ private:
     bool parseData( std::istream & is,
                     Handler & handler ) const;
 
+private:
     /*!
       \brief parse SHOW_MODE inof, actually short_showinfo_t2
       \param is reference to the input stream
@@ -36,6 +36,7 @@
 #include "parser_v4.h"
 
 #include "handler.h"
+#include "show_scanner.h"
 #include "types.h"
 
 #include <iostream>
@@ -161,423 +162,242 @@ bool
 ParserV4::parseShow( const int n_line,
                      const std::string & line,
                      Handler & handler ) const
+{
+    return parseShowInfo( n_line, line, false, handler );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParserV4::parseShowInfo( const int n_line,
+                         const std::string & line,
+                         const bool stamina_capacity,
+                         Handler & handler ) const
 {
     /*
       (show <Time> <Ball> <Players>)
     */
 
-    const char * buf = line.c_str();
+    // c_str() is required because the playmode and the team are read by sscanf.
+    ShowScanner scanner( line.c_str(), line.c_str() + line.size() );
+
+    ShowInfoT show;
+
+    // time
+    scanner.skip( ' ' );
+    scanner.skipUntil( ' ' );
+    long time = scanner.readLong();
 
-    if ( 0 )
+    if ( time == LONG_MIN || time == LONG_MAX )
     {
-        int n_read = 0;
+        std::cerr << n_line << ": error: "
+                  << " Illegal show info time. "
+                  << " \"" << line << "\""
+                  << std::endl;
+        return false;
+    }
 
-        // time
-        int time = 0;
+    show.time_ = static_cast< UInt32 >( time );
 
-        if ( std::sscanf( buf, " ( show %d %n ",
-                          &time, &n_read ) != 1 )
-        {
-            std::cerr << n_line << ": error: "
-                      << "Illegal time info \"" << line << "\"" << std::endl;
-            return false;
-        }
-        buf += n_read;
+    scanner.skip( ' ' );
 
-        //
-        // playmode
-        //
-        if ( *(buf + 1) == 'p' )
+    //
+    // playmode
+    //
+    if ( scanner.startsWith( "(pm" ) )
+    {
+        int n_read = 0;
+        int pm = 0;
+        if ( std::sscanf( scanner.pos(),
+                          " ( pm %d ) %n ",
+                          &pm, &n_read ) == 1 )
         {
-            int pm = 0;
-            if ( std::sscanf( buf,
-                              " ( pm %d ) %n ",
-                              &pm, &n_read ) == 1 )
-            {
-                buf += n_read;
-                handler.handlePlayMode( time, static_cast< PlayMode >( pm ) );
-            }
+            scanner.advance( n_read );
+            handler.handlePlayMode( time, static_cast< PlayMode >( pm ) );
         }
+    }
 
-        //
-        // team
-        //
-        if ( *(buf + 1) == 't' )
+    //
+    // team
+    //
+    if ( scanner.startsWith( "(tm" ) )
+    {
+        char name_l[32], name_r[32];
+        int score_l = 0, score_r = 0;
+        int pen_score_l = 0, pen_miss_l = 0, pen_score_r = 0, pen_miss_r = 0;
+
+        int n = std::sscanf( scanner.pos(),
+                             " ( tm %31s %31s %d %d %d %d %d %d ",
+                             name_l, name_r,
+                             &score_l, &score_r,
+                             &pen_score_l, &pen_miss_l,
+                             &pen_score_r, &pen_miss_r );
+
+        if ( n != 4 && n != 8 )
         {
-            char name_l[32], name_r[32];
-            int score_l = 0, score_r = 0;
-            int pen_score_l = 0, pen_miss_l = 0, pen_score_r = 0, pen_miss_r = 0;
-
-            int n = std::sscanf( buf,
-                                 " ( tm %31s %31s %d %d %d %d %d %d ",
-                                 name_l, name_r,
-                                 &score_l, &score_r,
-                                 &pen_score_l, &pen_miss_l,
-                                 &pen_score_r, &pen_miss_r );
-
-            if ( n != 4 && n != 8 )
-            {
-                std::cerr << n_line << ": error: n=" << n << ' '
-                          << "Illegal team info. \"" << line << "\"" << std::endl;;
-                return false;
-            }
-            while ( *buf != ')' && *buf != '\0' ) ++buf;
-            while ( *buf == ')' && *buf != '\0' ) ++buf;
-
-            if ( ! std::strcmp( name_l, "null" ) ) std::memset( name_l, 0, 4 );
-            if ( ! std::strcmp( name_r, "null" ) ) std::memset( name_r, 0, 4 );
-
-            TeamT team_l( name_l, score_l, pen_score_l, pen_miss_l );
-            TeamT team_r( name_r, score_r, pen_score_r, pen_miss_r );
-
-            handler.handleTeam( time, team_l, team_r );
+            std::cerr << n_line << ": error: n=" << n << ' '
+                      << "Illegal team info. \"" << line << "\"" << std::endl;;
+            return false;
         }
+        scanner.skipUntil( ')' );
+        scanner.skip( ')' );
 
-        //
-        // show main
-        //
-
-        ShowInfoT show;
+        if ( ! std::strcmp( name_l, "null" ) ) std::memset( name_l, 0, 4 );
+        if ( ! std::strcmp( name_r, "null" ) ) std::memset( name_r, 0, 4 );
 
-        show.time_ = time;
+        TeamT team_l( name_l, score_l, pen_score_l, pen_miss_l );
+        TeamT team_r( name_r, score_r, pen_score_r, pen_miss_r );
 
-        //
-        // ball
-        //
+        handler.handleTeam( time, team_l, team_r );
+    }
 
-        if ( std::sscanf( buf, " ((b) %f %f %f %f) %n",
-                          &show.ball_.x_, &show.ball_.y_,
-                          &show.ball_.vx_, &show.ball_.vy_,
-                          &n_read ) != 4 )
+    // ball
+    {
+        // ((b) x y vx vy)
+        scanner.skip( ' ' );
+        scanner.skipUntil( ')' );
+        scanner.skip( ')' );
+        BallT & ball = show.ball_;
+        ball.x_ = scanner.readFloat();
+        ball.y_ = scanner.readFloat();
+        ball.vx_ = scanner.readFloat();
+        ball.vy_ = scanner.readFloat();
+        scanner.skip( ')' );
+        scanner.skip( ' ' );
+
+        if ( ball.vy_ == HUGE_VALF )
         {
             std::cerr << n_line << ": error: "
-                      << "Illegal ball info \"" << line << "\"" << std::endl;
+                      << " Illegal ball info. "
+                      << " \"" << line << "\""
+                      << std::endl;;
             return false;
         }
-        buf += n_read;
-
-        //
-        // players
-        //
-
-        char side;
-        short unum;
-        short type;
-        int state;
-        float x, y, vx, vy, body, neck;
-        for ( int i = 0; i < MAX_PLAYER * 2; ++i )
-        {
-            if ( *buf == ')' ) break;
-
-            if ( std::sscanf( buf,
-                              " ((%c %hd) %hd %x %f %f %f %f %f %f %n",
-                              &side, &unum,
-                              &type, &state,
-                              &x, &y, &vx, &vy, &body, &neck,
-                              &n_read ) != 10 )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player id or pos " << i << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
-            buf += n_read;
-
-            int idx = unum - 1;
-            if ( side == 'r' ) idx += MAX_PLAYER;
-            if ( idx < 0 || MAX_PLAYER*2 <= idx )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player id " << i << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
-
-            PlayerT & p = show.player_[idx];
-
-            p.side_ = side;
-            p.unum_ = unum;
-            p.type_ = type;
-            p.state_ = state;
-            p.x_ = x;
-            p.y_ = y;
-            p.vx_ = vx;
-            p.vy_ = vy;
-            p.body_ = body;
-            p.neck_ = neck;
-
-            if ( *buf != '('
-                 && std::sscanf( buf,
-                                 " %f %f %n",
-                                 &p.point_x_, &p.point_y_,
-                                 &n_read ) == 2 )
-            {
-                buf += n_read;
-            }
-
-            if ( std::sscanf( buf,
-                              " (v %c %f) (s %f %f %f) %n",
-                              &p.view_quality_, &p.view_width_,
-                              &p.stamina_, &p.effort_, &p.recovery_,
-                              &n_read ) != 5 )
-            {
-                std::cerr << n_line << ": error: "
-                          << "Illegal player view or stamina (" << side << ' ' << unum
-                          << ") [" << line << "]" << std::endl;;
-                return false;
-            }
-            buf += n_read;
-
-            if ( *(buf + 1) == 'f'
-                 && std::sscanf( buf,
-                                 " ( f %c %hd ) %n",
-                                 &p.focus_side_, &p.focus_unum_,
-                                 &n_read ) == 2 )
-            {
-                buf += n_read;
-            }
-
-            if ( std::sscanf( buf,
-                              " (c %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd)) %n",
-                              &p.kick_count_,
-                              &p.dash_count_,
-                              &p.turn_count_,
-                              &p.catch_count_,
-                              &p.move_count_,
-                              &p.turn_neck_count_,
-                              &p.change_view_count_,
-                              &p.say_count_,
-                              &p.tackle_count_,
-                              &p.pointto_count_,
-                              &p.attentionto_count_,
-                              &n_read ) != 11 )
-            {
-                std::cerr << n_line << ": error: "
-                          << "Illegal player count (" << side << ' ' << unum
-                          << ") [" << line << "]" << std::endl;;
-                return false;
-            }
-            buf += n_read;
-        }
-
-        handler.handleShow( time, show );
     }
-    else
-    {
-        ShowInfoT show;
 
-        char * next;
+    // players
+    // ((side unum) type state x y vx vy body neck [pointx pointy] (v h 90) (s 4000 1 1 [127000])[(f side unum)])
+    //              (c 1 1 1 1 1 1 1 1 1 1 1))
+    for ( int i = 0; i < MAX_PLAYER*2; ++i )
+    {
+        if ( scanner.atEnd() || scanner.peek() == ')' ) break;
 
-        // time
-        while ( *buf == ' ' ) ++buf;
-        while ( *buf != '\0' && *buf != ' ' ) ++buf;
-        long time = std::strtol( buf, &next, 10 ); buf = next;
+        // ((side unum)
+        scanner.skip( ' ' );
+        scanner.skip( '(' );
+        char side = scanner.peek();
+        if ( side != 'l' && side != 'r' )
+        {
+            std::cerr << n_line << ": error: "
+                      << " Illegal player side. " << side << ' ' << i
+                      << " \"" << scanner.pos() << "\""
+                      << std::endl;;
+            return false;
+        }
 
-        if ( time == LONG_MIN || time == LONG_MAX )
+        scanner.advance();
+        long unum = scanner.readLong();
+        if ( unum < 1 || MAX_PLAYER < unum )
         {
             std::cerr << n_line << ": error: "
-                      << " Illegal show info time. "
-                      << " \"" << line << "\""
-                      << std::endl;
+                      << " Illegal player unum. " << side << ' ' << i
+                      << " \"" << scanner.pos() << "\""
+                      << std::endl;;
             return false;
         }
 
-        show.time_ = static_cast< UInt32 >( time );
+        scanner.skip( ')' );
+
+        const int idx = ( side == 'l' ? unum - 1 : unum - 1 + MAX_PLAYER );
+
+        PlayerT & p = show.player_[idx];
+        p.side_ = side;
+        p.unum_ = static_cast< Int16 >( unum );
 
-        while ( *buf == ' ' ) ++buf;
+        // type state x y vx vy body neck
+        p.type_ = static_cast< Int16 >( scanner.readLong() );
+        p.state_ = static_cast< Int32 >( scanner.readLong( 16 ) );
+        p.x_ = scanner.readFloat();
+        p.y_ = scanner.readFloat();
+        p.vx_ = scanner.readFloat();
+        p.vy_ = scanner.readFloat();
+        p.body_ = scanner.readFloat();
+        p.neck_ = scanner.readFloat();
+        scanner.skip( ' ' );
 
-        //
-        // playmode
-        //
-        if ( ! std::strncmp( buf, "(pm", 3 ) )
+        // pointx pointy
+        if ( ! scanner.atEnd() && scanner.peek() != '(' )
         {
-            int n_read = 0;
-            int pm = 0;
-            if ( std::sscanf( buf,
-                              " ( pm %d ) %n ",
-                              &pm, &n_read ) == 1 )
-            {
-                buf += n_read;
-                handler.handlePlayMode( time, static_cast< PlayMode >( pm ) );
-            }
+            p.point_x_ = scanner.readFloat();
+            p.point_y_ = scanner.readFloat();
         }
 
-        //
-        // team
-        //
-        if ( ! std::strncmp( buf, "(tm", 3 ) )
+        // (v quality width)
+        scanner.skipUntil( 'v' );
+        scanner.advance(); // skip 'v'
+        scanner.skip( ' ' );
+        p.view_quality_ = scanner.get();
+        p.view_width_ = scanner.readFloat();
+
+        // (s stamina effort recovery [capacity])
+        scanner.skipUntil( 's' );
+        scanner.advance(); // skip 's'
+        p.stamina_ = scanner.readFloat();
+        p.effort_ = scanner.readFloat();
+        p.recovery_ = scanner.readFloat();
+        if ( stamina_capacity )
         {
-            char name_l[32], name_r[32];
-            int score_l = 0, score_r = 0;
-            int pen_score_l = 0, pen_miss_l = 0, pen_score_r = 0, pen_miss_r = 0;
-
-            int n = std::sscanf( buf,
-                                 " ( tm %31s %31s %d %d %d %d %d %d ",
-                                 name_l, name_r,
-                                 &score_l, &score_r,
-                                 &pen_score_l, &pen_miss_l,
-                                 &pen_score_r, &pen_miss_r );
-
-            if ( n != 4 && n != 8 )
-            {
-                std::cerr << n_line << ": error: n=" << n << ' '
-                          << "Illegal team info. \"" << line << "\"" << std::endl;;
-                return false;
-            }
-            while ( *buf != ')' && *buf != '\0' ) ++buf;
-            while ( *buf == ')' && *buf != '\0' ) ++buf;
-
-            if ( ! std::strcmp( name_l, "null" ) ) std::memset( name_l, 0, 4 );
-            if ( ! std::strcmp( name_r, "null" ) ) std::memset( name_r, 0, 4 );
-
-            TeamT team_l( name_l, score_l, pen_score_l, pen_miss_l );
-            TeamT team_r( name_r, score_r, pen_score_r, pen_miss_r );
-
-            handler.handleTeam( time, team_l, team_r );
+            p.stamina_capacity_ = scanner.readFloat();
         }
+        scanner.skipUntil( ')' );
+        scanner.skip( ')' );
 
-        // ball
+        scanner.skipUntil( '(' );
+
+        // (f side unum)
+        if ( scanner.peek( 1 ) == 'f' )
         {
-            // ((b) x y vx vy)
-            while ( *buf == ' ' ) ++buf;
-            while ( *buf != '\0' && *buf != ')' ) ++buf;
-            while ( *buf == ')' ) ++buf;
-            BallT & ball = show.ball_;
-            ball.x_ = strtof( buf, &next ); buf = next;
-            ball.y_ = strtof( buf, &next ); buf = next;
-            ball.vx_ = strtof( buf, &next ); buf = next;
-            ball.vy_ = strtof( buf, &next ); buf = next;
-            while ( *buf == ')' ) ++buf;
-            while ( *buf == ' ' ) ++buf;
-
-            if ( ball.vy_ == HUGE_VALF )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal ball info. "
-                          << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
+            scanner.skipUntil( ' ' );
+            scanner.skip( ' ' );
+            p.focus_side_ = scanner.get();
+            p.focus_unum_ = static_cast< Int16 >( scanner.readLong() );
+            scanner.skip( ' ' );
+            scanner.skip( ')' );
+            scanner.skip( ' ' );
         }
 
-        // players
-        // ((side unum) type state x y vx vy body neck [pointx pointy] (v h 90) (s 4000 1 1)[(f side unum)])
-        //              (c 1 1 1 1 1 1 1 1 1 1 1))
-        for ( int i = 0; i < MAX_PLAYER*2; ++i )
+        // (c kick dash turn catch move tneck cview say tackle pointto atttention)
+        scanner.skip( '(' );
+        scanner.advance(); // skip 'c'
+        p.kick_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.dash_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.turn_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.catch_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.move_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.turn_neck_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.change_view_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.say_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.tackle_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.pointto_count_ = static_cast< UInt16 >( scanner.readLong() );
+        p.attentionto_count_ = static_cast< UInt16 >( scanner.readLong() );
+        scanner.skip( ')' );
+        scanner.skip( ' ' );
+
+        if ( scanner.atEnd()
+             && i != MAX_PLAYER*2 - 1 )
         {
-            if ( *buf == '\0' || *buf == ')' ) break;
-
-            // ((side unum)
-            while ( *buf == ' ' ) ++buf;
-            while ( *buf == '(' ) ++buf;
-            char side = *buf;
-            if ( side != 'l' && side != 'r' )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player side. " << side << ' ' << i
-                          << " \"" << buf << "\""
-                          << std::endl;;
-                return false;
-            }
-
-            ++buf;
-            long unum = std::strtol( buf, &next, 10 ); buf = next;
-            if ( unum < 0 || MAX_PLAYER < unum )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player unum. " << side << ' ' << i
-                          << " \"" << buf << "\""
-                          << std::endl;;
-                return false;
-            }
-
-            while ( *buf == ')' ) ++buf;
-
-            const int idx = ( side == 'l' ? unum - 1 : unum - 1 + MAX_PLAYER );
-
-            PlayerT & p = show.player_[idx];
-            p.side_ = side;
-            p.unum_ = static_cast< Int16 >( unum );
-
-            // x y vx vy body neck
-            p.type_ = static_cast< Int16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.state_ = static_cast< Int32 >( std::strtol( buf, &next, 16 ) ); buf = next;
-            p.x_ = strtof( buf, &next ); buf = next;
-            p.y_ = strtof( buf, &next ); buf = next;
-            p.vx_ = strtof( buf, &next ); buf = next;
-            p.vy_ = strtof( buf, &next ); buf = next;
-            p.body_ = strtof( buf, &next ); buf = next;
-            p.neck_ = strtof( buf, &next ); buf = next;
-            while ( *buf == ' ' ) ++buf;
-
-            // x y vx vy body neck
-            if ( *buf != '\0' && *buf != '(' )
-            {
-                p.point_x_ = strtof( buf, &next ); buf = next;
-                p.point_y_ = strtof( buf, &next ); buf = next;
-            }
-
-            // (v quality width)
-            while ( *buf != '\0' && *buf != 'v' ) ++buf;
-            ++buf; // skip 'v'
-            while ( *buf == ' ' ) ++buf;
-            p.view_quality_ = *buf; ++buf;
-            p.view_width_ = strtof( buf, &next ); buf = next;
-
-            // (s stamina effort recovery)
-            while ( *buf != '\0' && *buf != 's' ) ++buf;
-            ++buf; // skip 's' //while ( *buf != '\0' && *buf != ' ' ) ++buf;
-            p.stamina_ = strtof( buf, &next ); buf = next;
-            p.effort_ = strtof( buf, &next ); buf = next;
-            p.recovery_ = strtof( buf, &next ); buf = next;
-            while ( *buf != '\0' && *buf != ')' ) ++buf;
-            while ( *buf == ')' ) ++buf;
-
-            while ( *buf != '\0' && *buf != '(' ) ++buf;
-
-            // (f side unum)
-            if ( *(buf + 1) == 'f' )
-            {
-                while ( *buf != '\0' && *buf != ' ' ) ++buf;
-                while ( *buf == ' ' ) ++buf;
-                p.focus_side_ = *buf; ++buf;
-                p.focus_unum_ = static_cast< Int16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-                while ( *buf == ' ' ) ++buf;
-                while ( *buf == ')' ) ++buf;
-                while ( *buf == ' ' ) ++buf;
-            }
-
-            // (c kick dash turn catch move tneck cview say tackle pointto atttention)
-            while ( *buf == '(' ) ++buf;
-            ++buf; // skip 'c' //while ( *buf != '\0' && *buf != ' ' ) ++buf;
-            p.kick_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.dash_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.turn_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.catch_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.move_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.turn_neck_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.change_view_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.say_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.tackle_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.pointto_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            p.attentionto_count_ = static_cast< UInt16 >( std::strtol( buf, &next, 10 ) ); buf = next;
-            while ( *buf == ')' ) ++buf;
-            while ( *buf == ' ' ) ++buf;
-
-            if ( *buf == '\0'
-                 && i != MAX_PLAYER*2 - 1 )
-            {
-                std::cerr << n_line << ": error: "
-                          << " Illegal player info. " << side << ' ' << unum
-                          << " \"" << line << "\""
-                          << std::endl;;
-                return false;
-            }
+            std::cerr << n_line << ": error: "
+                      << " Illegal player info. " << side << ' ' << unum
+                      << " \"" << line << "\""
+                      << std::endl;;
+            return false;
         }
-
-        handler.handleShow( time, show );
     }
 
+    handler.handleShow( time, show );
+
     return true;
 }
 
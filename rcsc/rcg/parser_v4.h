@@ -99,6 +99,22 @@ protected:
                     const std::string & line,
                     Handler & handler ) const;
 
+    /*!
+      \brief parse the show line of v4 or later.
+      \param n_line the number of total read line
+      \param line the data string
+      \param stamina_capacity if true, stamina capacity is read. (v5 or later)
+      \param handler reference to the data handler object
+      \retval true if successfully parsed.
+      \retval false if failed to parse.
+
+      The line is scanned in place by ShowScanner.
+    */
+    bool parseShowInfo( const int n_line,
+                        const std::string & line,
+                        const bool stamina_capacity,
+                        Handler & handler ) const;
+
     /*!
       \brief parse MSG_MODE info(msg_info_t)
       \param n_line the number of total read line
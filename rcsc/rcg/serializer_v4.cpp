@@ -56,6 +56,32 @@ quantize( const double & val,
     return rint( val / prec ) * prec;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+inline
+void
+put_param( rcsc::rcg::TextBuffer & buf,
+           const char * name,
+           const int val )
+{
+    buf.put( '(' ).put( name ).put( ' ' ).putInt( val ).put( ')' );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+inline
+void
+put_param( rcsc::rcg::TextBuffer & buf,
+           const char * name,
+           const double & val )
+{
+    buf.put( '(' ).put( name ).put( ' ' ).putDouble( val ).put( ')' );
+}
+
 }
 
 namespace rcsc {
@@ -91,135 +117,138 @@ SerializerV4::serialize( std::ostream & os,
                          const server_params_t & param )
 {
     double tmp = 0.0;
-    os << "(server_param "
-       << "(goal_width " << quantize( nltohd( param.goal_width ) ) << ')'
-       << "(inertia_moment " << quantize( nltohd( param.inertia_moment ) ) << ')'
-       << "(player_size " << quantize( nltohd( param.player_size ) ) << ')'
-       << "(player_decay " << quantize( nltohd( param.player_decay ) ) << ')'
-       << "(player_rand " << quantize( nltohd( param.player_rand ), 0.0001 ) << ')'
-       << "(player_weight " << quantize( nltohd( param.player_weight ) ) << ')'
-       << "(player_speed_max " << quantize( nltohd( param.player_speed_max ) ) << ')'
-       << "(player_accel_max " << quantize( nltohd( param.player_accel_max ) ) << ')'
-       << "(stamina_max " << quantize( nltohd( param.stamina_max ) ) << ')'
-       << "(stamina_inc_max " << quantize( nltohd( param.stamina_inc ) ) << ')'
-       << "(recover_init " << quantize( nltohd( param.recover_init ) ) << ')'
-       << "(recover_dec_thr " << quantize( nltohd( param.recover_dec_thr ) ) << ')'
-       << "(recover_min " << quantize( nltohd( param.recover_min ) ) << ')'
-       << "(recover_dec " << quantize( nltohd( param.recover_dec ) ) << ')'
-       << "(effort_init " << quantize( nltohd( param.effort_init ) ) << ')'
-       << "(effort_dec_thr " << quantize( nltohd( param.effort_dec_thr ) ) << ')'
-       << "(effort_min " << quantize( nltohd( param.effort_min ), 0.00001 ) << ')'
-       << "(effort_dec " << quantize( nltohd( param.effort_dec ), 0.00001 ) << ')'
-       << "(effort_inc_thr " << quantize( nltohd( param.effort_inc_thr ) ) << ')'
-       << "(effort_inc " << quantize( nltohd( param.effort_inc ), 0.0001 ) << ')'
-       << "(kick_rand " << quantize( nltohd( param.kick_rand ), 0.00001 ) << ')'
-       << "(team_actuator_noise " << nstohi( param.team_actuator_noise ) << ')'
-       << "(prand_factor_l " << quantize( nltohd( param.player_rand_factor_l ) ) << ')'
-       << "(prand_factor_r " << quantize( nltohd( param.player_rand_factor_r ) ) << ')'
-       << "(kick_rand_factor_l " << quantize( nltohd( param.kick_rand_factor_l ) ) << ')'
-       << "(kick_rand_factor_r " << quantize( nltohd( param.kick_rand_factor_r ) ) << ')'
-       << "(ball_size " << quantize( nltohd( param.ball_size ) ) << ')'
-       << "(ball_decay " << quantize( nltohd( param.ball_decay ) ) << ')'
-       << "(ball_rand " << quantize( nltohd( param.ball_rand ) ) << ')'
-       << "(ball_weight " << quantize( nltohd( param.ball_weight ) ) << ')'
-       << "(ball_speed_max " << quantize( nltohd( param.ball_speed_max ) ) << ')'
-       << "(ball_accel_max " << quantize( nltohd( param.ball_accel_max ) ) << ')'
-       << "(dash_power_rate " << quantize( nltohd( param.dash_power_rate ), 0.0001 ) << ')'
-       << "(kick_power_rate " << quantize( nltohd( param.kick_power_rate ), 0.0001 ) << ')'
-       << "(kickable_margin " << quantize( nltohd( param.kickable_margin ) ) << ')'
-       << "(control_radius " << quantize( nltohd( param.control_radius ) ) << ')'
-        //<< "(control_radius_width " << quantize( nltohd( param.control_radius_width ) ) << ')'
-       << "(maxpower " << quantize( nltohd( param.max_power ) ) << ')'
-       << "(minpower " << quantize( nltohd( param.min_power ) ) << ')'
-       << "(maxmoment " << quantize( nltohd( param.max_moment ) ) << ')'
-       << "(minmoment " << quantize( nltohd( param.min_moment ) ) << ')'
-       << "(maxneckmoment " << quantize( nltohd( param.max_neck_moment ) ) << ')'
-       << "(minneckmoment " << quantize( nltohd( param.min_neck_moment ) ) << ')'
-       << "(maxneckang " << quantize( nltohd( param.max_neck_angle ) ) << ')'
-       << "(minneckang " << quantize( nltohd( param.min_neck_angle ) ) << ')'
-       << "(visible_angle " << quantize( nltohd( param.visible_angle ) ) << ')'
-       << "(visible_distance " << quantize( nltohd( param.visible_distance ) ) << ')'
-       << "(wind_dir " << quantize( nltohd( param.wind_dir ) ) << ')'
-       << "(wind_force " << quantize( nltohd( param.wind_force ) ) << ')'
-       << "(wind_ang " << quantize( nltohd( param.wind_ang ) ) << ')'
-       << "(wind_rand " << quantize( nltohd( param.wind_rand ) ) << ')'
-        //<< "(kickable_area " << quantize( nltohd( param.kickable_area ) ) << ')'
-       << "(catchable_area_l " << quantize( nltohd( param.catch_area_l ) ) << ')'
-       << "(catchable_area_w " << quantize( nltohd( param.catch_area_w ) ) << ')'
-       << "(catch_probability " << quantize( nltohd( param.catch_probability ) ) << ')'
-       << "(goalie_max_moves " << nstohi( param.goalie_max_moves ) << ')'
-       << "(ckick_margin " << quantize( nltohd( param.corner_kick_margin ) ) << ')'
-       << "(offside_active_area_size " << quantize( nltohd( param.offside_active_area ) ) << ')'
-       << "(wind_none " << nstohi( param.wind_none ) << ')'
-       << "(wind_random " << nstohi( param.use_wind_random ) << ')'
-       << "(say_coach_cnt_max " << nstohi( param.coach_say_count_max ) << ')'
-       << "(say_coach_msg_size " << nstohi( param.coach_say_msg_size ) << ')'
-       << "(clang_win_size " << nstohi( param.clang_win_size ) << ')'
-       << "(clang_define_win " << nstohi( param.clang_define_win ) << ')'
-       << "(clang_meta_win " << nstohi( param.clang_meta_win ) << ')'
-       << "(clang_advice_win " << nstohi( param.clang_advice_win ) << ')'
-       << "(clang_info_win " << nstohi( param.clang_info_win ) << ')'
-       << "(clang_mess_delay " << nstohi( param.clang_mess_delay ) << ')'
-       << "(clang_mess_per_cycle " << nstohi( param.clang_mess_per_cycle ) << ')'
-       << "(half_time " << nstohi( param.half_time ) << ')'
-       << "(simulator_step " << nstohi( param.simulator_step ) << ')'
-       << "(send_step " << nstohi( param.send_step ) << ')'
-       << "(recv_step " << nstohi( param.recv_step ) << ')'
-       << "(sense_body_step " << nstohi( param.sense_body_step ) << ')'
-        //<< "(lcm_step " << nstohi( param.lcm_step ) << ')'
-       << "(say_msg_size " << nstohi( param.player_say_msg_size ) << ')'
-       << "(hear_max " << nstohi( param.player_hear_max ) << ')'
-       << "(hear_inc " << nstohi( param.player_hear_inc ) << ')'
-       << "(hear_decay " << nstohi( param.player_hear_decay ) << ')'
-       << "(catch_ban_cycle " << nstohi( param.catch_ban_cycle ) << ')'
-       << "(slow_down_factor " << nstohi( param.slow_down_factor ) << ')'
-       << "(use_offside " << nstohi( param.use_offside ) << ')'
-       << "(forbid_kick_off_offside " << nstohi( param.kickoff_offside ) << ')'
-       << "(offside_kick_margin " << quantize( nltohd( param.offside_kick_margin ) ) << ')'
-       << "(audio_cut_dist " << quantize( nltohd( param.audio_cut_dist ) ) << ')'
-       << "(quantize_step " << quantize( nltohd( param.dist_quantize_step ) ) << ')'
-       << "(quantize_step_l " << quantize( nltohd( param.landmark_dist_quantize_step ), 0.0001 ) << ')'
-        //<< "(quantize_step_dir " << quantize( nltohd( param.dir_quantize_step ) ) << ')'
-        //<< "(quantize_step_dist_team_l " << quantize( nltohd( param.dist_quantize_step_l ) ) << ')'
-        //<< "(quantize_step_dist_team_r " << quantize( nltohd( param.dist_quantize_step_r ) ) << ')'
-        //<< "(quantize_step_dist_l_team_l " << quantize( nltohd( param.landmark_dist_quantize_step_l ) ) << ')'
-        //<< "(quantize_step_dist_l_team_r " << quantize( nltohd( param.landmark_dist_quantize_step_r ) ) << ')'
-        //<< "(quantize_step_dir_team_l " << quantize( nltohd( param.dir_quantize_step_l ) ) << ')'
-        //<< "(quantize_step_dir_team_r " << quantize( nltohd( param.dir_quantize_step_r ) ) << ')'
-       << "(coach " << nstohi( param.coach_mode ) << ')'
-       << "(coach_w_referee " << nstohi( param.coach_with_referee_mode ) << ')'
-       << "(old_coach_hear " << nstohi( param.use_old_coach_hear ) << ')'
-       << "(send_vi_step " << nstohi( param.online_coach_look_step ) << ')'
-       << "(slowness_on_top_for_left_team " << quantize( nltohd( param.slowness_on_top_for_left_team ) ) << ')'
-       << "(slowness_on_top_for_right_team " << quantize( nltohd( param.slowness_on_top_for_right_team ) ) << ')'
-       << "(keepaway_length " << quantize( nltohd( param.ka_length ) ) << ')'
-       << "(keepaway_width " << quantize( nltohd( param.ka_width ) ) << ')';
+
+    M_buffer.clear();
+    M_buffer.put( "(server_param " );
+    put_param( M_buffer, "goal_width", quantize( nltohd( param.goal_width ) ) );
+    put_param( M_buffer, "inertia_moment", quantize( nltohd( param.inertia_moment ) ) );
+    put_param( M_buffer, "player_size", quantize( nltohd( param.player_size ) ) );
+    put_param( M_buffer, "player_decay", quantize( nltohd( param.player_decay ) ) );
+    put_param( M_buffer, "player_rand", quantize( nltohd( param.player_rand ), 0.0001 ) );
+    put_param( M_buffer, "player_weight", quantize( nltohd( param.player_weight ) ) );
+    put_param( M_buffer, "player_speed_max", quantize( nltohd( param.player_speed_max ) ) );
+    put_param( M_buffer, "player_accel_max", quantize( nltohd( param.player_accel_max ) ) );
+    put_param( M_buffer, "stamina_max", quantize( nltohd( param.stamina_max ) ) );
+    put_param( M_buffer, "stamina_inc_max", quantize( nltohd( param.stamina_inc ) ) );
+    put_param( M_buffer, "recover_init", quantize( nltohd( param.recover_init ) ) );
+    put_param( M_buffer, "recover_dec_thr", quantize( nltohd( param.recover_dec_thr ) ) );
+    put_param( M_buffer, "recover_min", quantize( nltohd( param.recover_min ) ) );
+    put_param( M_buffer, "recover_dec", quantize( nltohd( param.recover_dec ) ) );
+    put_param( M_buffer, "effort_init", quantize( nltohd( param.effort_init ) ) );
+    put_param( M_buffer, "effort_dec_thr", quantize( nltohd( param.effort_dec_thr ) ) );
+    put_param( M_buffer, "effort_min", quantize( nltohd( param.effort_min ), 0.00001 ) );
+    put_param( M_buffer, "effort_dec", quantize( nltohd( param.effort_dec ), 0.00001 ) );
+    put_param( M_buffer, "effort_inc_thr", quantize( nltohd( param.effort_inc_thr ) ) );
+    put_param( M_buffer, "effort_inc", quantize( nltohd( param.effort_inc ), 0.0001 ) );
+    put_param( M_buffer, "kick_rand", quantize( nltohd( param.kick_rand ), 0.00001 ) );
+    put_param( M_buffer, "team_actuator_noise", nstohi( param.team_actuator_noise ) );
+    put_param( M_buffer, "prand_factor_l", quantize( nltohd( param.player_rand_factor_l ) ) );
+    put_param( M_buffer, "prand_factor_r", quantize( nltohd( param.player_rand_factor_r ) ) );
+    put_param( M_buffer, "kick_rand_factor_l", quantize( nltohd( param.kick_rand_factor_l ) ) );
+    put_param( M_buffer, "kick_rand_factor_r", quantize( nltohd( param.kick_rand_factor_r ) ) );
+    put_param( M_buffer, "ball_size", quantize( nltohd( param.ball_size ) ) );
+    put_param( M_buffer, "ball_decay", quantize( nltohd( param.ball_decay ) ) );
+    put_param( M_buffer, "ball_rand", quantize( nltohd( param.ball_rand ) ) );
+    put_param( M_buffer, "ball_weight", quantize( nltohd( param.ball_weight ) ) );
+    put_param( M_buffer, "ball_speed_max", quantize( nltohd( param.ball_speed_max ) ) );
+    put_param( M_buffer, "ball_accel_max", quantize( nltohd( param.ball_accel_max ) ) );
+    put_param( M_buffer, "dash_power_rate", quantize( nltohd( param.dash_power_rate ), 0.0001 ) );
+    put_param( M_buffer, "kick_power_rate", quantize( nltohd( param.kick_power_rate ), 0.0001 ) );
+    put_param( M_buffer, "kickable_margin", quantize( nltohd( param.kickable_margin ) ) );
+    put_param( M_buffer, "control_radius", quantize( nltohd( param.control_radius ) ) );
+    //put_param( M_buffer, "control_radius_width", quantize( nltohd( param.control_radius_width ) ) );
+    put_param( M_buffer, "maxpower", quantize( nltohd( param.max_power ) ) );
+    put_param( M_buffer, "minpower", quantize( nltohd( param.min_power ) ) );
+    put_param( M_buffer, "maxmoment", quantize( nltohd( param.max_moment ) ) );
+    put_param( M_buffer, "minmoment", quantize( nltohd( param.min_moment ) ) );
+    put_param( M_buffer, "maxneckmoment", quantize( nltohd( param.max_neck_moment ) ) );
+    put_param( M_buffer, "minneckmoment", quantize( nltohd( param.min_neck_moment ) ) );
+    put_param( M_buffer, "maxneckang", quantize( nltohd( param.max_neck_angle ) ) );
+    put_param( M_buffer, "minneckang", quantize( nltohd( param.min_neck_angle ) ) );
+    put_param( M_buffer, "visible_angle", quantize( nltohd( param.visible_angle ) ) );
+    put_param( M_buffer, "visible_distance", quantize( nltohd( param.visible_distance ) ) );
+    put_param( M_buffer, "wind_dir", quantize( nltohd( param.wind_dir ) ) );
+    put_param( M_buffer, "wind_force", quantize( nltohd( param.wind_force ) ) );
+    put_param( M_buffer, "wind_ang", quantize( nltohd( param.wind_ang ) ) );
+    put_param( M_buffer, "wind_rand", quantize( nltohd( param.wind_rand ) ) );
+    //put_param( M_buffer, "kickable_area", quantize( nltohd( param.kickable_area ) ) );
+    put_param( M_buffer, "catchable_area_l", quantize( nltohd( param.catch_area_l ) ) );
+    put_param( M_buffer, "catchable_area_w", quantize( nltohd( param.catch_area_w ) ) );
+    put_param( M_buffer, "catch_probability", quantize( nltohd( param.catch_probability ) ) );
+    put_param( M_buffer, "goalie_max_moves", nstohi( param.goalie_max_moves ) );
+    put_param( M_buffer, "ckick_margin", quantize( nltohd( param.corner_kick_margin ) ) );
+    put_param( M_buffer, "offside_active_area_size", quantize( nltohd( param.offside_active_area ) ) );
+    put_param( M_buffer, "wind_none", nstohi( param.wind_none ) );
+    put_param( M_buffer, "wind_random", nstohi( param.use_wind_random ) );
+    put_param( M_buffer, "say_coach_cnt_max", nstohi( param.coach_say_count_max ) );
+    put_param( M_buffer, "say_coach_msg_size", nstohi( param.coach_say_msg_size ) );
+    put_param( M_buffer, "clang_win_size", nstohi( param.clang_win_size ) );
+    put_param( M_buffer, "clang_define_win", nstohi( param.clang_define_win ) );
+    put_param( M_buffer, "clang_meta_win", nstohi( param.clang_meta_win ) );
+    put_param( M_buffer, "clang_advice_win", nstohi( param.clang_advice_win ) );
+    put_param( M_buffer, "clang_info_win", nstohi( param.clang_info_win ) );
+    put_param( M_buffer, "clang_mess_delay", nstohi( param.clang_mess_delay ) );
+    put_param( M_buffer, "clang_mess_per_cycle", nstohi( param.clang_mess_per_cycle ) );
+    put_param( M_buffer, "half_time", nstohi( param.half_time ) );
+    put_param( M_buffer, "simulator_step", nstohi( param.simulator_step ) );
+    put_param( M_buffer, "send_step", nstohi( param.send_step ) );
+    put_param( M_buffer, "recv_step", nstohi( param.recv_step ) );
+    put_param( M_buffer, "sense_body_step", nstohi( param.sense_body_step ) );
+    //put_param( M_buffer, "lcm_step", nstohi( param.lcm_step ) );
+    put_param( M_buffer, "say_msg_size", nstohi( param.player_say_msg_size ) );
+    put_param( M_buffer, "hear_max", nstohi( param.player_hear_max ) );
+    put_param( M_buffer, "hear_inc", nstohi( param.player_hear_inc ) );
+    put_param( M_buffer, "hear_decay", nstohi( param.player_hear_decay ) );
+    put_param( M_buffer, "catch_ban_cycle", nstohi( param.catch_ban_cycle ) );
+    put_param( M_buffer, "slow_down_factor", nstohi( param.slow_down_factor ) );
+    put_param( M_buffer, "use_offside", nstohi( param.use_offside ) );
+    put_param( M_buffer, "forbid_kick_off_offside", nstohi( param.kickoff_offside ) );
+    put_param( M_buffer, "offside_kick_margin", quantize( nltohd( param.offside_kick_margin ) ) );
+    put_param( M_buffer, "audio_cut_dist", quantize( nltohd( param.audio_cut_dist ) ) );
+    put_param( M_buffer, "quantize_step", quantize( nltohd( param.dist_quantize_step ) ) );
+    put_param( M_buffer, "quantize_step_l", quantize( nltohd( param.landmark_dist_quantize_step ), 0.0001 ) );
+    //put_param( M_buffer, "quantize_step_dir", quantize( nltohd( param.dir_quantize_step ) ) );
+    //put_param( M_buffer, "quantize_step_dist_team_l", quantize( nltohd( param.dist_quantize_step_l ) ) );
+    //put_param( M_buffer, "quantize_step_dist_team_r", quantize( nltohd( param.dist_quantize_step_r ) ) );
+    //put_param( M_buffer, "quantize_step_dist_l_team_l", quantize( nltohd( param.landmark_dist_quantize_step_l ) ) );
+    //put_param( M_buffer, "quantize_step_dist_l_team_r", quantize( nltohd( param.landmark_dist_quantize_step_r ) ) );
+    //put_param( M_buffer, "quantize_step_dir_team_l", quantize( nltohd( param.dir_quantize_step_l ) ) );
+    //put_param( M_buffer, "quantize_step_dir_team_r", quantize( nltohd( param.dir_quantize_step_r ) ) );
+    put_param( M_buffer, "coach", nstohi( param.coach_mode ) );
+    put_param( M_buffer, "coach_w_referee", nstohi( param.coach_with_referee_mode ) );
+    put_param( M_buffer, "old_coach_hear", nstohi( param.use_old_coach_hear ) );
+    put_param( M_buffer, "send_vi_step", nstohi( param.online_coach_look_step ) );
+    put_param( M_buffer, "slowness_on_top_for_left_team", quantize( nltohd( param.slowness_on_top_for_left_team ) ) );
+    put_param( M_buffer, "slowness_on_top_for_right_team", quantize( nltohd( param.slowness_on_top_for_right_team ) ) );
+    put_param( M_buffer, "keepaway_length", quantize( nltohd( param.ka_length ) ) );
+    put_param( M_buffer, "keepaway_width", quantize( nltohd( param.ka_width ) ) );
 
     tmp = quantize( nltohd( param.ball_stuck_area ) );
-    if ( std::fabs( tmp ) < 100.0 ) os << "(ball_stuck_area " << tmp << ')';
+    if ( std::fabs( tmp ) < 100.0 ) put_param( M_buffer, "ball_stuck_area", tmp );
     tmp = quantize( nltohd( param.max_tackle_power ) );
-    if ( 0.0 <= tmp && tmp < 200.0 ) os << "(max_tackle_power " << tmp << ')';
+    if ( 0.0 <= tmp && tmp < 200.0 ) put_param( M_buffer, "max_tackle_power", tmp );
     tmp = quantize( nltohd( param.max_back_tackle_power ) );
-    if ( 0.0 <= tmp && tmp < 200.0 ) os << "(max_back_tackle_power " << tmp << ')';
+    if ( 0.0 <= tmp && tmp < 200.0 ) put_param( M_buffer, "max_back_tackle_power", tmp );
     tmp = quantize( nltohd( param.tackle_dist ) );
-    if ( 0.0 <= tmp && tmp < 100.0 ) os << "(tackle_dist " << tmp << ')';
+    if ( 0.0 <= tmp && tmp < 100.0 ) put_param( M_buffer, "tackle_dist", tmp );
     tmp = quantize( nltohd( param.tackle_back_dist ) );
-    if ( 0.0 <= tmp && tmp < 100.0 ) os << "(tackle_back_dist " << tmp << ')';
+    if ( 0.0 <= tmp && tmp < 100.0 ) put_param( M_buffer, "tackle_back_dist", tmp );
     tmp = quantize( nltohd( param.tackle_width ) );
-    if ( 0.0 <= tmp && tmp < 100.0 ) os << "(tackle_width " << tmp << ')';
-
-    os << "(start_goal_l " << nstohi( param.start_goal_l ) << ')'
-       << "(start_goal_r " << nstohi( param.start_goal_r ) << ')'
-       << "(fullstate_l " << nstohi( param.fullstate_l ) << ')'
-       << "(fullstate_r " << nstohi( param.fullstate_r ) << ')'
-       << "(drop_ball_time " << nstohi( param.drop_ball_time ) << ')'
-       << "(synch_mode " << nstohi( param.synch_mode ) << ')'
-       << "(synch_offset " << nstohi( param.synch_offset ) << ')'
-       << "(synch_micro_sleep " << nstohi( param.synch_micro_sleep ) << ')'
-       << "(point_to_ban " << nstohi( param.point_to_ban ) << ')'
-       << "(point_to_duration " << nstohi( param.point_to_duration ) << ')'
-       << ")\n";
-    return os;
+    if ( 0.0 <= tmp && tmp < 100.0 ) put_param( M_buffer, "tackle_width", tmp );
+
+    put_param( M_buffer, "start_goal_l", nstohi( param.start_goal_l ) );
+    put_param( M_buffer, "start_goal_r", nstohi( param.start_goal_r ) );
+    put_param( M_buffer, "fullstate_l", nstohi( param.fullstate_l ) );
+    put_param( M_buffer, "fullstate_r", nstohi( param.fullstate_r ) );
+    put_param( M_buffer, "drop_ball_time", nstohi( param.drop_ball_time ) );
+    put_param( M_buffer, "synch_mode", nstohi( param.synch_mode ) );
+    put_param( M_buffer, "synch_offset", nstohi( param.synch_offset ) );
+    put_param( M_buffer, "synch_micro_sleep", nstohi( param.synch_micro_sleep ) );
+    put_param( M_buffer, "point_to_ban", nstohi( param.point_to_ban ) );
+    put_param( M_buffer, "point_to_duration", nstohi( param.point_to_duration ) );
+    M_buffer.put( ")\n" );
+
+    return M_buffer.flush( os );
 }
 
 /*-------------------------------------------------------------------*/
@@ -230,33 +259,35 @@ std::ostream &
 SerializerV4::serialize( std::ostream & os,
                          const player_params_t & pparam )
 {
-    os << "(player_param "
-       << "(player_types " << nstohi( pparam.player_types ) << ')'
-       << "(subs_max " << nstohi( pparam.substitute_max ) << ')'
-       << "(pt_max " << nstohi( pparam.pt_max ) << ')'
-       << "(player_speed_max_delta_min " << quantize( nltohd( pparam.player_speed_max_delta_min ) ) << ')'
-       << "(player_speed_max_delta_max " << quantize( nltohd( pparam.player_speed_max_delta_max ) ) << ')'
-       << "(stamina_inc_max_delta_factor " << quantize( nltohd( pparam.stamina_inc_max_delta_factor ) ) << ')'
-       << "(player_decay_delta_min " << quantize( nltohd( pparam.player_decay_delta_min ) ) << ')'
-       << "(player_decay_delta_max " << quantize( nltohd( pparam.player_decay_delta_max ) ) << ')'
-       << "(inertia_moment_delta_factor " << quantize( nltohd( pparam.inertia_moment_delta_factor ) ) << ')'
-       << "(dash_power_rate_delta_min " << quantize( nltohd( pparam.dash_power_rate_delta_min ) ) << ')'
-       << "(dash_power_rate_delta_max " << quantize( nltohd( pparam.dash_power_rate_delta_max ) ) << ')'
-       << "(player_size_delta_factor " << quantize( nltohd( pparam.player_size_delta_factor ) ) << ')'
-       << "(kickable_margin_delta_min " << quantize( nltohd( pparam.kickable_margin_delta_min ) ) << ')'
-       << "(kickable_margin_delta_max " << quantize( nltohd( pparam.kickable_margin_delta_max ) ) << ')'
-       << "(kick_rand_delta_factor " << quantize( nltohd( pparam.kick_rand_delta_factor ) ) << ')'
-       << "(extra_stamina_delta_min " << quantize( nltohd( pparam.extra_stamina_delta_min ) ) << ')'
-       << "(extra_stamina_delta_max " << quantize( nltohd( pparam.extra_stamina_delta_max ) ) << ')'
-       << "(effort_max_delta_factor " << quantize( nltohd( pparam.effort_max_delta_factor ) ) << ')'
-       << "(effort_min_delta_factor " << quantize( nltohd( pparam.effort_min_delta_factor ) ) << ')'
-       << "(random_seed " << static_cast< Int32 >( ntohl( pparam.random_seed ) ) << ')'
-       << "(new_dash_power_rate_delta_min " << quantize( nltohd( pparam.new_dash_power_rate_delta_min ) ) << ')'
-       << "(new_dash_power_rate_delta_max " << quantize( nltohd( pparam.new_dash_power_rate_delta_max ) ) << ')'
-       << "(new_stamina_inc_max_delta_factor " << quantize( nltohd( pparam.new_stamina_inc_max_delta_factor ) ) << ')'
-       << "(allow_mult_default_type " << static_cast< bool >( nstohi( pparam.allow_mult_default_type ) ) << ')'
-       << ")\n";
-    return os;
+    M_buffer.clear();
+    M_buffer.put( "(player_param " );
+    put_param( M_buffer, "player_types", nstohi( pparam.player_types ) );
+    put_param( M_buffer, "subs_max", nstohi( pparam.substitute_max ) );
+    put_param( M_buffer, "pt_max", nstohi( pparam.pt_max ) );
+    put_param( M_buffer, "player_speed_max_delta_min", quantize( nltohd( pparam.player_speed_max_delta_min ) ) );
+    put_param( M_buffer, "player_speed_max_delta_max", quantize( nltohd( pparam.player_speed_max_delta_max ) ) );
+    put_param( M_buffer, "stamina_inc_max_delta_factor", quantize( nltohd( pparam.stamina_inc_max_delta_factor ) ) );
+    put_param( M_buffer, "player_decay_delta_min", quantize( nltohd( pparam.player_decay_delta_min ) ) );
+    put_param( M_buffer, "player_decay_delta_max", quantize( nltohd( pparam.player_decay_delta_max ) ) );
+    put_param( M_buffer, "inertia_moment_delta_factor", quantize( nltohd( pparam.inertia_moment_delta_factor ) ) );
+    put_param( M_buffer, "dash_power_rate_delta_min", quantize( nltohd( pparam.dash_power_rate_delta_min ) ) );
+    put_param( M_buffer, "dash_power_rate_delta_max", quantize( nltohd( pparam.dash_power_rate_delta_max ) ) );
+    put_param( M_buffer, "player_size_delta_factor", quantize( nltohd( pparam.player_size_delta_factor ) ) );
+    put_param( M_buffer, "kickable_margin_delta_min", quantize( nltohd( pparam.kickable_margin_delta_min ) ) );
+    put_param( M_buffer, "kickable_margin_delta_max", quantize( nltohd( pparam.kickable_margin_delta_max ) ) );
+    put_param( M_buffer, "kick_rand_delta_factor", quantize( nltohd( pparam.kick_rand_delta_factor ) ) );
+    put_param( M_buffer, "extra_stamina_delta_min", quantize( nltohd( pparam.extra_stamina_delta_min ) ) );
+    put_param( M_buffer, "extra_stamina_delta_max", quantize( nltohd( pparam.extra_stamina_delta_max ) ) );
+    put_param( M_buffer, "effort_max_delta_factor", quantize( nltohd( pparam.effort_max_delta_factor ) ) );
+    put_param( M_buffer, "effort_min_delta_factor", quantize( nltohd( pparam.effort_min_delta_factor ) ) );
+    put_param( M_buffer, "random_seed", static_cast< Int32 >( ntohl( pparam.random_seed ) ) );
+    put_param( M_buffer, "new_dash_power_rate_delta_min", quantize( nltohd( pparam.new_dash_power_rate_delta_min ) ) );
+    put_param( M_buffer, "new_dash_power_rate_delta_max", quantize( nltohd( pparam.new_dash_power_rate_delta_max ) ) );
+    put_param( M_buffer, "new_stamina_inc_max_delta_factor", quantize( nltohd( pparam.new_stamina_inc_max_delta_factor ) ) );
+    put_param( M_buffer, "allow_mult_default_type", ( nstohi( pparam.allow_mult_default_type ) != 0 ? 1 : 0 ) );
+    M_buffer.put( ")\n" );
+
+    return M_buffer.flush( os );
 }
 
 /*-------------------------------------------------------------------*/
@@ -267,21 +298,23 @@ std::ostream &
 SerializerV4::serialize( std::ostream & os,
                          const player_type_t & type )
 {
-    os << "(player_type "
-       << "(id " << nstohi( type.id ) << ')'
-       << "(player_speed_max " << quantize( nltohd( type.player_speed_max ) ) << ')'
-       << "(stamina_inc_max " << quantize( nltohd( type.stamina_inc_max ) ) << ')'
-       << "(player_decay " << quantize( nltohd( type.player_decay ) ) << ')'
-       << "(inertia_moment " << quantize( nltohd( type.inertia_moment ) ) << ')'
-       << "(dash_power_rate " << quantize( nltohd( type.dash_power_rate ) ) << ')'
-       << "(player_size " << quantize( nltohd( type.player_size ) ) << ')'
-       << "(kickable_margin " << quantize( nltohd( type.kickable_margin ) ) << ')'
-       << "(kick_rand " << quantize( nltohd( type.kick_rand ) ) << ')'
-       << "(extra_stamina " << quantize( nltohd( type.extra_stamina ) ) << ')'
-       << "(effort_max " << quantize( nltohd( type.effort_max ) ) << ')'
-       << "(effort_min " << quantize( nltohd( type.effort_min ) ) << ')'
-       << ")\n";
-    return os;
+    M_buffer.clear();
+    M_buffer.put( "(player_type " );
+    put_param( M_buffer, "id", nstohi( type.id ) );
+    put_param( M_buffer, "player_speed_max", quantize( nltohd( type.player_speed_max ) ) );
+    put_param( M_buffer, "stamina_inc_max", quantize( nltohd( type.stamina_inc_max ) ) );
+    put_param( M_buffer, "player_decay", quantize( nltohd( type.player_decay ) ) );
+    put_param( M_buffer, "inertia_moment", quantize( nltohd( type.inertia_moment ) ) );
+    put_param( M_buffer, "dash_power_rate", quantize( nltohd( type.dash_power_rate ) ) );
+    put_param( M_buffer, "player_size", quantize( nltohd( type.player_size ) ) );
+    put_param( M_buffer, "kickable_margin", quantize( nltohd( type.kickable_margin ) ) );
+    put_param( M_buffer, "kick_rand", quantize( nltohd( type.kick_rand ) ) );
+    put_param( M_buffer, "extra_stamina", quantize( nltohd( type.extra_stamina ) ) );
+    put_param( M_buffer, "effort_max", quantize( nltohd( type.effort_max ) ) );
+    put_param( M_buffer, "effort_min", quantize( nltohd( type.effort_min ) ) );
+    M_buffer.put( ")\n" );
+
+    return M_buffer.flush( os );
 }
 
 /*-------------------------------------------------------------------*/
@@ -408,9 +441,12 @@ std::ostream &
 SerializerV4::serialize( std::ostream & os,
                          const msginfo_t & msg )
 {
-    os << "(msg " << M_time << ' ' << ntohs( msg.board )
-       << " \"" << msg.message << "\")\n";
-    return os;
+    M_buffer.clear();
+    M_buffer.put( "(msg " ).putInt( M_time )
+        .put( ' ' ).putInt( ntohs( msg.board ) )
+        .put( " \"", 2 ).put( msg.message ).put( "\")\n", 3 );
+
+    return M_buffer.flush( os );
 }
 
 /*-------------------------------------------------------------------*/
@@ -422,10 +458,12 @@ SerializerV4::serialize( std::ostream & os,
                          const Int16 board,
                          const std::string & msg )
 {
-    os << "(msg " << M_time << ' ' << ntohs( board )
-       << " \"" << msg << "\")\n";
+    M_buffer.clear();
+    M_buffer.put( "(msg " ).putInt( M_time )
+        .put( ' ' ).putInt( ntohs( board ) )
+        .put( " \"", 2 ).put( msg ).put( "\")\n", 3 );
 
-    return os;
+    return M_buffer.flush( os );
 }
 
 /*-------------------------------------------------------------------*/
@@ -458,9 +496,11 @@ SerializerV4::serialize( std::ostream & os,
         return os;
     }
 
-    os << "(playmode " << M_time << ' ' << playmode_strings[pm] << ")\n";
+    M_buffer.clear();
+    M_buffer.put( "(playmode " ).putInt( M_time )
+        .put( ' ' ).put( playmode_strings[pm] ).put( ")\n", 2 );
 
-    return os;
+    return M_buffer.flush( os );
 }
 
 /*-------------------------------------------------------------------*/
@@ -490,19 +530,20 @@ SerializerV4::serialize( std::ostream & os,
     M_teams[0] = team_l;
     M_teams[1] = team_r;
 
-    os << "(team " << M_time
-       << ' ' << ( team_l.name_.empty() ? "null" : team_l.name_.c_str() )
-       << ' ' << ( team_r.name_.empty() ? "null" : team_r.name_.c_str() )
-       << ' ' << team_l.score_
-       << ' ' << team_r.score_;
+    M_buffer.clear();
+    M_buffer.put( "(team " ).putInt( M_time )
+        .put( ' ' ).put( team_l.name_.empty() ? "null" : team_l.name_.c_str() )
+        .put( ' ' ).put( team_r.name_.empty() ? "null" : team_r.name_.c_str() )
+        .put( ' ' ).putInt( team_l.score_ )
+        .put( ' ' ).putInt( team_r.score_ );
     if ( team_l.penaltyTrial() > 0 || team_r.penaltyTrial() > 0 )
     {
-        os << ' ' << team_l.pen_score_ << ' ' << team_l.pen_miss_
-           << ' ' << team_r.pen_score_ << ' ' << team_r.pen_miss_;
+        M_buffer.put( ' ' ).putInt( team_l.pen_score_ ).put( ' ' ).putInt( team_l.pen_miss_ )
+            .put( ' ' ).putInt( team_r.pen_score_ ).put( ' ' ).putInt( team_r.pen_miss_ );
     }
-    os << ")\n";
+    M_buffer.put( ")\n", 2 );
 
-    return os;
+    return M_buffer.flush( os );
 }
 
 /*-------------------------------------------------------------------*/
@@ -515,21 +556,22 @@ SerializerV4::serialize( std::ostream & os,
 {
     M_time = show.time_;
 
-    os << "(show " << show.time_;
+    M_buffer.clear();
+    M_buffer.put( "(show " ).putInt( show.time_ );
 
     // ball
 
-    os << " ((b)"
-       << ' ' << show.ball_.x_ << ' ' << show.ball_.y_;
+    M_buffer.put( " ((b)" )
+        .put( ' ' ).putFloat( show.ball_.x_ ).put( ' ' ).putFloat( show.ball_.y_ );
     if ( show.ball_.hasVelocity() )
     {
-        os << ' ' << show.ball_.vx_ << ' ' << show.ball_.vy_;
+        M_buffer.put( ' ' ).putFloat( show.ball_.vx_ ).put( ' ' ).putFloat( show.ball_.vy_ );
     }
     else
     {
-        os << " 0 0";
+        M_buffer.put( " 0 0", 4 );
     }
-    os << ')';
+    M_buffer.put( ')' );
 
     // players
 
@@ -537,74 +579,73 @@ SerializerV4::serialize( std::ostream & os,
     {
         const PlayerT & p = show.player_[i];
 
-        os << " ((" << p.side_ << ' ' << p.unum_ << ')';
-        os << ' ' << p.type_;
-        os << ' ' << std::hex << std::showbase
-           << p.state_
-           << std::dec << std::noshowbase;
+        M_buffer.put( " ((", 3 ).put( p.side_ ).put( ' ' ).putInt( p.unum_ ).put( ')' );
+        M_buffer.put( ' ' ).putInt( p.type_ );
+        M_buffer.put( ' ' ).putHex( static_cast< boost::uint32_t >( p.state_ ) );
 
-        os << ' ' << p.x_ << ' ' << p.y_;
+        M_buffer.put( ' ' ).putFloat( p.x_ ).put( ' ' ).putFloat( p.y_ );
         if ( p.hasVelocity() )
         {
-            os << ' ' << p.vx_ << ' ' << p.vy_;
+            M_buffer.put( ' ' ).putFloat( p.vx_ ).put( ' ' ).putFloat( p.vy_ );
         }
         else
         {
-            os << " 0 0";
+            M_buffer.put( " 0 0", 4 );
         }
-        os << ' ' << p.body_
-           << ' ' << ( p.hasNeck() ? p.neck_ : 0.0f );
+        M_buffer.put( ' ' ).putFloat( p.body_ )
+            .put( ' ' ).putFloat( p.hasNeck() ? p.neck_ : 0.0f );
 
         if ( p.isPointing() )
         {
-            os << ' ' << p.point_x_ << ' ' << p.point_y_;
+            M_buffer.put( ' ' ).putFloat( p.point_x_ ).put( ' ' ).putFloat( p.point_y_ );
         }
 
         if ( p.hasView() )
         {
-            os << " (v " << p.view_quality_ << ' ' << p.view_width_ << ')';
+            M_buffer.put( " (v ", 4 ).put( p.view_quality_ )
+                .put( ' ' ).putFloat( p.view_width_ ).put( ')' );
         }
         else
         {
-            os << " (v h 90)";
+            M_buffer.put( " (v h 90)" );
         }
 
         if ( p.hasStamina() )
         {
-            os << " (s " << p.stamina_
-               << ' ' << p.effort_
-               << ' ' << p.recovery_
-               << ')';
+            M_buffer.put( " (s ", 4 ).putFloat( p.stamina_ )
+                .put( ' ' ).putFloat( p.effort_ )
+                .put( ' ' ).putFloat( p.recovery_ )
+                .put( ')' );
         }
         else
         {
-            os << " (s 4000 1 1)";
+            M_buffer.put( " (s 4000 1 1)" );
         }
 
         if ( p.focus_side_ != 'n' )
         {
-            os << " (f" << p.focus_side_ << ' ' << p.focus_unum_ << ')';
+            M_buffer.put( " (f", 3 ).put( p.focus_side_ ).put( ' ' ).putInt( p.focus_unum_ ).put( ')' );
         }
 
-        os << " (c"
-           << ' ' << p.kick_count_
-           << ' ' << p.dash_count_
-           << ' ' << p.turn_count_
-           << ' ' << p.catch_count_
-           << ' ' << p.move_count_
-           << ' ' << p.turn_neck_count_
-           << ' ' << p.change_view_count_
-           << ' ' << p.say_count_
-           << ' ' << p.tackle_count_
-           << ' ' << p.pointto_count_
-           << ' ' << p.attentionto_count_
-           << ')';
-        os << ')';
+        M_buffer.put( " (c", 3 )
+            .put( ' ' ).putInt( p.kick_count_ )
+            .put( ' ' ).putInt( p.dash_count_ )
+            .put( ' ' ).putInt( p.turn_count_ )
+            .put( ' ' ).putInt( p.catch_count_ )
+            .put( ' ' ).putInt( p.move_count_ )
+            .put( ' ' ).putInt( p.turn_neck_count_ )
+            .put( ' ' ).putInt( p.change_view_count_ )
+            .put( ' ' ).putInt( p.say_count_ )
+            .put( ' ' ).putInt( p.tackle_count_ )
+            .put( ' ' ).putInt( p.pointto_count_ )
+            .put( ' ' ).putInt( p.attentionto_count_ )
+            .put( ')' );
+        M_buffer.put( ')' );
     }
 
-    os << ")\n";
+    M_buffer.put( ")\n", 2 );
 
-    return os;
+    return M_buffer.flush( os );
 }
 
 /*-------------------------------------------------------------------*/
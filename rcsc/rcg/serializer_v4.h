@@ -33,6 +33,7 @@
 #define RCSC_RCG_SERIALIZER_V4_H
 
 #include <rcsc/rcg/serializer.h>
+#include <rcsc/rcg/text_buffer.h>
 
 namespace rcsc {
 namespace rcg {
@@ -47,13 +48,17 @@ protected:
 
     Int32 M_time; //!< temporal time holder
 
+    //! reusable buffer. each text line is formatted into it and written by one write() call.
+    TextBuffer M_buffer;
+
 public:
 
     /*!
       \brief constructor
     */
     SerializerV4()
-        : M_time( 0 )
+        : M_time( 0 ),
+          M_buffer()
       { }
 
     /*!
@@ -81,21 +81,22 @@ SerializerV5::serialize( std::ostream & os,
 {
     M_time = show.time_;
 
-    os << "(show " << show.time_;
+    M_buffer.clear();
+    M_buffer.put( "(show " ).putInt( show.time_ );
 
     // ball
 
-    os << " ((b)"
-       << ' ' << show.ball_.x_ << ' ' << show.ball_.y_;
+    M_buffer.put( " ((b)" )
+        .put( ' ' ).putFloat( show.ball_.x_ ).put( ' ' ).putFloat( show.ball_.y_ );
     if ( show.ball_.hasVelocity() )
     {
-        os << ' ' << show.ball_.vx_ << ' ' << show.ball_.vy_;
+        M_buffer.put( ' ' ).putFloat( show.ball_.vx_ ).put( ' ' ).putFloat( show.ball_.vy_ );
     }
     else
     {
-        os << " 0 0";
+        M_buffer.put( " 0 0", 4 );
     }
-    os << ')';
+    M_buffer.put( ')' );
 
     // players
 
@@ -103,75 +104,74 @@ SerializerV5::serialize( std::ostream & os,
     {
         const PlayerT & p = show.player_[i];
 
-        os << " ((" << p.side_ << ' ' << p.unum_ << ')';
-        os << ' ' << p.type_;
-        os << ' ' << std::hex << std::showbase
-           << p.state_
-           << std::dec << std::noshowbase;
+        M_buffer.put( " ((", 3 ).put( p.side_ ).put( ' ' ).putInt( p.unum_ ).put( ')' );
+        M_buffer.put( ' ' ).putInt( p.type_ );
+        M_buffer.put( ' ' ).putHex( static_cast< boost::uint32_t >( p.state_ ) );
 
-        os << ' ' << p.x_ << ' ' << p.y_;
+        M_buffer.put( ' ' ).putFloat( p.x_ ).put( ' ' ).putFloat( p.y_ );
         if ( p.hasVelocity() )
         {
-            os << ' ' << p.vx_ << ' ' << p.vy_;
+            M_buffer.put( ' ' ).putFloat( p.vx_ ).put( ' ' ).putFloat( p.vy_ );
         }
         else
         {
-            os << " 0 0";
+            M_buffer.put( " 0 0", 4 );
         }
-        os << ' ' << p.body_
-           << ' ' << ( p.hasNeck() ? p.neck_ : 0.0f );
+        M_buffer.put( ' ' ).putFloat( p.body_ )
+            .put( ' ' ).putFloat( p.hasNeck() ? p.neck_ : 0.0f );
 
         if ( p.isPointing() )
         {
-            os << ' ' << p.point_x_ << ' ' << p.point_y_;
+            M_buffer.put( ' ' ).putFloat( p.point_x_ ).put( ' ' ).putFloat( p.point_y_ );
         }
 
         if ( p.hasView() )
         {
-            os << " (v " << p.view_quality_ << ' ' << p.view_width_ << ')';
+            M_buffer.put( " (v ", 4 ).put( p.view_quality_ )
+                .put( ' ' ).putFloat( p.view_width_ ).put( ')' );
         }
         else
         {
-            os << " (v h 90)";
+            M_buffer.put( " (v h 90)" );
         }
 
         if ( p.hasStamina() )
         {
-            os << " (s " << p.stamina_
-               << ' ' << p.effort_
-               << ' ' << p.recovery_
-               << ' ' << p.stamina_capacity_
-               << ')';
+            M_buffer.put( " (s ", 4 ).putFloat( p.stamina_ )
+                .put( ' ' ).putFloat( p.effort_ )
+                .put( ' ' ).putFloat( p.recovery_ )
+                .put( ' ' ).putFloat( p.stamina_capacity_ )
+                .put( ')' );
         }
         else
         {
-            os << " (s 4000 1 1 -1)";
+            M_buffer.put( " (s 4000 1 1 -1)" );
         }
 
         if ( p.focus_side_ != 'n' )
         {
-            os << " (f" << p.focus_side_ << ' ' << p.focus_unum_ << ')';
+            M_buffer.put( " (f", 3 ).put( p.focus_side_ ).put( ' ' ).putInt( p.focus_unum_ ).put( ')' );
         }
 
-        os << " (c"
-           << ' ' << p.kick_count_
-           << ' ' << p.dash_count_
-           << ' ' << p.turn_count_
-           << ' ' << p.catch_count_
-           << ' ' << p.move_count_
-           << ' ' << p.turn_neck_count_
-           << ' ' << p.change_view_count_
-           << ' ' << p.say_count_
-           << ' ' << p.tackle_count_
-           << ' ' << p.pointto_count_
-           << ' ' << p.attentionto_count_
-           << ')';
-        os << ')';
+        M_buffer.put( " (c", 3 )
+            .put( ' ' ).putInt( p.kick_count_ )
+            .put( ' ' ).putInt( p.dash_count_ )
+            .put( ' ' ).putInt( p.turn_count_ )
+            .put( ' ' ).putInt( p.catch_count_ )
+            .put( ' ' ).putInt( p.move_count_ )
+            .put( ' ' ).putInt( p.turn_neck_count_ )
+            .put( ' ' ).putInt( p.change_view_count_ )
+            .put( ' ' ).putInt( p.say_count_ )
+            .put( ' ' ).putInt( p.tackle_count_ )
+            .put( ' ' ).putInt( p.pointto_count_ )
+            .put( ' ' ).putInt( p.attentionto_count_ )
+            .put( ')' );
+        M_buffer.put( ')' );
     }
 
-    os << ")\n";
+    M_buffer.put( ")\n", 2 );
 
-    return os;
+    return M_buffer.flush( os );
 }
 
 
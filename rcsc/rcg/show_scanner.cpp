@@ -0,0 +1,337 @@
+// -*-c++-*-
+
+/*!
+  \file show_scanner.cpp
+  \brief in-place scanner for rcg text lines Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "show_scanner.h"
+
+#include <boost/cstdint.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <cfloat>
+
+namespace {
+
+//! exact powers of 10 in double
+const double POW10[] = {
+    1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7,
+    1.0e8, 1.0e9, 1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14, 1.0e15,
+};
+
+//! max number of digits that is always exact in double
+const int MAX_FLOAT_DIGITS = 15;
+
+//! max number of digits that never overflows the 32 bits long
+const int MAX_DEC_DIGITS = 9;
+const int MAX_HEX_DIGITS = 7;
+
+//! buffer size for the standard functions
+const int TOKEN_SIZE = 64;
+
+inline
+bool
+is_space( const char c )
+{
+    return ( c == ' ' || c == '\t' || c == '\n'
+             || c == '\v' || c == '\f' || c == '\r' );
+}
+
+inline
+bool
+is_alpha( const char c )
+{
+    return ( ( 'a' <= c && c <= 'z' )
+             || ( 'A' <= c && c <= 'Z' ) );
+}
+
+inline
+int
+digit_value( const char c,
+             const int base )
+{
+    if ( '0' <= c && c <= '9' ) return c - '0';
+    if ( base == 16 )
+    {
+        if ( 'a' <= c && c <= 'f' ) return c - 'a' + 10;
+        if ( 'A' <= c && c <= 'F' ) return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the double value can be rounded to float without the double rounding error.
+  \param value correctly rounded double value
+  \return true if static_cast< float >( value ) is same as the correctly rounded float.
+*/
+bool
+is_safe_float( const double & value )
+{
+    if ( value == 0.0 )
+    {
+        return true;
+    }
+
+    const double abs_value = ( value < 0.0 ? -value : value );
+    if ( abs_value < FLT_MIN
+         || FLT_MAX < abs_value )
+    {
+        return false;
+    }
+
+    // the double rounding may differ from the direct rounding only if
+    // the double value is just on the middle of two float values,
+    // i.e. the lower 29 bits of the significand are 1000...0.
+    boost::uint64_t bits = 0;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+
+    return ( bits & 0x1FFFFFFFu ) != 0x10000000u;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief copy the token to the null terminated buffer for the standard functions.
+  \param first token position
+  \param end end of the range
+  \param buf destination buffer. the size must be TOKEN_SIZE.
+  \return copied length
+*/
+int
+copy_token( const char * first,
+            const char * end,
+            char * buf )
+{
+    int len = 0;
+    const char * p = first;
+
+    while ( p < end && len < TOKEN_SIZE - 1 && is_space( *p ) )
+    {
+        buf[len++] = *p++;
+    }
+
+    while ( p < end && len < TOKEN_SIZE - 1
+            && ( ( '0' <= *p && *p <= '9' )
+                 || is_alpha( *p )
+                 || *p == '.' || *p == '+' || *p == '-' ) )
+    {
+        buf[len++] = *p++;
+    }
+
+    buf[len] = '\0';
+    return len;
+}
+
+}
+
+namespace rcsc {
+namespace rcg {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ShowScanner::startsWith( const char * str ) const
+{
+    const char * p = M_pos;
+    while ( *str != '\0' )
+    {
+        if ( p >= M_end || *p != *str )
+        {
+            return false;
+        }
+        ++p;
+        ++str;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+long
+ShowScanner::readLong( const int base )
+{
+    const char * p = M_pos;
+
+    while ( p < M_end && is_space( *p ) ) ++p;
+
+    bool negative = false;
+    if ( p < M_end
+         && ( *p == '-' || *p == '+' ) )
+    {
+        negative = ( *p == '-' );
+        ++p;
+    }
+
+    // "0x" prefix is skipped only if a hex digit follows, same as strtol.
+    if ( base == 16
+         && p + 2 < M_end
+         && p[0] == '0'
+         && ( p[1] == 'x' || p[1] == 'X' )
+         && digit_value( p[2], 16 ) >= 0 )
+    {
+        p += 2;
+    }
+
+    const char * first = p;
+    long value = 0;
+    int d = 0;
+    while ( p < M_end
+            && ( d = digit_value( *p, base ) ) >= 0 )
+    {
+        value = value * base + d;
+        ++p;
+    }
+
+    if ( p == first )
+    {
+        // no digit
+        return 0;
+    }
+
+    if ( p - first > ( base == 16 ? MAX_HEX_DIGITS : MAX_DEC_DIGITS ) )
+    {
+        return readLongSlow( base );
+    }
+
+    M_pos = p;
+    return ( negative ? -value : value );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+long
+ShowScanner::readLongSlow( const int base )
+{
+    char buf[TOKEN_SIZE];
+    copy_token( M_pos, M_end, buf );
+
+    char * next = buf;
+    long value = std::strtol( buf, &next, base );
+    M_pos += ( next - buf );
+    return value;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+float
+ShowScanner::readFloat()
+{
+    const char * p = M_pos;
+
+    while ( p < M_end && is_space( *p ) ) ++p;
+
+    bool negative = false;
+    if ( p < M_end
+         && ( *p == '-' || *p == '+' ) )
+    {
+        negative = ( *p == '-' );
+        ++p;
+    }
+
+    double mantissa = 0.0;
+    int n_digits = 0;
+    int n_fraction = 0;
+
+    while ( p < M_end
+            && '0' <= *p && *p <= '9' )
+    {
+        mantissa = mantissa * 10.0 + ( *p - '0' );
+        ++n_digits;
+        ++p;
+    }
+
+    if ( p < M_end
+         && *p == '.' )
+    {
+        ++p;
+        while ( p < M_end
+                && '0' <= *p && *p <= '9' )
+        {
+            mantissa = mantissa * 10.0 + ( *p - '0' );
+            ++n_digits;
+            ++n_fraction;
+            ++p;
+        }
+    }
+
+    if ( n_digits == 0
+         || n_digits > MAX_FLOAT_DIGITS
+         || ( p < M_end && is_alpha( *p ) ) )
+    {
+        // no number, too long number, exponent, hex, inf or nan
+        return readFloatSlow();
+    }
+
+    // both operands are exact, so the quotient is correctly rounded.
+    double value = mantissa / POW10[n_fraction];
+    if ( negative )
+    {
+        value = -value;
+    }
+
+    if ( ! is_safe_float( value ) )
+    {
+        return readFloatSlow();
+    }
+
+    M_pos = p;
+    return static_cast< float >( value );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+float
+ShowScanner::readFloatSlow()
+{
+    char buf[TOKEN_SIZE];
+    copy_token( M_pos, M_end, buf );
+
+    char * next = buf;
+    float value = strtof( buf, &next );
+    M_pos += ( next - buf );
+    return value;
+}
+
+}
+}
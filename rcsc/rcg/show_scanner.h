@@ -0,0 +1,187 @@
+// -*-c++-*-
+
+/*!
+  \file show_scanner.h
+  \brief in-place scanner for rcg text lines Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_SHOW_SCANNER_H
+#define RCSC_RCG_SHOW_SCANNER_H
+
+#include <string>
+
+namespace rcsc {
+namespace rcg {
+
+/*!
+  \class ShowScanner
+  \brief cursor over the character range of one rcg text line.
+
+  The scanner reads the range in place, without copying the string or
+  interpreting the format string. It never reads beyond the end of the
+  range, so the range need not be null terminated.
+
+  readLong() and readFloat() return the same values as std::strtol() and
+  std::strtof() in the "C" locale, and the cursor moves to the same place.
+  The usual decimal numbers in the rcg files are converted by the own code.
+  Other forms, e.g. exponents, too many digits or the rounding ties that
+  depend on the double rounding, are passed to the standard functions.
+*/
+class ShowScanner {
+private:
+
+    const char * M_pos; //!< current position
+    const char * M_end; //!< end of the range
+
+public:
+
+    /*!
+      \brief create the scanner for the character range.
+      \param begin first character
+      \param end position after the last character
+     */
+    ShowScanner( const char * begin,
+                 const char * end )
+        : M_pos( begin ),
+          M_end( end )
+      { }
+
+    /*!
+      \brief create the scanner for the whole string.
+      \param line string that must live longer than the scanner.
+     */
+    explicit
+    ShowScanner( const std::string & line )
+        : M_pos( line.data() ),
+          M_end( line.data() + line.size() )
+      { }
+
+    /*!
+      \brief get the current position.
+      \return pointer to the current character.
+     */
+    const char * pos() const
+      {
+          return M_pos;
+      }
+
+    /*!
+      \brief check if all characters are consumed.
+      \return true if the cursor is at the end.
+     */
+    bool atEnd() const
+      {
+          return M_pos >= M_end;
+      }
+
+    /*!
+      \brief get the character at the offset from the cursor.
+      \param offset offset from the current position
+      \return character value. '\\0' if out of range.
+     */
+    char peek( const int offset = 0 ) const
+      {
+          return ( M_pos + offset < M_end ? M_pos[offset] : '\0' );
+      }
+
+    /*!
+      \brief get the current character and move the cursor.
+      \return character value. '\\0' if at the end.
+     */
+    char get()
+      {
+          return ( M_pos < M_end ? *M_pos++ : '\0' );
+      }
+
+    /*!
+      \brief move the cursor. the cursor never goes beyond the end.
+      \param n the number of characters
+     */
+    void advance( const int n = 1 )
+      {
+          M_pos = ( n < M_end - M_pos ? M_pos + n : M_end );
+      }
+
+    /*!
+      \brief skip the successive characters equal to c.
+      \param c skipped character
+     */
+    void skip( const char c )
+      {
+          while ( M_pos < M_end && *M_pos == c ) ++M_pos;
+      }
+
+    /*!
+      \brief skip the characters until c is found.
+      \param c stop character
+     */
+    void skipUntil( const char c )
+      {
+          while ( M_pos < M_end && *M_pos != c ) ++M_pos;
+      }
+
+    /*!
+      \brief skip the characters until c1 or c2 is found.
+      \param c1 stop character
+      \param c2 stop character
+     */
+    void skipUntil( const char c1,
+                    const char c2 )
+      {
+          while ( M_pos < M_end && *M_pos != c1 && *M_pos != c2 ) ++M_pos;
+      }
+
+    /*!
+      \brief check if the rest of the range starts with str. the cursor is not moved.
+      \param str null terminated string
+      \return true if matched.
+     */
+    bool startsWith( const char * str ) const;
+
+    /*!
+      \brief read the integer value in the same manner as std::strtol().
+      \param base 10 or 16
+      \return read value. 0 if no digit, and the cursor is not moved.
+     */
+    long readLong( const int base = 10 );
+
+    /*!
+      \brief read the floating point value in the same manner as std::strtof().
+      \return read value. 0 if no number, and the cursor is not moved.
+     */
+    float readFloat();
+
+private:
+
+    long readLongSlow( const int base );
+    float readFloatSlow();
+};
+
+}
+}
+
+#endif
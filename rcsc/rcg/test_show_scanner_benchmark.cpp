@@ -0,0 +1,458 @@
+// -*-c++-*-
+
+/*!
+  \file test_show_scanner_benchmark.cpp
+  \brief benchmark of the rcg v4 show line parser
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG
+#include <config.h>
+#endif
+
+#include "parser_v4.h"
+#include "handler.h"
+#include "types.h"
+
+#include <boost/random.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/time.h> // struct timeval, gettimeofday()
+
+using namespace rcsc;
+using namespace rcsc::rcg;
+
+double
+elapsed_usec( const timeval & start,
+              const timeval & end )
+{
+    return ( end.tv_sec - start.tv_sec ) * 1000.0 * 1000.0
+        + ( end.tv_usec - start.tv_usec );
+}
+
+/*!
+  \brief handler that keeps the last show info.
+*/
+class ShowHolder
+    : public Handler {
+public:
+    ShowInfoT show_;
+    long count_;
+
+    ShowHolder()
+        : count_( 0 )
+      { }
+
+    bool handleDispInfo( const dispinfo_t & ) { return true; }
+    bool handleShowInfo( const showinfo_t & ) { return true; }
+    bool handleShortShowInfo2( const short_showinfo_t2 & ) { return true; }
+    bool handleMsgInfo( Int16, const std::string & ) { return true; }
+    bool handlePlayMode( char ) { return true; }
+    bool handleTeamInfo( const team_t &, const team_t & ) { return true; }
+    bool handlePlayerType( const player_type_t & ) { return true; }
+    bool handleServerParam( const server_params_t & ) { return true; }
+    bool handlePlayerParam( const player_params_t & ) { return true; }
+    bool handleEOF() { return true; }
+
+    bool handleShow( const int,
+                     const ShowInfoT & show )
+      {
+          show_ = show;
+          ++count_;
+          return true;
+      }
+    bool handleMsg( const int, const int, const std::string & ) { return true; }
+    bool handlePlayMode( const int, const PlayMode ) { return true; }
+    bool handleTeam( const int, const TeamT &, const TeamT & ) { return true; }
+    bool handleServerParam( const std::string & ) { return true; }
+    bool handlePlayerParam( const std::string & ) { return true; }
+    bool handlePlayerType( const std::string & ) { return true; }
+};
+
+/*!
+  \brief the old sscanf based parser. the reference of the result.
+  \param line show line without playmode and team
+  \param show result
+  \return true if successfully parsed.
+*/
+bool
+parse_sscanf( const std::string & line,
+              ShowInfoT * show )
+{
+    const char * buf = line.c_str();
+    int n_read = 0;
+
+    int time = 0;
+    if ( std::sscanf( buf, " ( show %d %n ",
+                      &time, &n_read ) != 1 )
+    {
+        return false;
+    }
+    buf += n_read;
+
+    show->time_ = time;
+
+    if ( std::sscanf( buf, " ((b) %f %f %f %f) %n",
+                      &show->ball_.x_, &show->ball_.y_,
+                      &show->ball_.vx_, &show->ball_.vy_,
+                      &n_read ) != 4 )
+    {
+        return false;
+    }
+    buf += n_read;
+
+    char side;
+    short unum;
+    short type;
+    int state;
+    float x, y, vx, vy, body, neck;
+    for ( int i = 0; i < MAX_PLAYER * 2; ++i )
+    {
+        if ( *buf == ')' ) break;
+
+        if ( std::sscanf( buf,
+                          " ((%c %hd) %hd %x %f %f %f %f %f %f %n",
+                          &side, &unum,
+                          &type, &state,
+                          &x, &y, &vx, &vy, &body, &neck,
+                          &n_read ) != 10 )
+        {
+            return false;
+        }
+        buf += n_read;
+
+        int idx = unum - 1;
+        if ( side == 'r' ) idx += MAX_PLAYER;
+        if ( idx < 0 || MAX_PLAYER*2 <= idx )
+        {
+            return false;
+        }
+
+        PlayerT & p = show->player_[idx];
+
+        p.side_ = side;
+        p.unum_ = unum;
+        p.type_ = type;
+        p.state_ = state;
+        p.x_ = x;
+        p.y_ = y;
+        p.vx_ = vx;
+        p.vy_ = vy;
+        p.body_ = body;
+        p.neck_ = neck;
+
+        if ( *buf != '('
+             && std::sscanf( buf,
+                             " %f %f %n",
+                             &p.point_x_, &p.point_y_,
+                             &n_read ) == 2 )
+        {
+            buf += n_read;
+        }
+
+        if ( std::sscanf( buf,
+                          " (v %c %f) (s %f %f %f) %n",
+                          &p.view_quality_, &p.view_width_,
+                          &p.stamina_, &p.effort_, &p.recovery_,
+                          &n_read ) != 5 )
+        {
+            return false;
+        }
+        buf += n_read;
+
+        if ( *(buf + 1) == 'f'
+             && std::sscanf( buf,
+                             " ( f %c %hd ) %n",
+                             &p.focus_side_, &p.focus_unum_,
+                             &n_read ) == 2 )
+        {
+            buf += n_read;
+        }
+
+        if ( std::sscanf( buf,
+                          " (c %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd %hd)) %n",
+                          &p.kick_count_,
+                          &p.dash_count_,
+                          &p.turn_count_,
+                          &p.catch_count_,
+                          &p.move_count_,
+                          &p.turn_neck_count_,
+                          &p.change_view_count_,
+                          &p.say_count_,
+                          &p.tackle_count_,
+                          &p.pointto_count_,
+                          &p.attentionto_count_,
+                          &n_read ) != 11 )
+        {
+            return false;
+        }
+        buf += n_read;
+    }
+
+    return true;
+}
+
+/*!
+  \brief compare all fields bit by bit.
+*/
+bool
+same_float( const float a,
+            const float b )
+{
+    return std::memcmp( &a, &b, sizeof( float ) ) == 0;
+}
+
+bool
+same_show( const ShowInfoT & a,
+           const ShowInfoT & b )
+{
+    if ( a.time_ != b.time_
+         || ! same_float( a.ball_.x_, b.ball_.x_ )
+         || ! same_float( a.ball_.y_, b.ball_.y_ )
+         || ! same_float( a.ball_.vx_, b.ball_.vx_ )
+         || ! same_float( a.ball_.vy_, b.ball_.vy_ ) )
+    {
+        return false;
+    }
+
+    for ( int i = 0; i < MAX_PLAYER * 2; ++i )
+    {
+        const PlayerT & p = a.player_[i];
+        const PlayerT & q = b.player_[i];
+        if ( p.side_ != q.side_ || p.unum_ != q.unum_ || p.type_ != q.type_
+             || p.view_quality_ != q.view_quality_
+             || p.focus_side_ != q.focus_side_ || p.focus_unum_ != q.focus_unum_
+             || p.state_ != q.state_
+             || ! same_float( p.x_, q.x_ ) || ! same_float( p.y_, q.y_ )
+             || ! same_float( p.vx_, q.vx_ ) || ! same_float( p.vy_, q.vy_ )
+             || ! same_float( p.body_, q.body_ ) || ! same_float( p.neck_, q.neck_ )
+             || ! same_float( p.point_x_, q.point_x_ ) || ! same_float( p.point_y_, q.point_y_ )
+             || ! same_float( p.view_width_, q.view_width_ )
+             || ! same_float( p.stamina_, q.stamina_ )
+             || ! same_float( p.effort_, q.effort_ )
+             || ! same_float( p.recovery_, q.recovery_ )
+             || p.kick_count_ != q.kick_count_ || p.dash_count_ != q.dash_count_
+             || p.turn_count_ != q.turn_count_ || p.catch_count_ != q.catch_count_
+             || p.move_count_ != q.move_count_ || p.turn_neck_count_ != q.turn_neck_count_
+             || p.change_view_count_ != q.change_view_count_ || p.say_count_ != q.say_count_
+             || p.tackle_count_ != q.tackle_count_ || p.pointto_count_ != q.pointto_count_
+             || p.attentionto_count_ != q.attentionto_count_ )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+  \brief create the show lines that have the random values.
+  \param size the number of lines
+  \return lines
+*/
+std::vector< std::string >
+create_lines( const int size )
+{
+    boost::mt19937 eng( 19937 );
+    boost::variate_generator< boost::mt19937&, boost::uniform_real<> >
+        pos_rng( eng, boost::uniform_real<>( -55.0, 55.0 ) );
+    boost::variate_generator< boost::mt19937&, boost::uniform_real<> >
+        vel_rng( eng, boost::uniform_real<>( -3.0, 3.0 ) );
+    boost::variate_generator< boost::mt19937&, boost::uniform_real<> >
+        dir_rng( eng, boost::uniform_real<>( -180.0, 180.0 ) );
+    boost::variate_generator< boost::mt19937&, boost::uniform_int<> >
+        int_rng( eng, boost::uniform_int<>( 0, 10000 ) );
+
+    std::vector< std::string > lines;
+    lines.reserve( size );
+
+    char buf[512];
+    for ( int i = 0; i < size; ++i )
+    {
+        std::string line;
+        std::sprintf( buf, "(show %d ((b) %.4f %.4f %.4f %.4f)",
+                       i + 1, pos_rng(), pos_rng(), vel_rng(), vel_rng() );
+        line += buf;
+
+        for ( int n = 0; n < MAX_PLAYER * 2; ++n )
+        {
+            const int r = int_rng();
+            std::sprintf( buf,
+                           " ((%c %d) %d 0x%x %.4f %.4f %.4f %.4f %.3f %.3f",
+                           ( n < MAX_PLAYER ? 'l' : 'r' ), n % MAX_PLAYER + 1,
+                           r % 18, 1 + ( r % 3 ) * 0x100,
+                           pos_rng(), pos_rng(), vel_rng(), vel_rng(),
+                           dir_rng(), dir_rng() / 2.0 );
+            line += buf;
+
+            if ( r % 7 == 0 )
+            {
+                std::sprintf( buf, " %.4f %.4f", pos_rng(), pos_rng() );
+                line += buf;
+            }
+
+            std::sprintf( buf, " (v %c %.2f) (s %.2f %.6f %.6f)",
+                           ( r % 2 ? 'h' : 'l' ), ( r % 3 ? 90.0 : 60.0 ),
+                           r * 0.8, 0.8 + r * 2.0e-5, 0.5 + r * 5.0e-5 );
+            line += buf;
+
+            if ( r % 5 == 0 )
+            {
+                std::sprintf( buf, " (f %c %d)",
+                               ( r % 2 ? 'l' : 'r' ), r % MAX_PLAYER + 1 );
+                line += buf;
+            }
+
+            std::sprintf( buf, " (c %d %d %d %d %d %d %d %d %d %d %d))",
+                           r, r / 2, r / 3, r / 4, r / 5, r / 6, r / 7, r / 8, r / 9, r / 10, r / 11 );
+            line += buf;
+        }
+
+        line += ')';
+        lines.push_back( line );
+    }
+
+    return lines;
+}
+
+/*!
+  \brief read the show lines of the rcg v4 or v5 file.
+  \param filepath rcg file path
+  \return lines
+*/
+std::vector< std::string >
+read_lines( const char * filepath )
+{
+    std::vector< std::string > lines;
+
+    std::ifstream fin( filepath );
+    std::string line;
+    while ( std::getline( fin, line ) )
+    {
+        if ( ! line.compare( 0, 6, "(show " ) )
+        {
+            lines.push_back( line );
+        }
+    }
+
+    return lines;
+}
+
+int
+main( int argc, char ** argv )
+{
+    const std::vector< std::string > lines = ( argc > 1
+                                               ? read_lines( argv[1] )
+                                               : create_lines( 20000 ) );
+    if ( lines.empty() )
+    {
+        std::cerr << "no show line." << std::endl;
+        return 1;
+    }
+
+    const int loop = std::max( 1, 200000 / static_cast< int >( lines.size() ) );
+
+    ParserV4 parser;
+    ShowHolder holder;
+
+    //
+    // parity
+    //
+    int n_mismatch = 0;
+    for ( size_t i = 0; i < lines.size(); ++i )
+    {
+        ShowInfoT expected;
+        parse_sscanf( lines[i], &expected );
+        parser.parseLine( static_cast< int >( i ), lines[i], holder );
+        if ( ! same_show( expected, holder.show_ ) )
+        {
+            if ( n_mismatch < 5 )
+            {
+                std::cout << "mismatch: " << lines[i].substr( 0, 120 ) << "..." << std::endl;
+            }
+            ++n_mismatch;
+        }
+    }
+
+    timeval start, end;
+
+    //
+    // sscanf
+    //
+    long check_sum_sscanf = 0;
+    ::gettimeofday( &start, NULL );
+    for ( int l = 0; l < loop; ++l )
+    {
+        for ( std::vector< std::string >::const_iterator it = lines.begin();
+              it != lines.end();
+              ++it )
+        {
+            ShowInfoT show;
+            parse_sscanf( *it, &show );
+            check_sum_sscanf += show.player_[0].kick_count_;
+        }
+    }
+    ::gettimeofday( &end, NULL );
+    const double sscanf_usec = elapsed_usec( start, end );
+
+    //
+    // scanner
+    //
+    long check_sum_scanner = 0;
+    ::gettimeofday( &start, NULL );
+    for ( int l = 0; l < loop; ++l )
+    {
+        for ( std::vector< std::string >::const_iterator it = lines.begin();
+              it != lines.end();
+              ++it )
+        {
+            parser.parseLine( 0, *it, holder );
+            check_sum_scanner += holder.show_.player_[0].kick_count_;
+        }
+    }
+    ::gettimeofday( &end, NULL );
+    const double scanner_usec = elapsed_usec( start, end );
+
+    const double n_line = static_cast< double >( loop ) * lines.size();
+
+    std::printf( "%d show lines x %d\n",
+                 static_cast< int >( lines.size() ), loop );
+    std::printf( "sscanf  %10.0f [lines/s]\n", n_line * 1.0e6 / sscanf_usec );
+    std::printf( "scanner %10.0f [lines/s]  x%.2f\n",
+                 n_line * 1.0e6 / scanner_usec,
+                 sscanf_usec / scanner_usec );
+    std::printf( "parity  %s  (%d mismatched lines)%s\n",
+                 ( n_mismatch == 0 ? "ok" : "NG" ),
+                 n_mismatch,
+                 ( check_sum_sscanf == check_sum_scanner ? "" : "  *** check sum mismatch ***" ) );
+
+    return ( n_mismatch == 0 ? 0 : 1 );
+}
@@ -0,0 +1,295 @@
+// -*-c++-*-
+
+/*!
+  \file text_buffer.cpp
+  \brief growable character buffer for the text serialization Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "text_buffer.h"
+
+#include <algorithm>
+#include <clocale>
+#include <cstdio>
+#include <cmath>
+
+namespace {
+
+//! exact powers of ten
+const double POW10[] = { 1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4,
+                         1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9 };
+
+//! the number of significant digits of the default stream precision
+const int PRECISION = 6;
+
+}
+
+namespace rcsc {
+namespace rcg {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+TextBuffer::TextBuffer( const std::size_t capacity )
+    : M_data( std::max( capacity, static_cast< std::size_t >( 64 ) ) ),
+      M_size( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+TextBuffer::reserve( const std::size_t n )
+{
+    std::size_t new_size = M_data.size() * 2;
+    while ( new_size < M_size + n )
+    {
+        new_size *= 2;
+    }
+
+    M_data.resize( new_size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+TextBuffer &
+TextBuffer::putInt( const long val )
+{
+    char buf[24];
+    char * end = buf + sizeof( buf );
+    char * p = end;
+
+    unsigned long u = ( val < 0
+                        ? 0ul - static_cast< unsigned long >( val )
+                        : static_cast< unsigned long >( val ) );
+    do
+    {
+        *--p = static_cast< char >( '0' + u % 10 );
+        u /= 10;
+    }
+    while ( u != 0 );
+
+    if ( val < 0 )
+    {
+        *--p = '-';
+    }
+
+    return put( p, end - p );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+TextBuffer &
+TextBuffer::putHex( const boost::uint32_t val )
+{
+    static const char digits[] = "0123456789abcdef";
+
+    if ( val == 0 )
+    {
+        return put( '0' );
+    }
+
+    char buf[16];
+    char * end = buf + sizeof( buf );
+    char * p = end;
+
+    boost::uint32_t u = val;
+    while ( u != 0 )
+    {
+        *--p = digits[u & 0xf];
+        u >>= 4;
+    }
+    *--p = 'x';
+    *--p = '0';
+
+    return put( p, end - p );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  A float multiplied by 10^n (0 <= n <= 9) is exactly representable
+  in double, because 5^9 needs only 21 bits. So the value is scaled to
+  the six digits integer and rounded half to even without any rounding
+  error, and the result is the same as the correctly rounded "%g".
+  The values that need the exponent notation, infinity and NaN are
+  formatted by putDouble().
+*/
+TextBuffer &
+TextBuffer::putFloat( const float val )
+{
+    const double v = val;
+
+    if ( v == 0.0 )
+    {
+        // -0 is written as "-0" by the stream.
+        return ( 1.0 / v < 0.0 ? put( "-0", 2 ) : put( '0' ) );
+    }
+
+    const double a = std::fabs( v );
+    if ( ! ( 1.0e-4 <= a && a < 1.0e6 ) ) // also NaN
+    {
+        return putDouble( v );
+    }
+
+    // find the exponent: 10^e <= a < 10^(e+1)
+    int e = 5;
+    while ( e > -4 && a < ( e >= 0 ? POW10[e] : 1.0 / POW10[-e] ) )
+    {
+        --e;
+    }
+
+    double scaled = a * POW10[PRECISION - 1 - e];
+
+    // 1/10^k is not exact in double. adjust the exponent by the exact product.
+    if ( scaled < POW10[PRECISION - 1] )
+    {
+        --e;
+        if ( e < -4 )
+        {
+            return putDouble( v );
+        }
+        scaled = a * POW10[PRECISION - 1 - e];
+    }
+    else if ( scaled >= POW10[PRECISION] )
+    {
+        ++e;
+        scaled = a * POW10[PRECISION - 1 - e];
+    }
+
+    unsigned long digits = static_cast< unsigned long >( std::floor( scaled ) );
+    const double frac = scaled - static_cast< double >( digits );
+    if ( frac > 0.5
+         || ( frac == 0.5 && ( digits & 1ul ) ) )
+    {
+        ++digits;
+    }
+
+    if ( digits == static_cast< unsigned long >( POW10[PRECISION] ) )
+    {
+        digits /= 10;
+        ++e;
+        if ( e >= PRECISION )
+        {
+            return putDouble( v );
+        }
+    }
+
+    // six digits without the trailing zeros
+    char buf[PRECISION];
+    for ( int i = PRECISION - 1; i >= 0; --i )
+    {
+        buf[i] = static_cast< char >( '0' + digits % 10 );
+        digits /= 10;
+    }
+
+    int n = PRECISION;
+    while ( n > e + 1 && buf[n - 1] == '0' )
+    {
+        --n;
+    }
+
+    char out[PRECISION + 8];
+    char * p = out;
+
+    if ( v < 0.0 )
+    {
+        *p++ = '-';
+    }
+
+    if ( e >= 0 )
+    {
+        for ( int i = 0; i <= e; ++i )
+        {
+            *p++ = buf[i];
+        }
+        if ( n > e + 1 )
+        {
+            *p++ = '.';
+            for ( int i = e + 1; i < n; ++i )
+            {
+                *p++ = buf[i];
+            }
+        }
+    }
+    else
+    {
+        *p++ = '0';
+        *p++ = '.';
+        for ( int i = -1; i > e; --i )
+        {
+            *p++ = '0';
+        }
+        for ( int i = 0; i < n; ++i )
+        {
+            *p++ = buf[i];
+        }
+    }
+
+    return put( out, p - out );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+TextBuffer &
+TextBuffer::putDouble( const double val )
+{
+    char buf[64];
+    int n = snprintf( buf, sizeof( buf ), "%.*g", PRECISION, val );
+    if ( n < 0 )
+    {
+        return *this;
+    }
+    if ( n >= static_cast< int >( sizeof( buf ) ) )
+    {
+        n = sizeof( buf ) - 1;
+    }
+
+    // the stream always uses the classic locale.
+    const char point = *std::localeconv()->decimal_point;
+    if ( point != '.' )
+    {
+        std::replace( buf, buf + n, point, '.' );
+    }
+
+    return put( buf, n );
+}
+
+} // end of namespace
+} // end of namespace
@@ -0,0 +1,197 @@
+// -*-c++-*-
+
+/*!
+  \file text_buffer.h
+  \brief growable character buffer for the text serialization Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_TEXT_BUFFER_H
+#define RCSC_RCG_TEXT_BUFFER_H
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstring>
+
+namespace rcsc {
+namespace rcg {
+
+/*!
+  \class TextBuffer
+  \brief reusable character buffer that formats numbers without iostream.
+
+  The output of each put function is the same as operator<< of the
+  std::ostream with the default format flags, the default precision (6)
+  and the classic locale. The allocated memory is kept by clear(), so a
+  buffer that is reused for each record does not allocate after the
+  first few records.
+*/
+class TextBuffer {
+private:
+
+    std::vector< char > M_data; //!< allocated memory
+    std::size_t M_size; //!< used size
+
+public:
+
+    /*!
+      \brief allocate the initial memory.
+      \param capacity initial capacity in bytes
+     */
+    explicit
+    TextBuffer( const std::size_t capacity = 8192 );
+
+    /*!
+      \brief clear the contents. the allocated memory is not released.
+     */
+    void clear()
+      {
+          M_size = 0;
+      }
+
+    /*!
+      \brief get the top of the contents.
+      \return pointer to the first character. the contents are not null-terminated.
+     */
+    const char * data() const
+      {
+          return &M_data[0];
+      }
+
+    /*!
+      \brief get the size of the contents.
+      \return the number of characters
+     */
+    std::size_t size() const
+      {
+          return M_size;
+      }
+
+    /*!
+      \brief write the contents to the stream by one write() call and clear the contents.
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    std::ostream & flush( std::ostream & os )
+      {
+          os.write( data(), static_cast< std::streamsize >( M_size ) );
+          M_size = 0;
+          return os;
+      }
+
+    /*!
+      \brief append a character.
+      \param c appended character
+      \return reference to itself
+     */
+    TextBuffer & put( const char c )
+      {
+          if ( M_size == M_data.size() )
+          {
+              reserve( 1 );
+          }
+          M_data[M_size++] = c;
+          return *this;
+      }
+
+    /*!
+      \brief append characters.
+      \param str pointer to the characters
+      \param n the number of characters
+      \return reference to itself
+     */
+    TextBuffer & put( const char * str,
+                      const std::size_t n )
+      {
+          if ( M_size + n > M_data.size() )
+          {
+              reserve( n );
+          }
+          std::memcpy( &M_data[M_size], str, n );
+          M_size += n;
+          return *this;
+      }
+
+    /*!
+      \brief append a null-terminated string.
+      \param str pointer to the string
+      \return reference to itself
+     */
+    TextBuffer & put( const char * str )
+      {
+          return put( str, std::strlen( str ) );
+      }
+
+    /*!
+      \brief append a string.
+      \param str appended string
+      \return reference to itself
+     */
+    TextBuffer & put( const std::string & str )
+      {
+          return put( str.data(), str.length() );
+      }
+
+    /*!
+      \brief append a decimal integer.
+      \param val appended value
+      \return reference to itself
+     */
+    TextBuffer & putInt( const long val );
+
+    /*!
+      \brief append a hexadecimal integer with the "0x" prefix, as std::hex and std::showbase.
+      \param val appended value. 0 is written as "0".
+      \return reference to itself
+     */
+    TextBuffer & putHex( const boost::uint32_t val );
+
+    /*!
+      \brief append a floating point number, as the "%g" format.
+      \param val appended value
+      \return reference to itself
+     */
+    TextBuffer & putFloat( const float val );
+
+    /*!
+      \brief append a floating point number, as the "%g" format.
+      \param val appended value
+      \return reference to itself
+     */
+    TextBuffer & putDouble( const double val );
+
+private:
+
+    void reserve( const std::size_t n );
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
@@ -195,5 +195,46 @@ nltons( const Int32 & val )
     //         ( htons( static_cast< Int16 >( nltohd( val ) * SHOWINFO_SCALE ) ) ) );
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::size_t
+data_block_size( const int log_version,
+                 const int mode )
+{
+    if ( log_version == REC_VERSION_2 )
+    {
+        switch ( mode ) {
+        case SHOW_MODE:
+            return sizeof( showinfo_t );
+        case DRAW_MODE:
+            return sizeof( drawinfo_t );
+        default:
+            break;
+        }
+        return 0;
+    }
+
+    switch ( mode ) {
+    case SHOW_MODE:
+        return sizeof( short_showinfo_t2 );
+    case PM_MODE:
+        return sizeof( char );
+    case TEAM_MODE:
+        return sizeof( team_t ) * 2;
+    case PT_MODE:
+        return sizeof( player_type_t );
+    case PARAM_MODE:
+        return sizeof( server_params_t );
+    case PPARAM_MODE:
+        return sizeof( player_params_t );
+    default:
+        break;
+    }
+
+    return 0;
+}
+
 } // end namespace
 } // end namespace
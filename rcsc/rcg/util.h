@@ -34,6 +34,8 @@
 
 #include <rcsc/rcg/types.h>
 
+#include <cstddef>
+
 namespace rcsc {
 namespace rcg {
 
@@ -169,6 +171,17 @@ nstonl( const Int16 val );
 Int16
 nltons( const Int32 & val );
 
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the size of the fixed size data block in the binary rcg.
+  \param log_version rcg version (REC_VERSION_2 or REC_VERSION_3)
+  \param mode data mode in local byte order
+  \return block size without the mode value. 0 if variable size (MSG_MODE) or unknown mode.
+*/
+std::size_t
+data_block_size( const int log_version,
+                 const int mode );
+
 } // end namespace
 } // end namespace
 
@@ -9,6 +9,15 @@ LIBS += -L../zlib -lz
 DEFINES += HAVE_NETINET_IN_H
 DEFINES += TRILIBRARY REDUCED CDT_ONLY NO_TIMER VOID=int REAL=double
 CONFIG += staticlib warn_on release
+# OpenMP for the parallel loops in formation and rcg.
+QMAKE_CXXFLAGS += -fopenmp
+QMAKE_LFLAGS += -fopenmp
+# pthread for the background threads.
+# win32 builds use the synchronous code paths and need no flag.
+unix {
+  QMAKE_CXXFLAGS += -pthread
+  LIBS += -lpthread
+}
 OBJECTS_DIR = $$PWD/objs
 MOC_DIR = $$PWD/objs
 # Input
@@ -28,15 +37,19 @@ HEADERS += factory.h \
            geom/line_2d.h \
            geom/matrix_2d.h \
            geom/polygon_2d.h \
+           geom/predicates_2d.h \
            geom/ray_2d.h \
            geom/rect_2d.h \
            geom/region_2d.h \
            geom/sector_2d.h \
            geom/segment_2d.h \
+           geom/segment_intersection.h \
            geom/size_2d.h \
+           geom/spatial_grid.h \
            geom/triangle_2d.h \
            geom/triangulation.h \
            geom/vector_2d.h \
+           geom/vector_2d_array.h \
            geom/voronoi_diagram.h \
            param/cmd_line_parser.h \
            param/conf_file_parser.h \
@@ -45,6 +58,7 @@ HEADERS += factory.h \
            param/rcss_param_parser.h \
            rcg/handler.h \
            rcg/holder.h \
+           rcg/column_holder.h \
            rcg/reader.h \
            rcg/parser.h \
            rcg/parser_v1.h \
@@ -52,6 +66,9 @@ HEADERS += factory.h \
            rcg/parser_v3.h \
            rcg/parser_v4.h \
            rcg/parser_v5.h \
+           rcg/parallel_parser.h \
+           rcg/cycle_index.h \
+           rcg/show_scanner.h \
            ann/bpn1.h \
            ann/ngnet.h \
            ann/rbf.h \
@@ -66,6 +83,8 @@ HEADERS += factory.h \
            formation/formation_static.h \
            formation/formation_uva.h \
            formation/sample_data.h \
+           formation/sample_harvester.h \
+           formation/sample_reducer.h \
            formation/formation_ssl.h
 
 SOURCES += common/player_param.cpp \
@@ -79,18 +98,32 @@ SOURCES += common/player_param.cpp \
            geom/line_2d.cpp \
            geom/matrix_2d.cpp \
            geom/polygon_2d.cpp \
+           geom/predicates_2d.cpp \
            geom/ray_2d.cpp \
            geom/rect_2d.cpp \
            geom/sector_2d.cpp \
            geom/segment_2d.cpp \
+           geom/segment_intersection.cpp \
            geom/triangle_2d.cpp \
            geom/triangulation.cpp \
            geom/vector_2d.cpp \
+           geom/vector_2d_array.cpp \
            geom/voronoi_diagram.cpp \
            param/cmd_line_parser.cpp \
            param/conf_file_parser.cpp \
            param/param_map.cpp \
            param/rcss_param_parser.cpp \
+           rcg/holder.cpp \
+           rcg/column_holder.cpp \
+           rcg/parser.cpp \
+           rcg/parser_v1.cpp \
+           rcg/parser_v2.cpp \
+           rcg/parser_v3.cpp \
+           rcg/parser_v4.cpp \
+           rcg/parser_v5.cpp \
+           rcg/parallel_parser.cpp \
+           rcg/cycle_index.cpp \
+           rcg/show_scanner.cpp \
            rcg/util.cpp \
            ann/ngnet.cpp \
            ann/rbf.cpp \
@@ -105,4 +138,6 @@ SOURCES += common/player_param.cpp \
            formation/formation_static.cpp \
            formation/formation_uva.cpp \
            formation/sample_data.cpp \
+           formation/sample_harvester.cpp \
+           formation/sample_reducer.cpp \
            formation/formation_ssl.cpp
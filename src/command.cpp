@@ -146,3 +146,87 @@ MoveCommand::updateText()
                        .arg( M_new_pos.y() ) );
     }
 }
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+DataEditCommand::DataEditCommand( boost::shared_ptr< EditData > edit_data,
+                                  EditData::Delta & delta,
+                                  const QString & text,
+                                  QUndoCommand * parent )
+    : QUndoCommand( text, parent )
+    , M_edit_data( edit_data )
+    , M_applied( true )
+{
+    M_delta.swap( delta );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DataEditCommand::undo()
+{
+    boost::shared_ptr< EditData > edit_data = M_edit_data.lock();
+    if ( ! edit_data )
+    {
+        return;
+    }
+
+    if ( ! edit_data->applyDelta( M_delta, true ) )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " ***ERROR*** failed to undo [" << text().toStdString() << "]"
+                  << std::endl;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+DataEditCommand::redo()
+{
+    if ( M_applied )
+    {
+        M_applied = false;
+        return;
+    }
+
+    boost::shared_ptr< EditData > edit_data = M_edit_data.lock();
+    if ( ! edit_data )
+    {
+        return;
+    }
+
+    if ( ! edit_data->applyDelta( M_delta, false ) )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " ***ERROR*** failed to redo [" << text().toStdString() << "]"
+                  << std::endl;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+DataEditCommand::mergeWith( const QUndoCommand * command )
+{
+    const DataEditCommand * other = static_cast< const DataEditCommand * >( command );
+
+    if ( ! isSingleReplace()
+         || ! other->isSingleReplace()
+         || M_delta.front().index_ != other->M_delta.front().index_
+         || M_edit_data.lock() != other->M_edit_data.lock() )
+    {
+        return false;
+    }
+
+    M_delta.front().new_data_ = other->M_delta.front().new_data_;
+    return true;
+}
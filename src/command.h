@@ -35,6 +35,11 @@
 #include <QUndoCommand>
 #include <QPointF>
 
+#include "edit_data.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
 class EditScene;
 
 class QGraphicsItem;
@@ -68,4 +73,69 @@ private:
 
 };
 
+/*!
+  \class DataEditCommand
+  \brief undoable change of the training data.
+
+  The command holds only the changes recorded by the edit operation, not
+  the copy of the whole data set. The first redo() called by
+  QUndoStack::push() does nothing, because the operation has been already
+  applied to the data.
+*/
+class DataEditCommand
+    : public QUndoCommand {
+private:
+
+    boost::weak_ptr< EditData > M_edit_data;
+    EditData::Delta M_delta;
+    bool M_applied; //!< true until the first redo() is called
+
+public:
+
+    /*!
+      \brief create the command.
+      \param edit_data edited data
+      \param delta changes taken by EditData::takeDelta(). the content is moved to this command.
+      \param text command text shown in the undo/redo action.
+      \param parent parent command
+     */
+    DataEditCommand( boost::shared_ptr< EditData > edit_data,
+                     EditData::Delta & delta,
+                     const QString & text,
+                     QUndoCommand * parent = 0 );
+
+    int id() const
+      {
+          return 2;
+      }
+
+    /*!
+      \brief get the changes held by this command.
+      \return const reference to the changes.
+     */
+    const EditData::Delta & delta() const
+      {
+          return M_delta;
+      }
+
+    void undo();
+    void redo();
+
+    /*!
+      \brief merge the successive changes of the same sample into one step.
+      \param command the command pushed after this.
+      \return true if merged.
+     */
+    bool mergeWith( const QUndoCommand * command );
+
+private:
+
+    bool isSingleReplace() const
+      {
+          return ( M_delta.size() == 1
+                   && M_delta.front().type_ == EditData::Change::REPLACE_DATA );
+      }
+
+};
+
 #endif
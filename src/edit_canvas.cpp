@@ -38,6 +38,7 @@
 #include "edit_canvas.h"
 
 #include "edit_data.h"
+#include "heat_map.h"
 #include "main_window.h"
 #include "options.h"
 
@@ -53,6 +54,11 @@
 #define ButtonGoal -0.50
 #define FieldWidth 9.000
 
+namespace {
+//! interval [ms] of the drag evaluation. about one frame of 60Hz display.
+const int DRAG_FRAME_INTERVAL = 16;
+}
+
 
 using namespace rcsc;
 using namespace rcsc::formation;
@@ -93,9 +99,32 @@ EditCanvas::EditCanvas( QWidget * parent )
     , M_background_right_team_brush( QColor( 127, 20, 20 ), Qt::SolidPattern )
     , M_background_symmetry_brush( QColor( 0, 192, 31 ), Qt::SolidPattern )
     , M_background_font_pen( QColor( 0, 63, 127 ), 0, Qt::SolidLine )
+    , M_field_layer_valid( false )
+    , M_data_layer_valid( false )
+    , M_data_layer_revision( 0 )
+    , M_data_layer_flags( 0 )
+    , M_drag_pending( false )
+    , M_heat_map_unum( 0 )
 {
     field = new CField();
 
+    M_drag_timer = new QTimer( this );
+    M_drag_timer->setSingleShot( true );
+    M_drag_timer->setInterval( DRAG_FRAME_INTERVAL );
+    connect( M_drag_timer, SIGNAL( timeout() ),
+             this, SLOT( applyDrag() ) );
+
+    // zero interval timer is fired after all pending events are processed.
+    M_moved_timer = new QTimer( this );
+    M_moved_timer->setSingleShot( true );
+    M_moved_timer->setInterval( 0 );
+    connect( M_moved_timer, SIGNAL( timeout() ),
+             this, SLOT( notifyObjectMoved() ) );
+
+    M_heat_map = new HeatMap( this );
+    connect( M_heat_map, SIGNAL( updated() ),
+             this, SLOT( update() ) );
+
 
     //this->setPalette( QPalette( M_field_brush.color() ) );
     this->setPalette( QPalette( M_field_color ) );
@@ -134,7 +163,6 @@ EditCanvas::~EditCanvas()
 void
 EditCanvas::paintEvent( QPaintEvent * )
 {
-    QPainter painter( this );
     if ( Options::instance().autoFitMode() )
     {
         double scale_w = this->width() / ( _FIELD_WIDTH +0.5 );
@@ -146,18 +174,29 @@ EditCanvas::paintEvent( QPaintEvent * )
         M_transform.scale( scale_factor, scale_factor );
     }
 
+    updateLayers();
+
+    QPainter painter( this );
     painter.setWorldTransform( M_transform );
 
     if ( Options::instance().antialiasing() )
     {
         setAntialiasFlag( painter, true );
     }
-    drawField( painter );
-    if ( Options::instance().showBackgroundData() )
-    {
-        drawBackgroundData( painter );
-    }
-    drawData( painter );
+
+    // the contained triangles depend on the ball position,
+    // and they are placed under the field lines.
+    drawContainedAreas( painter );
+    drawHeatMap( painter );
+
+    // static layers
+    painter.setWorldMatrixEnabled( false );
+    painter.drawPixmap( 0, 0, M_field_layer );
+    painter.drawPixmap( 0, 0, M_data_layer );
+    painter.setWorldMatrixEnabled( true );
+
+    // dynamic layer
+    drawSelectedData( painter );
     drawPlayers( painter );
     if ( Options::instance().showBackgroundData() )
     {
@@ -165,9 +204,88 @@ EditCanvas::paintEvent( QPaintEvent * )
     }
     drawBall( painter );
     drawConstraintSelection( painter );
+}
 
+/*-------------------------------------------------------------------*/
+/*!
 
+ */
+int
+EditCanvas::dataLayerFlags() const
+{
+    int flags = 0;
+    if ( Options::instance().showBackgroundData() ) flags |= 1;
+    if ( Options::instance().showTriangulation() ) flags |= 2;
+    if ( Options::instance().showIndex() ) flags |= 4;
+    if ( Options::instance().antialiasing() ) flags |= 8;
+    return flags;
+}
 
+/*-------------------------------------------------------------------*/
+/*!
+  re-render the cached layers if their source has been changed.
+ */
+void
+EditCanvas::updateLayers()
+{
+    if ( this->width() <= 0
+         || this->height() <= 0 )
+    {
+        return;
+    }
+
+    if ( M_layer_transform != M_transform
+         || M_field_layer.size() != this->size() )
+    {
+        M_layer_transform = M_transform;
+        M_field_layer_valid = false;
+        M_data_layer_valid = false;
+    }
+
+    boost::shared_ptr< EditData > ptr = M_edit_data.lock();
+    const unsigned long revision = ( ptr ? ptr->dataRevision() : 0 );
+    const int flags = dataLayerFlags();
+
+    if ( revision != M_data_layer_revision
+         || flags != M_data_layer_flags )
+    {
+        M_data_layer_valid = false;
+    }
+
+    if ( ! M_field_layer_valid )
+    {
+        M_field_layer = QPixmap( this->size() );
+        M_field_layer.fill( Qt::transparent );
+
+        QPainter painter( &M_field_layer );
+        painter.setWorldTransform( M_transform );
+        drawField( painter );
+
+        M_field_layer_valid = true;
+    }
+
+    if ( ! M_data_layer_valid )
+    {
+        M_data_layer = QPixmap( this->size() );
+        M_data_layer.fill( Qt::transparent );
+
+        QPainter painter( &M_data_layer );
+        painter.setWorldTransform( M_transform );
+        if ( Options::instance().antialiasing() )
+        {
+            setAntialiasFlag( painter, true );
+        }
+
+        if ( Options::instance().showBackgroundData() )
+        {
+            drawBackgroundData( painter );
+        }
+        drawData( painter );
+
+        M_data_layer_revision = revision;
+        M_data_layer_flags = flags;
+        M_data_layer_valid = true;
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -209,16 +327,6 @@ EditCanvas::drawField( QPainter & painter )
 
     //painter.fillRect( M_transform.inverted().mapRect( painter.window() ), M_field_brush );
 
-    if ( Options::instance().showBackgroundData() )
-    {
-        drawBackgroundContainedArea( painter );
-    }
-
-    if ( Options::instance().showTriangulation() )
-    {
-        drawContainedArea( painter );
-    }
-
     // set screen coordinates of field
     const double left_x   =  field->ourGoal().x; // - ServerParam::DEFAULT_PITCH_LENGTH * 0.5;
     const double right_x  =  field->oppGoal().x;// + ServerParam::DEFAULT_PITCH_LENGTH * 0.5;
@@ -353,6 +461,65 @@ EditCanvas::drawField( QPainter & painter )
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditCanvas::drawContainedAreas( QPainter & painter )
+{
+    if ( Options::instance().antialiasing() )
+    {
+        setAntialiasFlag( painter, false );
+    }
+
+    if ( Options::instance().showBackgroundData() )
+    {
+        drawBackgroundContainedArea( painter );
+    }
+
+    if ( Options::instance().showTriangulation() )
+    {
+        drawContainedArea( painter );
+    }
+
+    if ( Options::instance().antialiasing() )
+    {
+        setAntialiasFlag( painter, true );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditCanvas::drawHeatMap( QPainter & painter )
+{
+    const Options::HeatMapMode mode = Options::instance().heatMapMode();
+    if ( mode == Options::NO_HEAT_MAP )
+    {
+        return;
+    }
+
+    boost::shared_ptr< EditData > ptr = M_edit_data.lock();
+    if ( ! ptr )
+    {
+        return;
+    }
+
+    M_heat_map->setFormations( ptr->formation(),
+                               ptr->backgroundFormation(),
+                               ptr->dataRevision() );
+
+    const QRectF visible_rect = M_transform.inverted().mapRect( QRectF( this->rect() ) );
+    M_heat_map->draw( painter,
+                      visible_rect,
+                      M_transform.m11(),
+                      mode,
+                      M_heat_map_unum );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -534,22 +701,44 @@ EditCanvas::drawData( QPainter & painter )
         painter.setWorldMatrixEnabled( true );
     }
 
-    //
-    // draw selected sample
-    //
+    if ( Options::instance().antialiasing() )
+    {
+        setAntialiasFlag( painter, true );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
 
-    if ( 0 <= ptr->currentIndex() )
+ */
+void
+EditCanvas::drawSelectedData( QPainter & painter )
+{
+    boost::shared_ptr< EditData > ptr = M_edit_data.lock();
+    if ( ! ptr )
     {
-        SampleDataSet::DataCont::const_iterator it = ptr->samples()->dataCont().begin();
-        std::advance( it, ptr->currentIndex() );
+        return;
+    }
 
-        painter.setPen( Qt::yellow );
-        painter.setBrush( Qt::NoBrush );
+    if ( ptr->currentIndex() < 0 )
+    {
+        return;
+    }
 
-        //painter.drawEllipse( QRectF( it->ball_.x - 1.0, it->ball_.y - 1.0, 2.0, 2.0 ) );
-        painter.drawRect( QRectF( it->ball_.x - 0.05, it->ball_.y - 0.05, 0.1, 0.1 ) );
+    if ( Options::instance().antialiasing() )
+    {
+        setAntialiasFlag( painter, false );
     }
 
+    SampleDataSet::DataCont::const_iterator it = ptr->samples()->dataCont().begin();
+    std::advance( it, ptr->currentIndex() );
+
+    painter.setPen( Qt::yellow );
+    painter.setBrush( Qt::NoBrush );
+
+    //painter.drawEllipse( QRectF( it->ball_.x - 1.0, it->ball_.y - 1.0, 2.0, 2.0 ) );
+    painter.drawRect( QRectF( it->ball_.x - 0.05, it->ball_.y - 0.05, 0.1, 0.1 ) );
+
     if ( Options::instance().antialiasing() )
     {
         setAntialiasFlag( painter, true );
@@ -991,6 +1180,10 @@ EditCanvas::mousePressEvent( QMouseEvent * event )
                 QPointF field_pos = M_transform.inverted().map( QPointF( event->pos() ) );
                 if ( ptr->selectObject( field_pos.x(), field_pos.y() ) )
                 {
+                    if ( ptr->selectType() == EditData::SELECT_PLAYER )
+                    {
+                        M_heat_map_unum = ptr->selectIndex() + 1;
+                    }
                     this->update();
                 }
             }
@@ -1032,6 +1225,10 @@ EditCanvas::mouseReleaseEvent( QMouseEvent * event )
             M_mouse_state[0].setMenuFailed( false );
         }
 
+        // the last drag position must be applied before the release.
+        M_drag_timer->stop();
+        applyDrag();
+
         if ( boost::shared_ptr< EditData > ptr = M_edit_data.lock() )
         {
             if ( ptr->selectType() == EditData::SELECT_SAMPLE
@@ -1076,13 +1273,7 @@ EditCanvas::mouseMoveEvent( QMouseEvent * event )
     {
         if ( event->modifiers() == 0 )
         {
-            boost::shared_ptr< EditData > ptr = M_edit_data.lock();
-            if ( ptr
-                 && ptr->moveSelectObjectTo( field_pos.x(), field_pos.y() ) )
-            {
-                emit objectMoved();
-                this->update();
-            }
+            requestDrag( field_pos );
         }
         else if ( event->modifiers() & Qt::ControlModifier )
         {
@@ -1106,6 +1297,61 @@ EditCanvas::mouseMoveEvent( QMouseEvent * event )
 }
 
 
+/*-------------------------------------------------------------------*/
+/*!
+  \brief store the drag target. only the latest target is evaluated
+  in the next frame.
+ */
+void
+EditCanvas::requestDrag( const QPointF & field_pos )
+{
+    M_drag_target = field_pos;
+    M_drag_pending = true;
+
+    if ( ! M_drag_timer->isActive() )
+    {
+        M_drag_timer->start();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditCanvas::applyDrag()
+{
+    if ( ! M_drag_pending )
+    {
+        return;
+    }
+
+    M_drag_pending = false;
+
+    boost::shared_ptr< EditData > ptr = M_edit_data.lock();
+    if ( ptr
+         && ptr->moveSelectObjectTo( M_drag_target.x(), M_drag_target.y() ) )
+    {
+        this->update();
+
+        // dependent views are updated when the event queue becomes idle.
+        if ( ! M_moved_timer->isActive() )
+        {
+            M_moved_timer->start();
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditCanvas::notifyObjectMoved()
+{
+    emit objectMoved();
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
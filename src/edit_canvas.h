@@ -42,6 +42,7 @@
 #include <QBrush>
 #include <QPen>
 #include <QFont>
+#include <QPixmap>
 #include <QPointF>
 
 #include "mouse_state.h"
@@ -51,8 +52,10 @@
 #include <Field.h>
 
 class QPainter;
+class QTimer;
 
 class EditData;
+class HeatMap;
 class MainWindow;
 
 /*!
@@ -101,9 +104,31 @@ private:
     QBrush M_background_symmetry_brush;
     QPen M_background_font_pen;
 
+    //
+    // cached layers
+    //
+    QPixmap M_field_layer; //!< field lines and goals
+    QPixmap M_data_layer; //!< triangulation, samples and background data
+    QTransform M_layer_transform; //!< transform used to render the cached layers
+    bool M_field_layer_valid;
+    bool M_data_layer_valid;
+    unsigned long M_data_layer_revision; //!< EditData revision of the cached data layer
+    int M_data_layer_flags; //!< drawing options of the cached data layer
+
     //! 0: left, 1: middle, 2: right
     MouseState M_mouse_state[3];
 
+    //
+    // drag coalescing
+    //
+    QPointF M_drag_target; //!< latest requested position of the dragged object
+    bool M_drag_pending; //!< true if M_drag_target is not applied yet
+    QTimer * M_drag_timer; //!< fires once per frame while dragging
+    QTimer * M_moved_timer; //!< fires when the event queue becomes idle
+
+    HeatMap * M_heat_map; //!< formation overlay evaluated by the thread pool
+    int M_heat_map_unum; //!< last clicked player number. 0 means no player.
+
     // not used
     EditCanvas( const EditCanvas & );
     const EditCanvas & operator=( const EditCanvas & );
@@ -120,6 +145,7 @@ public:
     void setData( boost::shared_ptr< EditData > ptr )
       {
           M_edit_data = ptr;
+          M_data_layer_valid = false;
       }
 
 private:
@@ -128,9 +154,15 @@ private:
     void setAntialiasFlag( QPainter & painter,
                            bool on );
 
+    int dataLayerFlags() const;
+    void updateLayers();
+
     void drawField( QPainter & painter );
+    void drawContainedAreas( QPainter & painter );
+    void drawHeatMap( QPainter & painter );
     void drawContainedArea( QPainter & painter );
     void drawData( QPainter & painter );
+    void drawSelectedData( QPainter & painter );
     void drawPlayers( QPainter & painter );
     void drawBall( QPainter & painter );
     void drawConstraintSelection( QPainter & painter );
@@ -141,6 +173,8 @@ private:
 
     void setFocusPoint( const QPoint & pos );
 
+    void requestDrag( const QPointF & field_pos );
+
 protected:
 
     void paintEvent( QPaintEvent * );
@@ -159,6 +193,11 @@ public slots:
     void zoomOut();
     void fitToScreen();
 
+private slots:
+
+    void applyDrag();
+    void notifyObjectMoved();
+
 signals:
     void objectMoved();
     void mouseMoved( const QPointF & pos );
@@ -33,9 +33,6 @@
 #include <config.h>
 #endif
 
-#include <QDateTime>
-#include <QFile>
-
 #include "edit_data.h"
 
 #include "options.h"
@@ -48,6 +45,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <limits>
 
 using namespace rcsc;
 using namespace rcsc::formation;
@@ -57,6 +55,28 @@ const double EditData::MAX_Y = _FIELD_HEIGHT * 0.5 + 0.2;
 
 namespace {
 
+inline
+bool
+is_same_data( const SampleData & lhs,
+              const SampleData & rhs )
+{
+    if ( ! lhs.ball_.equals( rhs.ball_ )
+         || lhs.players_.size() != rhs.players_.size() )
+    {
+        return false;
+    }
+
+    for ( size_t i = 0; i < lhs.players_.size(); ++i )
+    {
+        if ( ! lhs.players_[i].equals( rhs.players_[i] ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 inline
 Vector2D
 round_coordinates( const double & x,
@@ -86,6 +106,7 @@ EditData::EditData()
     , M_constraint_origin_index( -1 )
     , M_constraint_terminal_index( -1 )
     , M_constraint_terminal( Vector2D::INVALIDATED )
+    , M_data_revision( 0 )
 {
     init();
 }
@@ -124,6 +145,7 @@ EditData::init()
     M_select_index = 0;
 
     M_triangulation.clear();
+    ++M_data_revision;
 }
 
 /*-------------------------------------------------------------------*/
@@ -156,28 +178,6 @@ EditData::createFormation( const QString & type_name )
     train();
 }
 
-/*-------------------------------------------------------------------*/
-/*!
-
- */
-void
-EditData::backup( const QString & filepath )
-{
-    if ( filepath.isEmpty() )
-    {
-        return;
-    }
-
-    QString backup_filepath = filepath;
-    backup_filepath += QDateTime::currentDateTime().toString( QString( ".yyyyMMdd-hhmmss" ) );
-
-    if ( ! QFile::copy( filepath, backup_filepath ) )
-    {
-        std::cerr << "Failed to backup the file [" << filepath.toStdString()  << "]"
-                  << std::endl;
-    }
-}
-
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -194,9 +194,20 @@ EditData::openConf( const QString & filepath )
         return false;
     }
 
+    return readConf( fin, filepath );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+EditData::readConf( std::istream & is,
+                    const QString & filepath )
+{
     M_samples.reset();
 
-    M_formation = Formation::create( fin );
+    M_formation = Formation::create( is );
     if ( ! M_formation )
     {
         std::cerr << "Failed to read a formation. ["
@@ -205,14 +216,13 @@ EditData::openConf( const QString & filepath )
         return false;
     }
 
-    fin.seekg( 0 );
-    if ( ! M_formation->read( fin ) )
+    is.clear();
+    is.seekg( 0 );
+    if ( ! M_formation->read( is ) )
     {
-        fin.close();
         M_formation.reset();
         return false;
     }
-    fin.close();
 
     init();
     M_filepath = filepath;
@@ -236,6 +246,7 @@ EditData::openData( const QString & filepath )
     }
 
     M_triangulation.clear();
+    ++M_data_revision;
 
     M_samples = SampleDataSet::Ptr( new SampleDataSet() );
     if ( ! M_samples->open( filepath.toStdString() ) )
@@ -269,6 +280,7 @@ EditData::openBackgroundConf( const QString & filepath )
     }
 
     M_background_formation = Formation::create( fin );
+    ++M_data_revision;
     if ( ! M_background_formation )
     {
         std::cerr << "Failed to read a background formation. ["
@@ -341,11 +353,6 @@ EditData::saveConfAs( const QString & filepath )
         return false;
     }
 
-    if ( Options::instance().autoBackup() )
-    {
-        backup( M_filepath );
-    }
-
     std::ofstream fout( filepath.toStdString().c_str() );
     if ( ! fout.is_open() )
     {
@@ -426,6 +433,7 @@ EditData::updateTriangulation()
 
     M_triangulation.compute();
     //M_triangulation.updateHalfEdges();
+    ++M_data_revision;
 
     std::cerr << "updateTriangulation"
 //               << "\n  vertices=" << M_triangulation.indexedVertices().size()
@@ -452,6 +460,8 @@ EditData::updateRoleData( const int unum,
     if ( M_formation->updateRole( unum, symmetry_unum, role_name ) )
     {
         M_conf_changed = true;
+        // the formation cloned by the running training must not overwrite this change.
+        ++M_data_revision;
     }
 }
 
@@ -677,7 +687,8 @@ EditData::selectObject( const double & x,
                         const double & y )
 {
     const Vector2D pos( x, y );
-	const double dist2_thr = .1 * .1;
+    const double dist_thr = .1;
+    const double dist2_thr = dist_thr * dist_thr;
 
     double mindist2 = 200.0 * 200.0;
 
@@ -688,21 +699,12 @@ EditData::selectObject( const double & x,
         //
         if ( M_samples )
         {
-            size_t index = 0;
-            const SampleDataSet::DataCont::const_iterator d_end = M_samples->dataCont().end();
-            for ( SampleDataSet::DataCont::const_iterator d = M_samples->dataCont().begin();
-                  d != d_end;
-                  ++d, ++index )
+            SampleDataSet::IndexData d = M_samples->nearestData( pos, dist_thr );
+            if ( d.second )
             {
-                double d2 = d->ball_.dist2( pos );
-                if ( d2 < dist2_thr
-                     && d2 < mindist2 )
-                {
-                    M_select_type = SELECT_SAMPLE;
-                    M_select_index = index; //std::distance( M_triangulation.indexedVertices().begin(), v );
-                    M_constraint_origin_index = index;
-                    mindist2 = d2;
-                }
+                M_select_type = SELECT_SAMPLE;
+                M_select_index = d.first;
+                M_constraint_origin_index = d.first;
             }
         }
     }
@@ -783,12 +785,16 @@ EditData::releaseObject()
 SampleDataSet::ErrorType
 EditData::addData()
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
         return SampleDataSet::NO_FORMATION;
     }
 
+    const size_t old_size = M_samples->dataCont().size();
+
     SampleDataSet::ErrorType err
         = M_samples->addData( *M_formation,
                               M_state,
@@ -798,11 +804,14 @@ EditData::addData()
 
     }
 
+    recordInsertedData( old_size, M_samples->dataCont().size() - old_size );
+
     M_state = M_samples->dataCont().back();
     M_current_index = M_samples->dataCont().size() - 1;
 
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
@@ -813,6 +822,8 @@ EditData::addData()
 SampleDataSet::ErrorType
 EditData::insertData( const int idx )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
@@ -824,14 +835,21 @@ EditData::insertData( const int idx )
         return SampleDataSet::INVALID_INDEX;
     }
 
+    const size_t old_size = M_samples->dataCont().size();
+
     SampleDataSet::ErrorType err
         = M_samples->insertData( *M_formation,
                                  static_cast< size_t >( idx ),
                                  M_state,
                                  Options::instance().symmetryMode() );
 
+    // the symmetry data can fail after the data is inserted.
+    recordInsertedData( static_cast< size_t >( idx ),
+                        M_samples->dataCont().size() - old_size );
+
     if ( err != SampleDataSet::NO_ERROR )
     {
+        trainIfChanged();
         return err;
     }
 
@@ -839,6 +857,7 @@ EditData::insertData( const int idx )
 
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
@@ -849,25 +868,25 @@ EditData::insertData( const int idx )
 SampleDataSet::ErrorType
 EditData::replaceData( const int idx )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
         return SampleDataSet::NO_FORMATION;
     }
 
-    SampleDataSet::ErrorType err
-        = M_samples->replaceData( *M_formation,
-                                  static_cast< size_t >( idx ),
-                                  M_state,
-                                  Options::instance().symmetryMode() );
+    SampleDataSet::ErrorType err = replaceSample( idx, M_state );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
+        trainIfChanged();
         return err;
     }
 
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
@@ -880,6 +899,8 @@ EditData::replaceBall( const int idx,
                        const double & x,
                        const double & y )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
@@ -896,19 +917,17 @@ EditData::replaceBall( const int idx,
     SampleData tmp = *d;
     tmp.ball_.assign( x, y );
 
-    SampleDataSet::ErrorType err
-        = M_samples->replaceData( *M_formation,
-                                  static_cast< size_t >( idx ),
-                                  tmp,
-                                  Options::instance().symmetryMode() );
+    SampleDataSet::ErrorType err = replaceSample( idx, tmp );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
+        trainIfChanged();
         return err;
     }
 
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
@@ -922,6 +941,8 @@ EditData::replacePlayer( const int idx,
                          const double & x,
                          const double & y )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
@@ -948,22 +969,189 @@ EditData::replacePlayer( const int idx,
         return SampleDataSet::INVALID_INDEX;
     }
 
-    SampleDataSet::ErrorType err
-        = M_samples->replaceData( *M_formation,
-                                  static_cast< size_t >( idx ),
-                                  tmp,
-                                  Options::instance().symmetryMode() );
+    SampleDataSet::ErrorType err = replaceSample( idx, tmp );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
+        trainIfChanged();
         return err;
     }
 
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+  replace the sample and record the changes, including the symmetry data
+  replaced or added by SampleDataSet::replaceData().
+ */
+SampleDataSet::ErrorType
+EditData::replaceSample( const int idx,
+                         const SampleData & data )
+{
+    const SampleData * d = ( idx < 0
+                             ? static_cast< const SampleData * >( 0 )
+                             : M_samples->data( static_cast< size_t >( idx ) ) );
+    if ( ! d )
+    {
+        return SampleDataSet::INVALID_INDEX;
+    }
+
+    const SampleData original_data = *d;
+    const size_t old_size = M_samples->dataCont().size();
+    const bool symmetry = Options::instance().symmetryMode();
+
+    int symmetry_idx = -1;
+    SampleData symmetry_data;
+    if ( symmetry )
+    {
+        symmetry_idx = findSymmetryData( static_cast< size_t >( idx ), data, original_data );
+        if ( symmetry_idx >= 0 )
+        {
+            symmetry_data = *M_samples->data( static_cast< size_t >( symmetry_idx ) );
+        }
+    }
+
+    SampleDataSet::ErrorType err
+        = M_samples->replaceData( *M_formation,
+                                  static_cast< size_t >( idx ),
+                                  data,
+                                  symmetry );
+
+    // the symmetry data can fail after the data at idx is replaced.
+    // record all changes regardless of the result.
+
+    const SampleData & new_data = *M_samples->data( static_cast< size_t >( idx ) );
+    if ( ! is_same_data( new_data, original_data ) )
+    {
+        Change change( Change::REPLACE_DATA );
+        change.index_ = idx;
+        change.old_data_ = original_data;
+        change.new_data_ = new_data;
+        M_delta.push_back( change );
+    }
+
+    if ( M_samples->dataCont().size() > old_size )
+    {
+        recordInsertedData( old_size, M_samples->dataCont().size() - old_size );
+    }
+    else if ( symmetry_idx >= 0 )
+    {
+        const SampleData & replaced = *M_samples->data( static_cast< size_t >( symmetry_idx ) );
+        if ( ! is_same_data( replaced, symmetry_data ) )
+        {
+            Change symmetry_change( Change::REPLACE_DATA );
+            symmetry_change.index_ = symmetry_idx;
+            symmetry_change.old_data_ = symmetry_data;
+            symmetry_change.new_data_ = replaced;
+            M_delta.push_back( symmetry_change );
+        }
+    }
+
+    return err;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  same search as SampleDataSet::replaceSymmetryData(), which is done
+  after the sample at idx is replaced by data.
+ */
+int
+EditData::findSymmetryData( const size_t idx,
+                            const SampleData & data,
+                            const SampleData & original_data ) const
+{
+    if ( data.ball_.absY() < 0.5 )
+    {
+        return -1;
+    }
+
+    const Vector2D pos( original_data.ball_.x, - original_data.ball_.y );
+    const double dist_thr2 = SampleDataSet::NEAR_DIST_THR * SampleDataSet::NEAR_DIST_THR;
+
+    int result = -1;
+    double min_dist2 = std::numeric_limits< double >::max();
+
+    size_t i = 0;
+    for ( SampleDataSet::DataCont::const_iterator it = M_samples->dataCont().begin(), end = M_samples->dataCont().end();
+          it != end;
+          ++it, ++i )
+    {
+        const double d2 = ( i == idx
+                            ? data.ball_.dist2( pos )
+                            : it->ball_.dist2( pos ) );
+        if ( d2 < dist_thr2
+             && d2 < min_dist2 )
+        {
+            min_dist2 = d2;
+            result = static_cast< int >( i );
+        }
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditData::recordInsertedData( const size_t first,
+                              const size_t count )
+{
+    if ( count == 0 )
+    {
+        return;
+    }
+
+    SampleDataSet::DataCont::const_iterator it = M_samples->dataCont().begin();
+    std::advance( it, first );
+
+    for ( size_t i = 0; i < count; ++i, ++it )
+    {
+        Change change( Change::INSERT_DATA );
+        change.index_ = static_cast< int >( first + i );
+        change.new_data_ = *it;
+        M_delta.push_back( change );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  the constraints connected to the sample are recorded at first, so that
+  they are restored after the sample when the delta is reverted.
+ */
+void
+EditData::recordRemovedData( const size_t idx )
+{
+    const SampleData * d = M_samples->data( idx );
+    if ( ! d )
+    {
+        return;
+    }
+
+    for ( SampleDataSet::Constraints::const_iterator c = M_samples->constraints().begin(), end = M_samples->constraints().end();
+          c != end;
+          ++c )
+    {
+        if ( c->first == d
+             || c->second == d )
+        {
+            Change change( Change::REMOVE_CONSTRAINT );
+            change.constraint_ = std::make_pair( c->first->index_, c->second->index_ );
+            M_delta.push_back( change );
+        }
+    }
+
+    Change change( Change::REMOVE_DATA );
+    change.index_ = static_cast< int >( idx );
+    change.old_data_ = *d;
+    M_delta.push_back( change );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -971,17 +1159,25 @@ EditData::replacePlayer( const int idx,
 SampleDataSet::ErrorType
 EditData::deleteData( const int idx )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
         return SampleDataSet::NO_FORMATION;
     }
 
+    if ( idx >= 0 )
+    {
+        recordRemovedData( static_cast< size_t >( idx ) );
+    }
+
     SampleDataSet::ErrorType err
         = M_samples->removeData( static_cast< size_t >( idx ) );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
+        M_delta.clear();
         return err;
     }
 
@@ -989,6 +1185,7 @@ EditData::deleteData( const int idx )
 
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
@@ -1000,6 +1197,8 @@ SampleDataSet::ErrorType
 EditData::changeDataIndex( const int old_idx,
                            const int new_idx )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
@@ -1024,10 +1223,16 @@ EditData::changeDataIndex( const int old_idx,
     std::cerr << "move data from " << old_idx << " to " << new_idx
               << std::endl;
 
+    Change change( Change::MOVE_DATA );
+    change.index_ = old_idx;
+    change.new_index_ = new_idx;
+    M_delta.push_back( change );
+
     M_current_index = new_idx;
 
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
@@ -1039,6 +1244,8 @@ rcsc::formation::SampleDataSet::ErrorType
 EditData::addConstraint( const int origin_idx,
                          const int terminal_idx )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
@@ -1058,8 +1265,14 @@ EditData::addConstraint( const int origin_idx,
     std::cerr << "add constraint (" << origin << ',' << terminal << ')'
               << std::endl;
 
+    Change change( Change::ADD_CONSTRAINT );
+    change.constraint_ = std::make_pair( static_cast< int >( origin ),
+                                         static_cast< int >( terminal ) );
+    M_delta.push_back( change );
+
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
@@ -1072,12 +1285,24 @@ EditData::replaceConstraint( const int idx,
                              const int origin_idx,
                              const int terminal_idx )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
         return SampleDataSet::NO_FORMATION;
     }
 
+    if ( idx < 0
+         || static_cast< size_t >( idx ) >= M_samples->constraints().size() )
+    {
+        return SampleDataSet::INVALID_INDEX;
+    }
+
+    const SampleDataSet::Constraint & old_constraint = M_samples->constraints()[idx];
+    const std::pair< int, int > old_indices( old_constraint.first->index_,
+                                             old_constraint.second->index_ );
+
     SampleDataSet::ErrorType err
         = M_samples->replaceConstraint( static_cast< size_t >( idx ),
                                         static_cast< size_t >( origin_idx ),
@@ -1092,8 +1317,14 @@ EditData::replaceConstraint( const int idx,
               << " to (" << origin_idx << ',' << terminal_idx << ')'
               << std::endl;
 
+    Change change( Change::REPLACE_CONSTRAINT );
+    change.old_constraint_ = old_indices;
+    change.constraint_ = std::make_pair( origin_idx, terminal_idx );
+    M_delta.push_back( change );
+
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
@@ -1105,6 +1336,8 @@ rcsc::formation::SampleDataSet::ErrorType
 EditData::deleteConstraint( const int origin_idx,
                             const int terminal_idx )
 {
+    M_delta.clear();
+
     if ( ! M_formation
          || ! M_samples )
     {
@@ -1123,11 +1356,323 @@ EditData::deleteConstraint( const int origin_idx,
     std::cerr << "delete constraint (" << origin_idx << ',' << terminal_idx << ')'
               << std::endl;
 
+    Change change( Change::REMOVE_CONSTRAINT );
+    change.constraint_ = std::make_pair( origin_idx, terminal_idx );
+    M_delta.push_back( change );
+
     train();
 
+    ++M_data_revision;
     return SampleDataSet::NO_ERROR;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+size_t
+EditData::importSamples( const SampleHarvester & harvester )
+{
+    M_delta.clear();
+
+    if ( ! M_formation
+         || ! M_samples )
+    {
+        return 0;
+    }
+
+    const size_t old_size = M_samples->dataCont().size();
+    const size_t capacity = ( old_size < SampleDataSet::MAX_DATA_SIZE
+                              ? SampleDataSet::MAX_DATA_SIZE - old_size
+                              : 0 );
+
+    size_t count = 0;
+    if ( harvester.samples().size() <= capacity )
+    {
+        count = harvester.appendTo( *M_formation, *M_samples );
+    }
+    else
+    {
+        // select the samples that cover the harvested ball area evenly
+        SampleReducer reducer;
+        const std::vector< size_t > indices
+            = reducer.select( harvester.samples(), std::vector< size_t >(), capacity );
+
+        for ( std::vector< size_t >::const_iterator it = indices.begin(), end = indices.end();
+              it != end;
+              ++it )
+        {
+            if ( M_samples->addData( *M_formation, harvester.samples()[*it], false )
+                 == SampleDataSet::NO_ERROR )
+            {
+                ++count;
+            }
+        }
+    }
+
+    if ( count == 0 )
+    {
+        return 0;
+    }
+
+    std::cerr << "import " << count << " samples" << std::endl;
+
+    recordInsertedData( old_size, count );
+
+    train();
+
+    ++M_data_revision;
+    return count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  The unselected samples are removed from the current data set one by one,
+  so that the removal can be recorded as the delta.
+ */
+size_t
+EditData::reduceSamples( const SampleReducer & reducer )
+{
+    M_delta.clear();
+
+    if ( ! M_formation
+         || ! M_samples )
+    {
+        return 0;
+    }
+
+    const size_t old_size = M_samples->dataCont().size();
+
+    SampleDataSet::Ptr reduced = reducer.reduce( *M_formation, *M_samples );
+    if ( reduced->dataCont().size() >= old_size )
+    {
+        return 0;
+    }
+
+    //
+    // the reduced set keeps the order of the samples.
+    //
+    std::vector< size_t > removed;
+    {
+        SampleDataSet::DataCont::const_iterator kept = reduced->dataCont().begin();
+        size_t i = 0;
+        for ( SampleDataSet::DataCont::const_iterator it = M_samples->dataCont().begin(), end = M_samples->dataCont().end();
+              it != end;
+              ++it, ++i )
+        {
+            if ( kept != reduced->dataCont().end()
+                 && kept->ball_.equals( it->ball_ ) )
+            {
+                ++kept;
+            }
+            else
+            {
+                removed.push_back( i );
+            }
+        }
+    }
+
+    for ( std::vector< size_t >::reverse_iterator it = removed.rbegin(), end = removed.rend();
+          it != end;
+          ++it )
+    {
+        recordRemovedData( *it );
+        M_samples->removeData( *it );
+    }
+
+    std::cerr << "reduce " << old_size << " -> " << M_samples->dataCont().size()
+              << " samples" << std::endl;
+
+    M_current_index = -1;
+
+    train();
+
+    ++M_data_revision;
+    return removed.size();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  some operations return the error after the partial change.
+ */
+void
+EditData::trainIfChanged()
+{
+    if ( ! M_delta.empty() )
+    {
+        train();
+        ++M_data_revision;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+EditData::takeDelta( Delta * delta )
+{
+    delta->clear();
+    delta->swap( M_delta );
+    return ! delta->empty();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+EditData::applyDelta( const Delta & delta,
+                      const bool revert )
+{
+    M_delta.clear();
+
+    if ( ! M_formation
+         || ! M_samples )
+    {
+        return false;
+    }
+
+    bool result = true;
+    if ( revert )
+    {
+        for ( Delta::const_reverse_iterator it = delta.rbegin(), end = delta.rend();
+              it != end;
+              ++it )
+        {
+            if ( ! applyChange( *it, true ) )
+            {
+                result = false;
+                break;
+            }
+        }
+    }
+    else
+    {
+        for ( Delta::const_iterator it = delta.begin(), end = delta.end();
+              it != end;
+              ++it )
+        {
+            if ( ! applyChange( *it, false ) )
+            {
+                result = false;
+                break;
+            }
+        }
+    }
+
+    M_current_index = -1;
+    if ( ! delta.empty() )
+    {
+        const Change & last = ( revert ? delta.front() : delta.back() );
+        const int idx = ( last.type_ == Change::MOVE_DATA && ! revert
+                          ? last.new_index_
+                          : last.index_ );
+        if ( 0 <= idx
+             && static_cast< size_t >( idx ) < M_samples->dataCont().size() )
+        {
+            M_current_index = idx;
+        }
+    }
+
+    train();
+
+    ++M_data_revision;
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+EditData::applyChange( const Change & change,
+                       const bool revert )
+{
+    SampleDataSet::ErrorType err = SampleDataSet::NO_ERROR;
+
+    switch ( change.type_ ) {
+    case Change::INSERT_DATA:
+    case Change::REMOVE_DATA:
+        if ( ( change.type_ == Change::INSERT_DATA ) != revert )
+        {
+            err = M_samples->insertData( *M_formation,
+                                         static_cast< size_t >( change.index_ ),
+                                         ( revert ? change.old_data_ : change.new_data_ ),
+                                         false );
+        }
+        else
+        {
+            err = M_samples->removeData( static_cast< size_t >( change.index_ ) );
+        }
+        break;
+    case Change::REPLACE_DATA:
+        // the symmetry data replaced by the same operation may be
+        // too near to this data until it is also replaced.
+        err = M_samples->restoreData( static_cast< size_t >( change.index_ ),
+                                      ( revert ? change.old_data_ : change.new_data_ ) );
+        break;
+    case Change::MOVE_DATA:
+        {
+            const int from = ( revert ? change.new_index_ : change.index_ );
+            const int to = ( revert ? change.index_ : change.new_index_ );
+            err = M_samples->changeDataIndex( static_cast< size_t >( from ),
+                                              static_cast< size_t >( to > from ? to + 1 : to ) );
+        }
+        break;
+    case Change::ADD_CONSTRAINT:
+    case Change::REMOVE_CONSTRAINT:
+        if ( ( change.type_ == Change::ADD_CONSTRAINT ) != revert )
+        {
+            err = M_samples->addConstraint( static_cast< size_t >( change.constraint_.first ),
+                                            static_cast< size_t >( change.constraint_.second ) );
+        }
+        else
+        {
+            err = M_samples->removeConstraint( static_cast< size_t >( change.constraint_.first ),
+                                               static_cast< size_t >( change.constraint_.second ) );
+        }
+        break;
+    case Change::REPLACE_CONSTRAINT:
+        {
+            const std::pair< int, int > & from = ( revert ? change.constraint_ : change.old_constraint_ );
+            const std::pair< int, int > & to = ( revert ? change.old_constraint_ : change.constraint_ );
+
+            err = SampleDataSet::INVALID_INDEX;
+            size_t idx = 0;
+            for ( SampleDataSet::Constraints::const_iterator c = M_samples->constraints().begin(), end = M_samples->constraints().end();
+                  c != end;
+                  ++c, ++idx )
+            {
+                if ( ( c->first->index_ == from.first && c->second->index_ == from.second )
+                     || ( c->first->index_ == from.second && c->second->index_ == from.first ) )
+                {
+                    err = M_samples->replaceConstraint( idx,
+                                                        static_cast< size_t >( to.first ),
+                                                        static_cast< size_t >( to.second ) );
+                    break;
+                }
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    if ( err != SampleDataSet::NO_ERROR )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " ***ERROR*** could not " << ( revert ? "revert" : "apply" )
+                  << " the change. type=" << change.type_
+                  << " index=" << change.index_
+                  << " error=" << err
+                  << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1259,3 +1804,23 @@ EditData::train()
     updatePlayerPosition();
     updateTriangulation();
 }
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditData::setTrainedFormation( Formation::Ptr formation )
+{
+    if ( ! formation )
+    {
+        return;
+    }
+
+    formation->setTrainingObserver( static_cast< Formation::TrainingObserver * >( 0 ) );
+    formation->setSamples( M_samples );
+    M_formation = formation;
+    M_conf_changed = true;
+    updatePlayerPosition();
+    updateTriangulation();
+}
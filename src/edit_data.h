@@ -35,6 +35,8 @@
 #include <QString>
 
 #include <rcsc/formation/sample_data.h>
+#include <rcsc/formation/sample_harvester.h>
+#include <rcsc/formation/sample_reducer.h>
 #include <rcsc/formation/formation.h>
 //#include <rcsc/geom/cdt/triangulation.h>
 #include <rcsc/geom/triangulation.h>
@@ -60,6 +62,45 @@ public:
         NO_SELECT,
     };
 
+    /*!
+      \struct Change
+      \brief one primitive change of the sample data set.
+
+      Constraints are identified by the indices of their samples, because
+      the order of the constraint container is not kept by undo/redo.
+     */
+    struct Change {
+        enum Type {
+            INSERT_DATA, //!< new_data_ is inserted at index_
+            REMOVE_DATA, //!< old_data_ at index_ is removed
+            REPLACE_DATA, //!< old_data_ at index_ is replaced by new_data_
+            MOVE_DATA, //!< the sample at index_ is moved to new_index_
+            ADD_CONSTRAINT, //!< constraint_ is added
+            REMOVE_CONSTRAINT, //!< constraint_ is removed
+            REPLACE_CONSTRAINT //!< old_constraint_ is replaced by constraint_
+        };
+
+        Type type_;
+        int index_;
+        int new_index_;
+        rcsc::formation::SampleData old_data_;
+        rcsc::formation::SampleData new_data_;
+        std::pair< int, int > constraint_;
+        std::pair< int, int > old_constraint_;
+
+        explicit
+        Change( const Type type )
+            : type_( type ),
+              index_( -1 ),
+              new_index_( -1 ),
+              constraint_( -1, -1 ),
+              old_constraint_( -1, -1 )
+          { }
+    };
+
+    //! changes made by one edit operation, in the applied order.
+    typedef std::vector< Change > Delta;
+
 private:
 
     QString M_filepath;
@@ -83,6 +124,12 @@ private:
     size_t M_constraint_terminal_index;
     rcsc::Vector2D M_constraint_terminal;
 
+    //! incremented whenever samples, roles, triangulation or background data are changed.
+    unsigned long M_data_revision;
+
+    //! changes made by the last edit operation. taken by takeDelta().
+    Delta M_delta;
+
     // not used
     EditData( const EditData & );
     EditData & operator=( const EditData & );
@@ -95,7 +142,6 @@ public:
 private:
 
     void init();
-    void backup( const QString & filepath );
 
 public:
 
@@ -170,7 +216,21 @@ public:
           return M_constraint_terminal;
       }
 
+    unsigned long dataRevision() const
+      {
+          return M_data_revision;
+      }
+
     bool openConf( const QString & filepath );
+
+    /*!
+      \brief read the formation from the stream, e.g. the snapshot in the edit journal.
+      \param is input stream. must be seekable.
+      \param filepath conf file path associated with the read formation.
+      \return true if successfully read.
+     */
+    bool readConf( std::istream & is,
+                   const QString & filepath );
     bool saveConf();
     bool saveConfAs( const QString & filepath );
 
@@ -178,10 +238,38 @@ public:
 
     bool openBackgroundConf( const QString & filepath );
 
+    /*!
+      \brief move the changes made by the last edit operation to the caller.
+      \param delta pointer to the destination. the old content is discarded.
+      \return true if any change exists.
+     */
+    bool takeDelta( Delta * delta );
+
+    /*!
+      \brief apply or revert the recorded changes, and train the formation once.
+      \param delta changes recorded by takeDelta()
+      \param revert if true, the inverse changes are applied in the reverse order.
+      \return true if all changes are successfully applied.
+     */
+    bool applyDelta( const Delta & delta,
+                     const bool revert );
+
 private:
     void updatePlayerPosition();
     void updateTriangulation();
 
+    bool applyChange( const Change & change,
+                      const bool revert );
+    void recordInsertedData( const size_t first,
+                             const size_t count );
+    void recordRemovedData( const size_t idx );
+    void trainIfChanged();
+    int findSymmetryData( const size_t idx,
+                          const rcsc::formation::SampleData & data,
+                          const rcsc::formation::SampleData & original_data ) const;
+    rcsc::formation::SampleDataSet::ErrorType replaceSample( const int idx,
+                                                             const rcsc::formation::SampleData & data );
+
 public:
 
     void updateRoleData( const int unum,
@@ -226,10 +314,14 @@ public:
     rcsc::formation::SampleDataSet::ErrorType deleteConstraint( const int origin_idx,
                                                                 const int terminal_idx );
 
+    size_t importSamples( const rcsc::formation::SampleHarvester & harvester );
+    size_t reduceSamples( const rcsc::formation::SampleReducer & reducer );
+
 
     bool setCurrentIndex( const int idx );
     void reverseY();
     void train();
+    void setTrainedFormation( rcsc::Formation::Ptr formation );
 };
 
 #endif
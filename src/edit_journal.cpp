@@ -0,0 +1,601 @@
+// -*-c++-*-
+
+/*!
+  \file edit_journal.cpp
+  \brief append-only edit journal writer class Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <QDir>
+#include <QMutexLocker>
+
+#include "edit_journal.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace rcsc;
+using namespace rcsc::formation;
+
+namespace {
+
+//! the first line of the journal file
+const char * JOURNAL_HEADER = "fedit2-journal 1";
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+print_data( std::ostream & os,
+            const SampleData & data )
+{
+    os << ' ' << data.players_.size()
+       << ' ' << data.ball_.x << ' ' << data.ball_.y;
+
+    for ( SampleData::PlayerCont::const_iterator p = data.players_.begin();
+          p != data.players_.end();
+          ++p )
+    {
+        os << ' ' << p->x << ' ' << p->y;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+read_data( std::istream & is,
+           SampleData * data )
+{
+    size_t size = 0;
+    if ( ! ( is >> size >> data->ball_.x >> data->ball_.y )
+         || size > 11 )
+    {
+        return false;
+    }
+
+    data->players_.clear();
+    for ( size_t i = 0; i < size; ++i )
+    {
+        Vector2D p;
+        if ( ! ( is >> p.x >> p.y ) )
+        {
+            return false;
+        }
+        data->players_.push_back( p );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+read_change( const std::string & line,
+             EditData::Change * change )
+{
+    std::istringstream is( line );
+
+    int type = -1;
+    if ( ! ( is >> type )
+         || type < EditData::Change::INSERT_DATA
+         || EditData::Change::REPLACE_CONSTRAINT < type )
+    {
+        return false;
+    }
+
+    change->type_ = static_cast< EditData::Change::Type >( type );
+
+    if ( ! ( is >> change->index_ >> change->new_index_
+             >> change->constraint_.first >> change->constraint_.second
+             >> change->old_constraint_.first >> change->old_constraint_.second ) )
+    {
+        return false;
+    }
+
+    return ( read_data( is, &change->old_data_ )
+             && read_data( is, &change->new_data_ ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+read_record( std::istream & is,
+             EditJournal::Record * record )
+{
+    std::string line;
+    if ( ! std::getline( is, line ) )
+    {
+        return false;
+    }
+
+    int seq = 0;
+    int revert = 0;
+    unsigned long size = 0;
+    if ( std::sscanf( line.c_str(), " Record %d %d %lu",
+                      &seq, &revert, &size ) != 3 )
+    {
+        return false;
+    }
+
+    record->revert_ = ( revert != 0 );
+    record->delta_.clear();
+    record->delta_.reserve( size );
+
+    for ( unsigned long i = 0; i < size; ++i )
+    {
+        EditData::Change change( EditData::Change::INSERT_DATA );
+        if ( ! std::getline( is, line )
+             || ! read_change( line, &change ) )
+        {
+            return false;
+        }
+        record->delta_.push_back( change );
+    }
+
+    // the record is valid only if its end line is completely written.
+    int end_seq = 0;
+    if ( ! std::getline( is, line )
+         || is.eof()
+         || std::sscanf( line.c_str(), " End %d", &end_seq ) != 1
+         || end_seq != seq )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+sync_file( std::FILE * fp )
+{
+    if ( std::fflush( fp ) != 0 )
+    {
+        return false;
+    }
+#ifndef _WIN32
+    if ( ::fsync( fileno( fp ) ) != 0 )
+    {
+        return false;
+    }
+#endif
+    return true;
+}
+
+}
+
+const int EditJournal::COMPACTION_SIZE = 256;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+EditJournal::EditJournal( QObject * parent )
+    : QThread( parent ),
+      M_quit( false ),
+      M_file( static_cast< std::FILE * >( 0 ) ),
+      M_record_count( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+EditJournal::~EditJournal()
+{
+    {
+        QMutexLocker lock( &M_mutex );
+        M_quit = true;
+        M_condition.wakeOne();
+    }
+
+    wait();
+    closeFile();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+QString
+EditJournal::path_for( const QString & conf_path )
+{
+    if ( conf_path.isEmpty() )
+    {
+        return QDir::home().filePath( QString( ".fedit2-untitled.journal" ) );
+    }
+
+    return conf_path + QString( ".journal" );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::reset( const QString & path,
+                    const std::string & snapshot )
+{
+    if ( ! M_path.isEmpty()
+         && M_path != path )
+    {
+        enqueue( Request( Request::REMOVE, M_path.toStdString(), std::string() ) );
+    }
+
+    M_path = path;
+    M_record_count = 0;
+
+    if ( M_path.isEmpty() )
+    {
+        return;
+    }
+
+    std::ostringstream os;
+    os << JOURNAL_HEADER << '\n'
+       << "Snapshot " << snapshot.size() << '\n'
+       << snapshot << '\n';
+
+    enqueue( Request( Request::RESET, M_path.toStdString(), os.str() ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::append( const EditData::Delta & delta,
+                     const bool revert )
+{
+    if ( M_path.isEmpty()
+         || delta.empty() )
+    {
+        return;
+    }
+
+    ++M_record_count;
+    enqueue( Request( Request::APPEND,
+                      M_path.toStdString(),
+                      to_record( M_record_count, delta, revert ) ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::remove()
+{
+    if ( M_path.isEmpty() )
+    {
+        return;
+    }
+
+    enqueue( Request( Request::REMOVE, M_path.toStdString(), std::string() ) );
+
+    M_path.clear();
+    M_record_count = 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::string
+EditJournal::to_record( const int seq,
+                        const EditData::Delta & delta,
+                        const bool revert )
+{
+    std::ostringstream os;
+    os.precision( 17 );
+
+    os << "Record " << seq << ' ' << ( revert ? 1 : 0 ) << ' ' << delta.size() << '\n';
+
+    for ( EditData::Delta::const_iterator it = delta.begin();
+          it != delta.end();
+          ++it )
+    {
+        os << static_cast< int >( it->type_ )
+           << ' ' << it->index_ << ' ' << it->new_index_
+           << ' ' << it->constraint_.first << ' ' << it->constraint_.second
+           << ' ' << it->old_constraint_.first << ' ' << it->old_constraint_.second;
+        print_data( os, it->old_data_ );
+        print_data( os, it->new_data_ );
+        os << '\n';
+    }
+
+    os << "End " << seq << '\n';
+
+    return os.str();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+EditJournal::read( const QString & path,
+                   std::string * snapshot,
+                   std::vector< Record > * records )
+{
+    std::ifstream fin( path.toStdString().c_str(),
+                       std::ios_base::in | std::ios_base::binary );
+    if ( ! fin.is_open() )
+    {
+        return false;
+    }
+
+    std::string line;
+    if ( ! std::getline( fin, line )
+         || line != JOURNAL_HEADER )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " *** ERROR *** Illegal journal header. [" << path.toStdString() << "]"
+                  << std::endl;
+        return false;
+    }
+
+    unsigned long size = 0;
+    if ( ! std::getline( fin, line )
+         || std::sscanf( line.c_str(), " Snapshot %lu", &size ) != 1 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " *** ERROR *** Illegal journal snapshot. [" << path.toStdString() << "]"
+                  << std::endl;
+        return false;
+    }
+
+    snapshot->assign( size, '\0' );
+    if ( size > 0
+         && ! fin.read( &(*snapshot)[0], size ) )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " *** ERROR *** Incomplete journal snapshot. [" << path.toStdString() << "]"
+                  << std::endl;
+        return false;
+    }
+
+    // the end of the snapshot line
+    if ( ! std::getline( fin, line ) )
+    {
+        return false;
+    }
+
+    records->clear();
+
+    Record record;
+    while ( read_record( fin, &record ) )
+    {
+        records->push_back( record );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::enqueue( const Request & request )
+{
+    QMutexLocker lock( &M_mutex );
+    M_requests.push_back( request );
+    M_condition.wakeOne();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::run()
+{
+    std::deque< Request > requests;
+
+    QMutexLocker lock( &M_mutex );
+
+    while ( true )
+    {
+        while ( M_requests.empty()
+                && ! M_quit )
+        {
+            M_condition.wait( &M_mutex );
+        }
+
+        if ( M_requests.empty() )
+        {
+            // quit requested and all requests are written.
+            break;
+        }
+
+        // the queued requests are written in a batch without the lock,
+        // and the file is synced once per batch.
+        requests.swap( M_requests );
+        lock.unlock();
+
+        for ( std::deque< Request >::const_iterator it = requests.begin();
+              it != requests.end();
+              ++it )
+        {
+            switch ( it->type_ ) {
+            case Request::RESET:
+                processReset( *it );
+                break;
+            case Request::APPEND:
+                processAppend( *it );
+                break;
+            case Request::REMOVE:
+                processRemove( *it );
+                break;
+            default:
+                break;
+            }
+        }
+        requests.clear();
+
+        sync();
+
+        lock.relock();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::processReset( const Request & request )
+{
+    closeFile();
+
+    const std::string tmp_path = request.path_ + ".tmp";
+
+    std::FILE * fp = std::fopen( tmp_path.c_str(), "wb" );
+    if ( ! fp )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " *** ERROR *** Failed to open the journal [" << tmp_path << "]"
+                  << std::endl;
+        return;
+    }
+
+    bool ok = ( std::fwrite( request.text_.data(), 1, request.text_.size(), fp )
+                == request.text_.size() );
+    ok = sync_file( fp ) && ok;
+    std::fclose( fp );
+
+#ifdef _WIN32
+    std::remove( request.path_.c_str() );
+#endif
+    if ( ! ok
+         || std::rename( tmp_path.c_str(), request.path_.c_str() ) != 0 )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " *** ERROR *** Failed to write the journal [" << request.path_ << "]"
+                  << std::endl;
+        std::remove( tmp_path.c_str() );
+        return;
+    }
+
+    M_file = std::fopen( request.path_.c_str(), "ab" );
+    if ( M_file )
+    {
+        M_file_path = request.path_;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::processAppend( const Request & request )
+{
+    if ( ! M_file
+         || M_file_path != request.path_ )
+    {
+        // the journal was not successfully reset.
+        return;
+    }
+
+    if ( std::fwrite( request.text_.data(), 1, request.text_.size(), M_file )
+         != request.text_.size() )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " *** ERROR *** Failed to append the journal [" << M_file_path << "]"
+                  << std::endl;
+        closeFile();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::processRemove( const Request & request )
+{
+    if ( M_file_path == request.path_ )
+    {
+        closeFile();
+    }
+
+    std::remove( request.path_.c_str() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::sync()
+{
+    if ( M_file
+         && ! sync_file( M_file ) )
+    {
+        std::cerr << __FILE__ << ':' << __LINE__
+                  << " *** ERROR *** Failed to sync the journal [" << M_file_path << "]"
+                  << std::endl;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+EditJournal::closeFile()
+{
+    if ( M_file )
+    {
+        std::fclose( M_file );
+        M_file = static_cast< std::FILE * >( 0 );
+    }
+    M_file_path.clear();
+}
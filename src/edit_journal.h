@@ -0,0 +1,239 @@
+// -*-c++-*-
+
+/*!
+  \file edit_journal.h
+  \brief append-only edit journal writer class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef FEDIT2_EDIT_JOURNAL_H
+#define FEDIT2_EDIT_JOURNAL_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QString>
+
+#include "edit_data.h"
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <cstdio>
+
+/*!
+  \class EditJournal
+  \brief worker thread that writes the edit journal of the formation data.
+
+  The journal file starts with the snapshot of the conf text, followed by
+  the records of the sample edits (EditData::Delta). The snapshot may be
+  empty, in which case the base of the records is the conf file saved at
+  the same place. Records are only appended, and each record is closed by
+  its end line, so a record truncated by a crash is simply ignored by
+  read().
+
+  The GUI thread only formats the record text and puts it to the queue.
+  Writing and syncing the file are done in this thread, so the cost of an
+  edit does not depend on the size of the formation. When the number of
+  records exceeds COMPACTION_SIZE, the caller should start a new journal by
+  reset() with the current snapshot. The new file is written to the
+  temporary path and renamed, so the old journal is valid until the new
+  one is complete.
+*/
+class EditJournal
+    : public QThread {
+public:
+
+    //! the number of records that triggers the compaction
+    static const int COMPACTION_SIZE;
+
+    /*!
+      \struct Record
+      \brief one journal record read from the file.
+     */
+    struct Record {
+        bool revert_; //!< if true, the delta was reverted (undo)
+        EditData::Delta delta_; //!< recorded changes
+    };
+
+private:
+
+    /*!
+      \struct Request
+      \brief file operation queued to the worker thread.
+     */
+    struct Request {
+        enum Type {
+            RESET, //!< start the new journal at path_ with the snapshot text_
+            APPEND, //!< append the record text_
+            REMOVE //!< remove the journal file
+        };
+
+        Type type_;
+        std::string path_;
+        std::string text_;
+
+        Request( const Type type,
+                 const std::string & path,
+                 const std::string & text )
+            : type_( type ),
+              path_( path ),
+              text_( text )
+          { }
+    };
+
+    //
+    // shared by the GUI thread and the worker thread
+    //
+
+    QMutex M_mutex; //!< lock of the request queue
+    QWaitCondition M_condition; //!< signaled when a request is queued
+    std::deque< Request > M_requests; //!< pending requests
+    bool M_quit; //!< quit request flag
+
+    //
+    // used only by the worker thread
+    //
+
+    std::FILE * M_file; //!< current journal file opened by the append mode
+    std::string M_file_path; //!< path of M_file
+
+    //
+    // used only by the GUI thread
+    //
+
+    QString M_path; //!< current journal path. empty if not started.
+    int M_record_count; //!< the number of records in the current journal
+
+    // not used
+    EditJournal( const EditJournal & );
+    const EditJournal & operator=( const EditJournal & );
+
+public:
+
+    /*!
+      \brief create the journal writer. the thread is not started.
+      \param parent parent object
+     */
+    explicit
+    EditJournal( QObject * parent = 0 );
+
+    /*!
+      \brief write the pending requests and wait the thread.
+     */
+    ~EditJournal();
+
+    /*!
+      \brief get the journal path for the conf file.
+      \param conf_path conf file path. if empty, the path for the untitled formation is returned.
+      \return journal file path
+     */
+    static
+    QString path_for( const QString & conf_path );
+
+    /*!
+      \brief get the current journal path.
+      \return file path. empty if the journal is not started.
+     */
+    const QString & path() const
+      {
+          return M_path;
+      }
+
+    /*!
+      \brief get the number of records appended after the last reset().
+      \return the number of records
+     */
+    int recordCount() const
+      {
+          return M_record_count;
+      }
+
+    /*!
+      \brief start the new journal. the old journal is removed if the path is changed.
+      \param path journal file path
+      \param snapshot conf text. if empty, the conf file is the base of the records.
+     */
+    void reset( const QString & path,
+                const std::string & snapshot );
+
+    /*!
+      \brief append the record of the applied changes.
+      \param delta changes
+      \param revert true if the changes were reverted
+     */
+    void append( const EditData::Delta & delta,
+                 const bool revert );
+
+    /*!
+      \brief remove the current journal file and stop journaling.
+     */
+    void remove();
+
+    /*!
+      \brief format the record text.
+      \param seq sequence number of the record
+      \param delta changes
+      \param revert true if the changes were reverted
+      \return record text
+     */
+    static
+    std::string to_record( const int seq,
+                           const EditData::Delta & delta,
+                           const bool revert );
+
+    /*!
+      \brief read the journal file.
+      \param path journal file path
+      \param snapshot pointer to the result conf text. empty if the base is the conf file.
+      \param records pointer to the result records. an incomplete last record is dropped.
+      \return true if the header and the snapshot are successfully read.
+     */
+    static
+    bool read( const QString & path,
+               std::string * snapshot,
+               std::vector< Record > * records );
+
+protected:
+
+    void run();
+
+private:
+
+    void enqueue( const Request & request );
+
+    void processReset( const Request & request );
+    void processAppend( const Request & request );
+    void processRemove( const Request & request );
+    void sync();
+    void closeFile();
+
+};
+
+#endif
@@ -0,0 +1,569 @@
+// -*-c++-*-
+
+/*!
+  \file heat_map.cpp
+  \brief formation heat map overlay class Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <QtGui>
+
+#include "heat_map.h"
+
+#include "Field.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+using namespace rcsc;
+
+namespace {
+
+//! cell size [m] at the coarsest level
+const double BASE_CELL_SIZE = 0.8;
+
+//! the finer level is used until the cell becomes smaller than this size [pixel].
+const double MAX_CELL_PIXELS = 12.0;
+
+//! distance [m] drawn by the hottest color
+const double ERROR_SCALE = 1.0;
+
+//! evaluated area. same as the area where the ball can be placed.
+const double AREA_MIN_X = -( _FIELD_WIDTH * 0.5 + _FIELD_MARGIN_WIDTH );
+const double AREA_MIN_Y = -( _FIELD_HEIGHT * 0.5 + _FIELD_MARGIN_HEIGHT );
+const double AREA_WIDTH = _FIELD_WIDTH + _FIELD_MARGIN_WIDTH * 2.0;
+const double AREA_HEIGHT = _FIELD_HEIGHT + _FIELD_MARGIN_HEIGHT * 2.0;
+
+}
+
+const int HeatMap::TILE_CELLS = 16;
+const int HeatMap::MAX_LEVEL = 3;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class HeatMapTask
+  \brief evaluates one tile in the worker thread.
+*/
+class HeatMapTask
+    : public QRunnable {
+private:
+    HeatMap * M_heat_map;
+    Formation::ConstPtr M_formation;
+    Formation::ConstPtr M_background;
+    HeatMap::TilePtr M_tile;
+
+public:
+
+    HeatMapTask( HeatMap * heat_map,
+                 Formation::ConstPtr formation,
+                 Formation::ConstPtr background,
+                 HeatMap::TilePtr tile )
+        : M_heat_map( heat_map )
+        , M_formation( formation )
+        , M_background( background )
+        , M_tile( tile )
+      { }
+
+    void run()
+      {
+          // the snapshot is shared by all tasks. evaluate the copy owned by this thread.
+          const Formation::ConstPtr formation
+              = HeatMap::worker_copy( M_heat_map->M_formation_copies, M_formation );
+          const Formation::ConstPtr background
+              = HeatMap::worker_copy( M_heat_map->M_background_copies, M_background );
+          if ( ! formation )
+          {
+              return;
+          }
+
+          const int cells = HeatMap::TILE_CELLS;
+          const double cell = BASE_CELL_SIZE / ( 1 << M_tile->level_ );
+          const double left = AREA_MIN_X + M_tile->tx_ * cells * cell;
+          const double top = AREA_MIN_Y + M_tile->ty_ * cells * cell;
+
+          M_tile->positions_.reserve( cells * cells * 11 );
+          if ( background )
+          {
+              M_tile->background_.reserve( cells * cells * 11 );
+          }
+
+          std::vector< Vector2D > positions;
+          positions.reserve( 11 );
+
+          for ( int iy = 0; iy < cells; ++iy )
+          {
+              // the tile is not needed any more.
+              if ( M_heat_map->M_generation != M_tile->generation_ )
+              {
+                  return;
+              }
+
+              for ( int ix = 0; ix < cells; ++ix )
+              {
+                  const Vector2D ball( left + ( ix + 0.5 ) * cell,
+                                       top + ( iy + 0.5 ) * cell );
+
+                  formation->getPositions( ball, positions );
+                  positions.resize( 11, ball );
+                  M_tile->positions_.insert( M_tile->positions_.end(),
+                                             positions.begin(), positions.end() );
+
+                  if ( background )
+                  {
+                      background->getPositions( ball, positions );
+                      positions.resize( 11, ball );
+                      M_tile->background_.insert( M_tile->background_.end(),
+                                                  positions.begin(), positions.end() );
+                  }
+              }
+          }
+
+          M_heat_map->postResult( M_tile );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+HeatMap::HeatMap( QObject * parent )
+    : QObject( parent )
+    , M_generation( 0 )
+    , M_version( 0 )
+{
+    // leave one core for the GUI thread.
+    M_pool.setMaxThreadCount( std::max( 1, QThread::idealThreadCount() - 1 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+HeatMap::~HeatMap()
+{
+    M_generation.fetchAndAddOrdered( 1 );
+    M_pool.waitForDone();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+HeatMap::cell_size( const int level )
+{
+    return BASE_CELL_SIZE / ( 1 << level );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+quint64
+HeatMap::tile_key( const int level,
+                   const int tx,
+                   const int ty )
+{
+    return ( static_cast< quint64 >( level ) << 32 )
+        | ( static_cast< quint64 >( tx & 0xffff ) << 16 )
+        | static_cast< quint64 >( ty & 0xffff );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+HeatMap::setFormations( Formation::ConstPtr formation,
+                        Formation::ConstPtr background,
+                        const unsigned long version )
+{
+    if ( M_version == version
+         && M_formation
+         && M_source.lock() == formation
+         && M_background_source.lock() == background )
+    {
+        return;
+    }
+
+    // pending tasks of the previous generation return immediately.
+    M_generation.fetchAndAddOrdered( 1 );
+    M_tiles.clear();
+    M_pending.clear();
+
+    M_version = version;
+    M_source = formation;
+    M_background_source = background;
+
+    // the tasks use the private copies, so the formations can be edited
+    // in the GUI thread while evaluating.
+    M_formation.reset();
+    M_background.reset();
+    if ( formation )
+    {
+        M_formation = formation->clone();
+    }
+    if ( background )
+    {
+        M_background = background->clone();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+HeatMap::request( const int level,
+                  const int tx,
+                  const int ty )
+{
+    const quint64 key = tile_key( level, tx, ty );
+    if ( ! M_pending.insert( key ).second )
+    {
+        return;
+    }
+
+    TilePtr tile( new Tile );
+    tile->level_ = level;
+    tile->tx_ = tx;
+    tile->ty_ = ty;
+    tile->generation_ = M_generation;
+    tile->image_unum_ = -1;
+
+    // coarse levels are evaluated first.
+    M_pool.start( new HeatMapTask( this, M_formation, M_background, tile ),
+                  MAX_LEVEL - level );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief called from the worker thread.
+
+  The copy is made once per thread and snapshot, and reused by the
+  following tasks in the same thread.
+ */
+Formation::ConstPtr
+HeatMap::worker_copy( QThreadStorage< WorkerCopy * > & copies,
+                      Formation::ConstPtr origin )
+{
+    if ( ! origin )
+    {
+        return Formation::ConstPtr();
+    }
+
+    if ( ! copies.hasLocalData() )
+    {
+        copies.setLocalData( new WorkerCopy );
+    }
+
+    WorkerCopy * copy = copies.localData();
+    if ( copy->origin_ != origin )
+    {
+        // clone() only reads the snapshot, so it can be called from several threads.
+        copy->origin_ = origin;
+        copy->formation_ = origin->clone();
+    }
+
+    return copy->formation_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief called from the worker thread.
+ */
+void
+HeatMap::postResult( TilePtr tile )
+{
+    bool first = false;
+    {
+        QMutexLocker lock( &M_result_mutex );
+        first = M_results.empty();
+        M_results.push_back( tile );
+    }
+
+    if ( first )
+    {
+        QMetaObject::invokeMethod( this, "collectTiles", Qt::QueuedConnection );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+HeatMap::collectTiles()
+{
+    std::vector< TilePtr > results;
+    {
+        QMutexLocker lock( &M_result_mutex );
+        results.swap( M_results );
+    }
+
+    const int generation = M_generation;
+    bool changed = false;
+
+    for ( std::vector< TilePtr >::iterator t = results.begin(), end = results.end();
+          t != end;
+          ++t )
+    {
+        if ( (*t)->generation_ != generation )
+        {
+            continue;
+        }
+
+        const quint64 key = tile_key( (*t)->level_, (*t)->tx_, (*t)->ty_ );
+        M_pending.erase( key );
+        M_tiles[key] = *t;
+        changed = true;
+    }
+
+    if ( changed )
+    {
+        emit this->updated();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+HeatMap::draw( QPainter & painter,
+               const QRectF & visible_rect,
+               const double & scale,
+               const Options::HeatMapMode mode,
+               const int unum )
+{
+    if ( mode == Options::NO_HEAT_MAP
+         || ! M_formation )
+    {
+        return;
+    }
+
+    if ( mode == Options::BACKGROUND_ERROR_MAP
+         && ! M_background )
+    {
+        return;
+    }
+
+    if ( mode == Options::VECTOR_FIELD_MAP
+         && ( unum < 1 || 11 < unum ) )
+    {
+        return;
+    }
+
+    const QRectF area( AREA_MIN_X, AREA_MIN_Y, AREA_WIDTH, AREA_HEIGHT );
+    const QRectF rect = visible_rect.intersected( area );
+    if ( rect.isEmpty() )
+    {
+        return;
+    }
+
+    int needed_level = 0;
+    while ( needed_level < MAX_LEVEL
+            && cell_size( needed_level ) * scale > MAX_CELL_PIXELS )
+    {
+        ++needed_level;
+    }
+
+    //
+    // request all missing tiles from the coarse level,
+    // and find the finest level where all visible tiles are ready.
+    //
+
+    int draw_level = -1;
+    for ( int level = 0; level <= needed_level; ++level )
+    {
+        const double tile_size = cell_size( level ) * TILE_CELLS;
+        const int min_tx = static_cast< int >( std::floor( ( rect.left() - AREA_MIN_X ) / tile_size ) );
+        const int max_tx = static_cast< int >( std::floor( ( rect.right() - AREA_MIN_X ) / tile_size ) );
+        const int min_ty = static_cast< int >( std::floor( ( rect.top() - AREA_MIN_Y ) / tile_size ) );
+        const int max_ty = static_cast< int >( std::floor( ( rect.bottom() - AREA_MIN_Y ) / tile_size ) );
+
+        bool ready = true;
+        for ( int tx = min_tx; tx <= max_tx; ++tx )
+        {
+            for ( int ty = min_ty; ty <= max_ty; ++ty )
+            {
+                if ( M_tiles.find( tile_key( level, tx, ty ) ) == M_tiles.end() )
+                {
+                    ready = false;
+                    request( level, tx, ty );
+                }
+            }
+        }
+
+        if ( ready
+             && draw_level == level - 1 )
+        {
+            draw_level = level;
+        }
+    }
+
+    if ( draw_level < 0 )
+    {
+        return;
+    }
+
+    const double tile_size = cell_size( draw_level ) * TILE_CELLS;
+    const int min_tx = static_cast< int >( std::floor( ( rect.left() - AREA_MIN_X ) / tile_size ) );
+    const int max_tx = static_cast< int >( std::floor( ( rect.right() - AREA_MIN_X ) / tile_size ) );
+    const int min_ty = static_cast< int >( std::floor( ( rect.top() - AREA_MIN_Y ) / tile_size ) );
+    const int max_ty = static_cast< int >( std::floor( ( rect.bottom() - AREA_MIN_Y ) / tile_size ) );
+
+    for ( int tx = min_tx; tx <= max_tx; ++tx )
+    {
+        for ( int ty = min_ty; ty <= max_ty; ++ty )
+        {
+            std::map< quint64, TilePtr >::iterator it = M_tiles.find( tile_key( draw_level, tx, ty ) );
+            if ( it == M_tiles.end() )
+            {
+                continue;
+            }
+
+            if ( mode == Options::BACKGROUND_ERROR_MAP )
+            {
+                drawErrorTile( painter, *it->second, unum );
+            }
+            else
+            {
+                drawVectorTile( painter, *it->second, unum );
+            }
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+HeatMap::drawErrorTile( QPainter & painter,
+                        Tile & tile,
+                        const int unum )
+{
+    if ( tile.background_.size() != tile.positions_.size() )
+    {
+        return;
+    }
+
+    if ( tile.image_unum_ != unum
+         || tile.image_.isNull() )
+    {
+        tile.image_ = QImage( TILE_CELLS, TILE_CELLS, QImage::Format_ARGB32 );
+
+        for ( int iy = 0; iy < TILE_CELLS; ++iy )
+        {
+            for ( int ix = 0; ix < TILE_CELLS; ++ix )
+            {
+                const std::size_t base = ( iy * TILE_CELLS + ix ) * 11;
+
+                double err = 0.0;
+                if ( 1 <= unum && unum <= 11 )
+                {
+                    err = tile.positions_[base + unum - 1].dist( tile.background_[base + unum - 1] );
+                }
+                else
+                {
+                    for ( int i = 0; i < 11; ++i )
+                    {
+                        err += tile.positions_[base + i].dist( tile.background_[base + i] );
+                    }
+                    err /= 11.0;
+                }
+
+                const double rate = std::min( 1.0, err / ERROR_SCALE );
+                // blue (small error) -> red (large error)
+                QColor col = QColor::fromHsvF( ( 1.0 - rate ) * 0.66, 1.0, 1.0, 0.55 );
+                tile.image_.setPixel( ix, iy, col.rgba() );
+            }
+        }
+
+        tile.image_unum_ = unum;
+    }
+
+    const double size = cell_size( tile.level_ ) * TILE_CELLS;
+    painter.drawImage( QRectF( AREA_MIN_X + tile.tx_ * size,
+                               AREA_MIN_Y + tile.ty_ * size,
+                               size, size ),
+                       tile.image_ );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+HeatMap::drawVectorTile( QPainter & painter,
+                         const Tile & tile,
+                         const int unum )
+{
+    const double cell = cell_size( tile.level_ );
+    const double left = AREA_MIN_X + tile.tx_ * TILE_CELLS * cell;
+    const double top = AREA_MIN_Y + tile.ty_ * TILE_CELLS * cell;
+    const double len = cell * 0.8;
+
+    QVector< QLineF > lines;
+    QVector< QPointF > points;
+    lines.reserve( TILE_CELLS * TILE_CELLS );
+    points.reserve( TILE_CELLS * TILE_CELLS );
+
+    for ( int iy = 0; iy < TILE_CELLS; ++iy )
+    {
+        for ( int ix = 0; ix < TILE_CELLS; ++ix )
+        {
+            const Vector2D ball( left + ( ix + 0.5 ) * cell,
+                                 top + ( iy + 0.5 ) * cell );
+            const Vector2D & pos = tile.positions_[( iy * TILE_CELLS + ix ) * 11 + unum - 1];
+
+            // direction from the ball to the player, normalized to the cell size.
+            Vector2D dir = pos - ball;
+            const double r = dir.r();
+            if ( r > 1.0e-6 )
+            {
+                dir *= len / r;
+            }
+
+            points.push_back( QPointF( ball.x, ball.y ) );
+            lines.push_back( QLineF( ball.x, ball.y, ball.x + dir.x, ball.y + dir.y ) );
+        }
+    }
+
+    painter.setBrush( Qt::NoBrush );
+    painter.setPen( QPen( QColor( 255, 255, 0, 160 ), 0, Qt::SolidLine ) );
+    painter.drawLines( lines );
+    painter.setPen( QPen( QColor( 255, 0, 0, 200 ), 0, Qt::SolidLine ) );
+    painter.drawPoints( points.constData(), points.size() );
+}
@@ -0,0 +1,208 @@
+// -*-c++-*-
+
+/*!
+  \file heat_map.h
+  \brief formation heat map overlay class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef FEDIT2_HEAT_MAP_H
+#define FEDIT2_HEAT_MAP_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QImage>
+#include <QMutex>
+#include <QThreadPool>
+#include <QThreadStorage>
+
+#include "options.h"
+
+#include <rcsc/formation/formation.h>
+#include <rcsc/geom/vector_2d.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+class QPainter;
+class QRectF;
+
+class HeatMapTask;
+
+/*!
+  \class HeatMap
+  \brief overlay that samples the formation over a grid of ball positions.
+
+  The field is divided into square tiles. Each tile is evaluated by a task
+  on the thread pool, and the result is cached until the formation version
+  changes. Several levels of the grid resolution are used. Coarse levels
+  are requested first, and the finest level that is ready for all visible
+  tiles is drawn. So panning and zooming never recompute the cached tiles.
+*/
+class HeatMap
+    : public QObject {
+
+    Q_OBJECT
+
+    friend class HeatMapTask;
+
+public:
+
+    static const int TILE_CELLS; //!< number of cells along the tile edge
+    static const int MAX_LEVEL; //!< finest level of the grid resolution
+
+    /*!
+      \struct Tile
+      \brief evaluated positions in one tile.
+     */
+    struct Tile {
+        int level_; //!< grid resolution level
+        int tx_; //!< tile column
+        int ty_; //!< tile row
+        int generation_; //!< generation when requested
+
+        //! positions of all players for each cell. size = TILE_CELLS^2 * 11
+        std::vector< rcsc::Vector2D > positions_;
+        //! same layout for the background formation. empty if no background.
+        std::vector< rcsc::Vector2D > background_;
+
+        QImage image_; //!< rendered error map
+        int image_unum_; //!< player number used for image_. -1 if not rendered.
+    };
+
+    typedef boost::shared_ptr< Tile > TilePtr;
+
+private:
+
+    /*!
+      \struct WorkerCopy
+      \brief formation copied for one worker thread.
+     */
+    struct WorkerCopy {
+        rcsc::Formation::ConstPtr origin_; //!< snapshot copied from
+        rcsc::Formation::ConstPtr formation_; //!< private copy of origin_
+    };
+
+    //! per thread copies of M_formation. declared before M_pool, so they outlive the pool threads.
+    QThreadStorage< WorkerCopy * > M_formation_copies;
+    QThreadStorage< WorkerCopy * > M_background_copies; //!< per thread copies of M_background
+
+    QThreadPool M_pool;
+    QAtomicInt M_generation; //!< incremented when cached tiles become invalid
+
+    unsigned long M_version; //!< formation version of the cached tiles
+    boost::weak_ptr< const rcsc::Formation > M_source; //!< original formation
+    boost::weak_ptr< const rcsc::Formation > M_background_source; //!< original background formation
+
+    rcsc::Formation::ConstPtr M_formation; //!< snapshot copied by the worker threads
+    rcsc::Formation::ConstPtr M_background; //!< snapshot copied by the worker threads
+
+    std::map< quint64, TilePtr > M_tiles; //!< ready tiles
+    std::set< quint64 > M_pending; //!< requested tiles
+
+    QMutex M_result_mutex;
+    std::vector< TilePtr > M_results; //!< finished tiles not collected yet
+
+    // not used
+    HeatMap( const HeatMap & );
+    const HeatMap & operator=( const HeatMap & );
+
+public:
+
+    explicit
+    HeatMap( QObject * parent = 0 );
+    ~HeatMap();
+
+    /*!
+      \brief set the evaluated formations.
+      \param formation foreground formation
+      \param background background formation. may be NULL.
+      \param version version number of formations
+
+      If they are different from the cached ones, all tiles are discarded.
+     */
+    void setFormations( rcsc::Formation::ConstPtr formation,
+                        rcsc::Formation::ConstPtr background,
+                        const unsigned long version );
+
+    /*!
+      \brief draw the overlay and request missing tiles.
+      \param painter painter with the field coordinate transform
+      \param visible_rect visible area in the field coordinate
+      \param scale pixels per meter
+      \param mode overlay type
+      \param unum selected player number. 0 means all players.
+     */
+    void draw( QPainter & painter,
+               const QRectF & visible_rect,
+               const double & scale,
+               const Options::HeatMapMode mode,
+               const int unum );
+
+private:
+
+    static
+    double cell_size( const int level );
+
+    static
+    quint64 tile_key( const int level,
+                      const int tx,
+                      const int ty );
+
+    void request( const int level,
+                  const int tx,
+                  const int ty );
+
+    static
+    rcsc::Formation::ConstPtr worker_copy( QThreadStorage< WorkerCopy * > & copies,
+                                           rcsc::Formation::ConstPtr origin );
+
+    void postResult( TilePtr tile );
+
+    void drawErrorTile( QPainter & painter,
+                        Tile & tile,
+                        const int unum );
+    void drawVectorTile( QPainter & painter,
+                         const Tile & tile,
+                         const int unum );
+
+private slots:
+
+    void collectTiles();
+
+signals:
+
+    void updated();
+
+};
+
+#endif
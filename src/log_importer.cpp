@@ -0,0 +1,238 @@
+// -*-c++-*-
+
+/*!
+  \file log_importer.cpp
+  \brief game log sample importer class Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <QtCore>
+
+#include "log_importer.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace rcsc;
+using namespace rcsc::formation;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class LogImportTask
+  \brief parses one log file in the worker thread.
+*/
+class LogImportTask
+    : public QRunnable {
+private:
+    LogImporter * M_importer;
+    const int M_index;
+    const QString M_filepath;
+    const std::string M_team_name;
+    const std::size_t M_max_size;
+
+public:
+
+    LogImportTask( LogImporter * importer,
+                   const int index,
+                   const QString & filepath,
+                   const std::string & team_name,
+                   const std::size_t max_size )
+        : M_importer( importer )
+        , M_index( index )
+        , M_filepath( filepath )
+        , M_team_name( team_name )
+        , M_max_size( max_size )
+      { }
+
+    void run()
+      {
+          LogImporter::Result result;
+          result.index_ = M_index;
+          result.ok_ = true;
+
+          if ( M_importer->M_cancelled == 0 )
+          {
+              result.harvester_ = LogImporter::HarvesterPtr( new SampleHarvester() );
+              result.harvester_->setTeamName( M_team_name );
+              result.harvester_->setMaxSize( M_max_size );
+              result.ok_ = result.harvester_->harvest( QFile::encodeName( M_filepath ).constData() );
+          }
+
+          M_importer->postResult( result );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+LogImporter::LogImporter( QObject * parent )
+    : QObject( parent )
+    , M_cancelled( 0 )
+    , M_finished_count( 0 )
+    , M_merged_count( 0 )
+    , M_failed_count( 0 )
+{
+    M_pool.setMaxThreadCount( std::max( 1, QThread::idealThreadCount() - 1 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+LogImporter::~LogImporter()
+{
+    M_cancelled.fetchAndStoreOrdered( 1 );
+    M_pool.waitForDone();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LogImporter::start( const QStringList & files,
+                    const QString & team_name,
+                    const std::size_t max_size )
+{
+    if ( isRunning() )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " LogImporter::start() Already running." << std::endl;
+        return;
+    }
+
+    M_cancelled.fetchAndStoreOrdered( 0 );
+
+    M_files = files;
+    M_result = SampleHarvester();
+    M_result.setTeamName( team_name.toStdString() );
+    M_result.setMaxSize( max_size );
+
+    M_pending.clear();
+    M_pending.resize( files.size() );
+    M_finished_count = 0;
+    M_merged_count = 0;
+    M_failed_count = 0;
+
+    if ( files.isEmpty() )
+    {
+        emit finished();
+        return;
+    }
+
+    for ( int i = 0; i < files.size(); ++i )
+    {
+        M_pool.start( new LogImportTask( this, i, files[i],
+                                         M_result.teamName(), max_size ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LogImporter::cancel()
+{
+    M_cancelled.fetchAndStoreOrdered( 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LogImporter::postResult( const Result & result )
+{
+    bool first = false;
+    {
+        QMutexLocker lock( &M_result_mutex );
+        first = M_results.empty();
+        M_results.push_back( result );
+    }
+
+    if ( first )
+    {
+        QMetaObject::invokeMethod( this, "collectResults", Qt::QueuedConnection );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LogImporter::collectResults()
+{
+    std::vector< Result > results;
+    {
+        QMutexLocker lock( &M_result_mutex );
+        results.swap( M_results );
+    }
+
+    for ( std::vector< Result >::const_iterator r = results.begin(), end = results.end();
+          r != end;
+          ++r )
+    {
+        ++M_finished_count;
+        if ( ! r->ok_ )
+        {
+            std::cerr << "LogImporter: failed to parse "
+                      << M_files[r->index_].toStdString() << std::endl;
+            ++M_failed_count;
+        }
+
+        M_pending[r->index_] = *r;
+    }
+
+    // merge in the order of the file list.
+    while ( M_merged_count < static_cast< int >( M_pending.size() )
+            && M_pending[M_merged_count].index_ >= 0 )
+    {
+        Result & r = M_pending[M_merged_count];
+        if ( r.harvester_ )
+        {
+            M_result.merge( *r.harvester_ );
+            r.harvester_.reset();
+        }
+        ++M_merged_count;
+    }
+
+    if ( ! results.empty() )
+    {
+        emit progressed( M_finished_count, M_files.size() );
+    }
+
+    if ( M_finished_count >= M_files.size() )
+    {
+        emit finished();
+    }
+}
@@ -0,0 +1,180 @@
+// -*-c++-*-
+
+/*!
+  \file log_importer.h
+  \brief game log sample importer class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef FEDIT2_LOG_IMPORTER_H
+#define FEDIT2_LOG_IMPORTER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <rcsc/formation/sample_harvester.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+class LogImportTask;
+
+/*!
+  \class LogImporter
+  \brief collects the formation samples from game log files on the thread pool.
+
+  Each log file is parsed by one task. The result of each file is merged
+  into result() in the order of the file list, as soon as the preceding
+  files are merged. So the result does not depend on the thread timing,
+  and the unmerged results are not kept longer than needed.
+*/
+class LogImporter
+    : public QObject {
+
+    Q_OBJECT
+
+    friend class LogImportTask;
+
+public:
+
+    typedef boost::shared_ptr< rcsc::formation::SampleHarvester > HarvesterPtr;
+
+    /*!
+      \struct Result
+      \brief result of one file.
+     */
+    struct Result {
+        int index_; //!< index in the file list. -1 if not finished.
+        HarvesterPtr harvester_; //!< collected samples. NULL if skipped.
+        bool ok_; //!< false if the file could not be parsed.
+
+        Result()
+            : index_( -1 ),
+              ok_( false )
+          { }
+    };
+
+private:
+
+    QThreadPool M_pool;
+    QAtomicInt M_cancelled; //!< cancel request flag
+
+    QStringList M_files; //!< imported files
+    rcsc::formation::SampleHarvester M_result; //!< merged samples
+
+    std::vector< Result > M_pending; //!< results not merged yet. indexed by file.
+    int M_finished_count; //!< number of finished files
+    int M_merged_count; //!< number of merged files
+    int M_failed_count; //!< number of files that could not be parsed
+
+    QMutex M_result_mutex;
+    std::vector< Result > M_results; //!< results not collected yet
+
+    // not used
+    LogImporter( const LogImporter & );
+    const LogImporter & operator=( const LogImporter & );
+
+public:
+
+    explicit
+    LogImporter( QObject * parent = 0 );
+
+    ~LogImporter();
+
+    /*!
+      \brief start importing. must not be called while running.
+      \param files game log file paths
+      \param team_name target team name. if empty, the left team is used.
+      \param max_size max number of samples
+     */
+    void start( const QStringList & files,
+                const QString & team_name,
+                const std::size_t max_size );
+
+    /*!
+      \brief check if importing is in progress.
+      \return true if some files are not finished.
+     */
+    bool isRunning() const
+      {
+          return M_finished_count < M_files.size();
+      }
+
+    /*!
+      \brief check if importing was cancelled.
+      \return true if cancel() was called.
+     */
+    bool isCancelled() const
+      {
+          return M_cancelled != 0;
+      }
+
+    /*!
+      \brief get the merged samples. valid after the finished() signal.
+      \return const reference to the harvester.
+     */
+    const rcsc::formation::SampleHarvester & result() const
+      {
+          return M_result;
+      }
+
+    /*!
+      \brief get the number of files that could not be parsed.
+      \return the number of failed files.
+     */
+    int failedCount() const
+      {
+          return M_failed_count;
+      }
+
+public slots:
+
+    /*!
+      \brief request to stop. the files not started yet are skipped.
+     */
+    void cancel();
+
+private:
+
+    void postResult( const Result & result );
+
+private slots:
+
+    void collectResults();
+
+signals:
+
+    void progressed( int finished,
+                     int total );
+    void finished();
+
+};
+
+#endif
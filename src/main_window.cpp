@@ -46,11 +46,15 @@
 #include "edit_canvas.h"
 #include "edit_data.h"
 #include "edit_dialog.h"
+#include "edit_journal.h"
 #include "constraint_view.h"
+#include "log_importer.h"
 #include "sample_view.h"
+#include "training_thread.h"
 #include "options.h"
 
 #include <rcsc/formation/sample_data.h>
+#include <rcsc/formation/sample_reducer.h>
 
 //#include <rcsc/formation/formation_bpn.h>
 #include <rcsc/formation/formation_cdt.h>
@@ -63,6 +67,8 @@
 //#include <rcsc/formation/formation_static.h>
 //#include <rcsc/formation/formation_uva.h>
 
+#include <algorithm>
+#include <sstream>
 #include <iostream>
 
 #include "xpm/fedit2.xpm"
@@ -86,6 +92,9 @@ using namespace formation;
 
  */
 MainWindow::MainWindow()
+    : M_training_thread( static_cast< TrainingThread * >( 0 ) )
+    , M_log_importer( static_cast< LogImporter * >( 0 ) )
+    , M_journal( static_cast< EditJournal * >( 0 ) )
 {
     qApp->setWindowIcon( QIcon( QPixmap( fedit2_xpm ) ) );
     this->setWindowTitle( tr( "SSL Formation Editor" ) );
@@ -114,6 +123,15 @@ MainWindow::MainWindow()
     //
     createUndoStack();
 
+    M_log_importer = new LogImporter( this );
+    connect( M_log_importer, SIGNAL( progressed( int, int ) ),
+             this, SLOT( showImportProgress( int, int ) ) );
+    connect( M_log_importer, SIGNAL( finished() ),
+             this, SLOT( finishImport() ) );
+
+    M_journal = new EditJournal( this );
+    M_journal->start( QThread::LowPriority );
+
     createActions();
     createMenus();
     createToolBars();
@@ -121,6 +139,8 @@ MainWindow::MainWindow()
 
     connect( M_edit_dialog, SIGNAL( viewUpdated() ),
              M_edit_canvas, SLOT( update() ) );
+    connect( M_edit_dialog, SIGNAL( viewUpdated() ),
+             this, SLOT( saveJournalSnapshot() ) );
     connect( M_edit_canvas, SIGNAL( objectMoved() ),
              M_edit_dialog, SLOT( updateData() ) );
     connect( M_edit_canvas, SIGNAL( objectMoved() ),
@@ -138,6 +158,12 @@ MainWindow::MainWindow()
  */
 MainWindow::~MainWindow()
 {
+    if ( M_training_thread )
+    {
+        M_training_thread->cancel();
+        M_training_thread->wait();
+    }
+
     if ( QApplication::overrideCursor() )
     {
         QApplication::restoreOverrideCursor();
@@ -183,6 +209,28 @@ MainWindow::init()
     {
         openConfFile( opt.confFile() );
     }
+    else if ( recoverJournal( QString() ) )
+    {
+        this->setWindowTitle( tr( "FormationEditor - New Formation -" ) );
+
+        M_edit_canvas->setData( M_edit_data );
+        M_edit_dialog->setData( M_edit_data );
+        M_sample_view->setData( M_edit_data );
+        M_constraint_view->setData( M_edit_data );
+
+        const int data_count = M_edit_data->samples()->dataCont().size();
+        M_index_spin_box->setRange( 0, data_count );
+        M_edit_canvas->update(); //emit viewUpdated();
+        M_sample_view->updateData();
+        M_constraint_view->updateData();
+        M_edit_dialog->updateData();
+
+        resetJournal( true );
+    }
+    else
+    {
+        QFile::remove( EditJournal::path_for( QString() ) );
+    }
 
     if ( ! opt.dataFile().isEmpty() )
     {
@@ -333,6 +381,7 @@ void
 MainWindow::createUndoStack()
 {
     M_undo_stack = new QUndoStack( this );
+    M_undo_stack->setUndoLimit( 256 );
 }
 
 /*-------------------------------------------------------------------*/
@@ -486,6 +535,12 @@ MainWindow::createActionsFile()
                                    + tr( ")" ) );
     connect( M_open_data_act, SIGNAL( triggered() ), this, SLOT( openData() ) );
 
+    //
+    M_import_logs_act = new QAction( tr( "&Import from logs..." ),
+                                     this );
+    M_import_logs_act->setStatusTip( tr( "Add samples collected from game log files." ) );
+    connect( M_import_logs_act, SIGNAL( triggered() ), this, SLOT( importLogs() ) );
+
     //
     M_save_act = new QAction( QIcon( QPixmap( save_xpm ) ),
                               tr( "&Save formation" ),
@@ -542,7 +597,7 @@ MainWindow::createActionsEdit()
 #endif
     M_undo_act->setEnabled( false );
     connect( M_undo_act, SIGNAL( triggered() ),
-             M_undo_stack, SLOT( undo() ) );
+             this, SLOT( undo() ) );
     this->addAction( M_undo_act );
 
     //
@@ -554,7 +609,7 @@ MainWindow::createActionsEdit()
 #endif
     M_redo_act->setEnabled( false );
     connect( M_redo_act, SIGNAL( triggered() ),
-             M_undo_stack, SLOT( redo() ) );
+             this, SLOT( redo() ) );
     this->addAction( M_redo_act );
 
     //
@@ -683,6 +738,13 @@ MainWindow::createActionsEdit()
              this, SLOT( showConstraintEditDialog() ) );
     this->addAction( M_add_constraint_act );
 
+    //
+    M_reduce_samples_act = new QAction( tr( "Reduce samples..." ),
+                                        this );
+    M_reduce_samples_act->setStatusTip( tr( "Select the representative samples and remove others." ) );
+    connect( M_reduce_samples_act, SIGNAL( triggered() ), this, SLOT( reduceSamples() ) );
+    this->addAction( M_reduce_samples_act );
+
     //
     M_train_act = new QAction( QIcon( QPixmap( train_xpm ) ),
                                tr( "Train" ),
@@ -690,6 +752,14 @@ MainWindow::createActionsEdit()
     M_train_act->setStatusTip( tr( "Train formation using current trainig data set." ) );
     connect( M_train_act, SIGNAL( triggered() ), this, SLOT( train() ) );
     this->addAction( M_train_act );
+
+    //
+    M_cancel_training_act = new QAction( tr( "Cancel training" ),
+                                         this );
+    M_cancel_training_act->setStatusTip( tr( "Cancel the running training." ) );
+    M_cancel_training_act->setEnabled( false );
+    connect( M_cancel_training_act, SIGNAL( triggered() ), this, SLOT( cancelTraining() ) );
+    this->addAction( M_cancel_training_act );
 }
 
 /*-------------------------------------------------------------------*/
@@ -821,6 +891,35 @@ MainWindow::createActionsView()
     M_toggle_show_circumcircle_act->setChecked( false );
     this->addAction( M_toggle_show_circumcircle_act );
 
+    //
+    {
+        QActionGroup * group = new QActionGroup( this );
+
+        M_heat_map_none_act = new QAction( tr( "No Heat Map" ),
+                                           group );
+        M_heat_map_none_act->setStatusTip( tr( "Hide the formation heat map." ) );
+        M_heat_map_none_act->setData( static_cast< int >( Options::NO_HEAT_MAP ) );
+        M_heat_map_none_act->setCheckable( true );
+        M_heat_map_none_act->setChecked( true );
+
+        M_heat_map_vector_act = new QAction( tr( "Player Vector Field" ),
+                                             group );
+        M_heat_map_vector_act->setStatusTip( tr( "Show the direction to the selected player"
+                                                 " for each ball position." ) );
+        M_heat_map_vector_act->setData( static_cast< int >( Options::VECTOR_FIELD_MAP ) );
+        M_heat_map_vector_act->setCheckable( true );
+
+        M_heat_map_error_act = new QAction( tr( "Background Error Map" ),
+                                            group );
+        M_heat_map_error_act->setStatusTip( tr( "Show the distance from the background formation"
+                                                " for each ball position." ) );
+        M_heat_map_error_act->setData( static_cast< int >( Options::BACKGROUND_ERROR_MAP ) );
+        M_heat_map_error_act->setCheckable( true );
+
+        connect( group, SIGNAL( triggered( QAction * ) ),
+                 this, SLOT( setHeatMapMode( QAction * ) ) );
+    }
+
     //
     M_toggle_antialiasing_act = new QAction( tr( "Antialiasing" ),
                                              this );
@@ -907,6 +1006,7 @@ MainWindow::createMenuFile()
 
     menu->addAction( M_open_conf_act );
     menu->addAction( M_open_data_act );
+    menu->addAction( M_import_logs_act );
 
     menu->addSeparator();
 
@@ -933,10 +1033,10 @@ MainWindow::createMenuEdit()
     connect( menu, SIGNAL( aboutToShow() ),
              this, SLOT( editMenuAboutToShow() ) );
 
-    // menu->addAction( M_undo_act );
-    // menu->addAction( M_redo_act );
+    menu->addAction( M_undo_act );
+    menu->addAction( M_redo_act );
 
-    // menu->addSeparator();
+    menu->addSeparator();
 
     menu->addAction( M_toggle_player_auto_move_act );
     menu->addAction( M_toggle_data_auto_select_act );
@@ -951,7 +1051,9 @@ MainWindow::createMenuEdit()
         submenu->addAction( M_insert_data_act );
         submenu->addAction( M_replace_data_act );
         submenu->addAction( M_delete_data_act );
+        submenu->addAction( M_reduce_samples_act );
         submenu->addAction( M_train_act );
+        submenu->addAction( M_cancel_training_act );
 
         menu->addMenu( submenu );
     }
@@ -988,6 +1090,13 @@ MainWindow::createMenuView()
     menu->addAction( M_toggle_antialiasing_act );
     menu->addAction( M_toggle_show_background_data_act );
 
+    {
+        QMenu * submenu = menu->addMenu( tr( "Heat Map" ) );
+        submenu->addAction( M_heat_map_none_act );
+        submenu->addAction( M_heat_map_vector_act );
+        submenu->addAction( M_heat_map_error_act );
+    }
+
     menu->addSeparator();
 
     menu->addAction( M_show_edit_dialog_act );
@@ -1019,6 +1128,9 @@ MainWindow::closeEvent( QCloseEvent * event )
         return;
     }
 
+    // changes are saved or discarded by the user.
+    M_journal->remove();
+
     event->ignore();
     qApp->quit();
 }
@@ -1135,6 +1247,7 @@ MainWindow::openConfFile( const QString & filepath )
         return false;
     }
 
+    M_undo_stack->clear();
     M_edit_data = boost::shared_ptr< EditData >( new EditData );
     if ( ! M_edit_data->openConf( filepath ) )
     {
@@ -1158,7 +1271,13 @@ MainWindow::openConfFile( const QString & filepath )
         return false;
     }
 
-    this->statusBar()->showMessage( tr( "Opened %1" ).arg( filepath ), 2000 );
+    const bool recovered = recoverJournal( filepath );
+    resetJournal( recovered );
+
+    this->statusBar()->showMessage( recovered
+                                    ? tr( "Recovered %1" ).arg( filepath )
+                                    : tr( "Opened %1" ).arg( filepath ),
+                                    2000 );
     this->setWindowTitle( tr( "Formation Editor - " )
                           + fileinfo.fileName()
                           + tr( " -") );
@@ -1288,6 +1407,7 @@ MainWindow::openDataFile( const QString & filepath )
         return false;
     }
 
+    M_undo_stack->clear();
     if ( ! M_edit_data->openData( filepath ) )
     {
         QMessageBox::warning( this,
@@ -1299,6 +1419,8 @@ MainWindow::openDataFile( const QString & filepath )
 
     }
 
+    resetJournal( true );
+
     this->statusBar()->showMessage( tr( "Opened %1" ).arg( filepath ), 2000 );
 
     const int data_count = M_edit_data->samples()->dataCont().size();
@@ -1418,6 +1540,7 @@ MainWindow::newFile()
 
     // create new data
 
+    M_undo_stack->clear();
     M_edit_data = boost::shared_ptr< EditData >( new EditData() );
     M_edit_data->createFormation( name );
 
@@ -1430,6 +1553,8 @@ MainWindow::newFile()
         return;
     }
 
+    resetJournal( true );
+
     M_edit_canvas->setData( M_edit_data );
     M_edit_dialog->setData( M_edit_data );
     M_sample_view->setData( M_edit_data );
@@ -1528,6 +1653,7 @@ MainWindow::saveConf()
 
     if ( M_edit_data->saveConf() )
     {
+        resetJournal( false );
         this->statusBar()->showMessage( tr( "Saved %1" ).arg( M_edit_data->filePath() ), 2000 );
     }
     else
@@ -1568,6 +1694,8 @@ MainWindow::saveConfAs()
 
     if ( M_edit_data->saveConfAs( filepath ) )
     {
+        resetJournal( false );
+
         QFileInfo fileinfo( filepath );
         this->setWindowTitle( tr( "FormationEditor - " )
                               + fileinfo.fileName()
@@ -1629,6 +1757,128 @@ MainWindow::saveDataAs()
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::importLogs()
+{
+    if ( ! M_edit_data
+         || ! M_edit_data->formation()
+         || ! M_edit_data->samples() )
+    {
+        QMessageBox::warning( this,
+                              tr( "Import from logs" ),
+                              tr( "No formation. Open or create a formation at first." ) );
+        return;
+    }
+
+    if ( M_log_importer->isRunning() )
+    {
+        this->statusBar()->showMessage( tr( "Import is already running." ) );
+        return;
+    }
+
+    const std::size_t data_count = M_edit_data->samples()->dataCont().size();
+    if ( data_count >= SampleDataSet::MAX_DATA_SIZE )
+    {
+        showWarningMessage( SampleDataSet::TOO_MANY_DATA );
+        return;
+    }
+
+    QString filter( tr( "Game log file (*.rcg *.rcg.gz);;"
+                        "All files (*)" ) );
+    QStringList files = QFileDialog::getOpenFileNames( this,
+                                                       tr( "Import from logs" ),
+                                                       tr( "" ),
+                                                       filter );
+    if ( files.isEmpty() )
+    {
+        return;
+    }
+
+    bool ok = false;
+    QString team_name = QInputDialog::getText( this,
+                                               tr( "Import from logs" ),
+                                               tr( "Team name (empty: left team)" ),
+                                               QLineEdit::Normal,
+                                               QString(),
+                                               &ok );
+    if ( ! ok )
+    {
+        return;
+    }
+
+    M_import_data = M_edit_data;
+    M_import_logs_act->setEnabled( false );
+    this->statusBar()->showMessage( tr( "Importing %1 logs..." ).arg( files.size() ) );
+
+    // collect more samples than the free space.
+    // EditData::importSamples() selects the representative ones.
+    M_log_importer->start( files,
+                           team_name.trimmed(),
+                           ( SampleDataSet::MAX_DATA_SIZE - data_count ) * 8 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::showImportProgress( int finished,
+                                int total )
+{
+    this->statusBar()->showMessage( tr( "Importing... %1/%2 logs, %3 samples" )
+                                    .arg( finished )
+                                    .arg( total )
+                                    .arg( M_log_importer->result().samples().size() ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::finishImport()
+{
+    M_import_logs_act->setEnabled( true );
+
+    boost::shared_ptr< EditData > data = M_import_data.lock();
+    M_import_data.reset();
+
+    if ( ! M_edit_data
+         || data != M_edit_data )
+    {
+        this->statusBar()->showMessage( tr( "Import result discarded."
+                                            " Formation was changed." ) );
+        return;
+    }
+
+    const std::size_t count = M_edit_data->importSamples( M_log_importer->result() );
+    pushDataCommand( tr( "Import samples" ) );
+
+    QString message = tr( "Imported %1 samples." ).arg( count );
+    if ( M_log_importer->failedCount() > 0 )
+    {
+        message += tr( " %1 logs could not be read." ).arg( M_log_importer->failedCount() );
+    }
+    this->statusBar()->showMessage( message );
+
+    if ( count == 0 )
+    {
+        return;
+    }
+
+    const int data_count = M_edit_data->samples()->dataCont().size();
+    M_index_spin_box->setRange( 0, data_count );
+
+    updateDataIndex();
+    M_edit_canvas->update(); // emit viewUpdated();
+    M_sample_view->updateData();
+    M_constraint_view->updateData();
+}
+
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -1685,6 +1935,7 @@ MainWindow::addData()
     }
 
     SampleDataSet::ErrorType err = M_edit_data->addData();
+    pushDataCommand( tr( "Add data" ) );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
@@ -1719,6 +1970,7 @@ MainWindow::insertData()
     if ( index == -1 ) index = 0;
 
     SampleDataSet::ErrorType err  = M_edit_data->insertData( index );
+    pushDataCommand( tr( "Insert data" ) );
     if ( err != SampleDataSet::NO_ERROR )
     {
         showWarningMessage( err );
@@ -1750,6 +2002,7 @@ MainWindow::replaceData()
 
     int index = M_index_spin_box->value() - 1;
     SampleDataSet::ErrorType err  = M_edit_data->replaceData( index );
+    pushDataCommand( tr( "Replace data" ) );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
@@ -1793,6 +2046,7 @@ MainWindow::deleteData()
     std::cerr << "deleteData index=" << index << std::endl;
 
     SampleDataSet::ErrorType err = M_edit_data->deleteData( index );
+    pushDataCommand( tr( "Delete data" ) );
     if ( err != SampleDataSet::NO_ERROR )
     {
         showWarningMessage( err );
@@ -1829,6 +2083,7 @@ MainWindow::changeSampleIndex( int old_visual_index,
 
     SampleDataSet::ErrorType err = M_edit_data->changeDataIndex( old_visual_index - 1,
                                                                  new_visual_index - 1 );
+    pushDataCommand( tr( "Move data" ) );
     if ( err != SampleDataSet::NO_ERROR )
     {
         showWarningMessage( err );
@@ -1864,25 +2119,224 @@ MainWindow::reverseY()
 
  */
 void
-MainWindow::train()
+MainWindow::reduceSamples()
 {
-    std::cerr << "train" << std::endl;
     if ( ! M_edit_data
-         || ! M_edit_data->samples() )
+         || ! M_edit_data->samples()
+         || ! M_edit_data->formation() )
     {
         return;
     }
 
-    M_edit_data->train();
+    if ( M_training_thread )
+    {
+        this->statusBar()->showMessage( tr( "Training is running." ) );
+        return;
+    }
 
     const int data_count = M_edit_data->samples()->dataCont().size();
-    M_index_spin_box->setRange( 0, data_count );
+    if ( data_count <= 3 )
+    {
+        this->statusBar()->showMessage( tr( "Too few samples to reduce." ) );
+        return;
+    }
+
+    QStringList methods;
+    methods.push_back( tr( "Farthest point" ) );
+    methods.push_back( tr( "k-means" ) );
+
+    bool ok = false;
+    const QString method = QInputDialog::getItem( this,
+                                                  tr( "Reduce Samples" ),
+                                                  tr( "Choose a selection method:" ),
+                                                  methods,
+                                                  0,
+                                                  false, // no editable
+                                                  &ok );
+    if ( ! ok )
+    {
+        return;
+    }
+
+    const int target = QInputDialog::getInt( this,
+                                             tr( "Reduce Samples" ),
+                                             tr( "Max number of samples" ),
+                                             std::max( 3, data_count / 2 ), // default
+                                             1, // min
+                                             data_count, // max
+                                             1, // step
+                                             &ok );
+    if ( ! ok )
+    {
+        return;
+    }
+
+    const double error = QInputDialog::getDouble( this,
+                                                  tr( "Reduce Samples" ),
+                                                  tr( "Allowed position error [m] (0: not used)" ),
+                                                  0.0, // default
+                                                  0.0, // min
+                                                  100.0, // max
+                                                  2, // decimals
+                                                  &ok );
+    if ( ! ok )
+    {
+        return;
+    }
 
+    SampleReducer reducer;
+    reducer.setMethod( method == methods.front()
+                       ? SampleReducer::FARTHEST_POINT
+                       : SampleReducer::K_MEANS );
+    reducer.setTargetSize( target );
+    reducer.setErrorBudget( error );
+
+    QApplication::setOverrideCursor( QCursor( Qt::WaitCursor ) );
+    const std::size_t removed = M_edit_data->reduceSamples( reducer );
+    pushDataCommand( tr( "Reduce samples" ) );
+    QApplication::restoreOverrideCursor();
+
+    this->statusBar()->showMessage( tr( "Removed %1 samples." ).arg( removed ) );
+
+    if ( removed == 0 )
+    {
+        return;
+    }
+
+    M_index_spin_box->setRange( 0, M_edit_data->samples()->dataCont().size() );
+
+    updateDataIndex();
     M_edit_canvas->update(); // emit viewUpdated();
     M_sample_view->updateData();
     M_constraint_view->updateData();
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::train()
+{
+    std::cerr << "train" << std::endl;
+    if ( ! M_edit_data
+         || ! M_edit_data->samples()
+         || ! M_edit_data->formation() )
+    {
+        return;
+    }
+
+    if ( M_training_thread )
+    {
+        this->statusBar()->showMessage( tr( "Training is already running." ) );
+        return;
+    }
+
+    M_training_thread = new TrainingThread( M_edit_data->formation(),
+                                            M_edit_data->dataRevision(),
+                                            this );
+    if ( ! M_training_thread->formation() )
+    {
+        delete M_training_thread;
+        M_training_thread = static_cast< TrainingThread * >( 0 );
+        QMessageBox::critical( this,
+                               tr( "Error" ),
+                               tr( "Failed to copy the formation for training." ) );
+        return;
+    }
+
+    M_training_data = M_edit_data;
+
+    connect( M_training_thread, SIGNAL( progressed( int, int, double ) ),
+             this, SLOT( showTrainingProgress( int, int, double ) ) );
+    connect( M_training_thread, SIGNAL( finished() ),
+             this, SLOT( finishTraining() ) );
+
+    M_train_act->setEnabled( false );
+    M_cancel_training_act->setEnabled( true );
+    this->statusBar()->showMessage( tr( "Training..." ) );
+
+    M_training_thread->start( QThread::LowPriority );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::cancelTraining()
+{
+    if ( M_training_thread )
+    {
+        M_training_thread->cancel();
+        this->statusBar()->showMessage( tr( "Cancelling the training..." ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::showTrainingProgress( int unum,
+                                  int epoch,
+                                  double error )
+{
+    this->statusBar()->showMessage( tr( "Training... player %1 epoch %2 error %3" )
+                                    .arg( unum )
+                                    .arg( epoch )
+                                    .arg( error, 0, 'g', 4 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::finishTraining()
+{
+    if ( ! M_training_thread )
+    {
+        return;
+    }
+
+    TrainingThread * thread = M_training_thread;
+    M_training_thread = static_cast< TrainingThread * >( 0 );
+
+    M_train_act->setEnabled( true );
+    M_cancel_training_act->setEnabled( false );
+
+    boost::shared_ptr< EditData > data = M_training_data.lock();
+    M_training_data.reset();
+
+    if ( thread->isCancelled() )
+    {
+        this->statusBar()->showMessage( tr( "Training cancelled." ) );
+    }
+    else if ( ! M_edit_data
+              || data != M_edit_data
+              || M_edit_data->dataRevision() != thread->dataRevision() )
+    {
+        // samples or roles were modified during the training.
+        this->statusBar()->showMessage( tr( "Training result discarded."
+                                            " Data were modified." ) );
+    }
+    else
+    {
+        M_edit_data->setTrainedFormation( thread->formation() );
+        this->statusBar()->showMessage( tr( "Training finished." ) );
+
+        const int data_count = M_edit_data->samples()->dataCont().size();
+        M_index_spin_box->setRange( 0, data_count );
+
+        M_edit_canvas->update(); // emit viewUpdated();
+        M_sample_view->updateData();
+        M_constraint_view->updateData();
+    }
+
+    thread->deleteLater();
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1967,6 +2421,22 @@ MainWindow::setShowCircumcircle( bool on )
     M_edit_canvas->update(); // emit viewUpdated();
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::setHeatMapMode( QAction * act )
+{
+    if ( ! act )
+    {
+        return;
+    }
+
+    Options::instance().setHeatMapMode( static_cast< Options::HeatMapMode >( act->data().toInt() ) );
+    M_edit_canvas->update(); // emit viewUpdated();
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -2037,6 +2507,226 @@ MainWindow::setPositionLabel( const QPointF & pos )
                                .arg( pos.y(), 0, 'f', 2 ) );
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::pushDataCommand( const QString & text )
+{
+    EditData::Delta delta;
+    if ( M_edit_data
+         && M_edit_data->takeDelta( &delta ) )
+    {
+        // the command takes the content of delta.
+        M_journal->append( delta, false );
+        M_undo_stack->push( new DataEditCommand( M_edit_data, delta, text ) );
+        compactJournal();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::resetJournal( const bool snapshot )
+{
+    if ( ! Options::instance().autoBackup()
+         || ! M_edit_data
+         || ! M_edit_data->formation() )
+    {
+        M_journal->remove();
+        return;
+    }
+
+    std::string text;
+
+    // the untitled formation has no base file.
+    if ( snapshot
+         || M_edit_data->filePath().isEmpty() )
+    {
+        std::ostringstream os;
+        M_edit_data->formation()->print( os );
+        text = os.str();
+    }
+
+    M_journal->reset( EditJournal::path_for( M_edit_data->filePath() ), text );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::compactJournal()
+{
+    if ( M_journal->recordCount() >= EditJournal::COMPACTION_SIZE )
+    {
+        resetJournal( true );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MainWindow::recoverJournal( const QString & conf_path )
+{
+    const QString path = EditJournal::path_for( conf_path );
+    if ( ! Options::instance().autoBackup()
+         || ! QFile::exists( path ) )
+    {
+        return false;
+    }
+
+    std::string snapshot;
+    std::vector< EditJournal::Record > records;
+    if ( ! EditJournal::read( path, &snapshot, &records )
+         || ( snapshot.empty() && records.empty() ) )
+    {
+        return false;
+    }
+
+    QMessageBox::StandardButton result
+            = QMessageBox::question( this,
+                                     tr( "Recover" ),
+                                     tr( "Unsaved changes were found in the journal.\n" )
+                                     + path
+                                     + tr( "\nRecover them?" ),
+                                     QMessageBox::Yes | QMessageBox::No,
+                                     QMessageBox::Yes );
+    if ( result != QMessageBox::Yes )
+    {
+        return false;
+    }
+
+    if ( ! snapshot.empty() )
+    {
+        boost::shared_ptr< EditData > data( new EditData );
+        std::istringstream is( snapshot );
+        if ( ! data->readConf( is, conf_path ) )
+        {
+            QMessageBox::warning( this,
+                                  tr( "Error" ),
+                                  tr( "Failed to read the journal. \n" ) + path,
+                                  QMessageBox::Ok,
+                                  QMessageBox::NoButton );
+            return false;
+        }
+
+        M_edit_data = data;
+        // the snapshot is newer than the conf file.
+        M_edit_data->train();
+    }
+
+    if ( ! M_edit_data )
+    {
+        return false;
+    }
+
+    for ( std::vector< EditJournal::Record >::const_iterator it = records.begin();
+          it != records.end();
+          ++it )
+    {
+        if ( ! M_edit_data->applyDelta( it->delta_, it->revert_ ) )
+        {
+            std::cerr << __FILE__ << ':' << __LINE__
+                      << " *** WARNING *** Failed to replay the journal record "
+                      << ( it - records.begin() ) + 1
+                      << std::endl;
+        }
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::saveJournalSnapshot()
+{
+    // the role data edited by the dialog is not recorded by the delta.
+    if ( M_edit_data
+         && M_edit_data->isConfChanged() )
+    {
+        resetJournal( true );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::undo()
+{
+    if ( ! M_edit_data
+         || ! M_undo_stack->canUndo() )
+    {
+        return;
+    }
+
+    this->statusBar()->showMessage( tr( "Undo " ) + M_undo_stack->undoText(), 2000 );
+
+    const DataEditCommand * command
+        = dynamic_cast< const DataEditCommand * >( M_undo_stack->command( M_undo_stack->index() - 1 ) );
+
+    M_undo_stack->undo();
+
+    if ( command )
+    {
+        M_journal->append( command->delta(), true );
+        compactJournal();
+    }
+
+    const int data_count = M_edit_data->samples()->dataCont().size();
+    M_index_spin_box->setRange( 0, data_count );
+
+    updateDataIndex();
+    M_edit_canvas->update(); // emit viewUpdated();
+    M_sample_view->updateData();
+    M_constraint_view->updateData();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MainWindow::redo()
+{
+    if ( ! M_edit_data
+         || ! M_undo_stack->canRedo() )
+    {
+        return;
+    }
+
+    this->statusBar()->showMessage( tr( "Redo " ) + M_undo_stack->redoText(), 2000 );
+
+    const DataEditCommand * command
+        = dynamic_cast< const DataEditCommand * >( M_undo_stack->command( M_undo_stack->index() ) );
+
+    M_undo_stack->redo();
+
+    if ( command )
+    {
+        M_journal->append( command->delta(), false );
+        compactJournal();
+    }
+
+    const int data_count = M_edit_data->samples()->dataCont().size();
+    M_index_spin_box->setRange( 0, data_count );
+
+    updateDataIndex();
+    M_edit_canvas->update(); // emit viewUpdated();
+    M_sample_view->updateData();
+    M_constraint_view->updateData();
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -2085,6 +2775,7 @@ MainWindow::deleteSample( int index )
     std::cerr << "deleteSample index=" << index << std::endl;
 
     SampleDataSet::ErrorType err = M_edit_data->deleteData( index );
+    pushDataCommand( tr( "Delete data" ) );
     if ( err != SampleDataSet::NO_ERROR )
     {
         showWarningMessage( err );
@@ -2120,6 +2811,7 @@ MainWindow::replaceBall( int index,
     }
 
     SampleDataSet::ErrorType err  = M_edit_data->replaceBall( index, x, y );
+    pushDataCommand( tr( "Move ball" ) );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
@@ -2156,6 +2848,7 @@ MainWindow::replacePlayer( int index,
     }
 
     SampleDataSet::ErrorType err  = M_edit_data->replacePlayer( index, unum, x, y );
+    pushDataCommand( tr( "Move player" ) );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
@@ -2186,6 +2879,7 @@ MainWindow::deleteConstraint( int origin_idx,
 
     SampleDataSet::ErrorType err = M_edit_data->deleteConstraint( origin_idx,
                                                                   terminal_idx );
+    pushDataCommand( tr( "Delete constraint" ) );
     if ( err != SampleDataSet::NO_ERROR )
     {
         showWarningMessage( err );
@@ -2212,6 +2906,7 @@ MainWindow::replaceConstraint( int idx,
     SampleDataSet::ErrorType err = M_edit_data->replaceConstraint( idx,
                                                                    origin_idx,
                                                                    terminal_idx );
+    pushDataCommand( tr( "Replace constraint" ) );
 
     if ( err != SampleDataSet::NO_ERROR )
     {
@@ -2297,6 +2992,7 @@ MainWindow::showConstraintEditDialog( int first_index,
                   << std::endl;
 
         SampleDataSet::ErrorType err = M_edit_data->addConstraint( origin, terminal );
+        pushDataCommand( tr( "Add constraint" ) );
 
         if ( err != SampleDataSet::NO_ERROR )
         {
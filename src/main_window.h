@@ -35,6 +35,7 @@
 #include <QMainWindow>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 
 class QCloseEvent;
 class QLabel;
@@ -47,8 +48,11 @@ class QToolBox;
 class EditCanvas;
 class EditData;
 class EditDialog;
+class EditJournal;
 class ConstraintView;
 class SampleView;
+class TrainingThread;
+class LogImporter;
 
 /*!
   \class MainWindow
@@ -72,11 +76,20 @@ private:
 
     QLabel * M_position_label;
 
+    TrainingThread * M_training_thread; //!< running training worker
+    boost::weak_ptr< EditData > M_training_data; //!< data that started the training
+
+    LogImporter * M_log_importer; //!< game log sample collector
+    boost::weak_ptr< EditData > M_import_data; //!< data that started the import
+
+    EditJournal * M_journal; //!< crash recovery journal writer
+
     // file actions
     QAction * M_new_file_act;
     QAction * M_open_conf_act;
     QAction * M_open_background_conf_act;
     QAction * M_open_data_act;
+    QAction * M_import_logs_act;
     QAction * M_save_act;
     QAction * M_save_as_act;
     QAction * M_save_data_as_act;
@@ -91,8 +104,10 @@ private:
     QAction * M_replace_data_act;
     QAction * M_delete_data_act;
     QAction * M_reverse_y_act;
+    QAction * M_reduce_samples_act;
     QAction * M_add_constraint_act;
     QAction * M_train_act;
+    QAction * M_cancel_training_act;
 
     QAction * M_toggle_player_auto_move_act;
     QAction * M_toggle_data_auto_select_act;
@@ -113,6 +128,9 @@ private:
     QAction * M_toggle_show_circumcircle_act;
     QAction * M_toggle_antialiasing_act;
     QAction * M_toggle_show_background_data_act;
+    QAction * M_heat_map_none_act;
+    QAction * M_heat_map_vector_act;
+    QAction * M_heat_map_error_act;
     QAction * M_show_edit_dialog_act;
 
     // help actions
@@ -181,6 +199,12 @@ private:
 
     void updateEditModel();
 
+    void pushDataCommand( const QString & text );
+
+    void resetJournal( const bool snapshot );
+    void compactJournal();
+    bool recoverJournal( const QString & conf_path );
+
 private slots:
 
     // file
@@ -194,7 +218,16 @@ private slots:
     void openData();
     void saveDataAs();
 
+    void importLogs();
+    void showImportProgress( int finished,
+                             int total );
+    void finishImport();
+
+    void saveJournalSnapshot();
+
     // edit
+    void undo();
+    void redo();
     void setPlayerAutoMove( bool on );
     void setDataAutoSelect( bool on );
     void setSymmetryMode( bool on );
@@ -207,7 +240,13 @@ private slots:
     void changeSampleIndex( int old_visual_index,
                             int new_visual_index );
     void reverseY();
+    void reduceSamples();
     void train();
+    void cancelTraining();
+    void showTrainingProgress( int unum,
+                               int epoch,
+                               double error );
+    void finishTraining();
 
     // view
     void toggleFullScreen();
@@ -219,6 +258,7 @@ private slots:
     void setShowCircumcircle( bool on );
     void setAntialiasing( bool on );
     void toggleShowBackgroundData( bool on );
+    void setHeatMapMode( QAction * act );
 
     // help
     void about();
@@ -82,6 +82,7 @@ Options::Options()
     , M_show_index( true )
     , M_show_triangulation( true )
     , M_show_circumcircle( false )
+    , M_heat_map_mode( NO_HEAT_MAP )
     , M_antialiasing( false )
     , M_auto_fit_mode( true )
 {
@@ -221,7 +222,7 @@ Options::parseCmdLine( int argc,
           "specifies a .conf file as a background data." )
         ( "auto-backup", "",
           &M_auto_backup,
-          "make backup files automatically" )
+          "record the edit journal to recover the unsaved changes" )
         ;
 
     view_options.add()
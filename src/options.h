@@ -53,6 +53,13 @@ public:
         BALL_Z = 30,
     };
 
+    //! overlay type drawn under the field lines
+    enum HeatMapMode {
+        NO_HEAT_MAP = 0,
+        VECTOR_FIELD_MAP = 1, //!< selected player's position for each ball position
+        BACKGROUND_ERROR_MAP = 2, //!< distance from the background formation
+    };
+
 private:
 
     //
@@ -93,6 +100,7 @@ private:
     bool M_show_index;
     bool M_show_triangulation;
     bool M_show_circumcircle;
+    HeatMapMode M_heat_map_mode;
     bool M_antialiasing;
     bool M_auto_fit_mode;
 
@@ -275,6 +283,15 @@ public:
           return M_show_circumcircle;
       }
 
+    void setHeatMapMode( const HeatMapMode mode )
+      {
+          M_heat_map_mode = mode;
+      }
+    HeatMapMode heatMapMode() const
+      {
+          return M_heat_map_mode;
+      }
+
     //
 
     void setAntialiasing( const bool on )
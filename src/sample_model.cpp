@@ -0,0 +1,523 @@
+// -*-c++-*-
+
+/*!
+  \file sample_model.cpp
+  \brief sample data item model class Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <QtGui>
+
+#include "sample_model.h"
+
+#include "edit_data.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace rcsc;
+using namespace rcsc::formation;
+
+namespace {
+//! mime type of the dragged sample row
+const char * SAMPLE_MIME_TYPE = "application/x-fedit2-sample";
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SampleModel::SampleModel( QObject * parent )
+    : QAbstractItemModel( parent )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SampleModel::~SampleModel()
+{
+    //std::cerr << "delete SampleModel" << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleModel::setEditData( boost::shared_ptr< EditData > ptr )
+{
+    M_edit_data = ptr;
+
+    reset( ptr
+           ? SampleDataSet::ConstPtr( ptr->samples() )
+           : SampleDataSet::ConstPtr() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleModel::set_row( const SampleData & data,
+                      Row * row )
+{
+    row->key_ = &data;
+    row->ball_ = data.ball_;
+    row->players_ = data.players_;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SampleModel::same_values( const Row & lhs,
+                          const Row & rhs )
+{
+    if ( ! lhs.ball_.equals( rhs.ball_ )
+         || lhs.players_.size() != rhs.players_.size() )
+    {
+        return false;
+    }
+
+    for ( std::size_t i = 0; i < lhs.players_.size(); ++i )
+    {
+        if ( ! lhs.players_[i].equals( rhs.players_[i] ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleModel::reset( SampleDataSet::ConstPtr samples )
+{
+    std::vector< Row > new_rows;
+    if ( samples )
+    {
+        new_rows.resize( samples->dataCont().size() );
+        std::vector< Row >::iterator row = new_rows.begin();
+        for ( SampleDataSet::DataCont::const_iterator it = samples->dataCont().begin(), end = samples->dataCont().end();
+              it != end;
+              ++it, ++row )
+        {
+            set_row( *it, &(*row) );
+        }
+    }
+
+    beginResetModel();
+
+    M_samples = samples;
+    M_rows.swap( new_rows );
+
+    endResetModel();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SampleModel::updateData()
+{
+    boost::shared_ptr< EditData > ptr = M_edit_data.lock();
+    SampleDataSet::ConstPtr samples;
+    if ( ptr )
+    {
+        samples = ptr->samples();
+    }
+
+    if ( ! samples
+         || samples != M_samples )
+    {
+        reset( samples );
+        return;
+    }
+
+    //
+    // list elements are never moved in the memory.
+    // the unchanged rows are detected by the element address.
+    // the address is only compared, because the old element may have been removed.
+    //
+
+    std::vector< Row > new_rows( samples->dataCont().size() );
+    {
+        std::vector< Row >::iterator row = new_rows.begin();
+        for ( SampleDataSet::DataCont::const_iterator it = samples->dataCont().begin(), end = samples->dataCont().end();
+              it != end;
+              ++it, ++row )
+        {
+            set_row( *it, &(*row) );
+        }
+    }
+
+    const std::size_t old_size = M_rows.size();
+    const std::size_t new_size = new_rows.size();
+    const std::size_t min_size = std::min( old_size, new_size );
+
+    std::size_t prefix = 0;
+    while ( prefix < min_size
+            && M_rows[prefix].key_ == new_rows[prefix].key_ )
+    {
+        ++prefix;
+    }
+
+    std::size_t suffix = 0;
+    while ( suffix < min_size - prefix
+            && M_rows[old_size - 1 - suffix].key_ == new_rows[new_size - 1 - suffix].key_ )
+    {
+        ++suffix;
+    }
+
+    // the old rows in [prefix, old_size - suffix) are removed.
+    if ( prefix < old_size - suffix )
+    {
+        beginRemoveRows( QModelIndex(), prefix, old_size - suffix - 1 );
+        M_rows.erase( M_rows.begin() + prefix,
+                      M_rows.begin() + ( old_size - suffix ) );
+        endRemoveRows();
+    }
+
+    // the new rows in [prefix, new_size - suffix) are inserted.
+    if ( prefix < new_size - suffix )
+    {
+        beginInsertRows( QModelIndex(), prefix, new_size - suffix - 1 );
+        M_rows.insert( M_rows.begin() + prefix,
+                       new_rows.begin() + prefix,
+                       new_rows.begin() + ( new_size - suffix ) );
+        endInsertRows();
+    }
+
+    // notify the value changes of the remaining rows.
+    for ( std::size_t i = 0; i < new_size; ++i )
+    {
+        Row & row = M_rows[i];
+        const Row & new_row = new_rows[i];
+
+        if ( same_values( row, new_row ) )
+        {
+            continue;
+        }
+
+        const QModelIndex sample = index( i, 0 );
+        const int old_count = static_cast< int >( row.players_.size() );
+        const int new_count = static_cast< int >( new_row.players_.size() );
+
+        if ( new_count < old_count )
+        {
+            beginRemoveRows( sample, new_count, old_count - 1 );
+            row.players_.resize( new_count );
+            endRemoveRows();
+        }
+        else if ( new_count > old_count )
+        {
+            beginInsertRows( sample, old_count, new_count - 1 );
+            row.players_.insert( row.players_.end(),
+                                 new_row.players_.begin() + old_count,
+                                 new_row.players_.end() );
+            endInsertRows();
+        }
+
+        row.ball_ = new_row.ball_;
+        row.players_ = new_row.players_;
+
+        emit dataChanged( sample, index( i, 2 ) );
+
+        if ( new_count > 0 )
+        {
+            emit dataChanged( index( 0, 0, sample ),
+                              index( new_count - 1, 2, sample ) );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+SampleModel::sampleIndex( const QModelIndex & index ) const
+{
+    if ( ! index.isValid() )
+    {
+        return -1;
+    }
+
+    if ( index.internalId() == 0 )
+    {
+        return index.row();
+    }
+
+    return static_cast< int >( index.internalId() ) - 1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+QModelIndex
+SampleModel::index( int row,
+                    int column,
+                    const QModelIndex & parent ) const
+{
+    if ( row < 0 || column < 0 || 3 <= column )
+    {
+        return QModelIndex();
+    }
+
+    if ( ! parent.isValid() )
+    {
+        if ( static_cast< std::size_t >( row ) >= M_rows.size() )
+        {
+            return QModelIndex();
+        }
+        return createIndex( row, column, quint32( 0 ) );
+    }
+
+    // player row. internal id is (sample index + 1).
+    if ( parent.internalId() != 0
+         || row >= rowCount( parent ) )
+    {
+        return QModelIndex();
+    }
+
+    return createIndex( row, column, quint32( parent.row() + 1 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+QModelIndex
+SampleModel::parent( const QModelIndex & child ) const
+{
+    if ( ! child.isValid()
+         || child.internalId() == 0 )
+    {
+        return QModelIndex();
+    }
+
+    return createIndex( static_cast< int >( child.internalId() ) - 1, 0, quint32( 0 ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+SampleModel::rowCount( const QModelIndex & parent ) const
+{
+    if ( ! parent.isValid() )
+    {
+        return static_cast< int >( M_rows.size() );
+    }
+
+    if ( parent.internalId() != 0
+         || parent.column() != 0
+         || static_cast< std::size_t >( parent.row() ) >= M_rows.size() )
+    {
+        return 0;
+    }
+
+    return static_cast< int >( M_rows[parent.row()].players_.size() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+SampleModel::columnCount( const QModelIndex & /*parent*/ ) const
+{
+    return 3;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+QVariant
+SampleModel::data( const QModelIndex & index,
+                   int role ) const
+{
+    if ( ! index.isValid()
+         || ( role != Qt::DisplayRole
+              && role != Qt::EditRole ) )
+    {
+        return QVariant();
+    }
+
+    const int sample_index = sampleIndex( index );
+    if ( sample_index < 0
+         || static_cast< std::size_t >( sample_index ) >= M_rows.size() )
+    {
+        return QVariant();
+    }
+
+    const Row & sample = M_rows[sample_index];
+
+    Vector2D pos;
+    if ( isPlayerIndex( index ) )
+    {
+        if ( static_cast< std::size_t >( index.row() ) >= sample.players_.size() )
+        {
+            return QVariant();
+        }
+
+        if ( index.column() == 0 )
+        {
+            return tr( "p%1" ).arg( index.row() + 1 );
+        }
+        pos = sample.players_[index.row()];
+    }
+    else
+    {
+        if ( index.column() == 0 )
+        {
+            return QString::number( sample_index + 1 ); // visual index
+        }
+        pos = sample.ball_;
+    }
+
+    const double value = ( index.column() == 1 ? pos.x : pos.y );
+    if ( role == Qt::EditRole )
+    {
+        return value;
+    }
+
+    return QString::number( value, 'f', 2 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+QVariant
+SampleModel::headerData( int section,
+                         Qt::Orientation orientation,
+                         int role ) const
+{
+    if ( orientation != Qt::Horizontal
+         || role != Qt::DisplayRole )
+    {
+        return QVariant();
+    }
+
+    switch ( section ) {
+    case 0:
+        return tr( "Index" );
+    case 1:
+        return tr( "X" );
+    case 2:
+        return tr( "Y" );
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Qt::ItemFlags
+SampleModel::flags( const QModelIndex & index ) const
+{
+    if ( ! index.isValid() )
+    {
+        // samples can be dropped between the top level rows.
+        return Qt::ItemIsDropEnabled;
+    }
+
+    Qt::ItemFlags f = Qt::ItemIsEnabled;
+    if ( index.column() != 0 )
+    {
+        f |= Qt::ItemIsEditable;
+    }
+
+    if ( ! isPlayerIndex( index ) )
+    {
+        f |= Qt::ItemIsSelectable
+            | Qt::ItemIsDragEnabled
+            | Qt::ItemIsUserCheckable;
+    }
+
+    return f;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+Qt::DropActions
+SampleModel::supportedDropActions() const
+{
+    return Qt::MoveAction;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+QStringList
+SampleModel::mimeTypes() const
+{
+    return QStringList() << QString::fromAscii( SAMPLE_MIME_TYPE );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+QMimeData *
+SampleModel::mimeData( const QModelIndexList & indexes ) const
+{
+    if ( indexes.isEmpty() )
+    {
+        return static_cast< QMimeData * >( 0 );
+    }
+
+    QMimeData * mime = new QMimeData();
+    mime->setData( QString::fromAscii( SAMPLE_MIME_TYPE ),
+                   QByteArray::number( sampleIndex( indexes.front() ) ) );
+    return mime;
+}
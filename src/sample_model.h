@@ -0,0 +1,163 @@
+// -*-c++-*-
+
+/*!
+  \file sample_model.h
+  \brief sample data item model class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef FEDIT2_SAMPLE_MODEL_H
+#define FEDIT2_SAMPLE_MODEL_H
+
+#include <QAbstractItemModel>
+
+#include <rcsc/formation/sample_data.h>
+
+#include <boost/weak_ptr.hpp>
+
+#include <vector>
+#include <cstddef>
+
+class EditData;
+
+/*!
+  \class SampleModel
+  \brief item model for the sample data set.
+
+  Top level rows are samples, and their child rows are players.
+  The cell text is formatted only when the view requests it.
+
+  Each row holds a copy of the displayed values, so the model never refers
+  the data container that may have been changed before updateData().
+  updateData() compares the current data container with the copy,
+  and emits row insertion/removal and dataChanged signals only for the
+  touched samples.
+ */
+class SampleModel
+    : public QAbstractItemModel {
+
+    Q_OBJECT
+
+private:
+
+    /*!
+      \struct Row
+      \brief copy of the displayed sample values.
+     */
+    struct Row {
+        const void * key_; //!< address of the element in the data container. used only as the identifier.
+        rcsc::Vector2D ball_; //!< ball position
+        rcsc::formation::SampleData::PlayerCont players_; //!< players' position
+    };
+
+    boost::weak_ptr< EditData > M_edit_data;
+
+    //! holds the current set so that the element addresses are not reused until the next update.
+    rcsc::formation::SampleDataSet::ConstPtr M_samples;
+    std::vector< Row > M_rows;
+
+    // not used
+    SampleModel( const SampleModel & );
+    const SampleModel & operator=( const SampleModel & );
+
+public:
+
+    explicit
+    SampleModel( QObject * parent = 0 );
+    ~SampleModel();
+
+    void setEditData( boost::shared_ptr< EditData > ptr );
+
+    /*!
+      \brief synchronize rows with the current sample data set.
+     */
+    void updateData();
+
+    /*!
+      \brief get the sample index of the model index.
+      \param index model index
+      \return sample index. -1 if index is invalid.
+     */
+    int sampleIndex( const QModelIndex & index ) const;
+
+    /*!
+      \brief check if the model index is a player row.
+      \param index model index
+      \return true if index is a child of a sample.
+     */
+    bool isPlayerIndex( const QModelIndex & index ) const
+      {
+          return index.isValid() && index.internalId() != 0;
+      }
+
+    //
+    // QAbstractItemModel interface
+    //
+
+    virtual
+    QModelIndex index( int row,
+                       int column,
+                       const QModelIndex & parent = QModelIndex() ) const;
+    virtual
+    QModelIndex parent( const QModelIndex & child ) const;
+    virtual
+    int rowCount( const QModelIndex & parent = QModelIndex() ) const;
+    virtual
+    int columnCount( const QModelIndex & parent = QModelIndex() ) const;
+    virtual
+    QVariant data( const QModelIndex & index,
+                   int role = Qt::DisplayRole ) const;
+    virtual
+    QVariant headerData( int section,
+                         Qt::Orientation orientation,
+                         int role = Qt::DisplayRole ) const;
+    virtual
+    Qt::ItemFlags flags( const QModelIndex & index ) const;
+
+    virtual
+    Qt::DropActions supportedDropActions() const;
+    virtual
+    QStringList mimeTypes() const;
+    virtual
+    QMimeData * mimeData( const QModelIndexList & indexes ) const;
+
+private:
+
+    static
+    void set_row( const rcsc::formation::SampleData & data,
+                  Row * row );
+
+    static
+    bool same_values( const Row & lhs,
+                      const Row & rhs );
+
+    void reset( rcsc::formation::SampleDataSet::ConstPtr samples );
+
+};
+
+#endif
@@ -39,6 +39,7 @@
 
 #include "coordinate_delegate.h"
 #include "edit_data.h"
+#include "sample_model.h"
 
 #include <iostream>
 
@@ -47,8 +48,12 @@
 
  */
 SampleView::SampleView( QWidget * parent )
-    : QTreeWidget( parent )
+    : QTreeView( parent )
+    , M_model( new SampleModel( this ) )
 {
+    this->setModel( M_model );
+    this->setUniformRowHeights( true );
+
     this->setSelectionBehavior( QAbstractItemView::SelectRows );
     this->setSelectionMode( QAbstractItemView::SingleSelection );
     //this->setEditTriggers( QAbstractItemView::NoEditTriggers );
@@ -63,10 +68,6 @@ SampleView::SampleView( QWidget * parent )
     this->setDragDropOverwriteMode( false );
     this->setDropIndicatorShown( true );
 
-    QStringList header_labels;
-    //header_labels << tr( "Index" ) << tr( "Value" );
-    header_labels << tr( "Index" ) << tr( "X" ) << tr( "Y" );
-    this->setHeaderLabels( header_labels );
     //this->setHeaderHidden( true );
 
     this->setColumnWidth( 0, this->fontMetrics().width( tr( "1234567890" ) + 64 ) );
@@ -85,8 +86,8 @@ SampleView::SampleView( QWidget * parent )
 //     M_samples->setFlags( Qt::ItemIsEnabled
 //                          | Qt::ItemIsDropEnabled );
 
-    connect( this, SIGNAL( currentItemChanged( QTreeWidgetItem *,  QTreeWidgetItem * ) ),
-             this, SLOT( setCurrentData( QTreeWidgetItem * ) ) );
+    connect( this->selectionModel(), SIGNAL( currentChanged( const QModelIndex &, const QModelIndex & ) ),
+             this, SLOT( setCurrentData( const QModelIndex & ) ) );
     //     connect( this, SIGNAL( itemDoubleClicked( QTreeWidgetItem *, int ) ),
     //              this, SLOT( doubleClickItem( QTreeWidgetItem *, int ) ) );
 
@@ -116,88 +117,20 @@ SampleView::~SampleView()
 
  */
 void
-SampleView::updateData()
+SampleView::setData( boost::shared_ptr< EditData > ptr )
 {
-    boost::shared_ptr< EditData > ptr = M_edit_data.lock();
-    if ( ! ptr
-         || ! ptr->samples() )
-    {
-        return;
-    }
-
-    //
-    // update samples
-    //
-
-    const int data_count = ptr->samples()->dataCont().size();
-
-    while ( this->topLevelItemCount() > data_count )
-    {
-        this->takeTopLevelItem( this->topLevelItemCount() - 1 );
-    }
-
-    int idx = 0;
-    const rcsc::formation::SampleDataSet::DataCont::const_iterator end = ptr->samples()->dataCont().end();
-    for ( rcsc::formation::SampleDataSet::DataCont::const_iterator it = ptr->samples()->dataCont().begin();
-          it != end;
-          ++it, ++idx )
-    {
-        QTreeWidgetItem * item = this->topLevelItem( idx );
-        if ( ! item )
-        {
-            item = new QTreeWidgetItem();
-            item->setFlags( Qt::ItemIsSelectable
-                            | Qt::ItemIsEditable
-                            | Qt::ItemIsDragEnabled
-                            //| Qt::ItemIsDropEnabled
-                            | Qt::ItemIsUserCheckable
-                            | Qt::ItemIsEnabled
-                            );
-            this->insertTopLevelItem( idx, item );
-
-            for ( size_t i = 0; i < it->players_.size(); ++i )
-            {
-                QTreeWidgetItem * p = new QTreeWidgetItem();
-                p->setText( 0, tr( "p%1" ).arg( i + 1 ) );
-                //p->setData( 0, Qt::DisplayRole, tr( "p%1" ).arg( i + 1 ) );
-                p->setFlags( //Qt::ItemIsSelectable
-                            Qt::ItemIsEditable
-                            //| Qt::ItemIsDragEnabled
-                            //| Qt::ItemIsUserCheckable
-                            | Qt::ItemIsEnabled
-                             );
-
-                item->addChild( p );
-            }
-        }
-
-        item->setText( 0, QString::number( idx + 1 ) ); // visual index
-        item->setText( 1, QString::number( it->ball_.x, 'f', 2 ) );
-        item->setText( 2, QString::number( it->ball_.y, 'f', 2 ) );
-        //item->setData( 0, Qt::DisplayRole, idx + 1 ); // visual index
-        //item->setData( 1, Qt::EditRole, it->ball_.x );
-        //item->setData( 2, Qt::EditRole, it->ball_.y );
+    M_edit_data = ptr;
+    M_model->setEditData( ptr );
+}
 
-        for ( size_t i = 0; i < it->players_.size(); ++i )
-        {
-            QTreeWidgetItem * p = item->child( i );
-            if ( ! p )
-            {
-                std::cerr << "SampleView::updateData " << idx
-                          << " player " << i + 1 << " not found"
-                          << std::endl;
-                //p = new QTreeWidgetItem();
-                //p->setText( 0, QString::number( i + 1 ) );
-                //item->insertChild( i, p );
-                continue;
-            }
+/*-------------------------------------------------------------------*/
+/*!
 
-            p->setText( 1, QString::number( it->players_[i].x, 'f', 2 ) );
-            p->setText( 2, QString::number( it->players_[i].y, 'f', 2 ) );
-            //p->setData( 1, Qt::EditRole, it->players_[i].x );
-            //p->setData( 2, Qt::EditRole, it->players_[i].y );
-        }
-    }
+ */
+void
+SampleView::updateData()
+{
+    M_model->updateData();
 }
 
 /*-------------------------------------------------------------------*/
@@ -209,17 +142,16 @@ SampleView::selectSample( int idx )
 {
     //std::cerr << "SampleView::selectDataIndex " << idx << std::endl;
 
-    QTreeWidgetItem * item = this->topLevelItem( idx );
-    if ( item )
+    QModelIndex index = M_model->index( idx, 0 );
+    if ( index.isValid() )
     {
         //         this->clearSelection();
-        //         item->setSelected( true );
-        //         this->scrollToItem( item );
-        this->setCurrentItem( item );
+        //         this->scrollTo( index );
+        this->setCurrentIndex( index );
     }
     else
     {
-        this->setCurrentItem( static_cast< QTreeWidgetItem * >( 0 ) );
+        this->setCurrentIndex( QModelIndex() );
     }
 }
 
@@ -233,7 +165,7 @@ SampleView::unselectData()
     //std::cerr << "SampleView::unselectDataIndex" << std::endl;
 
     //this->clearSelection();
-    this->setCurrentItem( static_cast< QTreeWidgetItem * >( 0 ) );
+    this->setCurrentIndex( QModelIndex() );
 }
 
 /*-------------------------------------------------------------------*/
@@ -253,30 +185,29 @@ SampleView::unselectData()
 void
 SampleView::contextMenuEvent( QContextMenuEvent * event )
 {
-    QTreeWidgetItem * item = this->itemAt( event->pos() );
+    QModelIndex index = this->indexAt( event->pos() );
 
-    if ( ! item )
+    if ( ! index.isValid() )
     {
         return;
     }
 
-    if ( item->parent() )
+    if ( M_model->isPlayerIndex( index ) )
     {
         std::cerr << "contextMenuEvent clicked item has parent." << std::endl;
         return;
     }
 
-    if ( ! item->isSelected() )
+    index = index.sibling( index.row(), 0 );
+    if ( ! this->selectionModel()->isSelected( index ) )
     {
         //         this->clearSelection();
-        //         item->setSelected( true );
-        this->setCurrentItem( item );
+        this->setCurrentIndex( index );
     }
 
     std::cerr << "SampleView::contextMenuEvent "
               << event->pos().x() << ',' << event->pos().y()
-              << "  item: idx=" << item->text( 0 ).toStdString()
-              << "  value=" << item->text( 1 ).toStdString()
+              << "  item: idx=" << index.row() + 1
               << std::endl;
 
     QMenu menu( this );
@@ -299,27 +230,30 @@ SampleView::dropEvent( QDropEvent * event )
     //          << "\n  pos=" << event->pos().x() << ',' << event->pos().y()
     //          << std::endl;
 
-    QTreeWidgetItem * moving = this->currentItem();
-    if ( ! moving )
+    QModelIndex moving = this->currentIndex();
+    if ( ! moving.isValid() )
     {
         event->ignore();
         return;
     }
 
-    QTreeWidgetItem * dest = this->itemAt( event->pos() );
-    if ( ! dest )
+    QModelIndex dest = this->indexAt( event->pos() );
+    if ( ! dest.isValid() )
     {
         event->ignore();
         return;
     }
 
+    moving = moving.sibling( moving.row(), 0 );
+    dest = dest.sibling( dest.row(), 0 );
+
     if ( this->dropIndicatorPosition() == QAbstractItemView::AboveItem )
     {
-        int dest_index = this->indexOfTopLevelItem( dest );
+        int dest_index = dest.row();
         if ( dest_index > 0 )
         {
-            dest = this->topLevelItem( dest_index - 1 );
-            if ( ! dest )
+            dest = dest.sibling( dest_index - 1, 0 );
+            if ( ! dest.isValid() )
             {
                 event->ignore();
                 return;
@@ -333,7 +267,7 @@ SampleView::dropEvent( QDropEvent * event )
         return;
     }
 
-    if ( moving->parent() != dest->parent() )
+    if ( moving.parent() != dest.parent() )
     {
         event->ignore();
         return;
@@ -341,21 +275,15 @@ SampleView::dropEvent( QDropEvent * event )
 
     event->ignore();
 
-    //std::cerr << "  moving item = " << moving->text( 0 ).toStdString()
-    //          << " , " << moving->text( 1 ).toStdString()
-    //          << "\n  dest=" << dest->text( 0 ).toStdString()
-    //          << " , " << dest->text( 1 ).toStdString()
-    //          << std::endl;
-
-    if ( ! moving->parent() )
+    if ( ! M_model->isPlayerIndex( moving ) )
     {
-        int visual_moving_index = this->indexOfTopLevelItem( moving ) + 1;
-        int visual_dest_index = this->indexOfTopLevelItem( dest ) + 1;
+        int visual_moving_index = moving.row() + 1;
+        int visual_dest_index = dest.row() + 1;
 
         emit sampleIndexChangeRequested( visual_moving_index, visual_dest_index );
     }
 
-    //QTreeWidget::dropEvent( event );
+    //QTreeView::dropEvent( event );
 }
 
 
@@ -383,9 +311,14 @@ SampleView::dropEvent( QDropEvent * event )
 
  */
 void
-SampleView::setCurrentData( QTreeWidgetItem * current )
+SampleView::setCurrentData( const QModelIndex & current )
 {
-    int idx = this->indexOfTopLevelItem( current );
+    if ( M_model->isPlayerIndex( current ) )
+    {
+        return;
+    }
+
+    int idx = M_model->sampleIndex( current );
     if ( 0 <= idx )
     {
         emit sampleSelected( idx );
@@ -406,13 +339,14 @@ SampleView::menuChangeSampleIndex()
         return;
     }
 
-    QTreeWidgetItem * item = this->currentItem();
-    if ( ! item )
+    QModelIndex index = this->currentIndex();
+    if ( ! index.isValid()
+         || M_model->isPlayerIndex( index ) )
     {
         return;
     }
 
-    int idx = this->indexOfTopLevelItem( item );
+    int idx = index.row();
     if ( 0 <= idx )
     {
         const int data_size = ptr->samples()->dataCont().size();
@@ -450,14 +384,11 @@ SampleView::menuChangeSampleIndex()
 void
 SampleView::menuDeleteSample()
 {
-    QTreeWidgetItem * item = this->currentItem();
-    if ( item )
+    QModelIndex index = this->currentIndex();
+    if ( index.isValid()
+         && ! M_model->isPlayerIndex( index ) )
     {
-        int idx = this->indexOfTopLevelItem( item );
-        if ( 0 <= idx )
-        {
-            emit sampleDeleteRequested( idx );
-        }
+        emit sampleDeleteRequested( index.row() );
     }
 }
 
@@ -501,71 +432,42 @@ SampleView::changeCoordinates( const QModelIndex & index,
               << " index=" << index.row() << ',' << index.column()
               << " value=" << value
               << std::endl;
-    QTreeWidgetItem * item = this->itemFromIndex( index );
+    const int idx = M_model->sampleIndex( index );
+    if ( idx < 0 )
+    {
+        return;
+    }
 
-    if ( item )
+    double x = 0.0, y = 0.0;
+    if ( index.column() == 1 )
     {
-        if ( ! item->parent() ) // no parent == root item
-        {
-            // ball
-            int idx = this->indexOfTopLevelItem( item );
-            if ( 0 <= idx )
-            {
-                double x = 0.0, y = 0.0;
-                if ( index.column() == 1 )
-                {
-                    x = value;
-                    y = item->text( 2 ).toDouble();
-                }
-                else if ( index.column() == 2 )
-                {
-                    x = item->text( 1 ).toDouble();
-                    y = value;
-                }
-                else
-                {
-                    std::cerr << __FILE__ << ':' << __LINE__ << ':'
-                              << " Illegal column count"
-                              << std::endl;
-                    return;
-                }
-
-                emit ballReplaced( idx, x, y );
-            }
-        }
-        else if ( item->parent()
-                  && ! item->parent()->parent() )
-        {
-            // players
-            int idx = this->indexOfTopLevelItem( item->parent() );
-            if ( 0 <= idx )
-            {
-                int unum = item->text( 0 ).mid( 1 ).toInt();
-
-                double x = 0.0, y = 0.0;
-                if ( index.column() == 1 )
-                {
-                    x = value;
-                    y = item->text( 2 ).toDouble();
-                }
-                else if ( index.column() == 2 )
-                {
-                    x = item->text( 1 ).toDouble();
-                    y = value;
-                }
-                else
-                {
-                    std::cerr << __FILE__ << ':' << __LINE__ << ':'
-                              << " Illegal column count"
-                              << std::endl;
-                    return;
-                }
-
-                emit playerReplaced( idx, unum, x, y );
-            }
-        }
+        x = value;
+        y = index.sibling( index.row(), 2 ).data( Qt::EditRole ).toDouble();
+    }
+    else if ( index.column() == 2 )
+    {
+        x = index.sibling( index.row(), 1 ).data( Qt::EditRole ).toDouble();
+        y = value;
+    }
+    else
+    {
+        std::cerr << __FILE__ << ':' << __LINE__ << ':'
+                  << " Illegal column count"
+                  << std::endl;
+        return;
     }
 
+    if ( ! M_model->isPlayerIndex( index ) )
+    {
+        // ball
+        emit ballReplaced( idx, x, y );
+    }
+    else
+    {
+        // players
+        int unum = index.row() + 1;
+        emit playerReplaced( idx, unum, x, y );
+    }
 }
 
 /*-------------------------------------------------------------------*/
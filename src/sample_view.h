@@ -32,14 +32,15 @@
 #ifndef FEDIT2_SAMPLE_VIEW_H
 #define FEDIT2_SAMPLE_VIEW_H
 
-#include <QTreeWidget>
+#include <QTreeView>
 
 #include <boost/weak_ptr.hpp>
 
 class EditData;
+class SampleModel;
 
 class SampleView
-    : public QTreeWidget {
+    : public QTreeView {
 
     Q_OBJECT
 
@@ -47,16 +48,14 @@ private:
 
     boost::weak_ptr< EditData > M_edit_data;
 
+    SampleModel * M_model;
+
 public:
 
     SampleView( QWidget * parent = 0 );
     ~SampleView();
 
-    void setData( boost::shared_ptr< EditData > ptr )
-      {
-          M_edit_data = ptr;
-      }
-
+    void setData( boost::shared_ptr< EditData > ptr );
 
     void updateData();
 
@@ -70,7 +69,7 @@ protected:
 
 private slots:
 
-    void setCurrentData( QTreeWidgetItem * current );
+    void setCurrentData( const QModelIndex & current );
     void menuChangeSampleIndex();
     void menuDeleteSample();
     void changeCoordinates( const QModelIndex & index,
@@ -44,6 +44,14 @@ win32 {
 }
 
 QMAKE_CXXFLAGS += -static
+# librcsc is built with OpenMP
+QMAKE_CXXFLAGS += -fopenmp
+QMAKE_LFLAGS += -fopenmp
+# librcsc uses pthread for the background threads except on win32
+unix {
+  QMAKE_CXXFLAGS += -pthread
+  LIBS += -lpthread
+}
 
 # Input
 HEADERS += \
@@ -55,10 +63,15 @@ HEADERS += \
 	edit_canvas.h \
 	edit_data.h \
 	edit_dialog.h \
+	edit_journal.h \
+	heat_map.h \
+	log_importer.h \
 	main_window.h \
 	mouse_state.h \
 	options.h \
+	sample_model.h \
 	sample_view.h \
+	training_thread.h \
     Field.h
 
 SOURCES += \
@@ -70,10 +83,15 @@ SOURCES += \
 	edit_canvas.cpp \
 	edit_data.cpp \
 	edit_dialog.cpp \
+	edit_journal.cpp \
+	heat_map.cpp \
+	log_importer.cpp \
 	main.cpp \
 	main_window.cpp \
 	options.cpp \
+	sample_model.cpp \
 	sample_view.cpp \
+	training_thread.cpp \
     Field.cpp
 
 nodist_soccerwindow2_qt4_SOURCES = \
@@ -83,8 +101,12 @@ nodist_soccerwindow2_qt4_SOURCES = \
 	moc_coordinate_delegate.cpp \
 	moc_edit_canvas.cpp \
 	moc_edit_dialog.cpp \
+	moc_heat_map.cpp \
+	moc_log_importer.cpp \
 	moc_main_window.cpp \
-	moc_sample_view.cpp
+	moc_sample_model.cpp \
+	moc_sample_view.cpp \
+	moc_training_thread.cpp
 
 RC_FILE = fedit2.rc
 OBJECTS_DIR = $$PWD/objs
@@ -0,0 +1,138 @@
+// -*-c++-*-
+
+/*!
+  \file training_thread.cpp
+  \brief formation training thread class Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "training_thread.h"
+
+#include <iostream>
+
+using namespace rcsc;
+
+namespace {
+//! minimum interval [ms] of the progress signal
+const int PROGRESS_INTERVAL = 100;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+TrainingThread::TrainingThread( Formation::ConstPtr formation,
+                                const unsigned long data_revision,
+                                QObject * parent )
+    : QThread( parent ),
+      M_data_revision( data_revision ),
+      M_cancelled( 0 )
+{
+    if ( ! formation )
+    {
+        return;
+    }
+
+    M_formation = formation->clone();
+    if ( ! M_formation )
+    {
+        std::cerr << __FILE__ << ":" << __LINE__
+                  << " Failed to copy the formation." << std::endl;
+        return;
+    }
+
+    M_formation->setTrainingObserver( this );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+TrainingThread::~TrainingThread()
+{
+    cancel();
+    wait();
+
+    if ( M_formation )
+    {
+        M_formation->setTrainingObserver( static_cast< Formation::TrainingObserver * >( 0 ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+TrainingThread::cancel()
+{
+    M_cancelled.fetchAndStoreOrdered( 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+TrainingThread::progress( const int unum,
+                          const int epoch,
+                          const double & error )
+{
+    if ( M_cancelled != 0 )
+    {
+        return false;
+    }
+
+    if ( M_progress_timer.elapsed() >= PROGRESS_INTERVAL )
+    {
+        M_progress_timer.restart();
+        emit progressed( unum, epoch, error );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+TrainingThread::run()
+{
+    if ( ! M_formation )
+    {
+        return;
+    }
+
+    M_progress_timer.start();
+    M_formation->train();
+}
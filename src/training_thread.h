@@ -0,0 +1,135 @@
+// -*-c++-*-
+
+/*!
+  \file training_thread.h
+  \brief formation training thread class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef FEDIT2_TRAINING_THREAD_H
+#define FEDIT2_TRAINING_THREAD_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QTime>
+
+#include <rcsc/formation/formation.h>
+#include <rcsc/formation/sample_data.h>
+
+/*!
+  \class TrainingThread
+  \brief worker thread that trains the private copy of the formation.
+
+  The formation and the sample data set are copied in the constructor,
+  so the GUI thread can continue to use the original ones while training.
+  The result formation is retrieved after the finished() signal.
+*/
+class TrainingThread
+    : public QThread,
+      public rcsc::Formation::TrainingObserver {
+
+    Q_OBJECT
+
+private:
+
+    rcsc::Formation::Ptr M_formation; //!< trained copy
+    const unsigned long M_data_revision; //!< data revision at the copy time
+
+    QAtomicInt M_cancelled; //!< cancel request flag
+    QTime M_progress_timer; //!< throttle of the progress signal
+
+    // not used
+    TrainingThread();
+    TrainingThread( const TrainingThread & );
+    const TrainingThread & operator=( const TrainingThread & );
+
+public:
+
+    /*!
+      \brief copy the formation and the sample data. must be called in the GUI thread.
+      \param formation original formation
+      \param data_revision revision number of the edit data
+      \param parent parent object
+     */
+    TrainingThread( rcsc::Formation::ConstPtr formation,
+                    const unsigned long data_revision,
+                    QObject * parent = 0 );
+
+    ~TrainingThread();
+
+    /*!
+      \brief get the trained formation. valid only after the thread finished.
+      \return formation pointer. NULL if failed to copy.
+     */
+    rcsc::Formation::Ptr formation() const
+      {
+          return M_formation;
+      }
+
+    /*!
+      \brief get the data revision number when the formation was copied.
+      \return revision number
+     */
+    unsigned long dataRevision() const
+      {
+          return M_data_revision;
+      }
+
+    /*!
+      \brief check if the cancel was requested.
+      \return true if cancelled.
+     */
+    bool isCancelled() const
+      {
+          return M_cancelled != 0;
+      }
+
+    /*!
+      \brief called from the training loop in the worker thread.
+     */
+    bool progress( const int unum,
+                   const int epoch,
+                   const double & error );
+
+public slots:
+
+    void cancel();
+
+protected:
+
+    void run();
+
+signals:
+
+    void progressed( int unum,
+                     int epoch,
+                     double error );
+
+};
+
+#endif
@@ -0,0 +1,91 @@
+// -*-c++-*-
+
+/*!
+  \file dlog2text.cpp
+  \brief binary debug log converter Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/common/logger.h>
+
+#include <iostream>
+#include <fstream>
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog << " <BinaryLogFile> [<OutputFile>]\n"
+              << "  Convert the binary debug log into the text format.\n"
+              << "  If the output file is not given, the result is written to stdout."
+              << std::endl;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+main( int argc, char ** argv )
+{
+    if ( argc < 2 || 3 < argc )
+    {
+        usage( argv[0] );
+        return 1;
+    }
+
+    std::ifstream fin( argv[1], std::ios_base::in | std::ios_base::binary );
+    if ( ! fin.is_open() )
+    {
+        std::cerr << "Could not open the input file [" << argv[1] << "]" << std::endl;
+        return 1;
+    }
+
+    if ( argc == 3 )
+    {
+        std::ofstream fout( argv[2] );
+        if ( ! fout.is_open() )
+        {
+            std::cerr << "Could not open the output file [" << argv[2] << "]" << std::endl;
+            return 1;
+        }
+
+        return ( rcsc::Logger::binary_to_text( fin, fout ) ? 0 : 1 );
+    }
+
+    return ( rcsc::Logger::binary_to_text( fin, std::cout ) ? 0 : 1 );
+}
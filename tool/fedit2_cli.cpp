@@ -0,0 +1,1184 @@
+// -*-c++-*-
+
+/*!
+  \file fedit2_cli.cpp
+  \brief command line formation processor Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2, or (at your option)
+ any later version.
+
+ This code is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this code; see the file COPYING.  If not, write to
+ the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/formation/formation.h>
+#include <rcsc/formation/sample_data.h>
+#include <rcsc/formation/sample_harvester.h>
+#include <rcsc/formation/sample_reducer.h>
+#include <rcsc/geom/rect_2d.h>
+#include <rcsc/geom/vector_2d.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace rcsc;
+using namespace rcsc::formation;
+
+namespace {
+
+/*!
+  \struct CommandOptions
+  \brief parsed command line.
+*/
+struct CommandOptions {
+    std::string command_; //!< subcommand name
+    std::string output_file_; //!< -o
+    std::string output_dir_; //!< -d
+    bool in_place_; //!< -i
+    std::string type_; //!< -t
+    int jobs_; //!< -j
+    double tolerance_; //!< --tolerance
+    double step_; //!< --step
+    std::string base_file_; //!< -b
+    std::string team_name_; //!< --team
+    bool all_modes_; //!< --all-modes
+    int max_samples_; //!< --max-samples
+    double min_dist_; //!< --min-dist
+    bool reduce_; //!< --reduce
+    SampleReducer::Method method_; //!< --method
+    int target_; //!< --target
+    double error_; //!< --error
+    unsigned long seed_; //!< --seed
+    std::vector< std::string > inputs_; //!< input file paths
+    std::vector< std::string > temp_files_; //!< result files of harvest workers
+
+    CommandOptions()
+        : in_place_( false ),
+          jobs_( 0 ),
+          tolerance_( 0.05 ),
+          step_( 0.1 ),
+          all_modes_( false ),
+          max_samples_( static_cast< int >( SampleDataSet::MAX_DATA_SIZE ) ),
+          min_dist_( SampleDataSet::NEAR_DIST_THR ),
+          reduce_( false ),
+          method_( SampleReducer::FARTHEST_POINT ),
+          target_( static_cast< int >( SampleDataSet::MAX_DATA_SIZE ) ),
+          error_( 0.0 ),
+          seed_( 0 )
+      { }
+};
+
+typedef bool (*FileCommand)( const CommandOptions &, const std::size_t );
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog << " COMMAND [OPTIONS] FILE...\n"
+              << "Commands:\n"
+              << "  train      retrain formations from their samples.\n"
+              << "  validate   check samples, constraints and the reproduction error.\n"
+              << "  convert    change the formation type. -t is required.\n"
+              << "  bake       write the position table over the ball position grid.\n"
+              << "  diff       compare two formations. (diff A.conf B.conf)\n"
+              << "  harvest    collect samples from game logs. (harvest [-b BASE.conf] LOG...)\n"
+              << "  reduce     select the representative samples of formations.\n"
+              << "Options:\n"
+              << "  -o FILE    output file. only for one input file.\n"
+              << "  -d DIR     output directory. the input file name is used.\n"
+              << "  -i         overwrite the input files. (train, convert, reduce)\n"
+              << "  -t TYPE    target formation type. (convert)\n"
+              << "  -j N       number of parallel jobs. default: number of processors.\n"
+              << "  --tolerance VALUE  allowed position error [m]. default: 0.05\n"
+              << "  --step VALUE       grid step of the ball position [m]. default: 0.1\n"
+              << "Harvest options:\n"
+              << "  -b FILE    base formation. samples are added to it and it is trained.\n"
+              << "             without -b, the collected samples are printed.\n"
+              << "  --team NAME        target team name. default: the left team.\n"
+              << "  --all-modes        collect samples in all playmodes, not only play on.\n"
+              << "  --max-samples N    max number of samples. default: 128\n"
+              << "  --min-dist VALUE   min distance between the ball positions [m]. default: 0.1\n"
+              << "  --reduce           reduce the harvested samples by the reduce options.\n"
+              << "                     with -b, the target is limited by the free space of BASE.\n"
+              << "Reduce options:\n"
+              << "  --method NAME      fps (farthest point) or kmeans. default: fps\n"
+              << "  --target N         max number of the samples. default: 128\n"
+              << "  --error VALUE      allowed max position error [m]. the smallest set\n"
+              << "                     within it is searched. default: 0 (not used)\n"
+              << "  --seed N           random seed. default: 0\n"
+              << "Without -o, -d and -i, the result is printed to the standard output."
+              << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+bool
+parse_options( int argc,
+               char ** argv,
+               CommandOptions * opt )
+{
+    if ( argc < 2 )
+    {
+        return false;
+    }
+
+    opt->command_ = argv[1];
+
+    for ( int i = 2; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        const bool has_value = ( i + 1 < argc );
+
+        if ( arg == "-o" && has_value )
+        {
+            opt->output_file_ = argv[++i];
+        }
+        else if ( arg == "-d" && has_value )
+        {
+            opt->output_dir_ = argv[++i];
+        }
+        else if ( arg == "-i" )
+        {
+            opt->in_place_ = true;
+        }
+        else if ( arg == "-t" && has_value )
+        {
+            opt->type_ = argv[++i];
+        }
+        else if ( arg == "-j" && has_value )
+        {
+            opt->jobs_ = std::atoi( argv[++i] );
+        }
+        else if ( arg == "--tolerance" && has_value )
+        {
+            opt->tolerance_ = std::atof( argv[++i] );
+        }
+        else if ( arg == "--step" && has_value )
+        {
+            opt->step_ = std::atof( argv[++i] );
+        }
+        else if ( arg == "-b" && has_value )
+        {
+            opt->base_file_ = argv[++i];
+        }
+        else if ( arg == "--team" && has_value )
+        {
+            opt->team_name_ = argv[++i];
+        }
+        else if ( arg == "--all-modes" )
+        {
+            opt->all_modes_ = true;
+        }
+        else if ( arg == "--max-samples" && has_value )
+        {
+            opt->max_samples_ = std::atoi( argv[++i] );
+        }
+        else if ( arg == "--min-dist" && has_value )
+        {
+            opt->min_dist_ = std::atof( argv[++i] );
+        }
+        else if ( arg == "--reduce" )
+        {
+            opt->reduce_ = true;
+        }
+        else if ( arg == "--method" && has_value )
+        {
+            if ( ! SampleReducer::parse_method( argv[++i], &opt->method_ ) )
+            {
+                std::cerr << "Unknown method [" << argv[i] << "]" << std::endl;
+                return false;
+            }
+        }
+        else if ( arg == "--target" && has_value )
+        {
+            opt->target_ = std::atoi( argv[++i] );
+        }
+        else if ( arg == "--error" && has_value )
+        {
+            opt->error_ = std::atof( argv[++i] );
+        }
+        else if ( arg == "--seed" && has_value )
+        {
+            opt->seed_ = std::strtoul( argv[++i], static_cast< char ** >( 0 ), 10 );
+        }
+        else if ( ! arg.empty() && arg[0] == '-' )
+        {
+            std::cerr << "Unknown option [" << arg << "]" << std::endl;
+            return false;
+        }
+        else
+        {
+            opt->inputs_.push_back( arg );
+        }
+    }
+
+    if ( opt->inputs_.empty() )
+    {
+        std::cerr << "No input file." << std::endl;
+        return false;
+    }
+
+    if ( ! opt->output_file_.empty()
+         && opt->command_ != "harvest"
+         && opt->inputs_.size() != 1 )
+    {
+        std::cerr << "-o can be used only for one input file." << std::endl;
+        return false;
+    }
+
+    if ( opt->step_ <= 0.0
+         || opt->tolerance_ < 0.0 )
+    {
+        std::cerr << "Illegal --step or --tolerance value." << std::endl;
+        return false;
+    }
+
+    if ( opt->max_samples_ <= 0
+         || opt->min_dist_ <= 0.0 )
+    {
+        std::cerr << "Illegal --max-samples or --min-dist value." << std::endl;
+        return false;
+    }
+
+    if ( opt->target_ <= 0
+         || opt->error_ < 0.0 )
+    {
+        std::cerr << "Illegal --target or --error value." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+Formation::Ptr
+open_formation( const std::string & filepath )
+{
+    std::ifstream fin( filepath.c_str() );
+    if ( ! fin )
+    {
+        std::cerr << filepath << ": Could not open the file." << std::endl;
+        return Formation::Ptr();
+    }
+
+    Formation::Ptr ptr = Formation::create( fin );
+    if ( ! ptr )
+    {
+        std::cerr << filepath << ": Unknown formation type." << std::endl;
+        return Formation::Ptr();
+    }
+
+    fin.seekg( 0 );
+    if ( ! ptr->read( fin ) )
+    {
+        std::cerr << filepath << ": Could not read the formation." << std::endl;
+        return Formation::Ptr();
+    }
+
+    return ptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+std::string
+output_path( const CommandOptions & opt,
+             const std::string & input,
+             const std::string & suffix )
+{
+    if ( ! opt.output_file_.empty() )
+    {
+        return opt.output_file_;
+    }
+
+    if ( ! opt.output_dir_.empty() )
+    {
+        std::string::size_type pos = input.find_last_of( "/\\" );
+        std::string name = ( pos == std::string::npos
+                             ? input
+                             : input.substr( pos + 1 ) );
+        return opt.output_dir_ + '/' + name + suffix;
+    }
+
+    if ( opt.in_place_ )
+    {
+        return input + suffix;
+    }
+
+    // standard output
+    return std::string();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief write the text into the file, or the standard output.
+  The file is replaced after the whole content is written.
+ */
+static
+bool
+write_output( const std::string & filepath,
+              const std::string & content )
+{
+    if ( filepath.empty() )
+    {
+        std::cout << content << std::flush;
+        return true;
+    }
+
+    const std::string tmp_path = filepath + ".tmp";
+    {
+        std::ofstream fout( tmp_path.c_str() );
+        if ( ! fout
+             || ! ( fout << content )
+             || ! fout.flush() )
+        {
+            std::cerr << filepath << ": Could not write the file." << std::endl;
+            std::remove( tmp_path.c_str() );
+            return false;
+        }
+    }
+
+    std::remove( filepath.c_str() );
+    if ( std::rename( tmp_path.c_str(), filepath.c_str() ) != 0 )
+    {
+        std::cerr << filepath << ": Could not rename the file." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the max distance between the samples and the formation output.
+ */
+static
+double
+reproduction_error( const Formation & formation,
+                    const SampleDataSet & samples )
+{
+    double max_error = 0.0;
+    std::vector< Vector2D > positions;
+
+    for ( SampleDataSet::DataCont::const_iterator it = samples.dataCont().begin(), end = samples.dataCont().end();
+          it != end;
+          ++it )
+    {
+        formation.getPositions( it->ball_, positions );
+
+        const std::size_t size = std::min( positions.size(), it->players_.size() );
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+            max_error = std::max( max_error, positions[i].dist( it->players_[i] ) );
+        }
+    }
+
+    return max_error;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the bounding rectangle of the ball positions in samples.
+ */
+static
+Rect2D
+sample_area( const SampleDataSet & samples )
+{
+    double min_x = 0.0, max_x = 0.0, min_y = 0.0, max_y = 0.0;
+    bool first = true;
+
+    for ( SampleDataSet::DataCont::const_iterator it = samples.dataCont().begin(), end = samples.dataCont().end();
+          it != end;
+          ++it )
+    {
+        if ( first )
+        {
+            min_x = max_x = it->ball_.x;
+            min_y = max_y = it->ball_.y;
+            first = false;
+            continue;
+        }
+
+        min_x = std::min( min_x, it->ball_.x );
+        max_x = std::max( max_x, it->ball_.x );
+        min_y = std::min( min_y, it->ball_.y );
+        max_y = std::max( max_y, it->ball_.y );
+    }
+
+    return Rect2D::from_corners( min_x, min_y, max_x, max_y );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+bool
+train_file( const CommandOptions & opt,
+            const std::size_t index )
+{
+    const std::string & input = opt.inputs_[index];
+
+    Formation::Ptr formation = open_formation( input );
+    if ( ! formation )
+    {
+        return false;
+    }
+
+    formation->train();
+
+    std::ostringstream os;
+    formation->print( os );
+
+    if ( ! write_output( output_path( opt, input, "" ), os.str() ) )
+    {
+        return false;
+    }
+
+    std::cerr << input << ": trained. samples="
+              << formation->samples()->dataCont().size()
+              << std::endl;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+bool
+validate_file( const CommandOptions & opt,
+               const std::size_t index )
+{
+    const std::string & input = opt.inputs_[index];
+
+    Formation::Ptr formation = open_formation( input );
+    if ( ! formation )
+    {
+        return false;
+    }
+
+    SampleDataSet::ConstPtr samples = formation->samples();
+    if ( ! samples
+         || samples->dataCont().empty() )
+    {
+        std::cout << input << ": NG no sample data." << std::endl;
+        return false;
+    }
+
+    bool result = true;
+
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        if ( formation->isSymmetryType( unum )
+             && ! formation->isSideType( formation->getSymmetryNumber( unum ) ) )
+        {
+            std::cout << input << ": NG player " << unum
+                      << " refers the illegal symmetry number "
+                      << formation->getSymmetryNumber( unum ) << std::endl;
+            result = false;
+        }
+    }
+
+    if ( samples->existIntersectedConstraints() )
+    {
+        std::cout << input << ": NG intersected constraints exist." << std::endl;
+        result = false;
+    }
+
+    formation->train();
+
+    const double error = reproduction_error( *formation, *samples );
+    if ( error > opt.tolerance_ )
+    {
+        std::cout << input << ": NG max sample error " << error
+                  << " > tolerance " << opt.tolerance_ << std::endl;
+        result = false;
+    }
+
+    if ( result )
+    {
+        std::cout << input << ": OK samples=" << samples->dataCont().size()
+                  << " constraints=" << samples->constraints().size()
+                  << " max_error=" << error << std::endl;
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+bool
+convert_file( const CommandOptions & opt,
+              const std::size_t index )
+{
+    const std::string & input = opt.inputs_[index];
+
+    Formation::Ptr formation = open_formation( input );
+    if ( ! formation )
+    {
+        return false;
+    }
+
+    Formation::Ptr converted = Formation::create( opt.type_ );
+    if ( ! converted )
+    {
+        std::cerr << input << ": Unknown formation type [" << opt.type_ << "]" << std::endl;
+        return false;
+    }
+
+    //
+    // copy role info.
+    // the new formation regards all players as side type without parameter,
+    // so the center role is created at first and then the type is changed.
+    // side type players must be ready before the symmetry players refer them.
+    //
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        converted->updateRole( unum, 0, formation->getRoleName( unum ) );
+        if ( formation->isSideType( unum ) )
+        {
+            converted->updateRole( unum, -1, formation->getRoleName( unum ) );
+        }
+    }
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        if ( ! formation->isSymmetryType( unum ) ) continue;
+
+        if ( ! converted->updateRole( unum,
+                                      formation->getSymmetryNumber( unum ),
+                                      formation->getRoleName( unum ) ) )
+        {
+            std::cerr << input << ": Could not copy the role of player " << unum << std::endl;
+            return false;
+        }
+    }
+
+    converted->setSamples( SampleDataSet::Ptr( new SampleDataSet( *formation->samples() ) ) );
+    converted->train();
+
+    std::ostringstream os;
+    converted->print( os );
+
+    if ( ! write_output( output_path( opt, input, "" ), os.str() ) )
+    {
+        return false;
+    }
+
+    std::cerr << input << ": converted " << formation->methodName()
+              << " -> " << converted->methodName() << std::endl;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+bool
+bake_file( const CommandOptions & opt,
+           const std::size_t index )
+{
+    const std::string & input = opt.inputs_[index];
+
+    Formation::Ptr formation = open_formation( input );
+    if ( ! formation )
+    {
+        return false;
+    }
+
+    if ( ! formation->samples()
+         || formation->samples()->dataCont().empty() )
+    {
+        std::cerr << input << ": No sample data." << std::endl;
+        return false;
+    }
+
+    const Rect2D area = sample_area( *formation->samples() );
+    const int nx = static_cast< int >( std::floor( area.size().length() / opt.step_ ) ) + 1;
+    const int ny = static_cast< int >( std::floor( area.size().width() / opt.step_ ) ) + 1;
+
+    std::ostringstream os;
+    os << "# " << formation->methodName() << " position table\n"
+       << "# nx ny min_x min_y step\n"
+       << nx << ' ' << ny << ' '
+       << area.left() << ' ' << area.top() << ' ' << opt.step_ << '\n'
+       << "# ball_x ball_y p1_x p1_y ... p11_x p11_y\n";
+
+    std::vector< Vector2D > positions;
+    for ( int iy = 0; iy < ny; ++iy )
+    {
+        for ( int ix = 0; ix < nx; ++ix )
+        {
+            const Vector2D ball( area.left() + ix * opt.step_,
+                                 area.top() + iy * opt.step_ );
+            formation->getPositions( ball, positions );
+
+            os << ball.x << ' ' << ball.y;
+            for ( std::vector< Vector2D >::const_iterator p = positions.begin(), end = positions.end();
+                  p != end;
+                  ++p )
+            {
+                os << ' ' << p->x << ' ' << p->y;
+            }
+            os << '\n';
+        }
+    }
+
+    if ( opt.in_place_ )
+    {
+        std::cerr << "bake: -i is not supported." << std::endl;
+        return false;
+    }
+
+    if ( ! write_output( output_path( opt, input, ".bake" ), os.str() ) )
+    {
+        return false;
+    }
+
+    std::cerr << input << ": baked " << nx << 'x' << ny << " positions" << std::endl;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+void
+setup_reducer( const CommandOptions & opt,
+               SampleReducer * reducer )
+{
+    reducer->setMethod( opt.method_ );
+    reducer->setTargetSize( static_cast< std::size_t >( opt.target_ ) );
+    reducer->setErrorBudget( opt.error_ );
+    reducer->setSeed( opt.seed_ );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+bool
+reduce_file( const CommandOptions & opt,
+             const std::size_t index )
+{
+    const std::string & input = opt.inputs_[index];
+
+    Formation::Ptr formation = open_formation( input );
+    if ( ! formation )
+    {
+        return false;
+    }
+
+    SampleReducer reducer;
+    setup_reducer( opt, &reducer );
+
+    const std::size_t old_size = formation->samples()->dataCont().size();
+
+    formation->setSamples( reducer.reduce( *formation, *formation->samples() ) );
+    formation->train();
+
+    std::ostringstream os;
+    formation->print( os );
+
+    if ( ! write_output( output_path( opt, input, "" ), os.str() ) )
+    {
+        return false;
+    }
+
+    std::cerr << input << ": reduced. samples=" << old_size
+              << " -> " << formation->samples()->dataCont().size()
+              << " max_error=" << reproduction_error( *formation, *formation->samples() )
+              << std::endl;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief run the command for each input file. files are processed by
+  the child processes in parallel.
+  \return number of failed files.
+ */
+static
+int
+run_files( const CommandOptions & opt,
+           FileCommand command )
+{
+    int failed = 0;
+
+#ifndef _WIN32
+    int jobs = opt.jobs_;
+    if ( jobs <= 0 )
+    {
+        jobs = static_cast< int >( sysconf( _SC_NPROCESSORS_ONLN ) );
+    }
+    jobs = std::max( 1, std::min( jobs, static_cast< int >( opt.inputs_.size() ) ) );
+
+    if ( jobs > 1 )
+    {
+        // flush before fork, or the buffered text is printed twice.
+        std::cout.flush();
+        std::cerr.flush();
+
+        int running = 0;
+        for ( std::size_t index = 0; index < opt.inputs_.size(); ++index )
+        {
+            if ( running >= jobs )
+            {
+                int status = 0;
+                if ( wait( &status ) > 0 )
+                {
+                    --running;
+                    if ( ! WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ) ++failed;
+                }
+            }
+
+            pid_t pid = fork();
+            if ( pid == 0 )
+            {
+                const bool result = command( opt, index );
+                std::cout.flush();
+                std::cerr.flush();
+                _exit( result ? 0 : 1 );
+            }
+            else if ( pid < 0 )
+            {
+                // could not create the process. run it here.
+                if ( ! command( opt, index ) ) ++failed;
+            }
+            else
+            {
+                ++running;
+            }
+        }
+
+        while ( running > 0 )
+        {
+            int status = 0;
+            if ( wait( &status ) <= 0 )
+            {
+                break;
+            }
+            --running;
+            if ( ! WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ) ++failed;
+        }
+
+        return failed;
+    }
+#endif
+
+    for ( std::size_t index = 0; index < opt.inputs_.size(); ++index )
+    {
+        if ( ! command( opt, index ) ) ++failed;
+    }
+
+    return failed;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+bool
+diff_files( const CommandOptions & opt )
+{
+    if ( opt.inputs_.size() != 2 )
+    {
+        std::cerr << "diff: two input files are required." << std::endl;
+        return false;
+    }
+
+    Formation::Ptr lhs = open_formation( opt.inputs_[0] );
+    Formation::Ptr rhs = open_formation( opt.inputs_[1] );
+    if ( ! lhs || ! rhs )
+    {
+        return false;
+    }
+
+    bool same = true;
+
+    if ( lhs->methodName() != rhs->methodName() )
+    {
+        std::cout << "type: " << lhs->methodName() << " | " << rhs->methodName() << '\n';
+        same = false;
+    }
+
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        if ( lhs->getRoleName( unum ) != rhs->getRoleName( unum )
+             || lhs->getSymmetryNumber( unum ) != rhs->getSymmetryNumber( unum ) )
+        {
+            std::cout << "role " << unum << ": "
+                      << lhs->getRoleName( unum ) << '(' << lhs->getSymmetryNumber( unum ) << ')'
+                      << " | "
+                      << rhs->getRoleName( unum ) << '(' << rhs->getSymmetryNumber( unum ) << ')'
+                      << '\n';
+            same = false;
+        }
+    }
+
+    //
+    // compare the positions over the grid covering both sample sets
+    //
+
+    const bool lhs_has_data = ( lhs->samples() && ! lhs->samples()->dataCont().empty() );
+    const bool rhs_has_data = ( rhs->samples() && ! rhs->samples()->dataCont().empty() );
+
+    if ( ! lhs_has_data && ! rhs_has_data )
+    {
+        std::cout << "no sample data." << std::endl;
+        return same;
+    }
+
+    const Rect2D area = ( ! rhs_has_data
+                          ? sample_area( *lhs->samples() )
+                          : ! lhs_has_data
+                          ? sample_area( *rhs->samples() )
+                          : sample_area( *lhs->samples() ).united( sample_area( *rhs->samples() ) ) );
+
+    const int nx = static_cast< int >( std::floor( area.size().length() / opt.step_ ) ) + 1;
+    const int ny = static_cast< int >( std::floor( area.size().width() / opt.step_ ) ) + 1;
+
+    std::vector< double > max_dist( 11, 0.0 );
+    std::vector< double > sum_dist( 11, 0.0 );
+    std::vector< Vector2D > lhs_pos, rhs_pos;
+
+    for ( int iy = 0; iy < ny; ++iy )
+    {
+        for ( int ix = 0; ix < nx; ++ix )
+        {
+            const Vector2D ball( area.left() + ix * opt.step_,
+                                 area.top() + iy * opt.step_ );
+            lhs->getPositions( ball, lhs_pos );
+            rhs->getPositions( ball, rhs_pos );
+
+            const std::size_t size = std::min( std::min( lhs_pos.size(), rhs_pos.size() ),
+                                               std::size_t( 11 ) );
+            for ( std::size_t i = 0; i < size; ++i )
+            {
+                const double d = lhs_pos[i].dist( rhs_pos[i] );
+                max_dist[i] = std::max( max_dist[i], d );
+                sum_dist[i] += d;
+            }
+        }
+    }
+
+    const double count = static_cast< double >( nx ) * ny;
+    for ( int i = 0; i < 11; ++i )
+    {
+        if ( max_dist[i] > opt.tolerance_ )
+        {
+            same = false;
+        }
+
+        std::cout << "player " << i + 1
+                  << ": max=" << max_dist[i]
+                  << " mean=" << sum_dist[i] / count
+                  << ( max_dist[i] > opt.tolerance_ ? "  *" : "" )
+                  << '\n';
+    }
+
+    std::cout << ( same ? "same" : "different" )
+              << " (grid " << nx << 'x' << ny
+              << ", tolerance " << opt.tolerance_ << ")" << std::endl;
+
+    return same;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+static
+void
+setup_harvester( const CommandOptions & opt,
+                 SampleHarvester * harvester )
+{
+    harvester->setTeamName( opt.team_name_ );
+    harvester->setPlayOnOnly( ! opt.all_modes_ );
+    harvester->setMaxSize( static_cast< std::size_t >( opt.max_samples_ ) );
+    harvester->setMinDistance( opt.min_dist_ );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief collect samples from one log file. the result is written to the temporary file.
+ */
+static
+bool
+harvest_file( const CommandOptions & opt,
+              const std::size_t index )
+{
+    const std::string & input = opt.inputs_[index];
+
+    SampleHarvester harvester;
+    setup_harvester( opt, &harvester );
+
+    const bool result = harvester.harvest( input );
+    if ( ! result )
+    {
+        std::cerr << input << ": Failed to parse the log. "
+                  << harvester.samples().size() << " samples are used." << std::endl;
+    }
+
+    std::ostringstream os;
+    harvester.print( os );
+    if ( ! write_output( opt.temp_files_[index], os.str() ) )
+    {
+        return false;
+    }
+
+    std::cerr << input << ": shows=" << harvester.showCount()
+              << " samples=" << harvester.samples().size()
+              << " min_dist=" << harvester.minDistance()
+              << std::endl;
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief collect samples from all log files in parallel, and merge them in the input order.
+ */
+static
+bool
+harvest_files( CommandOptions & opt )
+{
+    Formation::Ptr formation;
+    if ( ! opt.base_file_.empty() )
+    {
+        formation = open_formation( opt.base_file_ );
+        if ( ! formation )
+        {
+            return false;
+        }
+    }
+
+    const char * tmp_dir = std::getenv( "TMPDIR" );
+    for ( std::size_t i = 0; i < opt.inputs_.size(); ++i )
+    {
+        std::ostringstream os;
+        os << ( tmp_dir ? tmp_dir : "/tmp" ) << "/fedit2-cli-"
+#ifndef _WIN32
+           << getpid() << '-'
+#endif
+           << i << ".txt";
+        opt.temp_files_.push_back( os.str() );
+    }
+
+    const int failed = run_files( opt, &harvest_file );
+
+    SampleHarvester harvester;
+    setup_harvester( opt, &harvester );
+
+    for ( std::vector< std::string >::const_iterator it = opt.temp_files_.begin(), end = opt.temp_files_.end();
+          it != end;
+          ++it )
+    {
+        std::ifstream fin( it->c_str() );
+        if ( fin )
+        {
+            harvester.read( fin );
+        }
+        fin.close();
+        std::remove( it->c_str() );
+    }
+
+    std::cerr << "harvested " << harvester.samples().size() << " samples from "
+              << opt.inputs_.size() - failed << '/' << opt.inputs_.size() << " logs."
+              << " min_dist=" << harvester.minDistance() << std::endl;
+
+    if ( opt.reduce_ )
+    {
+        SampleReducer reducer;
+        setup_reducer( opt, &reducer );
+
+        std::size_t target = static_cast< std::size_t >( opt.target_ );
+        if ( formation )
+        {
+            const std::size_t used = formation->samples()->dataCont().size();
+            target = std::min( target,
+                               ( used < SampleDataSet::MAX_DATA_SIZE
+                                 ? SampleDataSet::MAX_DATA_SIZE - used
+                                 : 0 ) );
+        }
+        reducer.setTargetSize( target );
+
+        std::vector< std::size_t > indices;
+        if ( formation )
+        {
+            indices = reducer.reduce( *formation, harvester.samples(), std::vector< std::size_t >() );
+        }
+        else
+        {
+            // no formation to evaluate the error
+            indices = reducer.select( harvester.samples(), std::vector< std::size_t >(), target );
+        }
+
+        SampleHarvester reduced;
+        setup_harvester( opt, &reduced );
+        for ( std::vector< std::size_t >::const_iterator it = indices.begin(), end = indices.end();
+              it != end;
+              ++it )
+        {
+            reduced.add( harvester.samples()[*it] );
+        }
+
+        std::cerr << "reduced " << harvester.samples().size()
+                  << " -> " << reduced.samples().size() << " samples." << std::endl;
+        harvester = reduced;
+    }
+
+    std::ostringstream os;
+    if ( formation )
+    {
+        const std::size_t added = harvester.appendTo( *formation, *formation->samples() );
+        std::cerr << opt.base_file_ << ": added " << added << " samples." << std::endl;
+
+        formation->train();
+        formation->print( os );
+    }
+    else
+    {
+        harvester.print( os );
+    }
+
+    if ( ! write_output( opt.output_file_, os.str() ) )
+    {
+        return false;
+    }
+
+    return failed == 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+main( int argc, char ** argv )
+{
+    CommandOptions opt;
+    if ( ! parse_options( argc, argv, &opt ) )
+    {
+        usage( argv[0] );
+        return 2;
+    }
+
+    if ( opt.command_ == "diff" )
+    {
+        return diff_files( opt ) ? 0 : 1;
+    }
+
+    if ( opt.command_ == "harvest" )
+    {
+        return harvest_files( opt ) ? 0 : 1;
+    }
+
+    FileCommand command = static_cast< FileCommand >( 0 );
+    if ( opt.command_ == "train" )
+    {
+        command = &train_file;
+    }
+    else if ( opt.command_ == "validate" )
+    {
+        command = &validate_file;
+    }
+    else if ( opt.command_ == "convert" )
+    {
+        if ( opt.type_.empty() )
+        {
+            std::cerr << "convert: -t TYPE is required." << std::endl;
+            return 2;
+        }
+        command = &convert_file;
+    }
+    else if ( opt.command_ == "bake" )
+    {
+        command = &bake_file;
+    }
+    else if ( opt.command_ == "reduce" )
+    {
+        command = &reduce_file;
+    }
+    else
+    {
+        std::cerr << "Unknown command [" << opt.command_ << "]" << std::endl;
+        usage( argv[0] );
+        return 2;
+    }
+
+    if ( opt.command_ != "validate"
+         && opt.output_file_.empty()
+         && opt.output_dir_.empty()
+         && ! opt.in_place_
+         && opt.inputs_.size() > 1 )
+    {
+        std::cerr << opt.command_
+                  << ": -o, -d or -i is required for multiple input files." << std::endl;
+        return 2;
+    }
+
+    const int failed = run_files( opt, command );
+    if ( failed > 0 )
+    {
+        std::cerr << failed << " file(s) failed." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}